@@ -0,0 +1,432 @@
+/*
+   Copyright (C) 2011  Equinor ASA, Norway.
+
+   The file 'convert.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.hpp>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+
+/*
+  The source file is split in chunks of consecutive keywords, using the
+  keyword offsets from the ecl_file index. The chunks are converted by
+  worker threads into memory buffers, and the buffers are written to
+  the target file in order. At most 2 * num_threads chunks are kept in
+  memory at the same time. The chunks are at most CHUNK_SIZE bytes, and
+  smaller for small files so that all the threads get work.
+*/
+
+#define CHUNK_SIZE (8 << 20)
+
+struct convert_chunk_type {
+    offset_type offset;
+    int num_kw;
+    char *data = NULL;
+    size_t size = 0;
+    bool done = false;
+    bool ok = false;
+};
+
+static bool convert_keywords(fortio_type *src, fortio_type *target,
+                             int num_kw) {
+    for (int i = 0; i < num_kw; i++) {
+        ecl_kw_type *ecl_kw = ecl_kw_fread_alloc(src);
+        if (!ecl_kw)
+            return false;
+
+        ecl_kw_fwrite(ecl_kw, target);
+        ecl_kw_free(ecl_kw);
+    }
+    return true;
+}
+
+/*
+  The index of the source stops at the first keyword which can not be
+  read, so the last chunk must end at the end of the file.
+*/
+static void convert_chunk(const char *src_file, bool fmt_src,
+                          fortio_type *src, convert_chunk_type *chunk,
+                          bool last) {
+    FILE *stream = open_memstream(&chunk->data, &chunk->size);
+    fortio_type *target = fortio_alloc_FILE_wrapper(src_file, ECL_ENDIAN_FLIP,
+                                                    !fmt_src, true, stream);
+
+    if (fortio_fseek(src, chunk->offset, SEEK_SET))
+        chunk->ok = convert_keywords(src, target, chunk->num_kw) &&
+                    (!last || fortio_read_at_eof(src));
+
+    fortio_free_FILE_wrapper(target);
+    fclose(stream);
+}
+
+static bool alloc_chunks(const char *src_file, int num_threads,
+                         std::vector<convert_chunk_type> &chunks) {
+    ecl_file_type *ecl_file = ecl_file_open(src_file, ECL_FILE_READ_AHEAD);
+    if (!ecl_file)
+        return false;
+
+    {
+        offset_type chunk_size = util_file_size(src_file) / (2 * num_threads);
+        ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+
+        chunk_size = std::min<offset_type>(chunk_size, CHUNK_SIZE);
+        for (int i = 0; i < ecl_file_view_get_size(view); i++) {
+            offset_type offset =
+                ecl_file_kw_get_offset(ecl_file_view_iget_file_kw(view, i));
+
+            if (chunks.empty() || offset - chunks.back().offset >= chunk_size)
+                chunks.push_back({offset, 0});
+            chunks.back().num_kw++;
+        }
+    }
+    ecl_file_close(ecl_file);
+    return !chunks.empty() || util_file_size(src_file) == 0;
+}
+
+static bool file_convert_parallel(const char *src_file, FILE *target_stream,
+                                  bool fmt_src, int num_threads) {
+    std::vector<convert_chunk_type> chunks;
+    const size_t max_pending = 2 * num_threads;
+    std::atomic<size_t> next_chunk(0);
+    size_t written = 0;
+    bool ok = true;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::thread> workers;
+
+    if (!alloc_chunks(src_file, num_threads, chunks)) {
+        fprintf(stderr, "Opening %s failed \n", src_file);
+        return false;
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        workers.emplace_back([&]() {
+            fortio_type *src =
+                fortio_open_reader(src_file, fmt_src, ECL_ENDIAN_FLIP);
+            if (!src) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ok = false;
+                }
+                cond.notify_all();
+                return;
+            }
+
+            while (true) {
+                size_t index = next_chunk++;
+                if (index >= chunks.size())
+                    break;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() {
+                        return !ok || index < written + max_pending;
+                    });
+                    if (!ok)
+                        break;
+                }
+
+                convert_chunk(src_file, fmt_src, src, &chunks[index],
+                              index == chunks.size() - 1);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chunks[index].done = true;
+                }
+                cond.notify_all();
+            }
+            fortio_fclose(src);
+        });
+    }
+
+    for (auto &chunk : chunks) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return chunk.done || !ok; });
+            if (!chunk.done)
+                break;
+        }
+
+        if (chunk.ok)
+            util_fwrite(chunk.data, 1, chunk.size, target_stream, __func__);
+        free(chunk.data);
+        chunk.data = NULL;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written++;
+            if (!chunk.ok)
+                ok = false;
+        }
+        cond.notify_all();
+        if (!ok)
+            break;
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    for (auto &chunk : chunks)
+        free(chunk.data);
+
+    if (!ok)
+        fprintf(stderr, "Reading keyword failed \n");
+    return ok;
+}
+
+static bool file_convert_sequential(fortio_type *src, fortio_type *target) {
+    while (true) {
+        if (fortio_read_at_eof(src))
+            break;
+
+        {
+            ecl_kw_type *ecl_kw = ecl_kw_fread_alloc(src);
+            if (ecl_kw) {
+                ecl_kw_fwrite(ecl_kw, target);
+                ecl_kw_free(ecl_kw);
+            } else {
+                fprintf(stderr, "Reading keyword failed \n");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+  The target is written to a temporary file which is renamed to the
+  target when the conversion succeeds, so an existing target is left
+  untouched when the conversion fails.
+*/
+bool file_convert(const char *src_file, const char *target_file,
+                  ecl_file_enum file_type, bool fmt_src, int num_threads) {
+    char *tmp_file = util_alloc_sprintf("%s.tmp", target_file);
+    bool formatted_src;
+    bool ok;
+
+    if (file_type != ECL_OTHER_FILE)
+        formatted_src = fmt_src;
+    else {
+        if (util_fmt_bit8(src_file))
+            formatted_src = true;
+        else
+            formatted_src = false;
+    }
+
+    if (num_threads > 1) {
+        FILE *target_stream =
+            util_fopen(tmp_file, formatted_src ? "wb" : "w");
+        ok = file_convert_parallel(src_file, target_stream, formatted_src,
+                                   num_threads);
+        fclose(target_stream);
+    } else {
+        fortio_type *src =
+            fortio_open_reader(src_file, formatted_src, ECL_ENDIAN_FLIP);
+        if (!src) {
+            fprintf(stderr, "Opening %s failed \n", src_file);
+            free(tmp_file);
+            return false;
+        }
+
+        {
+            fortio_type *target =
+                fortio_open_writer(tmp_file, !formatted_src, ECL_ENDIAN_FLIP);
+            fortio_set_read_ahead(src, FORTIO_DEFAULT_READ_AHEAD);
+
+            ok = file_convert_sequential(src, target);
+
+            fortio_fclose(target);
+        }
+        fortio_fclose(src);
+    }
+
+    if (ok && rename(tmp_file, target_file) != 0) {
+        fprintf(stderr, "Renaming %s -> %s failed \n", tmp_file, target_file);
+        ok = false;
+    }
+    if (!ok)
+        remove(tmp_file);
+
+    free(tmp_file);
+    return ok;
+}
+
+struct convert_job_type {
+    std::string src_file;
+    std::string target_file;
+    ecl_file_enum file_type;
+    bool fmt_file;
+};
+
+/*
+  Converts many files concurrently, one file per thread. This is used
+  when there are at least as many files as threads; otherwise the files
+  are converted one at a time, with the threads sharing each file.
+*/
+static bool file_convert_list(const std::vector<std::string> &src_files,
+                              int num_threads) {
+    std::vector<convert_job_type> jobs;
+    std::atomic<size_t> next_file(0);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> workers;
+    int file_threads = 1;
+    int chunk_threads = num_threads;
+
+    if (src_files.size() >= (size_t)num_threads) {
+        file_threads = num_threads;
+        chunk_threads = 1;
+    }
+
+    /* The names are set up, and printed, by the main thread. */
+    for (const auto &file : src_files) {
+        const char *src_file = file.c_str();
+        char *path;
+        char *basename;
+        char *extension;
+        char *target_file;
+        int report_nr;
+        bool fmt_file;
+        ecl_file_enum file_type =
+            ecl_util_get_file_type(src_file, &fmt_file, &report_nr);
+
+        util_alloc_file_components(src_file, &path, &basename, &extension);
+        target_file = ecl_util_alloc_filename(path, basename, file_type,
+                                              !fmt_file, report_nr);
+        printf("Converting %s -> %s \n", src_file, target_file);
+        jobs.push_back({src_file, target_file, file_type, fmt_file});
+
+        free(path);
+        free(basename);
+        free(extension);
+        free(target_file);
+    }
+    fflush(stdout);
+
+    for (int i = 0; i < file_threads; i++) {
+        workers.emplace_back([&]() {
+            while (true) {
+                size_t index = next_file++;
+                if (index >= jobs.size())
+                    break;
+
+                const convert_job_type &job = jobs[index];
+                if (!file_convert(job.src_file.c_str(),
+                                  job.target_file.c_str(), job.file_type,
+                                  job.fmt_file, chunk_threads))
+                    ok = false;
+            }
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    return ok;
+}
+
+static bool has_wildcard(const char *arg) {
+    return strpbrk(arg, "*?[") != NULL;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: convert.x [-j num_threads] <filename1> <filename2> ...\n"
+            "\n"
+            "The filenames can be quoted glob patterns like 'CASE*.UNRST'.\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    int arg_offset = 1;
+
+    if (argc > 1 && strcmp(argv[1], "-j") == 0) {
+        if (argc < 3 || !util_sscanf_int(argv[2], &num_threads) ||
+            num_threads < 1)
+            usage();
+        arg_offset = 3;
+    }
+
+    if (argc == arg_offset)
+        usage();
+    else {
+        char *src_file = argv[arg_offset];
+        int report_nr;
+        ecl_file_enum file_type;
+        bool fmt_file;
+        file_type = ecl_util_get_file_type(src_file, &fmt_file, &report_nr);
+
+        if (file_type == ECL_OTHER_FILE && !has_wildcard(src_file)) {
+            if (argc != arg_offset + 2) {
+                fprintf(stderr,
+                        "When the file can not be recognized on the name as an "
+                        "ECLIPSE file you must give output_file as second (and "
+                        "final) argument \n");
+                exit(0);
+            }
+            printf("Converting %s -> %s \n", src_file, argv[arg_offset + 1]);
+            if (!file_convert(src_file, argv[arg_offset + 1], file_type,
+                              fmt_file, num_threads))
+                exit(1);
+        } else {
+            std::vector<std::string> src_files;
+            stringlist_type *matches = stringlist_alloc_new();
+
+            for (int iarg = arg_offset; iarg < argc; iarg++) {
+                if (has_wildcard(argv[iarg]) && !util_file_exists(argv[iarg])) {
+                    stringlist_select_matching(matches, argv[iarg]);
+                    for (int i = 0; i < stringlist_get_size(matches); i++)
+                        src_files.push_back(stringlist_iget(matches, i));
+                } else
+                    src_files.push_back(argv[iarg]);
+            }
+            stringlist_free(matches);
+
+            for (const auto &file : src_files) {
+                file_type =
+                    ecl_util_get_file_type(file.c_str(), &fmt_file, &report_nr);
+                if (file_type == ECL_OTHER_FILE) {
+                    fprintf(stderr, "File: %s - problem \n", file.c_str());
+                    fprintf(stderr, "In a list of many files ALL must be "
+                                    "recognizable by their name. \n");
+                    exit(1);
+                }
+            }
+            if (!file_convert_list(src_files, num_threads))
+                exit(1);
+        }
+        return 0;
+    }
+}
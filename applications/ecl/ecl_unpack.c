@@ -44,7 +44,8 @@ void unpack_file(const char *filename) {
                "ambigous - starting with 0001  -> \n");
     }
     {
-        ecl_file_type *src_file = ecl_file_open(filename, 0);
+        ecl_file_type *src_file =
+            ecl_file_open(filename, ECL_FILE_READ_AHEAD);
         int size;
         int offset;
         int report_step = 0;
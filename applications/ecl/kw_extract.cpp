@@ -43,6 +43,7 @@ int main(int argc, char **argv) {
 
         fmt_target = fmt_src; /* Can in principle be different */
         fortio_src = fortio_open_reader(src_file, fmt_src, ECL_ENDIAN_FLIP);
+        fortio_set_read_ahead(fortio_src, FORTIO_DEFAULT_READ_AHEAD);
         fortio_target =
             fortio_open_writer(target_file, fmt_target, ECL_ENDIAN_FLIP);
 
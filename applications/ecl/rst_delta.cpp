@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_rst_delta.hpp>
+
+/**
+   Packs a restart file, or any other ECLIPSE file, into a delta
+   archive with ecl_rst_delta_pack(), and unpacks a delta archive back
+   to an ordinary file with ecl_rst_delta_unpack(). The archive can
+   also be read directly with ecl_file_open().
+*/
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: rst_delta.x pack [-k keyframe_interval] [-b block_size] "
+            "<src_file> <archive>\n"
+            "       rst_delta.x unpack <archive> <target_file>\n"
+            "\n"
+            "The defaults are -k %d and -b %d; the target file of unpack is\n"
+            "formatted if the name indicates a formatted file.\n",
+            ECL_RST_DELTA_KEYFRAME_INTERVAL, ECL_RST_DELTA_BLOCK_SIZE);
+    exit(1);
+}
+
+static int pack(int argc, char **argv) {
+    int keyframe_interval = ECL_RST_DELTA_KEYFRAME_INTERVAL;
+    int block_size = ECL_RST_DELTA_BLOCK_SIZE;
+    int iarg = 0;
+
+    while (iarg + 1 < argc && argv[iarg][0] == '-') {
+        int *value = NULL;
+        if (strcmp(argv[iarg], "-k") == 0)
+            value = &keyframe_interval;
+        else if (strcmp(argv[iarg], "-b") == 0)
+            value = &block_size;
+        else
+            usage();
+
+        if (!util_sscanf_int(argv[iarg + 1], value))
+            usage();
+        iarg += 2;
+    }
+    if (argc - iarg != 2)
+        usage();
+
+    if (!ecl_rst_delta_pack(argv[iarg], argv[iarg + 1], keyframe_interval,
+                            block_size)) {
+        fprintf(stderr, "Packing %s failed - the file could not be read, or "
+                        "it ends with a partial keyword\n",
+                argv[iarg]);
+        return 1;
+    }
+    return 0;
+}
+
+static int unpack(int argc, char **argv) {
+    if (argc != 2)
+        usage();
+
+    if (!ecl_rst_delta_unpack(argv[0], argv[1])) {
+        fprintf(stderr, "Unpacking %s to %s failed\n", argv[0], argv[1]);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2)
+        usage();
+
+    if (strcmp(argv[1], "pack") == 0)
+        return pack(argc - 2, &argv[2]);
+    else if (strcmp(argv[1], "unpack") == 0)
+        return unpack(argc - 2, &argv[2]);
+
+    usage();
+    return 1;
+}
@@ -0,0 +1,58 @@
+# Converts a file in both directions with the sequential (-j 1) and the
+# parallel (-j 4) code path, and checks that the results are identical.
+#
+# Usage: cmake -DCONVERT=<convert.x> -DSOURCE=<CASE.EGRID>
+#              -DWORK_DIR=<dir> -P convert_parallel.cmake
+
+function(run_convert threads dir file)
+  execute_process(
+    COMMAND ${CONVERT} -j ${threads} ${file}
+    WORKING_DIRECTORY ${dir}
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "convert -j ${threads} ${file} failed")
+  endif()
+endfunction()
+
+function(compare_files file1 file2)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${file1} ${file2}
+                  RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${file1} and ${file2} differ")
+  endif()
+endfunction()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/serial ${WORK_DIR}/parallel)
+configure_file(${SOURCE} ${WORK_DIR}/serial/CASE.EGRID COPYONLY)
+configure_file(${SOURCE} ${WORK_DIR}/parallel/CASE.EGRID COPYONLY)
+
+run_convert(1 ${WORK_DIR}/serial CASE.EGRID)
+run_convert(4 ${WORK_DIR}/parallel CASE.EGRID)
+compare_files(${WORK_DIR}/serial/CASE.FEGRID ${WORK_DIR}/parallel/CASE.FEGRID)
+
+file(REMOVE ${WORK_DIR}/serial/CASE.EGRID ${WORK_DIR}/parallel/CASE.EGRID)
+run_convert(1 ${WORK_DIR}/serial CASE.FEGRID)
+run_convert(4 ${WORK_DIR}/parallel CASE.FEGRID)
+compare_files(${WORK_DIR}/serial/CASE.EGRID ${WORK_DIR}/parallel/CASE.EGRID)
+compare_files(${SOURCE} ${WORK_DIR}/parallel/CASE.EGRID)
+
+# A failed conversion leaves an existing target untouched.
+foreach(threads 1 4)
+  file(WRITE ${WORK_DIR}/serial/BAD.EGRID "not an ECLIPSE file")
+  file(WRITE ${WORK_DIR}/serial/BAD.FEGRID "old target")
+  execute_process(
+    COMMAND ${CONVERT} -j ${threads} BAD.EGRID
+    WORKING_DIRECTORY ${WORK_DIR}/serial
+    RESULT_VARIABLE result)
+  if(result EQUAL 0)
+    message(FATAL_ERROR "convert -j ${threads} BAD.EGRID did not fail")
+  endif()
+  file(READ ${WORK_DIR}/serial/BAD.FEGRID content)
+  if(NOT content STREQUAL "old target")
+    message(FATAL_ERROR "convert -j ${threads} overwrote BAD.FEGRID")
+  endif()
+  if(EXISTS ${WORK_DIR}/serial/BAD.FEGRID.tmp)
+    message(FATAL_ERROR "convert -j ${threads} left BAD.FEGRID.tmp")
+  endif()
+endforeach()
@@ -0,0 +1,46 @@
+# Packs a restart file and a unified summary file, which has many
+# report steps, into delta archives with and without deltas and
+# frames, unpacks them again and checks that the unpacked files are
+# identical to the originals.
+#
+# Usage: cmake -DRST_DELTA=<rst_delta.x> -DRESTART=<CASE.X0027>
+#              -DSUMMARY=<CASE.UNSMRY> -DWORK_DIR=<dir>
+#              -P rst_delta_roundtrip.cmake
+
+function(run_rst_delta expected_result)
+  execute_process(
+    COMMAND ${RST_DELTA} ${ARGN}
+    WORKING_DIRECTORY ${WORK_DIR}
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL expected_result)
+    message(FATAL_ERROR "rst_delta ${ARGN} returned ${result}")
+  endif()
+endfunction()
+
+function(compare_files file1 file2)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${WORK_DIR}/${file1}
+            ${WORK_DIR}/${file2} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${file1} and ${file2} differ")
+  endif()
+endfunction()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+foreach(source ${RESTART} ${SUMMARY})
+  get_filename_component(ext ${source} EXT)
+  configure_file(${source} ${WORK_DIR}/CASE${ext} COPYONLY)
+
+  run_rst_delta(0 pack CASE${ext} CASE.DELTA)
+  run_rst_delta(0 unpack CASE.DELTA UNPACKED${ext})
+  compare_files(CASE${ext} UNPACKED${ext})
+
+  run_rst_delta(0 pack -k 1 -b 0 CASE${ext} CASE_FULL.DELTA)
+  run_rst_delta(0 unpack CASE_FULL.DELTA UNPACKED_FULL${ext})
+  compare_files(CASE${ext} UNPACKED_FULL${ext})
+endforeach()
+
+run_rst_delta(1 pack MISSING.X0027 MISSING.DELTA)
+run_rst_delta(1 unpack MISSING.DELTA MISSING.X0027)
@@ -0,0 +1,8 @@
+__attribute__((target_clones("avx2", "default")))
+static int add(int a, int b) {
+  return a + b;
+}
+
+int main(int argc, char ** argv) {
+  return add(argc, -1);
+}
@@ -3,6 +3,18 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ert/util/build_config.h>
+#ifdef HAVE_PID_T
+#include <unistd.h>
+#endif
 
 #include <ert/util/hash.hpp>
 #include <ert/util/util.h>
@@ -18,6 +30,7 @@
 #include <ert/ecl/ecl_kw_magic.hpp>
 #include <ert/ecl/ecl_rsthead.hpp>
 #include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_rst_delta.hpp>
 #include <ert/ecl/ecl_type.hpp>
 
 /**
@@ -115,6 +128,7 @@ struct ecl_file_struct {
     int flags;
     vector_type *map_stack;
     inv_map_type *inv_view;
+    bool delta_archive; /* See ecl_rst_delta.cpp. */
 };
 
 /*
@@ -150,6 +164,7 @@ ecl_file_type *ecl_file_alloc_empty(int flags) {
     ecl_file->map_stack = vector_alloc_new();
     ecl_file->inv_view = inv_map_alloc();
     ecl_file->flags = flags;
+    ecl_file->delta_archive = false;
     return ecl_file;
 }
 
@@ -262,6 +277,7 @@ void ecl_file_replace_kw(ecl_file_type *ecl_file, ecl_kw_type *old_kw,
                          ecl_kw_type *new_kw, bool insert_copy) {
     ecl_file_view_replace_kw(ecl_file->active_view, old_kw, new_kw,
                              insert_copy);
+    ecl_file_kw_drop_shared_cache(fortio_filename_ref(ecl_file->fortio));
 }
 
 ecl_kw_type *ecl_file_icopy_named_kw(const ecl_file_type *ecl_file,
@@ -378,6 +394,27 @@ void ecl_file_indexed_read(const ecl_file_type *file, const char *kw, int index,
                                  buffer);
 }
 
+ecl_kw_type *ecl_file_iget_named_kw_slice(const ecl_file_type *file,
+                                          const char *kw, int ith, int start,
+                                          int end) {
+    return ecl_file_view_iget_named_kw_slice(file->active_view, kw, ith, start,
+                                             end);
+}
+
+bool ecl_file_fread_named_kw_as_double(const ecl_file_type *file,
+                                       const char *kw, int ith, int offset,
+                                       int count, double *data) {
+    return ecl_file_view_fread_named_kw_as_double(file->active_view, kw, ith,
+                                                  offset, count, data);
+}
+
+bool ecl_file_fread_named_kw_as_float(const ecl_file_type *file,
+                                      const char *kw, int ith, int offset,
+                                      int count, float *data) {
+    return ecl_file_view_fread_named_kw_as_float(file->active_view, kw, ith,
+                                                 offset, count, data);
+}
+
 ecl_data_type ecl_file_iget_named_data_type(const ecl_file_type *file,
                                             const char *kw, int ith) {
     return ecl_file_view_iget_named_data_type(file->active_view, kw, ith);
@@ -453,41 +490,550 @@ ecl_file_view_type *ecl_file_get_summary_view(ecl_file_type *ecl_file,
    the file, possible garbage at the end will be ignored.
 */
 
+static ecl_file_kw_type *ecl_file_fread_file_kw(fortio_type *fortio,
+                                                ecl_kw_type *work_kw) {
+    offset_type current_offset = fortio_ftell(fortio);
+    if (ecl_kw_fread_header(work_kw, fortio) == ECL_KW_READ_FAIL)
+        return NULL;
+
+    {
+        ecl_file_kw_type *file_kw = ecl_file_kw_alloc(work_kw, current_offset);
+        if (ecl_file_kw_fskip_data(file_kw, fortio))
+            return file_kw;
+
+        ecl_file_kw_free(file_kw);
+        return NULL;
+    }
+}
+
 static void ecl_file_scan(ecl_file_type *ecl_file) {
     fortio_fseek(ecl_file->fortio, 0, SEEK_SET);
     {
         ecl_kw_type *work_kw = ecl_kw_alloc_new("WORK-KW", 0, ECL_INT, NULL);
 
-        while (true) {
-            if (fortio_read_at_eof(ecl_file->fortio))
+        while (!fortio_read_at_eof(ecl_file->fortio)) {
+            ecl_file_kw_type *file_kw =
+                ecl_file_fread_file_kw(ecl_file->fortio, work_kw);
+            if (!file_kw)
+                break;
+
+            ecl_file_view_add_kw(ecl_file->global_view, file_kw);
+        }
+
+        ecl_kw_free(work_kw);
+    }
+    ecl_file_view_make_index(ecl_file->global_view);
+}
+
+/*
+  Sets @delta_archive to true if the file starts with the header
+  keyword of a delta archive, see ecl_rst_delta.cpp; only the header of
+  the first keyword is read from other files. Returns false for an
+  archive written with another version of the format, which can not be
+  opened.
+*/
+
+static bool ecl_file_fread_delta_header(fortio_type *fortio,
+                                        bool *delta_archive) {
+    bool version_ok = true;
+    ecl_kw_type *work_kw = ecl_kw_alloc_new("WORK-KW", 0, ECL_INT, NULL);
+
+    *delta_archive = false;
+
+    fortio_fseek(fortio, 0, SEEK_SET);
+    if (ecl_kw_fread_header(work_kw, fortio) == ECL_KW_READ_OK &&
+        util_string_equal(ecl_kw_get_header(work_kw), ECL_RST_DELTA_KW)) {
+        ecl_kw_type *delta_kw;
+
+        fortio_fseek(fortio, 0, SEEK_SET);
+        delta_kw = ecl_kw_fread_alloc(fortio);
+        if (delta_kw) {
+            if (ecl_kw_get_size(delta_kw) == ECL_RST_DELTA_SIZE &&
+                ecl_type_is_int(ecl_kw_get_data_type(delta_kw))) {
+                int version =
+                    ecl_kw_iget_int(delta_kw, ECL_RST_DELTA_VERSION_INDEX);
+                version_ok = (version == ECL_RST_DELTA_VERSION);
+                *delta_archive = true;
+            }
+            ecl_kw_free(delta_kw);
+        }
+    }
+    ecl_kw_free(work_kw);
+    fortio_fseek(fortio, 0, SEEK_SET);
+    return version_ok;
+}
+
+static ecl_kw_type *ecl_file_fread_delta_desc(fortio_type *fortio,
+                                              const ecl_file_kw_type *file_kw) {
+    if (!util_string_equal(ecl_file_kw_get_header(file_kw),
+                           ECL_RST_DELTA_DESC_KW))
+        return NULL;
+
+    fortio_fseek(fortio, ecl_file_kw_get_offset(file_kw), SEEK_SET);
+    {
+        ecl_kw_type *desc_kw = ecl_kw_fread_alloc(fortio);
+        if (desc_kw && ecl_kw_get_size(desc_kw) == ECL_RST_DELTA_DESC_SIZE &&
+            ecl_type_is_int(ecl_kw_get_data_type(desc_kw)))
+            return desc_kw;
+
+        if (desc_kw)
+            ecl_kw_free(desc_kw);
+        return NULL;
+    }
+}
+
+/*
+  Allocates the keyword @header of a delta archive from the descriptor
+  @desc, with the payload keyword of @payload_size integers stored at
+  @payload_offset; @kw_list holds the preceding keywords of the
+  archive. Returns NULL if the descriptor is not valid.
+*/
+
+static ecl_file_kw_type *
+ecl_file_alloc_delta_kw(const char *header, const int *desc,
+                        int payload_size, offset_type payload_offset,
+                        const std::vector<ecl_file_kw_type *> &kw_list) {
+    int size = desc[ECL_RST_DELTA_DESC_SIZE_INDEX];
+    int base = desc[ECL_RST_DELTA_DESC_BASE_INDEX];
+    int block_size = desc[ECL_RST_DELTA_DESC_BLOCK_SIZE_INDEX];
+
+    if (base >= (int)kw_list.size() || size < 0 || block_size <= 0 ||
+        payload_size < 0)
+        return NULL;
+
+    ecl_data_type data_type =
+        ecl_type_create((ecl_type_enum)desc[ECL_RST_DELTA_DESC_TYPE_INDEX],
+                        desc[ECL_RST_DELTA_DESC_TYPE_SIZE_INDEX]);
+    const ecl_file_kw_type *base_kw = base >= 0 ? kw_list[base] : NULL;
+    if (base_kw &&
+        (ecl_file_kw_get_size(base_kw) != size ||
+         !ecl_type_is_equal(ecl_file_kw_get_data_type(base_kw), data_type)))
+        return NULL;
+
+    {
+        ecl_file_kw_type *file_kw =
+            ecl_file_kw_alloc0(header, data_type, size, payload_offset);
+        ecl_file_kw_set_delta(
+            file_kw, (util_codec_enum)desc[ECL_RST_DELTA_DESC_CODEC_INDEX],
+            payload_size, block_size, base_kw);
+        return file_kw;
+    }
+}
+
+/*
+  The scan of a delta archive, see ecl_rst_delta.cpp, finds the
+  keywords as they are stored in the archive; the caller has checked
+  the header with ecl_file_fread_delta_header(). This function replaces
+  the global view with a view of the original keywords; only the
+  descriptors are read here, the payloads are decoded when the
+  keywords are loaded. As for an ordinary file the index ends at the
+  first keyword which can not be read.
+*/
+
+static void ecl_file_index_delta_archive(ecl_file_type *ecl_file) {
+    ecl_file_view_type *archive_view = ecl_file->global_view;
+    const int archive_size = ecl_file_view_get_size(archive_view);
+
+    if (archive_size == 0)
+        return;
+
+    ecl_file->delta_archive = true;
+    ecl_file->global_view = ecl_file_view_alloc(
+        ecl_file->fortio, &ecl_file->flags, ecl_file->inv_view, true);
+    {
+        std::vector<ecl_file_kw_type *> kw_list;
+        for (int i = 1; i + 1 < archive_size; i += 2) {
+            const ecl_file_kw_type *payload_kw =
+                ecl_file_view_iget_file_kw(archive_view, i + 1);
+            ecl_kw_type *desc_kw = ecl_file_fread_delta_desc(
+                ecl_file->fortio, ecl_file_view_iget_file_kw(archive_view, i));
+            if (!desc_kw)
                 break;
 
             {
-                offset_type current_offset = fortio_ftell(ecl_file->fortio);
-                ecl_read_status_enum read_status =
-                    ecl_kw_fread_header(work_kw, ecl_file->fortio);
-                if (read_status == ECL_KW_READ_FAIL)
+                ecl_file_kw_type *file_kw = ecl_file_alloc_delta_kw(
+                    ecl_file_kw_get_header(payload_kw),
+                    ecl_kw_get_const_int_ptr(desc_kw),
+                    ecl_file_kw_get_size(payload_kw),
+                    ecl_file_kw_get_offset(payload_kw), kw_list);
+                ecl_kw_free(desc_kw);
+                if (!file_kw)
                     break;
 
-                if (read_status == ECL_KW_READ_OK) {
-                    ecl_file_kw_type *file_kw =
-                        ecl_file_kw_alloc(work_kw, current_offset);
-
-                    if (ecl_file_kw_fskip_data(file_kw, ecl_file->fortio))
-                        ecl_file_view_add_kw(ecl_file->global_view, file_kw);
-                    else {
-                        ecl_file_kw_free(file_kw);
-                        break;
-                    }
-                }
+                ecl_file_view_add_kw(ecl_file->global_view, file_kw);
+                kw_list.push_back(file_kw);
+            }
+        }
+    }
+    ecl_file_view_make_index(ecl_file->global_view);
+    ecl_file_view_free(archive_view);
+}
+
+static offset_type ecl_file_delta_offset(const ecl_kw_type *ecl_kw,
+                                         int low_index, int high_index) {
+    return (offset_type)(uint32_t)ecl_kw_iget_int(ecl_kw, low_index) |
+           ((offset_type)ecl_kw_iget_int(ecl_kw, high_index) << 32);
+}
+
+/*
+  Reads the index at the end of a delta archive, see ecl_rst_delta.cpp,
+  into the global view; only the last three keywords of the archive
+  are read. Returns false if the index is missing or not valid, e.g.
+  because the packing was interrupted, and the archive must be
+  scanned.
+*/
+
+static bool ecl_file_fread_delta_index(ecl_file_type *ecl_file) {
+    fortio_type *fortio = ecl_file->fortio;
+    const offset_type end_size =
+        ecl_kw_fortio_size__(ECL_INT, ECL_RST_DELTA_END_SIZE);
+    offset_type file_size;
+    offset_type index_offset = -1;
+
+    fortio_fseek(fortio, 0, SEEK_END);
+    file_size = fortio_ftell(fortio);
+    if (file_size < end_size ||
+        !fortio_fseek(fortio, file_size - end_size, SEEK_SET))
+        return false;
+
+    {
+        ecl_kw_type *end_kw = ecl_kw_fread_alloc(fortio);
+        if (!end_kw)
+            return false;
+
+        if (util_string_equal(ecl_kw_get_header(end_kw),
+                              ECL_RST_DELTA_END_KW) &&
+            ecl_kw_get_size(end_kw) == ECL_RST_DELTA_END_SIZE &&
+            ecl_type_is_int(ecl_kw_get_data_type(end_kw)))
+            index_offset = ecl_file_delta_offset(
+                end_kw, ECL_RST_DELTA_END_OFFSET_LOW_INDEX,
+                ECL_RST_DELTA_END_OFFSET_HIGH_INDEX);
+        ecl_kw_free(end_kw);
+    }
+
+    if (index_offset <= 0 || index_offset >= file_size ||
+        !fortio_fseek(fortio, index_offset, SEEK_SET))
+        return false;
+
+    {
+        ecl_kw_type *index_kw = ecl_kw_fread_alloc(fortio);
+        ecl_kw_type *names_kw = index_kw ? ecl_kw_fread_alloc(fortio) : NULL;
+        std::vector<ecl_file_kw_type *> kw_list;
+        bool index_ok =
+            names_kw &&
+            util_string_equal(ecl_kw_get_header(index_kw),
+                              ECL_RST_DELTA_INDEX_KW) &&
+            ecl_type_is_int(ecl_kw_get_data_type(index_kw)) &&
+            util_string_equal(ecl_kw_get_header(names_kw),
+                              ECL_RST_DELTA_NAMES_KW) &&
+            ecl_type_is_char(ecl_kw_get_data_type(names_kw)) &&
+            ecl_kw_get_size(index_kw) ==
+                ecl_kw_get_size(names_kw) * ECL_RST_DELTA_INDEX_SIZE;
+
+        for (int i = 0; index_ok && i < ecl_kw_get_size(names_kw); i++) {
+            const int entry_index = i * ECL_RST_DELTA_INDEX_SIZE;
+            const int *entry =
+                ecl_kw_get_const_int_ptr(index_kw) + entry_index;
+            int payload_size = entry[ECL_RST_DELTA_INDEX_PAYLOAD_SIZE_INDEX];
+            offset_type payload_offset = ecl_file_delta_offset(
+                index_kw, entry_index + ECL_RST_DELTA_INDEX_OFFSET_LOW_INDEX,
+                entry_index + ECL_RST_DELTA_INDEX_OFFSET_HIGH_INDEX);
+            ecl_file_kw_type *file_kw = NULL;
+
+            if (payload_size >= 0 && payload_offset > 0 &&
+                payload_offset + (offset_type)ecl_kw_fortio_size__(
+                                     ECL_INT, payload_size) <=
+                    index_offset) {
+                char *header =
+                    util_alloc_strip_copy(ecl_kw_iget_char_ptr(names_kw, i));
+                file_kw = ecl_file_alloc_delta_kw(header, entry, payload_size,
+                                                  payload_offset, kw_list);
+                free(header);
+            }
+
+            if (file_kw)
+                kw_list.push_back(file_kw);
+            else
+                index_ok = false;
+        }
+
+        for (ecl_file_kw_type *file_kw : kw_list) {
+            if (index_ok)
+                ecl_file_view_add_kw(ecl_file->global_view, file_kw);
+            else
+                ecl_file_kw_free(file_kw);
+        }
+
+        if (names_kw)
+            ecl_kw_free(names_kw);
+        if (index_kw)
+            ecl_kw_free(index_kw);
+
+        if (index_ok)
+            ecl_file_view_make_index(ecl_file->global_view);
+        return index_ok;
+    }
+}
+
+/*
+  A delta archive with a valid index is opened without scanning it,
+  see ecl_file_fread_delta_index(); returns false if the archive must
+  be scanned.
+*/
+
+static bool ecl_file_open_delta_index(ecl_file_type *ecl_file) {
+    if (fortio_fmt_file(ecl_file->fortio))
+        return false;
+
+    ecl_file->delta_archive = ecl_file_fread_delta_index(ecl_file);
+    fortio_fseek(ecl_file->fortio, 0, SEEK_SET);
+    return ecl_file->delta_archive;
+}
+
+/*
+  With the ECL_FILE_PARALLEL_SCAN flag an unformatted file is split in
+  byte ranges of scan_range_size bytes which are scanned concurrently,
+  each range with a separate fortio instance. A range starts with a
+  probe for the first offset where a keyword can be read: the header
+  record must have record markers of ECL_KW_HEADER_DATA_SIZE bytes, a
+  valid type and a non-negative size, and the data section must have
+  consistent record markers. From the first keyword the range is
+  scanned exactly as in ecl_file_scan(), until a keyword starts after
+  the end of the range.
+
+  The probe can be fooled by keyword data which looks like a keyword,
+  so the ranges are verified when they are merged. Reading from a given
+  offset always gives the same keywords, so when the scan of a range
+  passes through the offset where the previous range ended, the rest of
+  the range is identical to what ecl_file_scan() would find. The
+  resulting index is therefore identical to the index from
+  ecl_file_scan().
+*/
+
+#define ECL_FILE_SCAN_RANGE_SIZE (256 << 20)
+#define ECL_FILE_SCAN_PROBE_WINDOW (64 << 10)
+
+/* Set from any thread while other threads are scanning. */
+static std::atomic<size_t> scan_range_size(ECL_FILE_SCAN_RANGE_SIZE);
+
+typedef struct {
+    offset_type range_start;
+    offset_type range_end;
+    std::vector<ecl_file_kw_type *> file_kw_list;
+    offset_type end_offset; /* Where the scan of the range stopped. */
+    bool complete; /* The scan stopped at EOF or at an invalid keyword. */
+} ecl_file_scan_range_type;
+
+void ecl_file_set_scan_range_size(size_t range_size) {
+    scan_range_size = range_size;
+}
+
+size_t ecl_file_get_scan_range_size(void) { return scan_range_size.load(); }
+
+static bool ecl_file_scan_probe_header(const char *buffer) {
+    int header_size, trailer_size, kw_size;
+
+    memcpy(&header_size, &buffer[0], sizeof header_size);
+    memcpy(&kw_size, &buffer[4 + ECL_STRING8_LENGTH], sizeof kw_size);
+    memcpy(&trailer_size, &buffer[4 + ECL_KW_HEADER_DATA_SIZE],
+           sizeof trailer_size);
+    if (ECL_ENDIAN_FLIP) {
+        util_endian_flip_vector(&header_size, sizeof header_size, 1);
+        util_endian_flip_vector(&kw_size, sizeof kw_size, 1);
+        util_endian_flip_vector(&trailer_size, sizeof trailer_size, 1);
+    }
+
+    if (header_size != ECL_KW_HEADER_DATA_SIZE ||
+        trailer_size != ECL_KW_HEADER_DATA_SIZE || kw_size < 0)
+        return false;
+
+    return ecl_type_is_valid_name(&buffer[4 + ECL_STRING8_LENGTH + 4]);
+}
+
+/*
+  Returns the first keyword starting in the range, and leaves the
+  fortio positioned after it; or NULL if no keyword starts in the
+  range.
+*/
+static ecl_file_kw_type *
+ecl_file_scan_probe(fortio_type *fortio, ecl_kw_type *work_kw,
+                    const ecl_file_scan_range_type *range) {
+    std::vector<char> window(ECL_FILE_SCAN_PROBE_WINDOW +
+                             ECL_KW_HEADER_FORTIO_SIZE);
+
+    for (offset_type window_start = range->range_start;
+         window_start < range->range_end;
+         window_start += ECL_FILE_SCAN_PROBE_WINDOW) {
+        size_t read_size = 0;
+        if (fortio_fseek(fortio, window_start, SEEK_SET))
+            read_size =
+                fread(window.data(), 1, window.size(), fortio_get_FILE(fortio));
+
+        for (size_t i = 0; i + ECL_KW_HEADER_FORTIO_SIZE <= read_size &&
+                           i < ECL_FILE_SCAN_PROBE_WINDOW &&
+                           window_start + (offset_type)i < range->range_end;
+             i++) {
+            if (!ecl_file_scan_probe_header(&window[i]))
+                continue;
+
+            fortio_fseek(fortio, window_start + i, SEEK_SET);
+            {
+                ecl_file_kw_type *file_kw =
+                    ecl_file_fread_file_kw(fortio, work_kw);
+                if (file_kw)
+                    return file_kw;
             }
         }
+    }
+    return NULL;
+}
+
+/*
+  Scans from the keyword @file_kw, which has just been read, until a
+  keyword starts after the end of the range. A NULL @file_kw is a
+  keyword which could not be read.
+*/
+static void ecl_file_scan_range_from(fortio_type *fortio, ecl_kw_type *work_kw,
+                                     ecl_file_kw_type *file_kw,
+                                     ecl_file_scan_range_type *range) {
+    range->complete = (file_kw == NULL);
+    while (file_kw) {
+        range->file_kw_list.push_back(file_kw);
+        range->end_offset = fortio_ftell(fortio);
+        if (fortio_read_at_eof(fortio)) {
+            range->complete = true;
+            break;
+        }
+
+        if (range->end_offset >= range->range_end)
+            break;
+
+        file_kw = ecl_file_fread_file_kw(fortio, work_kw);
+        range->complete = (file_kw == NULL);
+    }
+}
+
+static void ecl_file_scan_range(const char *filename, int flags,
+                                ecl_file_scan_range_type *range) {
+    fortio_type *fortio = fortio_open_reader(filename, false, ECL_ENDIAN_FLIP);
+
+    range->complete = false;
+    range->end_offset = range->range_start;
+    if (fortio) {
+        ecl_kw_type *work_kw = ecl_kw_alloc_new("WORK-KW", 0, ECL_INT, NULL);
+
+        if (ecl_file_view_check_flags(flags, ECL_FILE_READ_AHEAD))
+            fortio_set_read_ahead(fortio, FORTIO_DEFAULT_READ_AHEAD);
+
+        if (range->range_start == 0)
+            ecl_file_scan_range_from(fortio, work_kw,
+                                     ecl_file_fread_file_kw(fortio, work_kw),
+                                     range);
+        else {
+            ecl_file_kw_type *file_kw =
+                ecl_file_scan_probe(fortio, work_kw, range);
+            if (file_kw)
+                ecl_file_scan_range_from(fortio, work_kw, file_kw, range);
+        }
 
         ecl_kw_free(work_kw);
+        fortio_fclose(fortio);
     }
+}
+
+/*
+  The verification pass: the ranges are followed from the start of the
+  file, and each range is used from the offset where the previous range
+  ended. If that offset is not found in the range, i.e. the probe has
+  been fooled or the range could not be scanned, the range is scanned
+  again from the offset with the fortio of the ecl_file.
+*/
+static void ecl_file_scan_merge(ecl_file_type *ecl_file,
+                                std::vector<ecl_file_scan_range_type> &ranges) {
+    ecl_kw_type *work_kw = ecl_kw_alloc_new("WORK-KW", 0, ECL_INT, NULL);
+    offset_type offset = 0;
+    bool complete = false;
+
+    for (auto &range : ranges) {
+        if (complete || offset >= range.range_end)
+            continue;
+
+        {
+            size_t first = 0;
+            while (first < range.file_kw_list.size() &&
+                   ecl_file_kw_get_offset(range.file_kw_list[first]) != offset)
+                first++;
+
+            if (first == range.file_kw_list.size() &&
+                !(range.complete && range.end_offset == offset)) {
+                for (ecl_file_kw_type *file_kw : range.file_kw_list)
+                    ecl_file_kw_free(file_kw);
+                range.file_kw_list.clear();
+
+                fortio_fseek(ecl_file->fortio, offset, SEEK_SET);
+                range.end_offset = offset;
+                ecl_file_scan_range_from(
+                    ecl_file->fortio, work_kw,
+                    ecl_file_fread_file_kw(ecl_file->fortio, work_kw), &range);
+                first = 0;
+            }
+
+            for (size_t i = first; i < range.file_kw_list.size(); i++) {
+                ecl_file_view_add_kw(ecl_file->global_view,
+                                     range.file_kw_list[i]);
+                range.file_kw_list[i] = NULL;
+            }
+        }
+        offset = range.end_offset;
+        complete = range.complete;
+    }
+
+    for (auto &range : ranges)
+        for (ecl_file_kw_type *file_kw : range.file_kw_list)
+            if (file_kw)
+                ecl_file_kw_free(file_kw);
+
+    ecl_kw_free(work_kw);
     ecl_file_view_make_index(ecl_file->global_view);
 }
 
+static void ecl_file_scan_parallel(ecl_file_type *ecl_file) {
+    const char *filename = fortio_filename_ref(ecl_file->fortio);
+    const size_t range_size = util_size_t_max(scan_range_size.load(), 1);
+    const size_t file_size = util_file_size(filename);
+    const size_t num_ranges = (file_size + range_size - 1) / range_size;
+
+    if (fortio_fmt_file(ecl_file->fortio) || num_ranges < 2) {
+        ecl_file_scan(ecl_file);
+        return;
+    }
+
+    {
+        std::vector<ecl_file_scan_range_type> ranges(num_ranges);
+        std::vector<std::thread> threads;
+        std::atomic<size_t> next_range(0);
+        size_t num_threads =
+            util_size_t_min(num_ranges, std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < num_ranges; i++) {
+            ranges[i].range_start = i * range_size;
+            ranges[i].range_end =
+                util_size_t_min((i + 1) * range_size, file_size);
+        }
+
+        for (size_t t = 0; t < util_size_t_max(num_threads, 1); t++)
+            threads.emplace_back([&]() {
+                size_t i;
+                while ((i = next_range++) < num_ranges)
+                    ecl_file_scan_range(filename, ecl_file->flags, &ranges[i]);
+            });
+        for (auto &thread : threads)
+            thread.join();
+
+        ecl_file_scan_merge(ecl_file, ranges);
+    }
+}
+
 void ecl_file_select_global(ecl_file_type *ecl_file) {
     ecl_file->active_view = ecl_file->global_view;
 }
@@ -497,7 +1043,9 @@ void ecl_file_select_global(ecl_file_type *ecl_file) {
    functions start by calling this one. This function will read
    through the complete file, extract all the keyword headers and
    create the map/index stored in the global_view field of the ecl_file
-   structure. No keyword data will be loaded from the file.
+   structure. No keyword data will be loaded from the file. With the
+   ECL_FILE_AUTO_INDEX flag the scan is replaced by loading an index
+   file when a valid index exists, see ecl_file_open_auto_index().
 
    The ecl_file instance will retain an open fortio reference to the
    file until ecl_file_close() is called.
@@ -511,22 +1059,64 @@ static fortio_type *ecl_file_alloc_fortio(const char *filename, int flags) {
 
     if (ecl_file_view_check_flags(flags, ECL_FILE_WRITABLE))
         fortio = fortio_open_readwrite(filename, fmt_file, ECL_ENDIAN_FLIP);
+    else if (ecl_file_view_check_flags(flags, ECL_FILE_MMAP))
+        fortio = fortio_open_reader_mmap(filename, fmt_file, ECL_ENDIAN_FLIP);
     else
         fortio = fortio_open_reader(filename, fmt_file, ECL_ENDIAN_FLIP);
 
+    if (fortio && ecl_file_view_check_flags(flags, ECL_FILE_READ_AHEAD))
+        fortio_set_read_ahead(fortio, FORTIO_DEFAULT_READ_AHEAD);
+
     return fortio;
 }
 
-ecl_file_type *ecl_file_open(const char *filename, int flags) {
+/*
+  Files which are opened for writing never take part in the shared
+  keyword cache, see ecl_file_set_shared_cache(); the keywords which
+  other ecl_file instances have loaded from the file are dropped from
+  the cache.
+*/
+
+static void ecl_file_attach_shared_cache(ecl_file_type *ecl_file,
+                                         const char *filename) {
+    if (ecl_file_writable(ecl_file))
+        ecl_file_kw_drop_shared_cache(filename);
+    else
+        inv_map_set_shared_cache(ecl_file->inv_view, filename);
+}
+
+static ecl_file_type *ecl_file_open_scan(const char *filename, int flags) {
     fortio_type *fortio = ecl_file_alloc_fortio(filename, flags);
 
     if (fortio) {
+        bool delta_archive;
+        if (!ecl_file_fread_delta_header(fortio, &delta_archive)) {
+            fortio_fclose(fortio);
+            return NULL;
+        }
+
+        if (delta_archive &&
+            ecl_file_view_check_flags(flags, ECL_FILE_WRITABLE))
+            util_abort("%s: the delta archive:%s can not be opened for "
+                       "writing\n",
+                       __func__, filename);
+
         ecl_file_type *ecl_file = ecl_file_alloc_empty(flags);
         ecl_file->fortio = fortio;
+        ecl_file_attach_shared_cache(ecl_file, filename);
         ecl_file->global_view = ecl_file_view_alloc(
             ecl_file->fortio, &ecl_file->flags, ecl_file->inv_view, true);
 
-        ecl_file_scan(ecl_file);
+        if (!delta_archive || !ecl_file_open_delta_index(ecl_file)) {
+            if (ecl_file_view_check_flags(ecl_file->flags,
+                                          ECL_FILE_PARALLEL_SCAN))
+                ecl_file_scan_parallel(ecl_file);
+            else
+                ecl_file_scan(ecl_file);
+
+            if (delta_archive)
+                ecl_file_index_delta_archive(ecl_file);
+        }
         ecl_file_select_global(ecl_file);
 
         if (ecl_file_view_check_flags(ecl_file->flags, ECL_FILE_CLOSE_STREAM))
@@ -537,6 +1127,16 @@ ecl_file_type *ecl_file_open(const char *filename, int flags) {
         return NULL;
 }
 
+static ecl_file_type *ecl_file_open_auto_index(const char *filename,
+                                               int flags);
+
+ecl_file_type *ecl_file_open(const char *filename, int flags) {
+    if (ecl_file_view_check_flags(flags, ECL_FILE_AUTO_INDEX))
+        return ecl_file_open_auto_index(filename, flags);
+    else
+        return ecl_file_open_scan(filename, flags);
+}
+
 int ecl_file_get_flags(const ecl_file_type *ecl_file) {
     return ecl_file->flags;
 }
@@ -549,6 +1149,119 @@ bool ecl_file_flags_set(const ecl_file_type *ecl_file, int flags) {
     return ecl_file_view_check_flags(ecl_file->flags, flags);
 }
 
+/**
+   Enables compression in memory of loaded keywords which have not been
+   accessed recently. Each time a keyword is accessed through the
+   ecl_file, e.g. with ecl_file_iget_named_kw(), the least recently
+   accessed keywords are compressed with @codec until the uncompressed
+   keywords use at most @hot_size bytes. A compressed keyword is
+   decompressed automatically on the next access, also when it is
+   accessed directly through the ecl_kw pointer. Keywords which have
+   been accessed more than once through the ecl_file, or which are part
+   of a transaction, are not compressed. Observe that data pointers
+   from e.g. ecl_kw_get_ptr() of other keywords are only valid until
+   the next keyword access through the ecl_file.
+
+   UTIL_CODEC_FAST should normally be used; UTIL_CODEC_NONE disables
+   compression.
+*/
+
+void ecl_file_set_kw_compression(ecl_file_type *ecl_file,
+                                 util_codec_enum codec, size_t hot_size) {
+    inv_map_set_compression(ecl_file->inv_view, codec, hot_size);
+}
+
+/**
+   Sets a budget in bytes for the memory used by the keywords which
+   have been loaded on demand. Each time a keyword is accessed through
+   the ecl_file the least recently accessed keywords are evicted, i.e.
+   freed and reloaded from file on the next access, until the loaded
+   keywords use at most @memory_budget bytes; compressed keywords count
+   with their compressed size, see ecl_file_set_kw_compression(). A
+   budget of 0, the default, keeps all loaded keywords in memory.
+
+   Observe that an evicted ecl_kw instance is freed. Keywords which
+   have been accessed more than once, keywords in a transaction, see
+   ecl_file_view_start_transaction(), and keywords which have been
+   modified are never evicted; but the pointer to a keyword which has
+   been accessed once is only valid until the next keyword access
+   through the ecl_file. Keywords of a file opened with
+   ECL_FILE_WRITABLE are never evicted.
+*/
+
+void ecl_file_set_memory_budget(ecl_file_type *ecl_file,
+                                size_t memory_budget) {
+    inv_map_set_memory_budget(ecl_file->inv_view, memory_budget);
+}
+
+size_t ecl_file_get_memory_budget(const ecl_file_type *ecl_file) {
+    return inv_map_get_memory_budget(ecl_file->inv_view);
+}
+
+/*
+  Counters for the keyword accesses through the ecl_file: a hit is an
+  access served from memory, a miss an access which had to load the
+  keyword from file, and an eviction a keyword freed to honor the
+  memory budget.
+*/
+
+size_t ecl_file_get_kw_hits(const ecl_file_type *ecl_file) {
+    return inv_map_get_hits(ecl_file->inv_view);
+}
+
+size_t ecl_file_get_kw_misses(const ecl_file_type *ecl_file) {
+    return inv_map_get_misses(ecl_file->inv_view);
+}
+
+size_t ecl_file_get_kw_evictions(const ecl_file_type *ecl_file) {
+    return inv_map_get_evictions(ecl_file->inv_view);
+}
+
+/*
+  The number of payload keywords, or frames of payload keywords, which
+  have been read from a delta archive, see ecl_rst_delta_pack(); this
+  includes the reads of base keywords needed for the reconstruction.
+*/
+
+size_t ecl_file_get_delta_reads(const ecl_file_type *ecl_file) {
+    return inv_map_get_delta_reads(ecl_file->inv_view);
+}
+
+/**
+   Enables a process wide cache of loaded keywords, shared by all the
+   ecl_file instances which open the same file; this includes the files
+   opened internally by e.g. ecl_grid_alloc() and ecl_grav_alloc(). A
+   keyword is read from disk only once, and the ecl_kw instances of the
+   different ecl_file instances share the data copy-on-write: modifying
+   a keyword, or asking for a mutable data pointer with e.g.
+   ecl_kw_get_ptr(), gives the keyword a private copy of the data. Use
+   ecl_kw_get_const_ptr() and friends for read only access. Keywords
+   which share data are not compressed, see
+   ecl_file_set_kw_compression().
+
+   The cache only applies to files opened after it has been enabled,
+   and never to files opened with ECL_FILE_WRITABLE. A file is
+   identified by device, inode, size and modification time, with
+   nanosecond resolution where available, so a file which is rewritten
+   is not confused with the previous version. In addition the keywords
+   of a file are dropped from the cache when the file is opened with
+   ECL_FILE_WRITABLE, and when keywords are saved to it.
+*/
+
+void ecl_file_set_shared_cache(bool enabled) {
+    ecl_file_kw_set_shared_cache(enabled);
+}
+
+bool ecl_file_get_shared_cache(void) { return ecl_file_kw_get_shared_cache(); }
+
+/*
+  The number of keywords currently held by the shared keyword cache.
+*/
+
+int ecl_file_get_shared_cache_size(void) {
+    return ecl_file_kw_get_shared_cache_size();
+}
+
 bool ecl_file_writable(const ecl_file_type *ecl_file) {
     return ecl_file_view_check_flags(ecl_file->flags, ECL_FILE_WRITABLE);
 }
@@ -784,6 +1497,9 @@ bool ecl_file_save_kw(const ecl_file_type *ecl_file,
                 ecl_file->fortio)) { // the corresponding ecl_file_kw instance.
 
             ecl_file_kw_inplace_fwrite(file_kw, ecl_file->fortio);
+            fortio_fflush(ecl_file->fortio);
+            ecl_file_kw_drop_shared_cache(
+                fortio_filename_ref(ecl_file->fortio));
 
             if (ecl_file_view_check_flags(ecl_file->flags,
                                           ECL_FILE_CLOSE_STREAM))
@@ -860,13 +1576,12 @@ bool ecl_file_select_rstblock_sim_time(ecl_file_type *ecl_file,
 
 bool ecl_file_select_rstblock_report_step(ecl_file_type *ecl_file,
                                           int report_step) {
-    int global_index = ecl_file_view_find_kw_value(ecl_file->global_view,
-                                                   SEQNUM_KW, &report_step);
-    if (global_index >= 0) {
-        int seqnum_index =
-            ecl_file_view_iget_occurence(ecl_file->global_view, global_index);
+    int seqnum_index = ecl_file_view_seqnum_index_from_report_step(
+        ecl_file->global_view, report_step);
+
+    if (seqnum_index >= 0)
         return ecl_file_iselect_rstblock(ecl_file, seqnum_index);
-    } else
+    else
         return false;
 }
 
@@ -923,92 +1638,474 @@ ecl_file_type *ecl_file_iopen_rstblock(const char *filename, int seqnum_index,
     return ecl_file_iopen_rstblock__(filename, seqnum_index, flags);
 }
 
-static bool ecl_file_index_valid0(const char *file_name,
-                                  const char *index_file_name) {
-    if (!util_file_exists(file_name))
+/*
+   Index files
+   -----------
+
+   Opening a file with ecl_file_open() requires a scan through all the
+   keyword headers in the file; for large restart files on a network
+   file system that takes time. With ecl_file_write_index() the result
+   of the scan can be stored in an index file, and ecl_file_fast_open()
+   will then open the file based on the index without scanning. The
+   index file looks like this:
+
+      string       : The magic string ECL_FILE_INDEX_MAGIC
+      int          : Format version - ECL_FILE_INDEX_VERSION
+      offset_type  : Size of the data file
+      time_t       : Modification time of the data file
+      uint32_t     : Checksum of the keyword entries
+      string       : Name of the data file, without path
+      int          : Number of keywords
+      ...          : One entry per keyword, see ecl_file_kw_fwrite()
+
+   The checksum is an Adler-32 checksum of the keyword entries, and
+   protects against a damaged index file.
+   When the index is loaded the size and modification time are compared
+   with the data file. Then the headers of up to ECL_FILE_INDEX_SAMPLES
+   keywords, evenly spread and including the first and the last, are
+   read from the data file at the offsets recorded in the index and
+   compared with the index. Reading all the headers would cost as much
+   as the scan the index is meant to avoid.
+
+   The index is first written to a temporary file which is then renamed
+   to the final name; i.e. a concurrent reader will see either the old
+   or the new index, never a partly written file.
+
+   Index files written by older versions start directly with the name
+   of the data file. They are still accepted, and are then validated by
+   the file name and the modification time of the index file.
+*/
+
+#define ECL_FILE_INDEX_MAGIC "ECL_FILE_INDEX"
+#define ECL_FILE_INDEX_VERSION 2
+#define ECL_FILE_INDEX_EXT "ecl_index"
+#define ECL_FILE_INDEX_CACHE_ENV "ECL_INDEX_CACHE_DIR"
+#define ECL_FILE_INDEX_ADLER_MOD 65521
+#define ECL_FILE_INDEX_SAMPLES 16
+
+static char *index_cache_dir = NULL;
+static std::mutex index_cache_dir_mutex;
+
+static uint32_t ecl_file_index_adler32(uint32_t adler, const void *data,
+                                       size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    for (size_t i = 0; i < size; i++) {
+        a = (a + bytes[i]) % ECL_FILE_INDEX_ADLER_MOD;
+        b = (b + a) % ECL_FILE_INDEX_ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+/*
+  The checksum of the keyword entries, i.e. from @offset to the end of
+  the stream.
+*/
+static uint32_t ecl_file_index_checksum(FILE *stream, offset_type offset) {
+    char buffer[4096];
+    uint32_t checksum = 1;
+    size_t bytes;
+
+    util_fseek(stream, offset, SEEK_SET);
+    while ((bytes = fread(buffer, 1, sizeof buffer, stream)) > 0)
+        checksum = ecl_file_index_adler32(checksum, buffer, bytes);
+    util_fseek(stream, offset, SEEK_SET);
+    return checksum;
+}
+
+static void ecl_file_index_free_kw_list(ecl_file_kw_type **kw_list,
+                                        int num_kw) {
+    for (int ikw = 0; ikw < num_kw; ikw++)
+        ecl_file_kw_free(kw_list[ikw]);
+    free(kw_list);
+}
+
+/*
+  The index file can be damaged or written by somebody else, so it is
+  read with plain fread() calls which are checked, instead of the
+  util_fread_xxx() functions which abort on error.
+*/
+static bool ecl_file_index_fread(void *ptr, size_t size, FILE *stream) {
+    return fread(ptr, size, 1, stream) == 1;
+}
+
+static char *ecl_file_index_fread_alloc_string(FILE *stream,
+                                               size_t max_length) {
+    int length;
+    if (!ecl_file_index_fread(&length, sizeof length, stream))
+        return NULL;
+
+    if (length <= 0 || (size_t)length >= max_length)
+        return NULL;
+
+    char *s = (char *)util_calloc(length + 1, sizeof *s);
+    if (!ecl_file_index_fread(s, length + 1, stream) || s[length] != '\0') {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+static bool ecl_file_index_fread_header(FILE *stream, const char *file_name,
+                                        size_t index_size,
+                                        uint32_t *checksum) {
+    int version;
+    offset_type file_size;
+    time_t mtime;
+
+    if (!ecl_file_index_fread(&version, sizeof version, stream))
         return false;
 
-    if (!util_file_exists(index_file_name))
+    if (version != ECL_FILE_INDEX_VERSION)
         return false;
 
-    if (util_file_difftime(file_name, index_file_name) > 0)
+    if (!ecl_file_index_fread(&file_size, sizeof file_size, stream) ||
+        !ecl_file_index_fread(&mtime, sizeof mtime, stream) ||
+        !ecl_file_index_fread(checksum, sizeof *checksum, stream))
         return false;
 
-    return true;
+    if (file_size != (offset_type)util_file_size(file_name))
+        return false;
+
+    if (mtime != util_file_mtime(file_name))
+        return false;
+
+    bool name_equal = false;
+    {
+        char *source_file =
+            ecl_file_index_fread_alloc_string(stream, index_size);
+        char *input_name = util_split_alloc_filename(file_name);
+        name_equal = util_string_equal(source_file, input_name);
+        free(source_file);
+        free(input_name);
+    }
+    return name_equal;
 }
 
-static bool ecl_file_index_valid1(const char *file_name, FILE *stream) {
-    bool name_equal;
-    char *source_file = util_fread_alloc_string(stream);
-    char *input_name = util_split_alloc_filename(file_name);
+/*
+  Loads the keyword list from the index file. Returns NULL if the index
+  file can not be read, or does not match the data file. The content of
+  the data file is not checked, see ecl_file_index_check_fortio().
+*/
+static ecl_file_kw_type **
+ecl_file_index_fread_alloc(const char *file_name, const char *index_file_name,
+                           int *num_kw) {
+    if (!util_file_exists(file_name))
+        return NULL;
 
-    name_equal = util_string_equal(source_file, input_name);
+    if (!util_file_exists(index_file_name))
+        return NULL;
 
-    free(source_file);
-    free(input_name);
-    return name_equal;
+    FILE *stream = fopen(index_file_name, "rb");
+    if (!stream)
+        return NULL;
+
+    size_t index_size = util_file_size(index_file_name);
+    ecl_file_kw_type **kw_list = NULL;
+    bool has_checksum = false;
+    uint32_t checksum = 0;
+    bool header_valid = false;
+    {
+        char *source_file =
+            ecl_file_index_fread_alloc_string(stream, index_size);
+
+        if (util_string_equal(source_file, ECL_FILE_INDEX_MAGIC)) {
+            has_checksum = true;
+            header_valid = ecl_file_index_fread_header(stream, file_name,
+                                                       index_size, &checksum);
+        } else {
+            char *input_name = util_split_alloc_filename(file_name);
+            header_valid =
+                util_string_equal(source_file, input_name) &&
+                util_file_difftime(file_name, index_file_name) <= 0;
+            free(input_name);
+        }
+        free(source_file);
+    }
+
+    if (header_valid && has_checksum)
+        header_valid = (checksum == ecl_file_index_checksum(
+                                        stream, util_ftell(stream)));
+
+    if (header_valid) {
+        int size;
+        if (ecl_file_index_fread(&size, sizeof size, stream) && size > 0 &&
+            (size_t)size <= index_size / ECL_STRING8_LENGTH)
+            kw_list = ecl_file_kw_fread_alloc_multiple(stream, size);
+
+        if (kw_list) {
+            if (fgetc(stream) == EOF)
+                *num_kw = size;
+            else {
+                ecl_file_index_free_kw_list(kw_list, size);
+                kw_list = NULL;
+            }
+        }
+    }
+
+    fclose(stream);
+    return kw_list;
+}
+
+static bool ecl_file_index_check_header(fortio_type *fortio,
+                                        ecl_kw_type *work_kw,
+                                        const ecl_file_kw_type *file_kw) {
+    if (!fortio_fseek(fortio, ecl_file_kw_get_offset(file_kw), SEEK_SET))
+        return false;
+
+    if (ecl_kw_fread_header(work_kw, fortio) != ECL_KW_READ_OK)
+        return false;
+
+    return util_string_equal(ecl_kw_get_header(work_kw),
+                             ecl_file_kw_get_header(file_kw)) &&
+           ecl_kw_get_size(work_kw) == ecl_file_kw_get_size(file_kw) &&
+           ecl_type_is_equal(ecl_kw_get_data_type(work_kw),
+                             ecl_file_kw_get_data_type(file_kw));
+}
+
+/*
+  Reads a sample of the keyword headers from the data file at the
+  offsets recorded in the index, and compares them with the index; this
+  will detect most cases where the data file has been rewritten without
+  changing size and modification time.
+*/
+static bool ecl_file_index_check_fortio(fortio_type *fortio,
+                                        ecl_file_kw_type *const *kw_list,
+                                        int num_kw) {
+    ecl_kw_type *work_kw = ecl_kw_alloc_new("WORK-KW", 0, ECL_INT, NULL);
+    int num_samples = std::min(num_kw, ECL_FILE_INDEX_SAMPLES);
+    bool equal = true;
+
+    for (int i = 0; equal && i < num_samples; i++) {
+        int ikw = 0;
+        if (num_samples > 1)
+            ikw = (int)((int64_t)i * (num_kw - 1) / (num_samples - 1));
+        equal = ecl_file_index_check_header(fortio, work_kw, kw_list[ikw]);
+    }
+
+    ecl_kw_free(work_kw);
+    return equal;
 }
 
 bool ecl_file_index_valid(const char *file_name, const char *index_file_name) {
-    if (!ecl_file_index_valid0(file_name, index_file_name))
+    int num_kw;
+    ecl_file_kw_type **kw_list =
+        ecl_file_index_fread_alloc(file_name, index_file_name, &num_kw);
+    if (!kw_list)
         return false;
 
     bool valid = false;
-    FILE *stream = fopen(index_file_name, "rb");
-    if (stream) {
-        valid = ecl_file_index_valid1(file_name, stream);
-        fclose(stream);
+    fortio_type *fortio = ecl_file_alloc_fortio(file_name, 0);
+    if (fortio) {
+        valid = ecl_file_index_check_fortio(fortio, kw_list, num_kw);
+        fortio_fclose(fortio);
     }
 
+    ecl_file_index_free_kw_list(kw_list, num_kw);
     return valid;
 }
 
 bool ecl_file_write_index(const ecl_file_type *ecl_file,
                           const char *index_filename) {
-    FILE *ostream = fopen(index_filename, "wb");
-    if (!ostream)
+    static std::atomic<int> tmp_counter(0);
+    const char *file_name = fortio_filename_ref(ecl_file->fortio);
+    long pid = 0;
+
+    /* The index of a delta archive does not match the stored keywords. */
+    if (ecl_file->delta_archive)
         return false;
+#ifdef HAVE_PID_T
+    pid = getpid();
+#endif
+    char *tmp_file = util_alloc_sprintf("%s.%ld-%d.tmp", index_filename, pid,
+                                        tmp_counter++);
+
+    FILE *ostream = fopen(tmp_file, "w+b");
+    if (!ostream) {
+        free(tmp_file);
+        return false;
+    }
+
+    offset_type checksum_offset;
+    offset_type entries_offset;
+    uint32_t checksum = 0;
+    {
+        offset_type file_size = util_file_size(file_name);
+        time_t mtime = util_file_mtime(file_name);
+        int version = ECL_FILE_INDEX_VERSION;
+
+        util_fwrite_string(ECL_FILE_INDEX_MAGIC, ostream);
+        util_fwrite(&version, sizeof version, 1, ostream, __func__);
+        util_fwrite(&file_size, sizeof file_size, 1, ostream, __func__);
+        util_fwrite(&mtime, sizeof mtime, 1, ostream, __func__);
+        checksum_offset = util_ftell(ostream);
+        util_fwrite(&checksum, sizeof checksum, 1, ostream, __func__);
+    }
     {
-        char *filename =
-            util_split_alloc_filename(fortio_filename_ref(ecl_file->fortio));
+        char *filename = util_split_alloc_filename(file_name);
         util_fwrite_string(filename, ostream);
         free(filename);
     }
+    entries_offset = util_ftell(ostream);
     ecl_file_view_write_index(ecl_file->global_view, ostream);
-    fclose(ostream);
-    return true;
+
+    /*
+      The checksum is calculated from the keyword entries as they have
+      been written to the file, and then filled in.
+    */
+    fflush(ostream);
+    checksum = ecl_file_index_checksum(ostream, entries_offset);
+    util_fseek(ostream, checksum_offset, SEEK_SET);
+    util_fwrite(&checksum, sizeof checksum, 1, ostream, __func__);
+
+    bool write_ok = (fclose(ostream) == 0);
+    if (write_ok)
+        write_ok = (rename(tmp_file, index_filename) == 0);
+
+    if (!write_ok)
+        remove(tmp_file);
+
+    free(tmp_file);
+    return write_ok;
 }
 
 ecl_file_type *ecl_file_fast_open(const char *file_name,
                                   const char *index_file_name, int flags) {
-    if (!ecl_file_index_valid0(file_name, index_file_name))
-        return NULL;
-
-    FILE *istream = fopen(index_file_name, "rb");
-    if (!istream)
+    int num_kw;
+    ecl_file_kw_type **kw_list =
+        ecl_file_index_fread_alloc(file_name, index_file_name, &num_kw);
+    if (!kw_list)
         return NULL;
 
     ecl_file_type *ecl_file = NULL;
-
-    if (ecl_file_index_valid1(file_name, istream)) {
-        fortio_type *fortio = ecl_file_alloc_fortio(file_name, flags);
-        if (fortio) {
+    fortio_type *fortio = ecl_file_alloc_fortio(file_name, flags);
+    if (fortio) {
+        if (ecl_file_index_check_fortio(fortio, kw_list, num_kw)) {
             ecl_file = ecl_file_alloc_empty(flags);
             ecl_file->fortio = fortio;
-            ecl_file->global_view =
-                ecl_file_view_fread_alloc(ecl_file->fortio, &ecl_file->flags,
-                                          ecl_file->inv_view, istream);
-            if (ecl_file->global_view) {
-                ecl_file_select_global(ecl_file);
-                if (ecl_file_view_check_flags(ecl_file->flags,
-                                              ECL_FILE_CLOSE_STREAM))
-                    fortio_fclose_stream(ecl_file->fortio);
-            } else {
-                ecl_file_close(ecl_file);
-                ecl_file = NULL;
-            }
+            ecl_file_attach_shared_cache(ecl_file, file_name);
+            ecl_file->global_view = ecl_file_view_alloc(
+                ecl_file->fortio, &ecl_file->flags, ecl_file->inv_view, true);
+            for (int ikw = 0; ikw < num_kw; ikw++)
+                ecl_file_view_add_kw(ecl_file->global_view, kw_list[ikw]);
+            ecl_file_view_make_index(ecl_file->global_view);
+
+            ecl_file_select_global(ecl_file);
+            if (ecl_file_view_check_flags(ecl_file->flags,
+                                          ECL_FILE_CLOSE_STREAM))
+                fortio_fclose_stream(ecl_file->fortio);
+
+            free(kw_list);
+            kw_list = NULL;
+        } else
+            fortio_fclose(fortio);
+    }
+
+    if (kw_list)
+        ecl_file_index_free_kw_list(kw_list, num_kw);
+    return ecl_file;
+}
+
+/*
+  The directory used for index files when the ECL_FILE_AUTO_INDEX flag
+  is set, and the index can not be written next to the data file. If no
+  directory has been set with ecl_file_set_index_cache_dir() the
+  environment variable ECL_INDEX_CACHE_DIR is used. The directory may
+  be set while other threads open files, so it is returned as a copy
+  which the caller must free; NULL if there is no cache directory.
+*/
+void ecl_file_set_index_cache_dir(const char *path) {
+    std::lock_guard<std::mutex> lock(index_cache_dir_mutex);
+    index_cache_dir = util_realloc_string_copy(index_cache_dir, path);
+}
+
+char *ecl_file_alloc_index_cache_dir(void) {
+    std::lock_guard<std::mutex> lock(index_cache_dir_mutex);
+    if (index_cache_dir)
+        return util_alloc_string_copy(index_cache_dir);
+    return util_alloc_string_copy(getenv(ECL_FILE_INDEX_CACHE_ENV));
+}
+
+/*
+  The index file next to the data file is a hidden file: CASE.UNRST ->
+  .CASE.UNRST.ecl_index.
+*/
+char *ecl_file_alloc_index_filename(const char *filename) {
+    char *path = util_split_alloc_dirname(filename);
+    char *name = util_split_alloc_filename(filename);
+    char *hidden_name = util_alloc_sprintf(".%s", name);
+    char *index_file =
+        util_alloc_filename(path, hidden_name, ECL_FILE_INDEX_EXT);
+
+    free(hidden_name);
+    free(name);
+    free(path);
+    return index_file;
+}
+
+/*
+  Index files in the cache directory are named with the file name and a
+  hash of the absolute path of the data file, to separate files with the
+  same name from different directories. Returns NULL if there is no
+  cache directory.
+*/
+char *ecl_file_alloc_index_cache_filename(const char *filename) {
+    char *cache_dir = ecl_file_alloc_index_cache_dir();
+    if (!cache_dir || strlen(cache_dir) == 0) {
+        free(cache_dir);
+        return NULL;
+    }
+
+    char *abs_path = util_alloc_abs_path(filename);
+    char *name = util_split_alloc_filename(filename);
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *c = abs_path; *c; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 1099511628211ULL;
+    }
+
+    char *cache_name = util_alloc_sprintf("%s-%016llx", name,
+                                          (unsigned long long)hash);
+    char *index_file =
+        util_alloc_filename(cache_dir, cache_name, ECL_FILE_INDEX_EXT);
+
+    free(cache_name);
+    free(name);
+    free(abs_path);
+    free(cache_dir);
+    return index_file;
+}
+
+/*
+  Opening with the ECL_FILE_AUTO_INDEX flag: first an index next to the
+  data file is tried, then an index in the cache directory. If neither
+  is valid the file is scanned, and the index is written; next to the
+  data file if possible, otherwise in the cache directory. Failure to
+  write the index is not an error.
+*/
+static ecl_file_type *ecl_file_open_auto_index(const char *filename,
+                                               int flags) {
+    char *index_file = ecl_file_alloc_index_filename(filename);
+    char *cache_file = ecl_file_alloc_index_cache_filename(filename);
+    ecl_file_type *ecl_file = ecl_file_fast_open(filename, index_file, flags);
+
+    if (!ecl_file && cache_file)
+        ecl_file = ecl_file_fast_open(filename, cache_file, flags);
+
+    if (!ecl_file) {
+        ecl_file = ecl_file_open_scan(filename, flags);
+        if (ecl_file && !ecl_file_write_index(ecl_file, index_file) &&
+            cache_file) {
+            char *cache_dir = util_split_alloc_dirname(cache_file);
+            if (util_mkdir_p(cache_dir))
+                ecl_file_write_index(ecl_file, cache_file);
+            free(cache_dir);
         }
     }
-    fclose(istream);
+
+    free(cache_file);
+    free(index_file);
     return ecl_file;
 }
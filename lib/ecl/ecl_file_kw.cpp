@@ -2,12 +2,22 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ert/util/build_config.h>
 #include <ert/util/size_t_vector.hpp>
 #include <ert/util/util.h>
 
 #include <ert/ecl/ecl_util.hpp>
 #include <ert/ecl/ecl_kw.hpp>
 #include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_rst_delta.hpp>
 #include <ert/ecl/fortio.h>
 
 /*
@@ -27,35 +37,370 @@
 */
 
 #define ECL_FILE_KW_TYPE_ID 646107
+#define ECL_FILE_KW_LOAD_LOCKS 64
+
+/*
+  Keywords which are prefetched are read in runs of keywords which are
+  at most ECL_FILE_KW_PREFETCH_GAP bytes apart in the file, with at
+  most ECL_FILE_KW_PREFETCH_RUN bytes read in one system call; a
+  keyword which is larger than that is read on its own.
+*/
+#define ECL_FILE_KW_PREFETCH_GAP (256 * 1024)
+#define ECL_FILE_KW_PREFETCH_RUN (64 * 1024 * 1024)
+
+/*
+  A file is identified by device, inode, size and modification time,
+  with nanosecond resolution where the platform has it; a file which
+  is rewritten gets a new identity.
+*/
+typedef std::tuple<int64_t, int64_t, int64_t, int64_t> file_id_type;
+
+/*
+  A delta chain of a delta archive is identified by the name, type,
+  element size and size of the keywords, see delta_cache_get().
+*/
+typedef std::tuple<std::string, ecl_type_enum, size_t, int> delta_chain_type;
+
+/*
+  The inv_map is shared by all the views of one ecl_file; in addition
+  to the mapping from ecl_kw to ecl_file_kw it holds the settings for
+  compression of keywords which have not been accessed recently, see
+  inv_map_set_compression(), the memory budget for loaded keywords,
+  see inv_map_set_memory_budget(), and the hit/miss/eviction counters.
+
+  The inv_map also holds the locks which make it possible for several
+  threads to load keywords from the same ecl_file concurrently:
+
+    lock : Protects the mapping, the list of loaded keywords and the
+           memory bookkeeping.
+
+    load_locks : A keyword is loaded while holding the load lock
+           selected by the address of the ecl_file_kw instance; a
+           thread which asks for a keyword which is being loaded by
+           another thread waits for that load to complete instead of
+           loading the keyword a second time. Keywords which hash to
+           different locks are loaded concurrently.
+
+    stream_lock : Serializes reads through the shared fortio stream,
+           for the files which can not be read with positional reads,
+           see ecl_kw_pread_alloc(), and opening and closing the stream,
+           see inv_map_lock_stream(). The lock is recursive, so the
+           functions which take it can be called with it held.
+
+    delta_lock : Protects the cache of reconstructed keywords and
+           frame tables of a delta archive, see delta_cache_get().
+
+  The loaded keywords which can be compressed and evicted are kept in a
+  doubly linked list in order of access, from lru_head, the least
+  recently accessed, to lru_tail; see inv_map_lru_append(). The
+  keywords before lru_hot have already been considered for compression,
+  see inv_map_compress_cold(). The memory used by all the loaded
+  keywords, and by the uncompressed ones, is kept up to date in
+  loaded_bytes and hot_bytes.
+
+  When the file takes part in the shared keyword cache, see
+  inv_map_set_shared_cache(), the inv_map holds the identity of the
+  file.
+*/
 
 struct inv_map_struct {
     size_t_vector_type *file_kw_ptr;
     size_t_vector_type *ecl_kw_ptr;
     bool sorted;
+    std::atomic<util_codec_enum> codec;
+    size_t hot_size;
+    std::atomic<size_t> memory_budget;
+    ecl_file_kw_type *lru_head;
+    ecl_file_kw_type *lru_tail;
+    ecl_file_kw_type *lru_hot;
+    size_t loaded_bytes;
+    size_t hot_bytes;
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    std::atomic<size_t> evictions;
+    std::mutex lock;
+    std::mutex load_locks[ECL_FILE_KW_LOAD_LOCKS];
+    std::recursive_mutex stream_lock;
+    std::mutex delta_lock;
+    std::map<delta_chain_type, std::pair<offset_type, ecl_kw_type *>>
+        delta_cache;
+    std::atomic<size_t> delta_reads;
+    std::map<offset_type, std::vector<int>> delta_tables;
+    bool shared;
+    file_id_type file_id;
 };
 
+/*
+  The ref_count is > 0 when the keyword is loaded. It is only increased
+  after the kw pointer has been set, so a thread which sees a positive
+  ref_count can use the kw pointer without taking any locks. The
+  ref_count is increased every time the keyword is handed out, and the
+  pointers handed out are not given back; so a keyword with ref_count
+  > 1 can be held by a caller, and is pinned, see ecl_file_kw_is_held().
+  The pin_count is > 0 while the keyword takes part in a transaction.
+
+  For a keyword in a delta archive, see ecl_rst_delta.cpp, the header,
+  type and size are those of the original keyword, while file_offset
+  is the offset of the payload keyword; delta_base is the keyword the
+  payload is a delta to, or NULL.
+*/
+
 struct ecl_file_kw_struct {
     UTIL_TYPE_ID_DECLARATION;
     offset_type file_offset;
     ecl_data_type data_type;
     int kw_size;
-    int ref_count;
+    std::atomic<int> ref_count;
+    std::atomic<int> pin_count;
     char *header;
     ecl_kw_type *kw;
+    ecl_file_kw_type *lru_prev;
+    ecl_file_kw_type *lru_next;
+    bool lru_linked;
+    size_t memory_size;
+    bool memory_hot;
+    bool incompressible;
+    bool delta;
+    util_codec_enum delta_codec;
+    int delta_payload_size;
+    int delta_block_size;
+    const ecl_file_kw_type *delta_base;
 };
 
 inv_map_type *inv_map_alloc() {
-    inv_map_type *map = (inv_map_type *)util_malloc(sizeof *map);
+    inv_map_type *map = new inv_map_type();
     map->file_kw_ptr = size_t_vector_alloc(0, 0);
     map->ecl_kw_ptr = size_t_vector_alloc(0, 0);
     map->sorted = false;
+    map->codec = UTIL_CODEC_NONE;
+    map->hot_size = 0;
+    map->memory_budget = 0;
+    map->lru_head = NULL;
+    map->lru_tail = NULL;
+    map->lru_hot = NULL;
+    map->loaded_bytes = 0;
+    map->hot_bytes = 0;
+    map->hits = 0;
+    map->misses = 0;
+    map->evictions = 0;
+    map->delta_reads = 0;
+    map->shared = false;
     return map;
 }
 
+/*
+  When compression is enabled loaded keywords are compressed in memory,
+  least recently accessed first, until the uncompressed keywords use at
+  most @hot_size bytes. Compression is disabled with UTIL_CODEC_NONE.
+*/
+void inv_map_set_compression(inv_map_type *map, util_codec_enum codec,
+                             size_t hot_size) {
+    std::lock_guard<std::mutex> guard(map->lock);
+    map->codec = codec;
+    map->hot_size = hot_size;
+}
+
+/*
+  When the memory budget is > 0 the least recently accessed keywords
+  are evicted, i.e. freed and reloaded from file on the next access,
+  until the loaded keywords use at most @memory_budget bytes. The
+  keyword which is accessed is never evicted, and neither are keywords
+  which are held or modified, see ecl_file_kw_is_held(); so the budget
+  can be exceeded.
+*/
+void inv_map_set_memory_budget(inv_map_type *map, size_t memory_budget) {
+    std::lock_guard<std::mutex> guard(map->lock);
+    map->memory_budget = memory_budget;
+}
+
+size_t inv_map_get_memory_budget(const inv_map_type *map) {
+    return map->memory_budget;
+}
+
+size_t inv_map_get_hits(const inv_map_type *map) { return map->hits; }
+
+size_t inv_map_get_misses(const inv_map_type *map) { return map->misses; }
+
+size_t inv_map_get_evictions(const inv_map_type *map) {
+    return map->evictions;
+}
+
+size_t inv_map_get_delta_reads(const inv_map_type *map) {
+    return map->delta_reads;
+}
+
+/*
+  Code which seeks and reads through the shared fortio stream, or opens
+  and closes it, must hold the stream lock; keywords which are loaded
+  with positional reads do not need it.
+*/
+void inv_map_lock_stream(inv_map_type *map) { map->stream_lock.lock(); }
+
+void inv_map_unlock_stream(inv_map_type *map) { map->stream_lock.unlock(); }
+
+/*
+  The shared keyword cache makes it possible for all the ecl_file
+  instances in the process which have opened the same file to share
+  the keyword data. The cache maps (file identity, keyword offset) to a
+  keyword loaded from file, and the ecl_file_kw instances get copies
+  of this keyword which share the data copy-on-write, see
+  ecl_kw_alloc_cow_copy(). A keyword which is modified through one
+  ecl_file gets a private copy of the data, and the other ecl_file
+  instances are not affected.
+
+  An entry is freed when the last ecl_file which shares the data drops
+  its copy, e.g. when the keyword is evicted to stay within the memory
+  budget, see inv_map_set_memory_budget(); so the cache never holds
+  keywords which are not loaded by any ecl_file. Entries which have
+  become unused otherwise, e.g. because all the copies have been
+  modified, are freed when a file taking part in the cache is closed
+  and when the cache is disabled.
+*/
+
+typedef std::pair<file_id_type, offset_type> shared_key_type;
+
+static std::atomic<bool> shared_cache_enabled(false);
+static std::mutex shared_cache_lock;
+static std::map<shared_key_type, ecl_kw_type *> shared_cache;
+
+static void shared_cache_purge() {
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    auto iter = shared_cache.begin();
+    while (iter != shared_cache.end()) {
+        if (ecl_kw_is_cow_shared(iter->second))
+            ++iter;
+        else {
+            ecl_kw_free(iter->second);
+            iter = shared_cache.erase(iter);
+        }
+    }
+}
+
+/*
+  Returns a copy-on-write copy of the cached keyword, or NULL if the
+  keyword is not in the cache.
+*/
+static ecl_kw_type *shared_cache_get(const inv_map_type *map,
+                                     offset_type offset) {
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    auto iter = shared_cache.find(shared_key_type(map->file_id, offset));
+    if (iter == shared_cache.end())
+        return NULL;
+
+    return ecl_kw_alloc_cow_copy(iter->second);
+}
+
+/*
+  Adds the newly loaded @ecl_kw to the cache and returns a
+  copy-on-write copy of it. If another thread has added the same
+  keyword in the meantime @ecl_kw is freed and the cached keyword is
+  used instead.
+*/
+static ecl_kw_type *shared_cache_add(const inv_map_type *map,
+                                     offset_type offset, ecl_kw_type *ecl_kw) {
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    auto result =
+        shared_cache.emplace(shared_key_type(map->file_id, offset), ecl_kw);
+    if (!result.second)
+        ecl_kw_free(ecl_kw);
+
+    return ecl_kw_alloc_cow_copy(result.first->second);
+}
+
+/*
+  Frees the cached keyword at @offset if no keyword shares the data any
+  longer; called when the keyword loaded through @map is dropped.
+*/
+static void shared_cache_release(const inv_map_type *map,
+                                 offset_type offset) {
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    auto iter = shared_cache.find(shared_key_type(map->file_id, offset));
+    if (iter != shared_cache.end() && !ecl_kw_is_cow_shared(iter->second)) {
+        ecl_kw_free(iter->second);
+        shared_cache.erase(iter);
+    }
+}
+
+/*
+  The shared keyword cache is disabled by default. Only files which are
+  opened after the cache has been enabled take part in it.
+*/
+void ecl_file_kw_set_shared_cache(bool enabled) {
+    shared_cache_enabled = enabled;
+    if (!enabled)
+        shared_cache_purge();
+}
+
+bool ecl_file_kw_get_shared_cache(void) { return shared_cache_enabled; }
+
+int ecl_file_kw_get_shared_cache_size(void) {
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    return shared_cache.size();
+}
+
+/*
+  Lets the keywords loaded through @map take part in the shared keyword
+  cache, if the cache is enabled; @filename is the file the keywords
+  are loaded from. Keywords which are modified in the file, i.e. files
+  opened for writing, must not be shared.
+*/
+void inv_map_set_shared_cache(inv_map_type *map, const char *filename) {
+    stat_type stat_buffer;
+
+    if (!shared_cache_enabled)
+        return;
+
+    if (util_stat(filename, &stat_buffer) != 0)
+        return;
+
+#ifdef HAVE_STAT_ST_MTIM
+    int64_t mtime = (int64_t)stat_buffer.st_mtim.tv_sec * 1000000000 +
+                    stat_buffer.st_mtim.tv_nsec;
+#else
+    int64_t mtime = stat_buffer.st_mtime;
+#endif
+
+    map->file_id = file_id_type(stat_buffer.st_dev, stat_buffer.st_ino,
+                                stat_buffer.st_size, mtime);
+    map->shared = true;
+}
+
+/*
+  Removes the keywords of @filename from the shared keyword cache,
+  whatever version of the file they were loaded from; called when the
+  file is opened for writing and when it is written to, since the
+  modification time does not always change with a write. The ecl_file
+  instances which have loaded the keywords keep their copies.
+*/
+void ecl_file_kw_drop_shared_cache(const char *filename) {
+    stat_type stat_buffer;
+
+    if (util_stat(filename, &stat_buffer) != 0)
+        return;
+
+    std::lock_guard<std::mutex> guard(shared_cache_lock);
+    auto iter = shared_cache.begin();
+    while (iter != shared_cache.end()) {
+        const file_id_type &file_id = iter->first.first;
+        if (std::get<0>(file_id) == (int64_t)stat_buffer.st_dev &&
+            std::get<1>(file_id) == (int64_t)stat_buffer.st_ino) {
+            ecl_kw_free(iter->second);
+            iter = shared_cache.erase(iter);
+        } else
+            ++iter;
+    }
+}
+
 void inv_map_free(inv_map_type *map) {
+    for (auto &entry : map->delta_cache)
+        ecl_kw_free(entry.second.second);
+
+    if (map->shared)
+        shared_cache_purge();
+
     size_t_vector_free(map->file_kw_ptr);
     size_t_vector_free(map->ecl_kw_ptr);
-    free(map);
+    delete map;
 }
 
 static void inv_map_assert_sort(inv_map_type *map) {
@@ -92,6 +437,7 @@ static void inv_map_add_kw(inv_map_type *map, const ecl_file_kw_type *file_kw,
 
 ecl_file_kw_type *inv_map_get_file_kw(inv_map_type *inv_map,
                                       const ecl_kw_type *ecl_kw) {
+    std::lock_guard<std::mutex> guard(inv_map->lock);
     inv_map_assert_sort(inv_map);
     {
         int index =
@@ -105,6 +451,83 @@ ecl_file_kw_type *inv_map_get_file_kw(inv_map_type *inv_map,
     }
 }
 
+/*
+  A keyword is held while it is part of a transaction, or when it has
+  been handed out more than once, see the documentation of the
+  ecl_file_kw struct. Held keywords are neither compressed nor evicted,
+  and neither are modified keywords, see ecl_kw_is_modified(), since
+  the modifications would be lost.
+*/
+static bool ecl_file_kw_is_held(const ecl_file_kw_type *file_kw) {
+    return file_kw->ref_count > 1 || file_kw->pin_count > 0;
+}
+
+static void inv_map_lru_unlink(inv_map_type *map, ecl_file_kw_type *file_kw) {
+    if (!file_kw->lru_linked)
+        return;
+
+    if (map->lru_hot == file_kw)
+        map->lru_hot = file_kw->lru_next;
+
+    if (file_kw->lru_prev)
+        file_kw->lru_prev->lru_next = file_kw->lru_next;
+    else
+        map->lru_head = file_kw->lru_next;
+
+    if (file_kw->lru_next)
+        file_kw->lru_next->lru_prev = file_kw->lru_prev;
+    else
+        map->lru_tail = file_kw->lru_prev;
+
+    file_kw->lru_prev = NULL;
+    file_kw->lru_next = NULL;
+    file_kw->lru_linked = false;
+}
+
+/*
+  Moves the keyword to the end of the list, as the most recently
+  accessed. Keywords which are held by callers or modified are taken
+  out of the list instead.
+*/
+static void inv_map_lru_append(inv_map_type *map, ecl_file_kw_type *file_kw) {
+    inv_map_lru_unlink(map, file_kw);
+    if (file_kw->ref_count > 1 || ecl_kw_is_modified(file_kw->kw))
+        return;
+
+    file_kw->lru_prev = map->lru_tail;
+    if (map->lru_tail)
+        map->lru_tail->lru_next = file_kw;
+    else
+        map->lru_head = file_kw;
+    map->lru_tail = file_kw;
+    file_kw->lru_linked = true;
+    if (!map->lru_hot)
+        map->lru_hot = file_kw;
+}
+
+/*
+  Updates the memory bookkeeping of @map with the current size of the
+  keyword, which changes when the keyword is compressed or
+  decompressed; with @loaded false the keyword is no longer counted.
+*/
+static void inv_map_charge(inv_map_type *map, ecl_file_kw_type *file_kw,
+                           bool loaded) {
+    map->loaded_bytes -= file_kw->memory_size;
+    if (file_kw->memory_hot)
+        map->hot_bytes -= file_kw->memory_size;
+
+    file_kw->memory_size = 0;
+    file_kw->memory_hot = false;
+    if (loaded) {
+        file_kw->memory_size = ecl_kw_get_data_memory_size(file_kw->kw);
+        file_kw->memory_hot = !ecl_kw_is_compressed(file_kw->kw);
+    }
+
+    map->loaded_bytes += file_kw->memory_size;
+    if (file_kw->memory_hot)
+        map->hot_bytes += file_kw->memory_size;
+}
+
 static UTIL_SAFE_CAST_FUNCTION(ecl_file_kw, ECL_FILE_KW_TYPE_ID)
     UTIL_IS_INSTANCE_FUNCTION(ecl_file_kw, ECL_FILE_KW_TYPE_ID)
 
@@ -120,7 +543,16 @@ static UTIL_SAFE_CAST_FUNCTION(ecl_file_kw, ECL_FILE_KW_TYPE_ID)
     file_kw->kw_size = size;
     file_kw->file_offset = offset;
     file_kw->ref_count = 0;
+    file_kw->pin_count = 0;
     file_kw->kw = NULL;
+    file_kw->lru_prev = NULL;
+    file_kw->lru_next = NULL;
+    file_kw->lru_linked = false;
+    file_kw->memory_size = 0;
+    file_kw->memory_hot = false;
+    file_kw->incompressible = false;
+    file_kw->delta = false;
+    file_kw->delta_base = NULL;
 
     return file_kw;
 }
@@ -148,8 +580,45 @@ ecl_file_kw_type *ecl_file_kw_alloc(const ecl_kw_type *ecl_kw,
     Does NOT copy the kw pointer which must be reloaded.
 */
 ecl_file_kw_type *ecl_file_kw_alloc_copy(const ecl_file_kw_type *src) {
-    return ecl_file_kw_alloc0(src->header, ecl_file_kw_get_data_type(src),
-                              src->kw_size, src->file_offset);
+    ecl_file_kw_type *file_kw =
+        ecl_file_kw_alloc0(src->header, ecl_file_kw_get_data_type(src),
+                           src->kw_size, src->file_offset);
+    if (src->delta)
+        ecl_file_kw_set_delta(file_kw, src->delta_codec,
+                              src->delta_payload_size, src->delta_block_size,
+                              src->delta_base);
+    return file_kw;
+}
+
+/*
+  Marks the keyword as stored in a delta archive, see ecl_rst_delta.cpp;
+  @payload_size is the number of integers in the payload keyword,
+  @block_size the number of elements in a frame and @base the keyword
+  the payload is a delta to, or NULL. The @base must
+  have the same type and size as the keyword, and must live as long as
+  the keyword.
+*/
+void ecl_file_kw_set_delta(ecl_file_kw_type *file_kw, util_codec_enum codec,
+                           int payload_size, int block_size,
+                           const ecl_file_kw_type *base) {
+    if (block_size <= 0)
+        util_abort("%s: invalid block size:%d for keyword:%s\n", __func__,
+                   block_size, file_kw->header);
+
+    if (base && (base->kw_size != file_kw->kw_size ||
+                 !ecl_type_is_equal(base->data_type, file_kw->data_type)))
+        util_abort("%s: base of keyword:%s does not match.\n", __func__,
+                   file_kw->header);
+
+    file_kw->delta = true;
+    file_kw->delta_codec = codec;
+    file_kw->delta_payload_size = payload_size;
+    file_kw->delta_block_size = block_size;
+    file_kw->delta_base = base;
+}
+
+bool ecl_file_kw_is_delta(const ecl_file_kw_type *file_kw) {
+    return file_kw->delta;
 }
 
 void ecl_file_kw_free(ecl_file_kw_type *file_kw) {
@@ -195,27 +664,240 @@ static void ecl_file_kw_assert_kw(const ecl_file_kw_type *file_kw) {
 static void ecl_file_kw_drop_kw(ecl_file_kw_type *file_kw,
                                 inv_map_type *inv_map) {
     if (file_kw->kw != NULL) {
+        inv_map_lru_unlink(inv_map, file_kw);
+        inv_map_charge(inv_map, file_kw, false);
         inv_map_drop_kw(inv_map, file_kw->kw);
         ecl_kw_free(file_kw->kw);
         file_kw->kw = NULL;
+        if (inv_map->shared)
+            shared_cache_release(inv_map, file_kw->file_offset);
     }
 }
 
+static ecl_kw_type *ecl_file_kw_fread_kw(const ecl_file_kw_type *file_kw,
+                                         fortio_type *fortio,
+                                         inv_map_type *inv_map,
+                                         const char *records,
+                                         size_t records_size);
+
+/*
+  A keyword of a delta archive is reconstructed from the keyword it is
+  a delta to, which again needs its base, back to the previous
+  keyframe; see ecl_rst_delta.cpp. So that the whole chain is not read
+  and decoded for every keyword, the inv_map keeps the most recently
+  reconstructed keyword of every delta chain, i.e. of every keyword
+  name, type and size, as a copy which shares the data copy-on-write.
+  When the report steps are loaded in order every keyword is then
+  decoded from the previous one with one payload read, however many
+  keywords there are in a report step. The cached keywords are not
+  counted in the memory budget, see inv_map_set_memory_budget(). The
+  inv_map also keeps the frame tables of the keywords which have been
+  read in slices, see ecl_file_kw_fread_delta_table().
+
+  Returns a copy of the cached @file_kw, which the caller owns, or
+  NULL.
+*/
+static delta_chain_type delta_cache_key(const ecl_file_kw_type *file_kw) {
+    return delta_chain_type(file_kw->header,
+                            ecl_type_get_type(file_kw->data_type),
+                            ecl_type_get_sizeof_iotype(file_kw->data_type),
+                            file_kw->kw_size);
+}
+
+static ecl_kw_type *delta_cache_get(inv_map_type *map,
+                                    const ecl_file_kw_type *file_kw) {
+    std::lock_guard<std::mutex> guard(map->delta_lock);
+    auto iter = map->delta_cache.find(delta_cache_key(file_kw));
+    if (iter == map->delta_cache.end() ||
+        iter->second.first != file_kw->file_offset)
+        return NULL;
+
+    return ecl_kw_alloc_cow_copy(iter->second.second);
+}
+
+static void delta_cache_add(inv_map_type *map, const ecl_file_kw_type *file_kw,
+                            const ecl_kw_type *ecl_kw) {
+    std::lock_guard<std::mutex> guard(map->delta_lock);
+    auto &entry = map->delta_cache[delta_cache_key(file_kw)];
+    if (entry.second) {
+        if (entry.first == file_kw->file_offset)
+            return;
+        ecl_kw_free(entry.second);
+    }
+    entry.first = file_kw->file_offset;
+    entry.second = ecl_kw_alloc_cow_copy(ecl_kw);
+}
+
+/*
+  Reconstructs a keyword stored in a delta archive from the
+  @payload_kw, which is freed; the base keyword is taken from the cache
+  of @inv_map or read from file, but not taken from the loaded
+  keywords since a loaded keyword can have been modified. Returns NULL
+  if the keyword can not be reconstructed.
+*/
+static ecl_kw_type *ecl_file_kw_alloc_delta(const ecl_file_kw_type *file_kw,
+                                            fortio_type *fortio,
+                                            inv_map_type *inv_map,
+                                            ecl_kw_type *payload_kw) {
+    ecl_kw_type *ecl_kw = NULL;
+    ecl_kw_type *base_kw = NULL;
+    int element_size = ecl_type_get_sizeof_ctype(file_kw->data_type);
+    size_t byte_size = (size_t)file_kw->kw_size * element_size;
+    char *data = (char *)util_malloc(byte_size + 1);
+
+    if (file_kw->delta_base) {
+        if (inv_map)
+            base_kw =
+                delta_cache_get(inv_map, file_kw->delta_base);
+        if (!base_kw)
+            base_kw = ecl_file_kw_fread_kw(file_kw->delta_base, fortio,
+                                           inv_map, NULL, 0);
+    }
+
+    if (base_kw || !file_kw->delta_base) {
+        int num_frames = ecl_rst_delta_num_frames(file_kw->kw_size,
+                                                  file_kw->delta_block_size);
+        int payload_size = ecl_kw_get_size(payload_kw);
+        const int *payload = ecl_kw_get_const_int_ptr(payload_kw);
+
+        if (payload_size >= num_frames &&
+            ecl_rst_delta_decode(
+                payload, num_frames, &payload[num_frames],
+                payload_size - num_frames, file_kw->delta_codec, element_size,
+                (size_t)file_kw->delta_block_size * element_size,
+                base_kw ? ecl_kw_get_const_ptr(base_kw) : NULL, data,
+                byte_size))
+            ecl_kw = ecl_kw_alloc_new(file_kw->header, file_kw->kw_size,
+                                      file_kw->data_type, data);
+    }
+
+    if (ecl_kw && inv_map)
+        delta_cache_add(inv_map, file_kw, ecl_kw);
+
+    if (base_kw)
+        ecl_kw_free(base_kw);
+    ecl_kw_free(payload_kw);
+    free(data);
+    return ecl_kw;
+}
+
+/*
+  Reads the keyword from file. If @records is not NULL it holds the raw
+  content of the file starting at the keyword, see
+  ecl_file_kw_prefetch(), and the keyword is decoded from there. When
+  possible the keyword is read with positional reads, which do not
+  touch the shared stream; otherwise the stream is locked while seeking
+  and reading. Without an @inv_map the caller must ensure that the
+  stream is not used by other threads.
+*/
+static ecl_kw_type *ecl_file_kw_fread_kw(const ecl_file_kw_type *file_kw,
+                                         fortio_type *fortio,
+                                         inv_map_type *inv_map,
+                                         const char *records,
+                                         size_t records_size) {
+    ecl_kw_type *ecl_kw = NULL;
+    if (records)
+        ecl_kw = ecl_kw_unpack_alloc(fortio, records, records_size);
+
+    if (!ecl_kw)
+        ecl_kw = ecl_kw_pread_alloc(fortio, file_kw->file_offset);
+
+    if (!ecl_kw) {
+        std::unique_lock<std::recursive_mutex> guard;
+        if (inv_map)
+            guard =
+                std::unique_lock<std::recursive_mutex>(inv_map->stream_lock);
+        fortio_fseek(fortio, file_kw->file_offset, SEEK_SET);
+        ecl_kw = ecl_kw_fread_alloc(fortio);
+    }
+
+    if (ecl_kw && file_kw->delta) {
+        if (inv_map)
+            inv_map->delta_reads++;
+        ecl_kw = ecl_file_kw_alloc_delta(file_kw, fortio, inv_map, ecl_kw);
+    }
+    return ecl_kw;
+}
+
+/*
+  Allocates a new ecl_kw instance with the keyword read from @fortio;
+  the caller owns the returned keyword, and the keyword itself is not
+  loaded. The caller must ensure that the stream is not used by other
+  threads. Returns NULL if the keyword can not be read.
+*/
+ecl_kw_type *ecl_file_kw_alloc_kw(const ecl_file_kw_type *file_kw,
+                                  fortio_type *fortio) {
+    return ecl_file_kw_fread_kw(file_kw, fortio, NULL, NULL, 0);
+}
+
+/*
+  The load lock of the keyword, see the documentation of the inv_map.
+*/
+static std::mutex &ecl_file_kw_get_load_lock(const ecl_file_kw_type *file_kw,
+                                             inv_map_type *inv_map) {
+    size_t lock_index =
+        ((size_t)file_kw / sizeof *file_kw) % ECL_FILE_KW_LOAD_LOCKS;
+    return inv_map->load_locks[lock_index];
+}
+
+/*
+  The file offset just past the end of the keyword.
+*/
+static offset_type
+ecl_file_kw_get_fortio_end(const ecl_file_kw_type *file_kw) {
+    if (file_kw->delta)
+        return file_kw->file_offset +
+               ecl_kw_fortio_size__(ECL_INT, file_kw->delta_payload_size);
+
+    return file_kw->file_offset +
+           ecl_kw_fortio_size__(file_kw->data_type, file_kw->kw_size);
+}
+
+/*
+  Must be called with the load lock of the keyword held, see
+  ecl_file_kw_get_kw(); the file is read without holding the inv_map
+  lock. The @records argument is as for ecl_file_kw_fread_kw(). When
+  the file takes part in the shared keyword cache the keyword is taken
+  from the cache if possible, and otherwise added to it.
+*/
 static void ecl_file_kw_load_kw(ecl_file_kw_type *file_kw, fortio_type *fortio,
-                                inv_map_type *inv_map) {
+                                inv_map_type *inv_map, const char *records,
+                                size_t records_size) {
     if (fortio == NULL)
         util_abort("%s: trying to load a keyword after the backing file has "
                    "been detached.\n",
                    __func__);
 
-    if (file_kw->kw != NULL)
-        ecl_file_kw_drop_kw(file_kw, inv_map);
+    {
+        std::lock_guard<std::mutex> guard(inv_map->lock);
+        if (file_kw->kw != NULL)
+            ecl_file_kw_drop_kw(file_kw, inv_map);
+    }
 
     {
-        fortio_fseek(fortio, file_kw->file_offset, SEEK_SET);
-        file_kw->kw = ecl_kw_fread_alloc(fortio);
-        ecl_file_kw_assert_kw(file_kw);
-        inv_map_add_kw(inv_map, file_kw, file_kw->kw);
+        ecl_kw_type *ecl_kw = NULL;
+        if (inv_map->shared)
+            ecl_kw = shared_cache_get(inv_map, file_kw->file_offset);
+
+        if (!ecl_kw) {
+            ecl_kw = ecl_file_kw_fread_kw(file_kw, fortio, inv_map, records,
+                                          records_size);
+            if (ecl_kw && inv_map->shared)
+                ecl_kw =
+                    shared_cache_add(inv_map, file_kw->file_offset, ecl_kw);
+        }
+
+        std::lock_guard<std::mutex> guard(inv_map->lock);
+
+        file_kw->kw = ecl_kw;
+        if (ecl_kw) {
+            file_kw->incompressible = false;
+            ecl_kw_clear_modified(ecl_kw);
+            ecl_file_kw_assert_kw(file_kw);
+            inv_map_add_kw(inv_map, file_kw, file_kw->kw);
+            inv_map_charge(inv_map, file_kw, true);
+            inv_map_lru_append(inv_map, file_kw);
+        }
     }
 }
 
@@ -226,13 +908,258 @@ static void ecl_file_kw_load_kw(ecl_file_kw_type *file_kw, fortio_type *fortio,
 */
 
 ecl_kw_type *ecl_file_kw_get_kw_ptr(ecl_file_kw_type *file_kw) {
+    int ref_count = file_kw->ref_count;
+    while (ref_count > 0) {
+        if (file_kw->ref_count.compare_exchange_weak(ref_count, ref_count + 1))
+            return file_kw->kw;
+    }
+    return NULL;
+}
+
+/*
+  As ecl_file_kw_get_kw_ptr(), but a keyword which is found in memory
+  is counted as a hit in the statistics of @inv_map.
+*/
+
+ecl_kw_type *ecl_file_kw_get_loaded_kw(ecl_file_kw_type *file_kw,
+                                       inv_map_type *inv_map) {
+    ecl_kw_type *ecl_kw = ecl_file_kw_get_kw_ptr(file_kw);
+    if (ecl_kw)
+        inv_map->hits++;
+    return ecl_kw;
+}
+
+/*
+  Returns the ecl_kw instance if it is loaded, and NULL otherwise. As
+  opposed to ecl_file_kw_get_kw_ptr() the reference count is not
+  updated.
+*/
+
+const ecl_kw_type *ecl_file_kw_peek_kw(const ecl_file_kw_type *file_kw) {
     if (file_kw->ref_count == 0)
         return NULL;
 
-    file_kw->ref_count++;
     return file_kw->kw;
 }
 
+/*
+  Reads the frame sizes of a keyword stored in a delta archive into
+  @frame_bytes; the frame table is kept by @inv_map, so it is only read
+  from @fortio once. Returns false if the table can not be read.
+*/
+static bool ecl_file_kw_fread_delta_table(const ecl_file_kw_type *file_kw,
+                                          fortio_type *fortio,
+                                          inv_map_type *inv_map,
+                                          std::vector<int> &frame_bytes) {
+    const int num_frames =
+        ecl_rst_delta_num_frames(file_kw->kw_size, file_kw->delta_block_size);
+
+    if (num_frames > file_kw->delta_payload_size)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> guard(inv_map->delta_lock);
+        auto iter = inv_map->delta_tables.find(file_kw->file_offset);
+        if (iter != inv_map->delta_tables.end()) {
+            frame_bytes = iter->second;
+            return true;
+        }
+    }
+
+    {
+        ecl_kw_type *table_kw =
+            ecl_kw_alloc(file_kw->header, num_frames, ECL_INT);
+        bool read_ok = ecl_kw_fread_data_slice(
+            table_kw, fortio, file_kw->file_offset + ECL_KW_HEADER_FORTIO_SIZE,
+            file_kw->delta_payload_size, 0);
+
+        if (read_ok) {
+            const int *table = ecl_kw_get_const_int_ptr(table_kw);
+            frame_bytes.assign(table, table + num_frames);
+
+            std::lock_guard<std::mutex> guard(inv_map->delta_lock);
+            inv_map->delta_tables.emplace(file_kw->file_offset, frame_bytes);
+        }
+        ecl_kw_free(table_kw);
+        return read_ok;
+    }
+}
+
+/*
+  Decodes the frames [first_frame, last_frame) of a keyword stored in a
+  delta archive into @data. If the keyword is in the cache of @inv_map
+  the data is copied from there; otherwise only the frames themselves
+  are read from @fortio, and the same frames of the base keywords are
+  decoded recursively, until a keyframe or a cached base is reached.
+  The caller must ensure that the stream is not used by other threads.
+  Returns false if the frames can not be read.
+*/
+static bool ecl_file_kw_fread_delta_frames(const ecl_file_kw_type *file_kw,
+                                           fortio_type *fortio,
+                                           inv_map_type *inv_map,
+                                           int first_frame, int last_frame,
+                                           char *data) {
+    const int element_size = ecl_type_get_sizeof_ctype(file_kw->data_type);
+    const int block_size = file_kw->delta_block_size;
+    const int first_element = first_frame * block_size;
+    const int last_element =
+        std::min(last_frame * block_size, file_kw->kw_size);
+    const size_t byte_size =
+        (size_t)(last_element - first_element) * element_size;
+    std::vector<int> frame_bytes;
+    bool read_ok = false;
+
+    {
+        ecl_kw_type *cached_kw = delta_cache_get(inv_map, file_kw);
+        if (cached_kw) {
+            memcpy(data,
+                   (const char *)ecl_kw_get_const_ptr(cached_kw) +
+                       (size_t)first_element * element_size,
+                   byte_size);
+            ecl_kw_free(cached_kw);
+            return true;
+        }
+    }
+
+    if (ecl_file_kw_fread_delta_table(file_kw, fortio, inv_map, frame_bytes)) {
+        const int num_frames = frame_bytes.size();
+        int frames_start = num_frames;
+        int frames_end;
+
+        for (int i = 0; i < first_frame; i++)
+            frames_start += ecl_rst_delta_frame_ints(frame_bytes[i]);
+        frames_end = frames_start;
+        for (int i = first_frame; i < last_frame; i++)
+            frames_end += ecl_rst_delta_frame_ints(frame_bytes[i]);
+
+        if (frames_end <= file_kw->delta_payload_size) {
+            ecl_kw_type *frames_kw = ecl_kw_alloc(
+                file_kw->header, frames_end - frames_start, ECL_INT);
+            char *base_data = NULL;
+            bool base_ok = true;
+
+            if (file_kw->delta_base) {
+                base_data = (char *)util_malloc(byte_size + 1);
+                base_ok = ecl_file_kw_fread_delta_frames(
+                    file_kw->delta_base, fortio, inv_map, first_frame,
+                    last_frame, base_data);
+            }
+
+            if (base_ok) {
+                inv_map->delta_reads++;
+                if (ecl_kw_fread_data_slice(
+                        frames_kw, fortio,
+                        file_kw->file_offset + ECL_KW_HEADER_FORTIO_SIZE,
+                        file_kw->delta_payload_size, frames_start))
+                    read_ok = ecl_rst_delta_decode(
+                        &frame_bytes[first_frame], last_frame - first_frame,
+                        ecl_kw_get_const_int_ptr(frames_kw),
+                        frames_end - frames_start, file_kw->delta_codec,
+                        element_size, (size_t)block_size * element_size,
+                        base_data, data, byte_size);
+            }
+
+            free(base_data);
+            ecl_kw_free(frames_kw);
+        }
+    }
+    return read_ok;
+}
+
+/*
+  The slice [start, end) of a keyword stored in a delta archive is
+  decoded from the frames which cover the slice.
+*/
+static ecl_kw_type *
+ecl_file_kw_alloc_delta_slice(const ecl_file_kw_type *file_kw,
+                              fortio_type *fortio, inv_map_type *inv_map,
+                              int start, int end) {
+    const int element_size = ecl_type_get_sizeof_ctype(file_kw->data_type);
+    const int block_size = file_kw->delta_block_size;
+    const int first_frame = start / block_size;
+    const int last_frame = (end - 1) / block_size + 1;
+    const int first_element = first_frame * block_size;
+    const int last_element =
+        std::min(last_frame * block_size, file_kw->kw_size);
+    char *data = (char *)util_malloc(
+        (size_t)(last_element - first_element) * element_size);
+    ecl_kw_type *slice_kw = NULL;
+
+    if (ecl_file_kw_fread_delta_frames(file_kw, fortio, inv_map, first_frame,
+                                       last_frame, data))
+        slice_kw = ecl_kw_alloc_new(
+            file_kw->header, end - start, file_kw->data_type,
+            &data[(size_t)(start - first_element) * element_size]);
+
+    free(data);
+    return slice_kw;
+}
+
+/*
+  Allocates a new ecl_kw instance with the elements [start, end) of
+  the keyword; the caller owns the returned keyword. If the keyword is
+  loaded the elements are copied from memory. Otherwise, for an
+  unformatted file, only the Fortran records which cover the range are
+  read from @fortio, and for a keyword in a delta archive only the
+  frames which cover the range are decoded; a formatted file must be
+  parsed from the start of the keyword. The file is read while holding
+  the stream lock of @inv_map. The keyword itself is not loaded.
+  Returns NULL if the file can not be read.
+*/
+
+ecl_kw_type *ecl_file_kw_alloc_slice(const ecl_file_kw_type *file_kw,
+                                     fortio_type *fortio,
+                                     inv_map_type *inv_map, int start,
+                                     int end) {
+    if (start < 0 || end < start || end > file_kw->kw_size)
+        util_abort("%s: invalid range [%d,%d) for keyword:%s with %d "
+                   "elements\n",
+                   __func__, start, end, file_kw->header, file_kw->kw_size);
+
+    if (start == end)
+        return ecl_kw_alloc(file_kw->header, 0, file_kw->data_type);
+
+    {
+        const ecl_kw_type *loaded_kw = ecl_file_kw_peek_kw(file_kw);
+        if (loaded_kw)
+            return ecl_kw_alloc_sub_copy(loaded_kw, NULL, start, end - start);
+    }
+
+    if (fortio == NULL)
+        util_abort("%s: trying to load a keyword after the backing file has "
+                   "been detached.\n",
+                   __func__);
+
+    std::lock_guard<std::recursive_mutex> guard(inv_map->stream_lock);
+    if (file_kw->delta && !fortio_fmt_file(fortio))
+        return ecl_file_kw_alloc_delta_slice(file_kw, fortio, inv_map, start,
+                                             end);
+
+    if (fortio_fmt_file(fortio)) {
+        ecl_kw_type *slice_kw = NULL;
+        ecl_kw_type *tmp_kw =
+            ecl_file_kw_fread_kw(file_kw, fortio, inv_map, NULL, 0);
+        if (tmp_kw) {
+            slice_kw = ecl_kw_alloc_sub_copy(tmp_kw, NULL, start, end - start);
+            ecl_kw_free(tmp_kw);
+        }
+        return slice_kw;
+    }
+
+    {
+        ecl_kw_type *slice_kw =
+            ecl_kw_alloc(file_kw->header, end - start, file_kw->data_type);
+        if (!ecl_kw_fread_data_slice(
+                slice_kw, fortio,
+                file_kw->file_offset + ECL_KW_HEADER_FORTIO_SIZE,
+                file_kw->kw_size, start)) {
+            ecl_kw_free(slice_kw);
+            slice_kw = NULL;
+        }
+        return slice_kw;
+    }
+}
+
 /*
   Will return the ecl_kw instance of this file_kw; if it is not
   currently loaded the method will instantiate the ecl_kw instance
@@ -245,17 +1172,243 @@ ecl_kw_type *ecl_file_kw_get_kw_ptr(ecl_file_kw_type *file_kw) {
   ecl_kw_type pointers and their ecl_file_kw_type containers; this
   mapping needs the new_load return value from the
   ecl_file_kw_get_kw() function.
+
+  Several threads can call this function concurrently, also for the
+  same keyword; keywords which are already loaded are returned without
+  taking any locks.
 */
 
 ecl_kw_type *ecl_file_kw_get_kw(ecl_file_kw_type *file_kw, fortio_type *fortio,
                                 inv_map_type *inv_map) {
-    if (file_kw->ref_count == 0)
-        ecl_file_kw_load_kw(file_kw, fortio, inv_map);
+    ecl_kw_type *ecl_kw = ecl_file_kw_get_loaded_kw(file_kw, inv_map);
+    if (ecl_kw)
+        return ecl_kw;
 
-    if (file_kw->kw)
-        file_kw->ref_count++;
+    {
+        std::lock_guard<std::mutex> guard(
+            ecl_file_kw_get_load_lock(file_kw, inv_map));
 
-    return file_kw->kw;
+        if (file_kw->ref_count == 0) {
+            ecl_file_kw_load_kw(file_kw, fortio, inv_map, NULL, 0);
+            inv_map->misses++;
+        } else
+            inv_map->hits++;
+
+        if (file_kw->kw)
+            file_kw->ref_count++;
+
+        return file_kw->kw;
+    }
+}
+
+/*
+  The run is read into one buffer of raw records and decoded from
+  there. A single keyword larger than ECL_FILE_KW_PREFETCH_RUN, and the
+  keywords of a memory mapped file, are instead read directly into the
+  keyword with ecl_kw_pread_alloc(); the raw buffer would only add a
+  copy, and for a large keyword double the peak memory.
+*/
+static void ecl_file_kw_prefetch_run(ecl_file_kw_type *const *kw_list,
+                                     int num_kw, fortio_type *fortio,
+                                     inv_map_type *inv_map) {
+    const offset_type start = kw_list[0]->file_offset;
+    offset_type end = start;
+    for (int i = 0; i < num_kw; i++)
+        end = std::max(end, ecl_file_kw_get_fortio_end(kw_list[i]));
+
+    {
+        size_t records_size = end - start;
+        char *records = NULL;
+
+        if (!fortio_fmt_file(fortio) && !fortio_is_mmapped(fortio) &&
+            records_size <= ECL_FILE_KW_PREFETCH_RUN) {
+            records = (char *)util_malloc(records_size);
+            if (!fortio_pread(fortio, start, records, records_size)) {
+                free(records);
+                records = NULL;
+            }
+        }
+
+        for (int i = 0; i < num_kw; i++) {
+            ecl_file_kw_type *file_kw = kw_list[i];
+            size_t kw_offset = file_kw->file_offset - start;
+            std::lock_guard<std::mutex> guard(
+                ecl_file_kw_get_load_lock(file_kw, inv_map));
+
+            if (file_kw->ref_count > 0)
+                continue;
+
+            if (records)
+                ecl_file_kw_load_kw(file_kw, fortio, inv_map,
+                                    &records[kw_offset],
+                                    records_size - kw_offset);
+            else
+                ecl_file_kw_load_kw(file_kw, fortio, inv_map, NULL, 0);
+
+            if (file_kw->kw)
+                file_kw->ref_count++;
+        }
+        free(records);
+    }
+}
+
+/*
+  Loads all the keywords in @kw_list which are not already loaded. The
+  keywords are read in file order, and keywords which are close
+  together in the file are read with one positional read, see
+  fortio_pread(), and decoded afterwards. For files which can not be
+  read with positional reads the keywords are loaded one by one, still
+  in file order.
+
+  Prefetching does not count as an access to the keywords, neither in
+  the hit/miss counters nor for compression and memory budget; the
+  keywords are however registered as the most recently used. Several
+  threads can prefetch and get keywords from the same file
+  concurrently.
+*/
+
+void ecl_file_kw_prefetch(ecl_file_kw_type *const *kw_list, int num_kw,
+                          fortio_type *fortio, inv_map_type *inv_map) {
+    std::vector<ecl_file_kw_type *> pending;
+    for (int i = 0; i < num_kw; i++)
+        if (kw_list[i]->ref_count == 0)
+            pending.push_back(kw_list[i]);
+
+    std::sort(pending.begin(), pending.end(),
+              [](const ecl_file_kw_type *kw1, const ecl_file_kw_type *kw2) {
+                  return kw1->file_offset < kw2->file_offset;
+              });
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    {
+        size_t run_start = 0;
+        while (run_start < pending.size()) {
+            offset_type start = pending[run_start]->file_offset;
+            offset_type end = ecl_file_kw_get_fortio_end(pending[run_start]);
+            size_t run_end = run_start + 1;
+
+            while (run_end < pending.size()) {
+                const ecl_file_kw_type *next = pending[run_end];
+                offset_type next_end = ecl_file_kw_get_fortio_end(next);
+
+                if (next->file_offset > end + ECL_FILE_KW_PREFETCH_GAP)
+                    break;
+
+                if (std::max(end, next_end) - start >
+                    ECL_FILE_KW_PREFETCH_RUN)
+                    break;
+
+                end = std::max(end, next_end);
+                run_end++;
+            }
+
+            ecl_file_kw_prefetch_run(&pending[run_start], run_end - run_start,
+                                     fortio, inv_map);
+            run_start = run_end;
+        }
+    }
+}
+
+/*
+  Compresses the least recently accessed keywords until the
+  uncompressed keywords use at most hot_size bytes. Every keyword is
+  considered once, when lru_hot passes it: it is compressed unless it
+  can not be compressed or is held, see ecl_file_kw_is_held(), and it
+  is only considered again after it has been accessed and moved to
+  the end of the list. The keyword which is accessed is at the end of
+  the list, and is not compressed.
+*/
+static void inv_map_compress_cold(inv_map_type *map,
+                                  const ecl_file_kw_type *current) {
+    while (map->lru_hot && map->lru_hot != current &&
+           map->hot_bytes > map->hot_size) {
+        ecl_file_kw_type *file_kw = map->lru_hot;
+        map->lru_hot = file_kw->lru_next;
+
+        inv_map_charge(map, file_kw, true);
+        if (!file_kw->incompressible && !ecl_file_kw_is_held(file_kw) &&
+            !ecl_kw_is_compressed(file_kw->kw)) {
+            if (ecl_kw_compress(file_kw->kw, map->codec))
+                inv_map_charge(map, file_kw, true);
+            else
+                file_kw->incompressible = true;
+        }
+    }
+}
+
+/*
+  Returns the keyword to the "not loaded" state, a subsequent
+  ecl_file_kw_get_kw() will reload it from file.
+*/
+static void ecl_file_kw_evict(ecl_file_kw_type *file_kw,
+                              inv_map_type *inv_map) {
+    file_kw->ref_count = 0;
+    ecl_file_kw_drop_kw(file_kw, inv_map);
+    inv_map->evictions++;
+}
+
+/*
+  Evicts the least recently accessed keywords until the loaded keywords
+  use at most memory_budget bytes. Keywords which have become held by a
+  caller or modified since they were accessed are taken out of the
+  list, and keywords in a transaction are skipped.
+*/
+static void inv_map_evict_cold(inv_map_type *map,
+                               const ecl_file_kw_type *current) {
+    ecl_file_kw_type *file_kw = map->lru_head;
+    while (file_kw && map->loaded_bytes > map->memory_budget) {
+        ecl_file_kw_type *next = file_kw->lru_next;
+
+        inv_map_charge(map, file_kw, true);
+        if (file_kw->ref_count > 1 || ecl_kw_is_modified(file_kw->kw))
+            inv_map_lru_unlink(map, file_kw);
+        else if (file_kw != current && !ecl_file_kw_is_held(file_kw))
+            ecl_file_kw_evict(file_kw, map);
+        file_kw = next;
+    }
+}
+
+/*
+  Registers an access to the keyword through the ecl_file layer. When
+  compression is enabled, see inv_map_set_compression(), the least
+  recently accessed keywords are compressed. Then, if @evict is true
+  and a memory budget has been set, see inv_map_set_memory_budget(),
+  the least recently accessed keywords are evicted. The keyword which
+  is accessed is never compressed or evicted by this call, and neither
+  are keywords which are held or modified, see ecl_file_kw_is_held().
+
+  A compressed keyword is decompressed here, while holding the load
+  lock of the keyword, so that a keyword handed out by the ecl_file
+  layer is not decompressed in place by concurrent readers.
+
+  Observe that compression and eviction modify and free keywords, so
+  neither should be enabled while other threads access keywords from
+  the same file.
+*/
+void ecl_file_kw_mark_access(ecl_file_kw_type *file_kw, inv_map_type *inv_map,
+                             bool evict) {
+    bool compress = (inv_map->codec != UTIL_CODEC_NONE);
+    evict = evict && (inv_map->memory_budget > 0);
+
+    {
+        std::lock_guard<std::mutex> guard(
+            ecl_file_kw_get_load_lock(file_kw, inv_map));
+        if (file_kw->kw && ecl_kw_is_compressed(file_kw->kw))
+            ecl_kw_get_const_ptr(file_kw->kw);
+    }
+    if (!compress && !evict)
+        return;
+
+    std::lock_guard<std::mutex> guard(inv_map->lock);
+    if (file_kw->kw == NULL)
+        return;
+
+    inv_map_charge(inv_map, file_kw, true);
+    inv_map_lru_append(inv_map, file_kw);
+    if (compress)
+        inv_map_compress_cold(inv_map, file_kw);
+    if (evict)
+        inv_map_evict_cold(inv_map, file_kw);
 }
 
 bool ecl_file_kw_ptr_eq(const ecl_file_kw_type *file_kw,
@@ -266,8 +1419,12 @@ bool ecl_file_kw_ptr_eq(const ecl_file_kw_type *file_kw,
         return false;
 }
 
-void ecl_file_kw_replace_kw(ecl_file_kw_type *file_kw, fortio_type *target,
-                            ecl_kw_type *new_kw) {
+/*
+  The new keyword is owned by the ecl_file, but it is not taken from
+  file and is therefore never compressed or evicted.
+*/
+void ecl_file_kw_replace_kw(ecl_file_kw_type *file_kw, inv_map_type *inv_map,
+                            fortio_type *target, ecl_kw_type *new_kw) {
     if (!ecl_type_is_equal(ecl_file_kw_get_data_type(file_kw),
                            ecl_kw_get_data_type(new_kw)))
         util_abort("%s: sorry type mismatch between in-file keyword and new "
@@ -278,10 +1435,13 @@ void ecl_file_kw_replace_kw(ecl_file_kw_type *file_kw, fortio_type *target,
                    "keyword \n",
                    __func__);
 
-    if (file_kw->kw != NULL)
-        ecl_kw_free(file_kw->kw);
-
-    file_kw->kw = new_kw;
+    {
+        std::lock_guard<std::mutex> guard(inv_map->lock);
+        ecl_file_kw_drop_kw(file_kw, inv_map);
+        file_kw->kw = new_kw;
+        inv_map_add_kw(inv_map, file_kw, new_kw);
+        inv_map_charge(inv_map, file_kw, true);
+    }
     fortio_fseek(target, file_kw->file_offset, SEEK_SET);
     ecl_kw_fwrite(file_kw->kw, target);
 }
@@ -412,15 +1572,28 @@ ecl_file_kw_type *ecl_file_kw_fread_alloc(FILE *stream) {
     return file_kw;
 }
 
-void ecl_file_kw_start_transaction(const ecl_file_kw_type *file_kw,
-                                   int *ref_count) {
+/*
+  The keyword is held while the transaction is open, so it is neither
+  compressed nor evicted, see ecl_file_kw_is_held().
+*/
+void ecl_file_kw_start_transaction(ecl_file_kw_type *file_kw, int *ref_count) {
+    file_kw->pin_count++;
     *ref_count = file_kw->ref_count;
 }
 
-void ecl_file_kw_end_transaction(ecl_file_kw_type *file_kw, int ref_count) {
-    if (ref_count == 0 && file_kw->ref_count > 0) {
-        ecl_kw_free(file_kw->kw);
-        file_kw->kw = NULL;
-    }
-    file_kw->ref_count = ref_count;
+/*
+  A keyword which has been loaded during the transaction is dropped
+  again. A keyword which is no longer held when the transaction ends
+  can again be compressed and evicted.
+*/
+void ecl_file_kw_end_transaction(ecl_file_kw_type *file_kw,
+                                 inv_map_type *inv_map, int ref_count) {
+    std::lock_guard<std::mutex> guard(inv_map->lock);
+    file_kw->pin_count--;
+    if (ref_count == 0 && file_kw->ref_count > 0)
+        ecl_file_kw_drop_kw(file_kw, inv_map);
+
+    file_kw->ref_count = file_kw->kw ? ref_count : 0;
+    if (file_kw->kw && !file_kw->lru_linked && !ecl_file_kw_is_held(file_kw))
+        inv_map_lru_append(inv_map, file_kw);
 }
@@ -1,6 +1,15 @@
+#include <string.h>
+
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <ert/util/stringlist.hpp>
 
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.hpp>
@@ -9,6 +18,22 @@
 #include <ert/ecl/ecl_file_view.hpp>
 #include <ert/ecl/ecl_rsthead.hpp>
 #include <ert/ecl/ecl_type.hpp>
+#include <ert/ecl/ecl_util.hpp>
+
+/*
+  The restart index holds the report step and simulation time of each
+  SEQNUM block in the view, so that blocks can be looked up without
+  reading the SEQNUM, INTEHEAD and DOUBHEAD keywords each time; see
+  ecl_file_view_get_restart_index(). For report steps and times which
+  occur more than once the first block is used.
+*/
+struct restart_index_type {
+    std::unordered_map<int, int> report_step;
+    std::unordered_map<time_t, int> sim_time;
+    std::unordered_map<time_t, int> intehead_time;
+    std::vector<time_t> block_sim_time;
+    std::vector<double> block_sim_days;
+};
 
 struct ecl_file_view_struct {
     std::vector<ecl_file_kw_type *> kw_list;
@@ -23,6 +48,9 @@ struct ecl_file_view_struct {
         *inv_map; /* Shared reference owned by the ecl_file structure. */
     std::vector<ecl_file_view_type *> child_list;
     int *flags;
+    /* Built on demand, and reset by ecl_file_view_make_index(). */
+    mutable std::unique_ptr<restart_index_type> restart_index;
+    mutable std::mutex restart_index_lock;
 };
 
 struct ecl_file_transaction_struct {
@@ -30,6 +58,13 @@ struct ecl_file_transaction_struct {
     int *ref_count;
 };
 
+struct ecl_file_prefetch_struct {
+    const ecl_file_view_type *file_view;
+    std::vector<ecl_file_kw_type *> file_kw_list;
+    std::thread thread;
+    bool loadOK;
+};
+
 bool ecl_file_view_check_flags(int state_flags, int query_flags) {
     if ((state_flags & query_flags) == query_flags)
         return true;
@@ -75,6 +110,7 @@ int ecl_file_view_get_global_index(const ecl_file_view_type *ecl_file_view,
 void ecl_file_view_make_index(ecl_file_view_type *ecl_file_view) {
     ecl_file_view->distinct_kw.clear();
     ecl_file_view->kw_index.clear();
+    ecl_file_view->restart_index.reset();
     {
         int global_index = 0;
         for (const auto &file_kw : ecl_file_view->kw_list) {
@@ -122,20 +158,65 @@ void ecl_file_view_add_flag(ecl_file_view_type *file_view, int flag) {
     *file_view->flags |= flag;
 }
 
+/*
+  Opens the shared fortio stream for a read, and takes the stream lock
+  of the inv_map when the read seeks in the stream, @seek, or when the
+  file has been opened with the ECL_FILE_CLOSE_STREAM flag; the stream
+  is then reopened and closed around every read. Returns false, without
+  holding the lock, if the stream can not be opened. A successful call
+  must be matched by ecl_file_view_close_stream() with the same @seek.
+*/
+static bool ecl_file_view_open_stream(const ecl_file_view_type *ecl_file_view,
+                                      bool seek) {
+    bool lock =
+        seek || ecl_file_view_flags_set(ecl_file_view, ECL_FILE_CLOSE_STREAM);
+    if (lock)
+        inv_map_lock_stream(ecl_file_view->inv_map);
+
+    if (fortio_assert_stream_open(ecl_file_view->fortio))
+        return true;
+
+    if (lock)
+        inv_map_unlock_stream(ecl_file_view->inv_map);
+    return false;
+}
+
+static void
+ecl_file_view_close_stream(const ecl_file_view_type *ecl_file_view,
+                           bool seek) {
+    if (ecl_file_view_flags_set(ecl_file_view, ECL_FILE_CLOSE_STREAM)) {
+        fortio_fclose_stream(ecl_file_view->fortio);
+        inv_map_unlock_stream(ecl_file_view->inv_map);
+    } else if (seek)
+        inv_map_unlock_stream(ecl_file_view->inv_map);
+}
+
+/*
+  Several threads can load keywords concurrently through this function,
+  see ecl_file_kw_get_kw(), except when the file has been opened with
+  the ECL_FILE_CLOSE_STREAM flag; the loads are then serialized, since
+  the stream is reopened and closed around every load.
+
+  Keywords of a writable file are never evicted to honor a memory
+  budget, they might have been modified and not yet saved.
+*/
 static ecl_kw_type *
 ecl_file_view_get_kw(const ecl_file_view_type *ecl_file_view,
                      ecl_file_kw_type *file_kw) {
-    ecl_kw_type *ecl_kw = ecl_file_kw_get_kw_ptr(file_kw);
+    ecl_kw_type *ecl_kw =
+        ecl_file_kw_get_loaded_kw(file_kw, ecl_file_view->inv_map);
     if (!ecl_kw) {
-        if (fortio_assert_stream_open(ecl_file_view->fortio)) {
-
+        if (ecl_file_view_open_stream(ecl_file_view, false)) {
             ecl_kw = ecl_file_kw_get_kw(file_kw, ecl_file_view->fortio,
                                         ecl_file_view->inv_map);
-
-            if (ecl_file_view_flags_set(ecl_file_view, ECL_FILE_CLOSE_STREAM))
-                fortio_fclose_stream(ecl_file_view->fortio);
+            ecl_file_view_close_stream(ecl_file_view, false);
         }
     }
+
+    if (ecl_kw)
+        ecl_file_kw_mark_access(
+            file_kw, ecl_file_view->inv_map,
+            !ecl_file_view_flags_set(ecl_file_view, ECL_FILE_WRITABLE));
     return ecl_kw;
 }
 
@@ -146,6 +227,52 @@ ecl_kw_type *ecl_file_view_iget_kw(const ecl_file_view_type *ecl_file_view,
     return ecl_file_view_get_kw(ecl_file_view, file_kw);
 }
 
+/*
+  The keywords of a delta archive, see ecl_rst_delta.cpp, can not be
+  read element by element from file, the elements are taken from the
+  reconstructed keyword instead. The values are stored in the io
+  representation of the type, as by ecl_kw_fread_indexed_data().
+*/
+
+static void ecl_file_view_fload_delta_kw(fortio_type *fortio,
+                                         const ecl_file_kw_type *file_kw,
+                                         int num_elements,
+                                         const int *element_index,
+                                         char *io_buffer) {
+    ecl_kw_type *ecl_kw = ecl_file_kw_alloc_kw(file_kw, fortio);
+    if (!ecl_kw)
+        util_abort("%s: failed to read keyword:%s\n", __func__,
+                   ecl_file_kw_get_header(file_kw));
+
+    {
+        ecl_data_type data_type = ecl_kw_get_data_type(ecl_kw);
+        size_t sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+
+        for (int i = 0; i < num_elements; i++) {
+            char *io_value = &io_buffer[i * sizeof_iotype];
+            int index = element_index[i];
+
+            if (ecl_type_is_bool(data_type)) {
+                int int_value = ecl_kw_iget_bool(ecl_kw, index)
+                                    ? ECL_BOOL_TRUE_INT
+                                    : ECL_BOOL_FALSE_INT;
+                memcpy(io_value, &int_value, sizeof int_value);
+            } else if (ecl_type_is_char(data_type) ||
+                       ecl_type_is_string(data_type)) {
+                const char *string =
+                    ecl_type_is_char(data_type)
+                        ? ecl_kw_iget_char_ptr(ecl_kw, index)
+                        : ecl_kw_iget_string_ptr(ecl_kw, index);
+                size_t length = std::min(strlen(string), sizeof_iotype);
+                memcpy(io_value, string, length);
+                memset(&io_value[length], ' ', sizeof_iotype - length);
+            } else
+                ecl_kw_iget(ecl_kw, index, io_value);
+        }
+    }
+    ecl_kw_free(ecl_kw);
+}
+
 void ecl_file_view_index_fload_kw(const ecl_file_view_type *ecl_file_view,
                                   const char *kw, int index,
                                   const int_vector_type *index_map,
@@ -153,21 +280,233 @@ void ecl_file_view_index_fload_kw(const ecl_file_view_type *ecl_file_view,
     ecl_file_kw_type *file_kw =
         ecl_file_view_iget_named_file_kw(ecl_file_view, kw, index);
 
-    if (fortio_assert_stream_open(ecl_file_view->fortio)) {
-        offset_type offset = ecl_file_kw_get_offset(file_kw);
+    if (ecl_file_view_open_stream(ecl_file_view, true)) {
+        if (ecl_file_kw_is_delta(file_kw))
+            ecl_file_view_fload_delta_kw(
+                ecl_file_view->fortio, file_kw, int_vector_size(index_map),
+                int_vector_get_const_ptr(index_map), io_buffer);
+        else {
+            offset_type offset = ecl_file_kw_get_offset(file_kw);
+            ecl_data_type data_type = ecl_file_kw_get_data_type(file_kw);
+            int element_count = ecl_file_kw_get_size(file_kw);
+
+            ecl_kw_fread_indexed_data(
+                ecl_file_view->fortio, offset + ECL_KW_HEADER_FORTIO_SIZE,
+                data_type, element_count, index_map, io_buffer);
+        }
+        ecl_file_view_close_stream(ecl_file_view, true);
+    }
+}
+
+/**
+   Will load element 'element_index' from every occurence of keyword
+   'kw' in the view; the values are stored in 'io_buffer' in the order
+   the keywords appear in the file. The buffer must have space for
+   ecl_file_view_get_num_named_kw() elements of the io type of the
+   keyword.
+
+   This is equivalent to calling ecl_file_view_index_fload_kw() for
+   each occurence of 'kw', but all the values are read with one
+   batched read, which is much faster for e.g. extracting one
+   summary vector from all the PARAMS keywords of a UNSMRY file.
+*/
+
+void ecl_file_view_fload_named_element(const ecl_file_view_type *ecl_file_view,
+                                       const char *kw, int element_index,
+                                       char *io_buffer) {
+    const int num_kw = ecl_file_view_get_num_named_kw(ecl_file_view, kw);
+    if (num_kw == 0)
+        return;
+
+    if (ecl_file_view_open_stream(ecl_file_view, true)) {
+        ecl_data_type data_type =
+            ecl_file_view_iget_named_data_type(ecl_file_view, kw, 0);
+        size_t sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+        std::vector<offset_type> data_offset(num_kw);
+        std::vector<int> element_count(num_kw);
+        bool delta_archive = false;
+
+        for (int ikw = 0; ikw < num_kw; ikw++) {
+            const ecl_file_kw_type *file_kw =
+                ecl_file_view_iget_named_file_kw(ecl_file_view, kw, ikw);
+
+            if (!ecl_type_is_equal(data_type,
+                                   ecl_file_kw_get_data_type(file_kw)))
+                util_abort("%s: all occurences of %s must have the same "
+                           "type - aborting\n",
+                           __func__, kw);
+
+            /* All the keywords of a delta archive are delta keywords. */
+            if (ecl_file_kw_is_delta(file_kw)) {
+                ecl_file_view_fload_delta_kw(ecl_file_view->fortio, file_kw, 1,
+                                             &element_index,
+                                             &io_buffer[ikw * sizeof_iotype]);
+                delta_archive = true;
+                continue;
+            }
+
+            data_offset[ikw] =
+                ecl_file_kw_get_offset(file_kw) + ECL_KW_HEADER_FORTIO_SIZE;
+            element_count[ikw] = ecl_file_kw_get_size(file_kw);
+        }
+
+        if (!delta_archive)
+            ecl_kw_fread_element_multiple(
+                ecl_file_view->fortio, data_type, num_kw, data_offset.data(),
+                element_count.data(), element_index, io_buffer);
+        ecl_file_view_close_stream(ecl_file_view, true);
+    }
+}
+
+/**
+   Will return a new ecl_kw instance with the elements [start, end) of
+   occurence @ith of keyword @kw; the caller must free the keyword
+   with ecl_kw_free(). For unformatted files only the records which
+   cover the range are read, see ecl_file_kw_alloc_slice(). Returns
+   NULL if the file can not be read.
+*/
+
+ecl_kw_type *
+ecl_file_view_iget_named_kw_slice(const ecl_file_view_type *ecl_file_view,
+                                  const char *kw, int ith, int start, int end) {
+    const ecl_file_kw_type *file_kw =
+        ecl_file_view_iget_named_file_kw(ecl_file_view, kw, ith);
+
+    if (ecl_file_kw_peek_kw(file_kw))
+        return ecl_file_kw_alloc_slice(file_kw, NULL, ecl_file_view->inv_map,
+                                       start, end);
+
+    if (!ecl_file_view_open_stream(ecl_file_view, true))
+        return NULL;
+
+    {
+        ecl_kw_type *slice_kw = ecl_file_kw_alloc_slice(
+            file_kw, ecl_file_view->fortio, ecl_file_view->inv_map, start,
+            end);
+        ecl_file_view_close_stream(ecl_file_view, true);
+        return slice_kw;
+    }
+}
+
+/*
+  Decodes the elements [offset, offset + count) of @file_kw into @data;
+  a loaded keyword is copied from memory, otherwise the caller must
+  have opened the stream with ecl_file_view_open_stream().
+*/
+static bool ecl_file_view_fread_kw_as(const ecl_file_view_type *ecl_file_view,
+                                      const ecl_file_kw_type *file_kw,
+                                      int offset, int count,
+                                      ecl_data_type target_type, void *data) {
+    const ecl_kw_type *ecl_kw = ecl_file_kw_peek_kw(file_kw);
+    if (ecl_kw) {
+        if (ecl_type_is_double(target_type))
+            ecl_kw_get_slice_as_double(ecl_kw, offset, count, (double *)data);
+        else
+            ecl_kw_get_slice_as_float(ecl_kw, offset, count, (float *)data);
+        return true;
+    }
+
+    if (fortio_fmt_file(ecl_file_view->fortio) ||
+        ecl_file_kw_is_delta(file_kw)) {
+        /* Formatted files must be parsed from the start of the keyword,
+           and the frames of a delta archive must be decoded. */
+        ecl_kw_type *tmp_kw =
+            ecl_file_kw_alloc_slice(file_kw, ecl_file_view->fortio,
+                                    ecl_file_view->inv_map, offset,
+                                    offset + count);
+        if (!tmp_kw)
+            return false;
+
+        if (ecl_type_is_double(target_type))
+            ecl_kw_get_slice_as_double(tmp_kw, 0, count, (double *)data);
+        else
+            ecl_kw_get_slice_as_float(tmp_kw, 0, count, (float *)data);
+        ecl_kw_free(tmp_kw);
+        return true;
+    }
+
+    {
+        offset_type data_offset =
+            ecl_file_kw_get_offset(file_kw) + ECL_KW_HEADER_FORTIO_SIZE;
         ecl_data_type data_type = ecl_file_kw_get_data_type(file_kw);
         int element_count = ecl_file_kw_get_size(file_kw);
 
-        ecl_kw_fread_indexed_data(ecl_file_view->fortio,
-                                  offset + ECL_KW_HEADER_FORTIO_SIZE, data_type,
-                                  element_count, index_map, io_buffer);
+        if (ecl_type_is_double(target_type))
+            return ecl_kw_fread_data_as_double(
+                ecl_file_view->fortio, data_offset, data_type, element_count,
+                offset, count, (double *)data);
+        else
+            return ecl_kw_fread_data_as_float(
+                ecl_file_view->fortio, data_offset, data_type, element_count,
+                offset, count, (float *)data);
     }
 }
 
+static bool ecl_file_view_fread_named_kw_as(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int offset, int count, ecl_data_type target_type, void *data) {
+    const ecl_file_kw_type *file_kw =
+        ecl_file_view_iget_named_file_kw(ecl_file_view, kw, ith);
+
+    if (ecl_file_kw_peek_kw(file_kw))
+        return ecl_file_view_fread_kw_as(ecl_file_view, file_kw, offset,
+                                         count, target_type, data);
+
+    if (!ecl_file_view_open_stream(ecl_file_view, true))
+        return false;
+
+    {
+        bool read_ok = ecl_file_view_fread_kw_as(ecl_file_view, file_kw, offset,
+                                                 count, target_type, data);
+        ecl_file_view_close_stream(ecl_file_view, true);
+        return read_ok;
+    }
+}
+
+/**
+   Will decode the elements [offset, offset + count) of occurence @ith
+   of the int, float or double keyword @kw directly into the caller
+   supplied buffer, converting the values to double or float. If the
+   keyword is already loaded the values are copied from memory,
+   otherwise they are read straight from the file without creating an
+   ecl_kw instance, and the keyword is not loaded. Use offset = 0 and
+   count = ecl_file_view_iget_named_size() to get the whole keyword.
+
+   Returns false if the file can not be read.
+*/
+
+bool ecl_file_view_fread_named_kw_as_double(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int offset, int count, double *data) {
+    return ecl_file_view_fread_named_kw_as(ecl_file_view, kw, ith, offset,
+                                           count, ECL_DOUBLE, data);
+}
+
+bool ecl_file_view_fread_named_kw_as_float(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int offset, int count, float *data) {
+    return ecl_file_view_fread_named_kw_as(ecl_file_view, kw, ith, offset,
+                                           count, ECL_FLOAT, data);
+}
+
+static int
+ecl_file_view_find_report_step(const ecl_file_view_type *ecl_file_view,
+                               int report_step);
+
+/*
+  Lookups of a SEQNUM value, i.e. a report step, are served from the
+  restart index, the other keywords are scanned.
+*/
 int ecl_file_view_find_kw_value(const ecl_file_view_type *ecl_file_view,
                                 const char *kw, const void *value) {
     int global_index = -1;
-    if (ecl_file_view_has_kw(ecl_file_view, kw)) {
+    if (strcmp(kw, SEQNUM_KW) == 0) {
+        int seqnum_index =
+            ecl_file_view_find_report_step(ecl_file_view, *(const int *)value);
+        if (seqnum_index >= 0)
+            global_index =
+                ecl_file_view->kw_index.at(SEQNUM_KW)[seqnum_index];
+    } else if (ecl_file_view_has_kw(ecl_file_view, kw)) {
         const auto &index_list = ecl_file_view->kw_index.at(kw);
         size_t index = 0;
         while (index < index_list.size()) {
@@ -258,7 +597,8 @@ void ecl_file_view_replace_kw(ecl_file_view_type *ecl_file_view,
 
             if (insert_copy)
                 insert_kw = ecl_kw_alloc_copy(new_kw);
-            ecl_file_kw_replace_kw(ikw, ecl_file_view->fortio, insert_kw);
+            ecl_file_kw_replace_kw(ikw, ecl_file_view->inv_map,
+                                   ecl_file_view->fortio, insert_kw);
 
             ecl_file_view_make_index(ecl_file_view);
             return;
@@ -271,19 +611,117 @@ void ecl_file_view_replace_kw(ecl_file_view_type *ecl_file_view,
 bool ecl_file_view_load_all(ecl_file_view_type *ecl_file_view) {
     bool loadOK = false;
 
-    if (fortio_assert_stream_open(ecl_file_view->fortio)) {
+    if (ecl_file_view_open_stream(ecl_file_view, false)) {
         for (ecl_file_kw_type *file_kw : ecl_file_view->kw_list)
             ecl_file_kw_get_kw(file_kw, ecl_file_view->fortio,
                                ecl_file_view->inv_map);
         loadOK = true;
+        ecl_file_view_close_stream(ecl_file_view, false);
     }
 
-    if (ecl_file_view_flags_set(ecl_file_view, ECL_FILE_CLOSE_STREAM))
-        fortio_fclose_stream(ecl_file_view->fortio);
+    return loadOK;
+}
+
+static std::vector<ecl_file_kw_type *>
+ecl_file_view_get_prefetch_list(const ecl_file_view_type *ecl_file_view,
+                                const stringlist_type *kw_list) {
+    std::vector<ecl_file_kw_type *> file_kw_list;
+    for (int i = 0; i < stringlist_get_size(kw_list); i++) {
+        const auto index_iter =
+            ecl_file_view->kw_index.find(stringlist_iget(kw_list, i));
+        if (index_iter == ecl_file_view->kw_index.end())
+            continue;
+
+        for (int global_index : index_iter->second)
+            file_kw_list.push_back(ecl_file_view->kw_list[global_index]);
+    }
+    return file_kw_list;
+}
+
+/**
+   Loads all occurences in the view of the keywords in @kw_list, i.e.
+   the typical set of solution keywords for one report step, with as
+   few and as large reads as possible; see ecl_file_kw_prefetch().
+   Keywords which are not in the view are ignored. The keywords are
+   subsequently accessed with e.g. ecl_file_view_iget_named_kw() as
+   usual.
+*/
+
+bool ecl_file_view_prefetch(const ecl_file_view_type *ecl_file_view,
+                            const stringlist_type *kw_list) {
+    bool loadOK = false;
+    std::vector<ecl_file_kw_type *> file_kw_list =
+        ecl_file_view_get_prefetch_list(ecl_file_view, kw_list);
+
+    if (ecl_file_view_open_stream(ecl_file_view, false)) {
+        ecl_file_kw_prefetch(file_kw_list.data(), file_kw_list.size(),
+                             ecl_file_view->fortio, ecl_file_view->inv_map);
+        loadOK = true;
+        ecl_file_view_close_stream(ecl_file_view, false);
+    }
 
     return loadOK;
 }
 
+/**
+   As ecl_file_view_prefetch(), but the keywords are loaded by a
+   background thread; the calling thread can access the keywords
+   meanwhile, and will wait for a keyword which is being loaded by the
+   background thread instead of reading it a second time. The prefetch
+   must be completed with ecl_file_view_end_prefetch() before the file
+   is closed.
+
+   When the file has been opened with the ECL_FILE_CLOSE_STREAM flag
+   the keywords are loaded before this function returns. The
+   restrictions on compression and memory budget for concurrent access,
+   see ecl_file_kw_mark_access(), also apply while the prefetch is in
+   progress.
+*/
+
+ecl_file_prefetch_type *
+ecl_file_view_start_prefetch(const ecl_file_view_type *ecl_file_view,
+                             const stringlist_type *kw_list) {
+    ecl_file_prefetch_type *prefetch = new ecl_file_prefetch_type();
+    prefetch->file_view = ecl_file_view;
+
+    if (ecl_file_view_flags_set(ecl_file_view, ECL_FILE_CLOSE_STREAM))
+        prefetch->loadOK = ecl_file_view_prefetch(ecl_file_view, kw_list);
+    else if (fortio_assert_stream_open(ecl_file_view->fortio)) {
+        prefetch->file_kw_list =
+            ecl_file_view_get_prefetch_list(ecl_file_view, kw_list);
+        prefetch->loadOK = true;
+        prefetch->thread = std::thread(
+            ecl_file_kw_prefetch, prefetch->file_kw_list.data(),
+            (int)prefetch->file_kw_list.size(), ecl_file_view->fortio,
+            ecl_file_view->inv_map);
+    } else
+        prefetch->loadOK = false;
+
+    return prefetch;
+}
+
+/**
+   Waits for a prefetch started with ecl_file_view_start_prefetch() to
+   complete and frees it. Returns false if the file could not be
+   opened.
+*/
+
+bool ecl_file_view_end_prefetch(const ecl_file_view_type *ecl_file_view,
+                                ecl_file_prefetch_type *prefetch) {
+    if (prefetch->file_view != ecl_file_view)
+        util_abort("%s: internal error - file_view / prefetch mismatch\n",
+                   __func__);
+
+    if (prefetch->thread.joinable())
+        prefetch->thread.join();
+
+    {
+        bool loadOK = prefetch->loadOK;
+        delete prefetch;
+        return loadOK;
+    }
+}
+
 void ecl_file_view_add_kw(ecl_file_view_type *ecl_file_view,
                           ecl_file_kw_type *file_kw) {
     ecl_file_view->kw_list.push_back(file_kw);
@@ -543,68 +981,189 @@ we have introduced the following concepts:
 
 */
 
+/*
+  Reads element @index of occurence @ith of keyword @kw, without
+  loading the keyword; returns false if the keyword is too short or
+  can not be read. The stream must have been opened with
+  ecl_file_view_open_stream().
+*/
+static bool ecl_file_view_iget_named_value(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int index, double *value) {
+    if (index >= ecl_file_view_iget_named_size(ecl_file_view, kw, ith))
+        return false;
+
+    return ecl_file_view_fread_kw_as(
+        ecl_file_view, ecl_file_view_iget_named_file_kw(ecl_file_view, kw, ith),
+        index, 1, ECL_DOUBLE, value);
+}
+
+static time_t ecl_file_view_iget_intehead_date(
+    const ecl_file_view_type *ecl_file_view, int intehead_index) {
+    double day, month, year;
+
+    if (ecl_file_view_iget_named_value(ecl_file_view, INTEHEAD_KW,
+                                       intehead_index, INTEHEAD_DAY_INDEX,
+                                       &day) &&
+        ecl_file_view_iget_named_value(ecl_file_view, INTEHEAD_KW,
+                                       intehead_index, INTEHEAD_MONTH_INDEX,
+                                       &month) &&
+        ecl_file_view_iget_named_value(ecl_file_view, INTEHEAD_KW,
+                                       intehead_index, INTEHEAD_YEAR_INDEX,
+                                       &year))
+        return ecl_util_make_date(day, month, year);
+
+    return -1;
+}
+
+/*
+  Returns the occurence of the first keyword @kw in the block
+  [block_start, block_end) of global indices, or -1.
+*/
+static int ecl_file_view_find_in_block(const ecl_file_view_type *ecl_file_view,
+                                       const char *kw, int block_start,
+                                       int block_end) {
+    const auto index_iter = ecl_file_view->kw_index.find(kw);
+    if (index_iter == ecl_file_view->kw_index.end())
+        return -1;
+
+    {
+        const std::vector<int> &index_list = index_iter->second;
+        auto iter =
+            std::lower_bound(index_list.begin(), index_list.end(), block_start);
+        if (iter == index_list.end() || *iter >= block_end)
+            return -1;
+
+        return iter - index_list.begin();
+    }
+}
+
+/*
+  The values are read with the stream opened, and locked, once for the
+  whole index; if the stream can not be opened the index is empty.
+*/
+static restart_index_type *
+ecl_file_view_alloc_restart_index(const ecl_file_view_type *ecl_file_view) {
+    restart_index_type *restart_index = new restart_index_type();
+    if (!ecl_file_view_open_stream(ecl_file_view, true))
+        return restart_index;
+
+    int num_intehead =
+        ecl_file_view_get_num_named_kw(ecl_file_view, INTEHEAD_KW);
+    int num_seqnum = ecl_file_view_get_num_named_kw(ecl_file_view, SEQNUM_KW);
+    std::vector<time_t> intehead_time(num_intehead);
+
+    for (int i = 0; i < num_intehead; i++) {
+        intehead_time[i] = ecl_file_view_iget_intehead_date(ecl_file_view, i);
+        restart_index->intehead_time.emplace(intehead_time[i], i);
+    }
+
+    for (int seqnum_index = 0; seqnum_index < num_seqnum; seqnum_index++) {
+        const auto &seqnum_list = ecl_file_view->kw_index.at(SEQNUM_KW);
+        int block_start = seqnum_list[seqnum_index];
+        int block_end = (seqnum_index + 1 < num_seqnum)
+                            ? seqnum_list[seqnum_index + 1]
+                            : ecl_file_view_get_size(ecl_file_view);
+        time_t sim_time = -1;
+        double sim_days = -1;
+        double report_step;
+
+        if (ecl_file_view_iget_named_value(ecl_file_view, SEQNUM_KW,
+                                           seqnum_index, 0, &report_step))
+            restart_index->report_step.emplace(report_step, seqnum_index);
+
+        {
+            int intehead_index = ecl_file_view_find_in_block(
+                ecl_file_view, INTEHEAD_KW, block_start, block_end);
+            if (intehead_index >= 0) {
+                sim_time = intehead_time[intehead_index];
+                restart_index->sim_time.emplace(sim_time, seqnum_index);
+            }
+        }
+        {
+            int doubhead_index = ecl_file_view_find_in_block(
+                ecl_file_view, DOUBHEAD_KW, block_start, block_end);
+            if (doubhead_index >= 0)
+                ecl_file_view_iget_named_value(ecl_file_view, DOUBHEAD_KW,
+                                               doubhead_index,
+                                               DOUBHEAD_DAYS_INDEX, &sim_days);
+        }
+
+        restart_index->block_sim_time.push_back(sim_time);
+        restart_index->block_sim_days.push_back(sim_days);
+    }
+
+    ecl_file_view_close_stream(ecl_file_view, true);
+    return restart_index;
+}
+
+/*
+  The restart index is built the first time it is needed, by reading
+  the SEQNUM value and the dates from the INTEHEAD and DOUBHEAD
+  keywords of all the blocks once; the keywords are read without being
+  loaded. Subsequent lookups of report step and simulation time are
+  hash lookups.
+*/
+static const restart_index_type *
+ecl_file_view_get_restart_index(const ecl_file_view_type *ecl_file_view) {
+    std::lock_guard<std::mutex> guard(ecl_file_view->restart_index_lock);
+    if (!ecl_file_view->restart_index)
+        ecl_file_view->restart_index.reset(
+            ecl_file_view_alloc_restart_index(ecl_file_view));
+
+    return ecl_file_view->restart_index.get();
+}
+
+/*
+  Returns the SEQNUM occurence of the block with report step
+  @report_step, or -1.
+*/
+static int
+ecl_file_view_find_report_step(const ecl_file_view_type *ecl_file_view,
+                               int report_step) {
+    if (!ecl_file_view_has_kw(ecl_file_view, SEQNUM_KW))
+        return -1;
+
+    {
+        const restart_index_type *restart_index =
+            ecl_file_view_get_restart_index(ecl_file_view);
+        const auto iter = restart_index->report_step.find(report_step);
+        if (iter == restart_index->report_step.end())
+            return -1;
+
+        return iter->second;
+    }
+}
+
 bool ecl_file_view_has_report_step(const ecl_file_view_type *ecl_file_view,
                                    int report_step) {
-    int global_index =
-        ecl_file_view_find_kw_value(ecl_file_view, SEQNUM_KW, &report_step);
-    if (global_index >= 0)
-        return true;
-    else
-        return false;
+    return ecl_file_view_find_report_step(ecl_file_view, report_step) >= 0;
 }
 
 time_t
 ecl_file_view_iget_restart_sim_date(const ecl_file_view_type *ecl_file_view,
                                     int seqnum_index) {
-    time_t sim_time = -1;
-    ecl_file_view_type *seqnum_map =
-        ecl_file_view_alloc_blockview(ecl_file_view, SEQNUM_KW, seqnum_index);
+    const restart_index_type *restart_index =
+        ecl_file_view_get_restart_index(ecl_file_view);
 
-    if (seqnum_map != NULL) {
-        ecl_kw_type *intehead_kw =
-            ecl_file_view_iget_named_kw(seqnum_map, INTEHEAD_KW, 0);
-        sim_time = ecl_rsthead_date(intehead_kw);
-        ecl_file_view_free(seqnum_map);
-    }
+    if (seqnum_index < 0 ||
+        seqnum_index >= (int)restart_index->block_sim_time.size())
+        return -1;
 
-    return sim_time;
+    return restart_index->block_sim_time[seqnum_index];
 }
 
 double
 ecl_file_view_iget_restart_sim_days(const ecl_file_view_type *ecl_file_view,
                                     int seqnum_index) {
-    double sim_days = 0;
-    ecl_file_view_type *seqnum_map =
-        ecl_file_view_alloc_blockview(ecl_file_view, SEQNUM_KW, seqnum_index);
-
-    if (seqnum_map != NULL) {
-        ecl_kw_type *doubhead_kw =
-            ecl_file_view_iget_named_kw(seqnum_map, DOUBHEAD_KW, 0);
-        sim_days = ecl_kw_iget_double(doubhead_kw, DOUBHEAD_DAYS_INDEX);
-        ecl_file_view_free(seqnum_map);
-    }
+    const restart_index_type *restart_index =
+        ecl_file_view_get_restart_index(ecl_file_view);
 
-    return sim_days;
-}
+    if (seqnum_index < 0 ||
+        seqnum_index >= (int)restart_index->block_sim_days.size())
+        return 0;
 
-int ecl_file_view_find_sim_time(const ecl_file_view_type *ecl_file_view,
-                                time_t sim_time) {
-    int seqnum_index = -1;
-    if (ecl_file_view_has_kw(ecl_file_view, INTEHEAD_KW)) {
-        const auto &intehead_index_list =
-            ecl_file_view->kw_index.at(INTEHEAD_KW);
-        size_t index = 0;
-        while (index < intehead_index_list.size()) {
-            const ecl_kw_type *intehead_kw = ecl_file_view_iget_kw(
-                ecl_file_view, intehead_index_list[index]);
-            if (ecl_rsthead_date(intehead_kw) == sim_time) {
-                seqnum_index = index;
-                break;
-            }
-            index++;
-        }
-    }
-    return seqnum_index;
+    return restart_index->block_sim_days[seqnum_index];
 }
 
 /**
@@ -641,113 +1200,93 @@ int ecl_file_view_find_sim_time(const ecl_file_view_type *ecl_file_view,
    at all, and no INTEHEAD headers can be found.
 
    Observe that the function requires on-the-second-equality; which is
-   of course quite strict.
+   of course quite strict. The dates are looked up in the restart
+   index, see ecl_file_view_get_restart_index().
 
    Each report step only has one occurence of SEQNUM, but one INTEHEAD
    for each LGR; i.e. one should call iselect_rstblock() prior to
    calling this function.
 */
 
-bool ecl_file_view_has_sim_time(const ecl_file_view_type *ecl_file_view,
+int ecl_file_view_find_sim_time(const ecl_file_view_type *ecl_file_view,
                                 time_t sim_time) {
-    int num_INTEHEAD =
-        ecl_file_view_get_num_named_kw(ecl_file_view, INTEHEAD_KW);
-    if (num_INTEHEAD == 0)
-        return false; /* We have no INTEHEAD headers - probably not a restart file at all. */
-    else {
-        int intehead_index = 0;
-        while (true) {
-            time_t itime = ecl_file_view_iget_restart_sim_date(ecl_file_view,
-                                                               intehead_index);
-
-            if (itime == sim_time) /* Perfect hit. */
-                return true;
-
-            if (itime >
-                sim_time) /* We have gone past the target_time - i.e. we do not have it. */
-                return false;
-
-            intehead_index++;
-            if (intehead_index ==
-                num_INTEHEAD) /* We have iterated through the whole thing without finding sim_time. */
-                return false;
-        }
-    }
-}
-
-bool ecl_file_view_has_sim_days(const ecl_file_view_type *ecl_file_view,
-                                double sim_days) {
-    int num_DOUBHEAD =
-        ecl_file_view_get_num_named_kw(ecl_file_view, DOUBHEAD_KW);
-    if (num_DOUBHEAD == 0)
-        return false; /* We have no DOUBHEAD headers - probably not a restart file at all. */
-    else {
-        int doubhead_index = 0;
-        while (true) {
-            double file_sim_days = ecl_file_view_iget_restart_sim_days(
-                ecl_file_view, doubhead_index);
+    if (!ecl_file_view_has_kw(ecl_file_view, INTEHEAD_KW))
+        return -1;
 
-            if (util_double_approx_equal(sim_days,
-                                         file_sim_days)) /* Perfect hit. */
-                return true;
-
-            if (file_sim_days >
-                sim_days) /* We have gone past the target_time - i.e. we do not have it. */
-                return false;
+    {
+        const restart_index_type *restart_index =
+            ecl_file_view_get_restart_index(ecl_file_view);
+        const auto iter = restart_index->intehead_time.find(sim_time);
+        if (iter == restart_index->intehead_time.end())
+            return -1;
 
-            doubhead_index++;
-            if (doubhead_index ==
-                num_DOUBHEAD) /* We have iterated through the whole thing without finding sim_time. */
-                return false;
-        }
+        return iter->second;
     }
 }
 
 int ecl_file_view_seqnum_index_from_sim_time(ecl_file_view_type *parent_map,
                                              time_t sim_time) {
-    int num_seqnum = ecl_file_view_get_num_named_kw(parent_map, SEQNUM_KW);
-    ecl_file_view_type *seqnum_map;
+    if (!ecl_file_view_has_kw(parent_map, SEQNUM_KW))
+        return -1;
 
-    for (int s_idx = 0; s_idx < num_seqnum; s_idx++) {
-        seqnum_map =
-            ecl_file_view_alloc_blockview(parent_map, SEQNUM_KW, s_idx);
-
-        if (!seqnum_map)
-            continue;
+    {
+        const restart_index_type *restart_index =
+            ecl_file_view_get_restart_index(parent_map);
+        const auto iter = restart_index->sim_time.find(sim_time);
+        if (iter == restart_index->sim_time.end())
+            return -1;
 
-        bool sim = ecl_file_view_has_sim_time(seqnum_map, sim_time);
-        ecl_file_view_free(seqnum_map);
-        if (sim)
-            return s_idx;
+        return iter->second;
     }
-    return -1;
 }
 
+/*
+  The simulation days are compared approximately, so they are searched
+  linearly; the values are however held by the restart index, so no
+  keywords are read.
+*/
 int ecl_file_view_seqnum_index_from_sim_days(ecl_file_view_type *file_view,
                                              double sim_days) {
-    int num_seqnum = ecl_file_view_get_num_named_kw(file_view, SEQNUM_KW);
-    int seqnum_index = 0;
-    ecl_file_view_type *seqnum_map;
-
-    while (true) {
-        seqnum_map =
-            ecl_file_view_alloc_blockview(file_view, SEQNUM_KW, seqnum_index);
-
-        if (seqnum_map != NULL) {
-            if (ecl_file_view_has_sim_days(seqnum_map, sim_days)) {
-                ecl_file_view_free(seqnum_map);
-                return seqnum_index;
-            } else {
-                ecl_file_view_free(seqnum_map);
-                seqnum_index++;
-            }
-        }
+    if (!ecl_file_view_has_kw(file_view, SEQNUM_KW))
+        return -1;
 
-        if (num_seqnum == seqnum_index)
-            return -1;
+    {
+        const restart_index_type *restart_index =
+            ecl_file_view_get_restart_index(file_view);
+        const std::vector<double> &block_sim_days =
+            restart_index->block_sim_days;
+
+        for (size_t i = 0; i < block_sim_days.size(); i++) {
+            if (block_sim_days[i] >= 0 &&
+                util_double_approx_equal(sim_days, block_sim_days[i]))
+                return i;
+        }
+        return -1;
     }
 }
 
+bool ecl_file_view_has_sim_time(const ecl_file_view_type *ecl_file_view,
+                                time_t sim_time) {
+    return ecl_file_view_seqnum_index_from_sim_time(
+               (ecl_file_view_type *)ecl_file_view, sim_time) >= 0;
+}
+
+bool ecl_file_view_has_sim_days(const ecl_file_view_type *ecl_file_view,
+                                double sim_days) {
+    return ecl_file_view_seqnum_index_from_sim_days(
+               (ecl_file_view_type *)ecl_file_view, sim_days) >= 0;
+}
+
+/*
+  Returns the SEQNUM occurence, i.e. the argument to
+  ecl_file_view_add_blockview(), of the block with report step
+  @report_step; or -1 if the report step is not in the view.
+*/
+int ecl_file_view_seqnum_index_from_report_step(
+    const ecl_file_view_type *ecl_file_view, int report_step) {
+    return ecl_file_view_find_report_step(ecl_file_view, report_step);
+}
+
 /*
   Will mulitplex on the four input arguments.
 */
@@ -760,13 +1299,9 @@ ecl_file_view_add_restart_view(ecl_file_view_type *file_view, int input_index,
 
     if (input_index >= 0)
         seqnum_index = input_index;
-    else if (report_step >= 0) {
-        int global_index =
-            ecl_file_view_find_kw_value(file_view, SEQNUM_KW, &report_step);
-        if (global_index >= 0)
-            seqnum_index =
-                ecl_file_view_iget_occurence(file_view, global_index);
-    } else if (sim_time != -1)
+    else if (report_step >= 0)
+        seqnum_index = ecl_file_view_find_report_step(file_view, report_step);
+    else if (sim_time != -1)
         seqnum_index =
             ecl_file_view_seqnum_index_from_sim_time(file_view, sim_time);
     else if (sim_days >= 0)
@@ -849,7 +1384,7 @@ void ecl_file_view_end_transaction(ecl_file_view_type *file_view,
     const int *ref_count = transaction->ref_count;
     for (int i = 0; i < ecl_file_view_get_size(file_view); i++) {
         ecl_file_kw_type *file_kw = ecl_file_view_iget_file_kw(file_view, i);
-        ecl_file_kw_end_transaction(file_kw, ref_count[i]);
+        ecl_file_kw_end_transaction(file_kw, file_view->inv_map, ref_count[i]);
     }
     free(transaction->ref_count);
     free(transaction);
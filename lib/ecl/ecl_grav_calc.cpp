@@ -75,17 +75,17 @@ ecl_grav_phase_deltag(double utm_x, double utm_y, double tvd,
     double deltag = 0;
     const int *aquifern = NULL;
 
-    const float *rho1 = ecl_kw_get_float_ptr(rho1_kw);
-    const float *rho2 = ecl_kw_get_float_ptr(rho2_kw);
-    const float *sat1 = ecl_kw_get_float_ptr(sat1_kw);
-    const float *sat2 = ecl_kw_get_float_ptr(sat2_kw);
-    const float *porv1 = ecl_kw_get_float_ptr(porv1_kw);
-    const float *porv2 = ecl_kw_get_float_ptr(porv2_kw);
+    const float *rho1 = ecl_kw_get_const_float_ptr(rho1_kw);
+    const float *rho2 = ecl_kw_get_const_float_ptr(rho2_kw);
+    const float *sat1 = ecl_kw_get_const_float_ptr(sat1_kw);
+    const float *sat2 = ecl_kw_get_const_float_ptr(sat2_kw);
+    const float *porv1 = ecl_kw_get_const_float_ptr(porv1_kw);
+    const float *porv2 = ecl_kw_get_const_float_ptr(porv2_kw);
 
     if (ecl_file_has_kw(init_file, "AQUIFERN")) {
         const ecl_kw_type *aquifern_kw =
             ecl_file_iget_named_kw(init_file, "AQUIFERN", 0);
-        aquifern = ecl_kw_get_int_ptr(aquifern_kw);
+        aquifern = ecl_kw_get_const_int_ptr(aquifern_kw);
     }
 
     {
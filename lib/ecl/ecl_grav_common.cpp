@@ -28,7 +28,7 @@ bool *ecl_grav_common_alloc_aquifer_cell(const ecl::ecl_grid_cache &grid_cache,
     if (ecl_file_has_kw(init_file, AQUIFER_KW)) {
         ecl_kw_type *aquifer_kw =
             ecl_file_iget_named_kw(init_file, AQUIFER_KW, 0);
-        const int *aquifer_data = ecl_kw_get_int_ptr(aquifer_kw);
+        const int *aquifer_data = ecl_kw_get_const_int_ptr(aquifer_kw);
 
         for (int active_index = 0; active_index < grid_cache.size();
              active_index++) {
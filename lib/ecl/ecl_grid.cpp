@@ -2635,7 +2635,7 @@ ecl_grid_type *ecl_grid_alloc_GRDECL_data(int nx, int ny, int nz,
 } // namespace ecl
 
 const float *ecl_grid_get_mapaxes_from_kw__(const ecl_kw_type *mapaxes_kw) {
-    const float *mapaxes_data = ecl_kw_get_float_ptr(mapaxes_kw);
+    const float *mapaxes_data = ecl_kw_get_const_float_ptr(mapaxes_kw);
 
     float x1 = mapaxes_data[2];
     float y1 = mapaxes_data[3];
@@ -2690,14 +2690,15 @@ ecl_grid_alloc_GRDECL_kw__(ecl_grid_type *global_grid, int dualp_flag,
             mapaxes_data = ecl_grid_get_mapaxes_from_kw__(mapaxes_kw);
 
         if (corsnum_kw)
-            corsnum_data = ecl_kw_get_int_ptr(corsnum_kw);
+            corsnum_data = ecl_kw_get_const_int_ptr(corsnum_kw);
 
         if (gridunit_kw)
             unit_system = ecl_grid_check_unit_system(gridunit_kw);
 
         return ecl_grid_alloc_GRDECL_data__(
             global_grid, unit_system, dualp_flag, apply_mapaxes, nx, ny, nz,
-            ecl_kw_get_float_ptr(zcorn_kw), ecl_kw_get_float_ptr(coord_kw),
+            ecl_kw_get_const_float_ptr(zcorn_kw),
+            ecl_kw_get_const_float_ptr(coord_kw),
             actnum_data, mapaxes_data, corsnum_data, lgr_nr);
     }
 }
@@ -2717,7 +2718,7 @@ ecl_grid_alloc_GRDECL_kw(int nx, int ny, int nz, const ecl_kw_type *zcorn_kw,
 
     const int *actnum_data = NULL;
     if (actnum_kw)
-        actnum_data = ecl_kw_get_int_ptr(actnum_kw);
+        actnum_data = ecl_kw_get_const_int_ptr(actnum_kw);
 
     bool apply_mapaxes = true;
     ecl_kw_type *gridhead_kw = ecl_grid_alloc_gridhead_kw(nx, ny, nz, 0);
@@ -2990,7 +2991,7 @@ static ecl_grid_type *ecl_grid_alloc_EGRID__(ecl_grid_type *main_grid,
     else {
         if (ecl_file_get_num_named_kw(ecl_file, ACTNUM_KW) > grid_nr) {
             actnum_kw = ecl_file_iget_named_kw(ecl_file, ACTNUM_KW, grid_nr);
-            actnum_data = ecl_kw_get_int_ptr(actnum_kw);
+            actnum_data = ecl_kw_get_const_int_ptr(actnum_kw);
         }
     }
 
@@ -3056,8 +3057,9 @@ static ecl_grid_type *ecl_grid_alloc_EGRID_all_grids(const char *grid_file,
                         host_grid =
                             ecl_grid_get_lgr(main_grid, lgr_grid->parent_name);
 
-                    ecl_grid_install_lgr_EGRID(host_grid, lgr_grid,
-                                               ecl_kw_get_int_ptr(hostnum_kw));
+                    ecl_grid_install_lgr_EGRID(
+                        host_grid, lgr_grid,
+                        ecl_kw_get_const_int_ptr(hostnum_kw));
                 }
             }
             main_grid->name = util_alloc_string_copy(grid_file);
@@ -3,10 +3,20 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
 
+#include <atomic>
+#include <charconv>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ert/util/build_config.h>
 #include <ert/util/util.h>
 #include <ert/util/buffer.hpp>
 #include <ert/util/int_vector.hpp>
+#include <ert/util/util_codec.h>
 
 #include <ert/ecl/ecl_kw_magic.hpp>
 #include <ert/ecl/ecl_kw.hpp>
@@ -16,6 +26,8 @@
 
 #define ECL_KW_TYPE_ID 6111098
 
+typedef struct ecl_kw_cow_struct ecl_kw_cow_type;
+
 struct ecl_kw_struct {
     UTIL_TYPE_ID_DECLARATION;
     int size;
@@ -25,6 +37,12 @@ struct ecl_kw_struct {
     char *header;     /* Header which is trimmed to no-space. */
     char *data;       /* The actual data vector. */
     bool shared_data; /* Whether this keyword has shared data or not. */
+    bool mapped; /* Set when data points into a read only file mapping. */
+    char *zdata;  /* Compressed data; when this is set data is NULL. */
+    size_t zsize; /* Size of the compressed data in bytes. */
+    util_codec_enum codec; /* The codec used for zdata. */
+    ecl_kw_cow_type *cow;  /* Set when data is shared copy-on-write. */
+    bool modified; /* Set when the data has been accessed for writing. */
 };
 
 UTIL_IS_INSTANCE_FUNCTION(ecl_kw, ECL_KW_TYPE_ID)
@@ -59,31 +77,22 @@ UTIL_IS_INSTANCE_FUNCTION(ecl_kw, ECL_KW_TYPE_ID)
 /* Format string used when writing a formatted header. */
 #define WRITE_HEADER_FMT " '%-8s' %11d '%-4s'\n"
 
-/* Format string used when reading and writing formatted
-   files. Observe the following about these format strings:
+/* Format string used when writing formatted files. Observe the
+   following about these format strings:
 
-    1. The format string for reading double contains two '%'
-       identifiers, that is because doubles are read by parsing a
-       prefix and power separately.
-
-    2. For both double and float the write format contains two '%'
+    1. For both double and float the write format contains two '%'
        characters - that is because the values are split in a prefix
        and a power prior to writing - see the function
-       __fprintf_scientific().
+       __split_scientific().
 
-    3. The logical type involves converting back and forth between 'T'
+    2. The logical type involves converting back and forth between 'T'
        and 'F' and internal logical representation. The format strings
-       are therefore for reading/writing a character.
+       are therefore for writing a character.
 
+   Formatted files are read with the tokenizer in
+   ecl_kw_fread_fmt_data().
 */
 
-#define READ_FMT_CHAR "%8c"
-#define READ_FMT_FLOAT "%gE"
-#define READ_FMT_INT "%d"
-#define READ_FMT_MESS "%8c"
-#define READ_FMT_BOOL "  %c"
-#define READ_FMT_DOUBLE "%lgD%d"
-
 #define WRITE_FMT_CHAR " '%-8s'"
 #define WRITE_FMT_INT " %11d"
 #define WRITE_FMT_FLOAT "  %11.8fE%+03d"
@@ -119,33 +128,6 @@ UTIL_IS_INSTANCE_FUNCTION(ecl_kw, ECL_KW_TYPE_ID)
 ecl_type_enum ecl_kw_get_type(const ecl_kw_type *);
 void ecl_kw_set_data_type(ecl_kw_type *ecl_kw, ecl_data_type data_type);
 
-static char *alloc_read_fmt_string(const ecl_data_type ecl_type) {
-    return util_alloc_sprintf("%%%dc", ecl_type_get_sizeof_iotype(ecl_type));
-}
-
-static char *alloc_read_fmt(const ecl_data_type data_type) {
-    switch (ecl_type_get_type(data_type)) {
-    case (ECL_CHAR_TYPE):
-        return util_alloc_string_copy(READ_FMT_CHAR);
-    case (ECL_INT_TYPE):
-        return util_alloc_string_copy(READ_FMT_INT);
-    case (ECL_FLOAT_TYPE):
-        return util_alloc_string_copy(READ_FMT_FLOAT);
-    case (ECL_DOUBLE_TYPE):
-        return util_alloc_string_copy(READ_FMT_DOUBLE);
-    case (ECL_BOOL_TYPE):
-        return util_alloc_string_copy(READ_FMT_BOOL);
-    case (ECL_MESS_TYPE):
-        return util_alloc_string_copy(READ_FMT_MESS);
-    case (ECL_STRING_TYPE):
-        return alloc_read_fmt_string(data_type);
-    default:
-        util_abort("%s: invalid ecl_type:%s \n", __func__,
-                   ecl_type_alloc_name(data_type));
-        return NULL;
-    }
-}
-
 static char *alloc_write_fmt_string(const ecl_data_type ecl_type) {
     return util_alloc_sprintf(" '%%-%ds'",
                               ecl_type_get_sizeof_iotype(ecl_type));
@@ -181,6 +163,100 @@ static int get_blocksize(ecl_data_type data_type) {
     return BLOCKSIZE_NUMERIC;
 }
 
+/*
+  The number of elements in a keyword is limited to INT_MAX, but the
+  corresponding number of bytes can easily be larger than that; byte
+  sizes and offsets must therefore always be calculated as size_t.
+*/
+
+static size_t ecl_kw_ctype_byte_size(const ecl_kw_type *ecl_kw) {
+    return (size_t)ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+}
+
+/*
+  All access to the data vector goes through ecl_kw_data(), which will
+  decompress the data if the keyword has been compressed with
+  ecl_kw_compress(). Decompressing changes the keyword, also when it
+  is accessed through a const pointer. Code which modifies the data
+  must use ecl_kw_mutable_data(), which in addition gives the keyword
+  a private copy of data which is shared copy-on-write, see
+  ecl_kw_alloc_cow_copy(), or which points into a file mapping, see
+  ecl_kw_fread_alloc_mmap(), and marks the keyword as modified, see
+  ecl_kw_is_modified().
+*/
+
+static void ecl_kw_decompress(const ecl_kw_type *ecl_kw) {
+    ecl_kw_type *kw = (ecl_kw_type *)ecl_kw;
+    size_t byte_size = ecl_kw_ctype_byte_size(kw);
+    char *data = (char *)util_malloc(byte_size);
+
+    if (!util_codec_decompress(kw->codec,
+                               ecl_type_get_sizeof_ctype(kw->data_type),
+                               kw->zdata, kw->zsize, data, byte_size))
+        util_abort("%s: failed to decompress keyword:%s \n", __func__,
+                   kw->header);
+
+    free(kw->zdata);
+    kw->zdata = NULL;
+    kw->zsize = 0;
+    kw->data = data;
+}
+
+static inline const char *ecl_kw_data(const ecl_kw_type *ecl_kw) {
+    if (ecl_kw->zdata)
+        ecl_kw_decompress(ecl_kw);
+    return ecl_kw->data;
+}
+
+/*
+  Data shared copy-on-write is owned by the ecl_kw_cow instance, and
+  freed when the last keyword sharing it releases it.
+*/
+
+struct ecl_kw_cow_struct {
+    std::atomic<int> ref_count;
+    char *data;
+};
+
+static void ecl_kw_release_cow(ecl_kw_type *ecl_kw) {
+    if (ecl_kw->cow) {
+        if (--ecl_kw->cow->ref_count == 0) {
+            free(ecl_kw->cow->data);
+            delete ecl_kw->cow;
+        }
+        ecl_kw->cow = NULL;
+        ecl_kw->data = NULL;
+    }
+}
+
+static char *ecl_kw_mutable_data(const ecl_kw_type *ecl_kw) {
+    ecl_kw_type *kw = (ecl_kw_type *)ecl_kw;
+    const char *data = ecl_kw_data(kw);
+
+    kw->modified = true;
+    if (kw->mapped) {
+        kw->data = (char *)util_alloc_copy(data, ecl_kw_ctype_byte_size(kw));
+        kw->shared_data = false;
+        kw->mapped = false;
+    } else if (kw->cow) {
+        if (kw->cow->ref_count == 1) {
+            delete kw->cow;
+            kw->cow = NULL;
+        } else {
+            char *copy =
+                (char *)util_alloc_copy(data, ecl_kw_ctype_byte_size(kw));
+            ecl_kw_release_cow(kw);
+            kw->data = copy;
+        }
+    }
+    return kw->data;
+}
+
+static size_t ecl_kw_iotype_byte_size(const ecl_kw_type *ecl_kw) {
+    return (size_t)ecl_kw->size *
+           ecl_type_get_sizeof_iotype(ecl_kw->data_type);
+}
+
 static int get_columns(const ecl_data_type data_type) {
     switch (ecl_type_get_type(data_type)) {
     case (ECL_CHAR_TYPE):
@@ -216,10 +292,11 @@ static char *ecl_kw_alloc_output_buffer(const ecl_kw_type *ecl_kw) {
     size_t sizeof_iotype = ecl_type_get_sizeof_iotype(ecl_kw->data_type);
     size_t buffer_size = ecl_kw->size * sizeof_iotype;
     char *buffer = (char *)util_malloc(buffer_size);
+    const char *data = ecl_kw_data(ecl_kw);
 
     if (ecl_type_is_bool(ecl_kw->data_type)) {
         int *int_data = (int *)buffer;
-        bool *bool_data = (bool *)ecl_kw->data;
+        const bool *bool_data = (const bool *)data;
 
         for (int i = 0; i < ecl_kw->size; i++)
             if (bool_data[i])
@@ -237,10 +314,10 @@ static char *ecl_kw_alloc_output_buffer(const ecl_kw_type *ecl_kw) {
         for (int i = 0; i < ecl_kw->size; i++) {
             size_t buffer_offset = i * sizeof_iotype;
             size_t data_offset = i * sizeof_ctype;
-            size_t string_length = strlen(&ecl_kw->data[data_offset]);
+            size_t string_length = strlen(&data[data_offset]);
 
             for (size_t i = 0; i < string_length; i++)
-                buffer[buffer_offset + i] = ecl_kw->data[data_offset + i];
+                buffer[buffer_offset + i] = data[data_offset + i];
 
             // Pad with spaces
             for (size_t i = string_length; i < sizeof_iotype; i++)
@@ -253,8 +330,8 @@ static char *ecl_kw_alloc_output_buffer(const ecl_kw_type *ecl_kw) {
     if (ecl_type_is_mess(ecl_kw->data_type))
         return buffer;
 
-    if (ecl_kw->data) {
-        memcpy(buffer, ecl_kw->data, buffer_size);
+    if (data) {
+        memcpy(buffer, data, buffer_size);
         util_endian_flip_vector(buffer, sizeof_iotype, ecl_kw->size);
     }
 
@@ -262,8 +339,7 @@ static char *ecl_kw_alloc_output_buffer(const ecl_kw_type *ecl_kw) {
 }
 
 static char *ecl_kw_alloc_input_buffer(const ecl_kw_type *ecl_kw) {
-    size_t buffer_size =
-        ecl_kw->size * ecl_type_get_sizeof_iotype(ecl_kw->data_type);
+    size_t buffer_size = ecl_kw_iotype_byte_size(ecl_kw);
     char *buffer = (char *)util_malloc(buffer_size);
 
     return buffer;
@@ -284,7 +360,7 @@ static void ecl_kw_load_from_input_buffer(ecl_kw_type *ecl_kw, char *buffer) {
   */
     if (ecl_type_is_bool(ecl_kw->data_type)) {
         int *int_data = (int *)buffer;
-        bool *bool_data = (bool *)ecl_kw->data;
+        bool *bool_data = (bool *)ecl_kw_mutable_data(ecl_kw);
 
         for (int i = 0; i < ecl_kw->size; i++) {
             if (int_data[i] == ECL_BOOL_TRUE_INT)
@@ -303,12 +379,12 @@ static void ecl_kw_load_from_input_buffer(ecl_kw_type *ecl_kw, char *buffer) {
     if (ecl_type_is_char(ecl_kw->data_type) ||
         ecl_type_is_string(ecl_kw->data_type)) {
         const char null_char = '\0';
+        char *data = ecl_kw_mutable_data(ecl_kw);
         for (int i = 0; i < ecl_kw->size; i++) {
             size_t buffer_offset = i * sizeof_iotype;
             size_t data_offset = i * sizeof_ctype;
-            memcpy(&ecl_kw->data[data_offset], &buffer[buffer_offset],
-                   sizeof_iotype);
-            ecl_kw->data[data_offset + sizeof_iotype] = null_char;
+            memcpy(&data[data_offset], &buffer[buffer_offset], sizeof_iotype);
+            data[data_offset + sizeof_iotype] = null_char;
         }
         return;
     }
@@ -319,7 +395,7 @@ static void ecl_kw_load_from_input_buffer(ecl_kw_type *ecl_kw, char *buffer) {
     /*
     Plain int, double, float data - that can be copied straight over to the ->data field.
   */
-    memcpy(ecl_kw->data, buffer, buffer_size);
+    memcpy(ecl_kw_mutable_data(ecl_kw), buffer, buffer_size);
 }
 
 const char *ecl_kw_get_header8(const ecl_kw_type *ecl_kw) {
@@ -338,8 +414,7 @@ bool ecl_kw_name_equal(const ecl_kw_type *ecl_kw, const char *name) {
 }
 
 void ecl_kw_get_memcpy_data(const ecl_kw_type *ecl_kw, void *target) {
-    memcpy(target, ecl_kw->data,
-           ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
+    memcpy(target, ecl_kw_data(ecl_kw), ecl_kw_ctype_byte_size(ecl_kw));
 }
 
 void ecl_kw_get_memcpy_int_data(const ecl_kw_type *ecl_kw, int *target) {
@@ -359,16 +434,15 @@ void ecl_kw_get_memcpy_double_data(const ecl_kw_type *ecl_kw, double *target) {
 
 /** Allocates a untyped buffer with exactly the same content as the ecl_kw instances data. */
 void *ecl_kw_alloc_data_copy(const ecl_kw_type *ecl_kw) {
-    void *buffer = util_alloc_copy(
-        ecl_kw->data,
-        ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
+    void *buffer =
+        util_alloc_copy(ecl_kw_data(ecl_kw), ecl_kw_ctype_byte_size(ecl_kw));
     return buffer;
 }
 
 void ecl_kw_set_memcpy_data(ecl_kw_type *ecl_kw, const void *src) {
     if (src != NULL)
-        memcpy(ecl_kw->data, src,
-               ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
+        memcpy(ecl_kw_mutable_data(ecl_kw), src,
+               ecl_kw_ctype_byte_size(ecl_kw));
 }
 
 static bool ecl_kw_string_eq(const char *s1, const char *s2) {
@@ -420,7 +494,7 @@ bool ecl_kw_header_eq(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2) {
 static bool ecl_kw_data_equal__(const ecl_kw_type *ecl_kw, const void *data,
                                 int cmp_elements) {
     int cmp =
-        memcmp(ecl_kw->data, data,
+        memcmp(ecl_kw_data(ecl_kw), data,
                cmp_elements * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
     if (cmp == 0)
         return true;
@@ -440,7 +514,8 @@ bool ecl_kw_data_equal(const ecl_kw_type *ecl_kw, const void *data) {
 bool ecl_kw_content_equal(const ecl_kw_type *ecl_kw1,
                           const ecl_kw_type *ecl_kw2) {
     if (ecl_kw_size_and_type_equal(ecl_kw1, ecl_kw2))
-        return ecl_kw_data_equal__(ecl_kw1, ecl_kw2->data, ecl_kw1->size);
+        return ecl_kw_data_equal__(ecl_kw1, ecl_kw_data(ecl_kw2),
+                                   ecl_kw1->size);
     else
         return false;
 }
@@ -452,7 +527,7 @@ bool ecl_kw_content_equal(const ecl_kw_type *ecl_kw1,
 bool ecl_kw_equal(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2) {
     bool equal = ecl_kw_header_eq(ecl_kw1, ecl_kw2);
     if (equal)
-        equal = ecl_kw_data_equal(ecl_kw1, ecl_kw2->data);
+        equal = ecl_kw_data_equal(ecl_kw1, ecl_kw_data(ecl_kw2));
 
     return equal;
 }
@@ -464,8 +539,8 @@ bool ecl_kw_equal(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2) {
         int index;                                                             \
         bool equal = true;                                                     \
         {                                                                      \
-            const ctype *data1 = (const ctype *)ecl_kw1->data;                 \
-            const ctype *data2 = (const ctype *)ecl_kw2->data;                 \
+            const ctype *data1 = (const ctype *)ecl_kw_data(ecl_kw1);          \
+            const ctype *data2 = (const ctype *)ecl_kw_data(ecl_kw2);          \
             for (index = 0; index < ecl_kw1->size; index++) {                  \
                 equal = util_##ctype##_approx_equal__(                         \
                     data1[index], data2[index], rel_diff, abs_diff);           \
@@ -498,7 +573,7 @@ bool ecl_kw_numeric_equal(const ecl_kw_type *ecl_kw1,
         return ecl_kw_numeric_equal_double(ecl_kw1, ecl_kw2, abs_diff,
                                            rel_diff);
     else
-        return ecl_kw_data_equal(ecl_kw1, ecl_kw2->data);
+        return ecl_kw_data_equal(ecl_kw1, ecl_kw_data(ecl_kw2));
 }
 
 bool ecl_kw_block_equal(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2,
@@ -507,7 +582,7 @@ bool ecl_kw_block_equal(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2,
         if (cmp_elements == 0)
             cmp_elements = ecl_kw1->size;
 
-        return ecl_kw_data_equal__(ecl_kw1, ecl_kw2->data, cmp_elements);
+        return ecl_kw_data_equal__(ecl_kw1, ecl_kw_data(ecl_kw2), cmp_elements);
     } else
         return false;
 }
@@ -521,6 +596,13 @@ static void ecl_kw_set_shared_ref(ecl_kw_type *ecl_kw, void *data_ptr) {
     }
     ecl_kw->shared_data = true;
     ecl_kw->data = (char *)data_ptr;
+    ecl_kw->modified = true;
+}
+
+static void ecl_kw_set_mapped_ref(ecl_kw_type *ecl_kw, const char *data) {
+    ecl_kw->shared_data = true;
+    ecl_kw->mapped = true;
+    ecl_kw->data = (char *)data;
 }
 
 static void ecl_kw_initialize(ecl_kw_type *ecl_kw, const char *header, int size,
@@ -530,14 +612,21 @@ static void ecl_kw_initialize(ecl_kw_type *ecl_kw, const char *header, int size,
     ecl_kw->size = size;
 }
 
-static size_t ecl_kw_fortio_data_size(const ecl_kw_type *ecl_kw) {
-    const int blocksize = get_blocksize(ecl_kw->data_type);
-    const int num_blocks =
-        ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+static size_t ecl_kw_fortio_data_size(ecl_data_type data_type, int size) {
+    const int blocksize = get_blocksize(data_type);
+    const int num_blocks = size / blocksize + (size % blocksize == 0 ? 0 : 1);
 
     return num_blocks * (4 + 4) + // Fortran fluff for each block
-           ecl_kw->size *
-               ecl_type_get_sizeof_iotype(ecl_kw->data_type); // Actual data
+           (size_t)size * ecl_type_get_sizeof_iotype(data_type); // Actual data
+}
+
+/**
+   Returns the number of bytes a keyword with @size elements of type
+   @data_type occupies in a BINARY file, including the header.
+*/
+
+size_t ecl_kw_fortio_size__(ecl_data_type data_type, int size) {
+    return ECL_KW_HEADER_FORTIO_SIZE + ecl_kw_fortio_data_size(data_type, size);
 }
 
 /**
@@ -547,9 +636,7 @@ static size_t ecl_kw_fortio_data_size(const ecl_kw_type *ecl_kw) {
 */
 
 size_t ecl_kw_fortio_size(const ecl_kw_type *ecl_kw) {
-    size_t size = ECL_KW_HEADER_FORTIO_SIZE;
-    size += ecl_kw_fortio_data_size(ecl_kw);
-    return size;
+    return ecl_kw_fortio_size__(ecl_kw->data_type, ecl_kw->size);
 }
 
 /**
@@ -595,6 +682,12 @@ ecl_kw_type *ecl_kw_alloc_empty() {
     ecl_kw->header8 = NULL;
     ecl_kw->data = NULL;
     ecl_kw->shared_data = false;
+    ecl_kw->mapped = false;
+    ecl_kw->zdata = NULL;
+    ecl_kw->zsize = 0;
+    ecl_kw->codec = UTIL_CODEC_NONE;
+    ecl_kw->cow = NULL;
+    ecl_kw->modified = false;
     ecl_kw->size = 0;
 
     UTIL_TYPE_ID_INIT(ecl_kw, ECL_KW_TYPE_ID);
@@ -617,8 +710,8 @@ void ecl_kw_memcpy_data(ecl_kw_type *target, const ecl_kw_type *src) {
     if (!ecl_kw_size_and_type_equal(target, src))
         util_abort("%s: type/size mismatch \n", __func__);
 
-    memcpy(target->data, src->data,
-           target->size * ecl_type_get_sizeof_ctype(target->data_type));
+    memcpy(ecl_kw_mutable_data(target), ecl_kw_data(src),
+           ecl_kw_ctype_byte_size(target));
 }
 
 void ecl_kw_memcpy(ecl_kw_type *target, const ecl_kw_type *src) {
@@ -637,6 +730,52 @@ ecl_kw_type *ecl_kw_alloc_copy(const ecl_kw_type *src) {
     return new_;
 }
 
+/**
+   Allocates a copy of @src which shares the data with @src
+   copy-on-write: the data is not copied until one of the keywords is
+   modified, then the modified keyword gets a private copy of the data.
+   Functions which return a mutable pointer to the data, like
+   ecl_kw_get_ptr() and ecl_kw_iget_ptr(), count as modifications; use
+   e.g. ecl_kw_get_const_ptr() for read only access. If @src has shared
+   storage, see ecl_kw_alloc_new_shared(), the data is copied.
+
+   The keywords sharing data can be used and freed independently, also
+   from different threads; a single keyword should still only be used
+   by one thread at a time when it is modified. Observe that creating
+   the copy updates the bookkeeping of @src, so @src must not be used
+   by other threads while the copy is allocated.
+*/
+ecl_kw_type *ecl_kw_alloc_cow_copy(const ecl_kw_type *src) {
+    ecl_kw_type *kw = (ecl_kw_type *)src;
+    const char *data = ecl_kw_data(kw);
+
+    if (kw->shared_data || data == NULL)
+        return ecl_kw_alloc_copy(src);
+
+    if (!kw->cow) {
+        kw->cow = new ecl_kw_cow_type();
+        kw->cow->ref_count = 1;
+        kw->cow->data = kw->data;
+    }
+
+    {
+        ecl_kw_type *new_kw = ecl_kw_alloc_empty();
+        ecl_kw_initialize(new_kw, src->header, src->size, src->data_type);
+        kw->cow->ref_count++;
+        new_kw->cow = kw->cow;
+        new_kw->data = kw->cow->data;
+        return new_kw;
+    }
+}
+
+/**
+   Returns true if the data of the keyword is currently shared
+   copy-on-write with other keywords, see ecl_kw_alloc_cow_copy().
+*/
+bool ecl_kw_is_cow_shared(const ecl_kw_type *ecl_kw) {
+    return ecl_kw->cow != NULL && ecl_kw->cow->ref_count > 1;
+}
+
 /**
    This function will allocate a new copy of @src, where only the
    elements corresponding to the slice [index1:index2) is included.
@@ -681,9 +820,9 @@ ecl_kw_type *ecl_kw_alloc_slice_copy(const ecl_kw_type *src, int index1,
                 src_index = index1;
                 {
                     int target_index = 0;
-                    const char *src_ptr = src->data;
-                    char *new_ptr = new_kw->data;
-                    int sizeof_ctype =
+                    const char *src_ptr = ecl_kw_data(src);
+                    char *new_ptr = ecl_kw_mutable_data(new_kw);
+                    size_t sizeof_ctype =
                         ecl_type_get_sizeof_ctype(new_kw->data_type);
 
                     while (src_index < index2) {
@@ -707,12 +846,12 @@ void ecl_kw_resize(ecl_kw_type *ecl_kw, int new_size) {
                    __func__);
 
     if (new_size != ecl_kw->size) {
-        size_t old_byte_size =
-            ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+        size_t old_byte_size = ecl_kw_ctype_byte_size(ecl_kw);
         size_t new_byte_size =
-            new_size * ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+            (size_t)new_size * ecl_type_get_sizeof_ctype(ecl_kw->data_type);
 
-        ecl_kw->data = (char *)util_realloc(ecl_kw->data, new_byte_size);
+        char *data = ecl_kw_mutable_data(ecl_kw);
+        ecl_kw->data = (char *)util_realloc(data, new_byte_size);
         if (new_byte_size > old_byte_size) {
             size_t offset = old_byte_size;
             memset(&ecl_kw->data[offset], 0, new_byte_size - old_byte_size);
@@ -721,6 +860,12 @@ void ecl_kw_resize(ecl_kw_type *ecl_kw, int new_size) {
     }
 }
 
+static const void *ecl_kw_iget_ptr_static(const ecl_kw_type *ecl_kw, int i) {
+    ecl_kw_assert_index(ecl_kw, i, __func__);
+    return &ecl_kw_data(ecl_kw)[(size_t)i *
+                         ecl_type_get_sizeof_ctype(ecl_kw->data_type)];
+}
+
 /**
    Will allocate a copy of the src_kw. Will copy @count elements
    starting at @offset. If @count < 0 all remaining elements from
@@ -744,7 +889,7 @@ ecl_kw_type *ecl_kw_alloc_sub_copy(const ecl_kw_type *src, const char *new_kw,
         util_abort("%s: invalid count value: %d \n", __func__, count);
 
     {
-        void *src_data = ecl_kw_iget_ptr(src, offset);
+        const void *src_data = ecl_kw_iget_ptr_static(src, offset);
         return ecl_kw_alloc_new(new_kw, count, src->data_type, src_data);
     }
 }
@@ -753,11 +898,6 @@ const void *ecl_kw_copyc__(const void *void_kw) {
     return ecl_kw_alloc_copy((const ecl_kw_type *)void_kw);
 }
 
-static void *ecl_kw_iget_ptr_static(const ecl_kw_type *ecl_kw, int i) {
-    ecl_kw_assert_index(ecl_kw, i, __func__);
-    return &ecl_kw->data[i * ecl_type_get_sizeof_ctype(ecl_kw->data_type)];
-}
-
 static void ecl_kw_iget_static(const ecl_kw_type *ecl_kw, int i, void *iptr) {
     memcpy(iptr, ecl_kw_iget_ptr_static(ecl_kw, i),
            ecl_type_get_sizeof_ctype(ecl_kw->data_type));
@@ -766,7 +906,7 @@ static void ecl_kw_iget_static(const ecl_kw_type *ecl_kw, int i, void *iptr) {
 static void ecl_kw_iset_static(ecl_kw_type *ecl_kw, int i, const void *iptr) {
     size_t sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
     ecl_kw_assert_index(ecl_kw, i, __func__);
-    memcpy(&ecl_kw->data[i * sizeof_ctype], iptr, sizeof_ctype);
+    memcpy(&ecl_kw_mutable_data(ecl_kw)[i * sizeof_ctype], iptr, sizeof_ctype);
 }
 
 void ecl_kw_iget(const ecl_kw_type *ecl_kw, int i, void *iptr) {
@@ -829,14 +969,14 @@ const char *ecl_kw_iget_char_ptr(const ecl_kw_type *ecl_kw, int i) {
     if (ecl_kw_get_type(ecl_kw) != ECL_CHAR_TYPE)
         util_abort("%s: Keyword: %s is wrong type - aborting \n", __func__,
                    ecl_kw_get_header8(ecl_kw));
-    return (const char *)ecl_kw_iget_ptr(ecl_kw, i);
+    return (const char *)ecl_kw_iget_ptr_static(ecl_kw, i);
 }
 
 const char *ecl_kw_iget_string_ptr(const ecl_kw_type *ecl_kw, int i) {
     if (ecl_kw_get_type(ecl_kw) != ECL_STRING_TYPE)
         util_abort("%s: Keyword: %s is wrong type - aborting \n", __func__,
                    ecl_kw_get_header8(ecl_kw));
-    return (const char *)ecl_kw_iget_ptr(ecl_kw, i);
+    return (const char *)ecl_kw_iget_ptr_static(ecl_kw, i);
 }
 
 /**
@@ -967,7 +1107,7 @@ ECL_KW_ISET_TYPED(bool, ECL_BOOL_TYPE);
             util_abort("%s: Keyword: %s is wrong type - aborting \n",          \
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
         {                                                                      \
-            ctype *data = (ctype *)ecl_kw->data;                               \
+            ctype *data = (ctype *)ecl_kw_mutable_data(ecl_kw);                \
             int size = int_vector_size(index_list);                            \
             const int *index_ptr = int_vector_get_const_ptr(index_list);       \
             int i;                                                             \
@@ -988,7 +1128,7 @@ ECL_KW_SET_INDEXED(int, ECL_INT_TYPE);
             util_abort("%s: Keyword: %s is wrong type - aborting \n",          \
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
         {                                                                      \
-            ctype *data = (ctype *)ecl_kw->data;                               \
+            ctype *data = (ctype *)ecl_kw_mutable_data(ecl_kw);                \
             int size = int_vector_size(index_list);                            \
             const int *index_ptr = int_vector_get_const_ptr(index_list);       \
             int i;                                                             \
@@ -1009,7 +1149,7 @@ ECL_KW_SHIFT_INDEXED(int, ECL_INT_TYPE);
             util_abort("%s: Keyword: %s is wrong type - aborting \n",          \
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
         {                                                                      \
-            ctype *data = (ctype *)ecl_kw->data;                               \
+            ctype *data = (ctype *)ecl_kw_mutable_data(ecl_kw);                \
             int size = int_vector_size(index_list);                            \
             const int *index_ptr = int_vector_get_const_ptr(index_list);       \
             int i;                                                             \
@@ -1023,12 +1163,24 @@ ECL_KW_SCALE_INDEXED(float, ECL_FLOAT_TYPE);
 ECL_KW_SCALE_INDEXED(int, ECL_INT_TYPE);
 #undef ECL_KW_SCALE_INDEXED
 
+/*
+  The pointers returned by the ecl_kw_get_xxx_ptr() and
+  ecl_kw_get_const_xxx_ptr() functions below, and by ecl_kw_get_ptr(),
+  ecl_kw_get_const_ptr(), ecl_kw_get_void_ptr() and ecl_kw_iget_ptr(),
+  point into the uncompressed data of the keyword. They are invalidated
+  when the keyword is compressed with ecl_kw_compress(). For keywords
+  loaded through an ecl_file with compression enabled, see
+  ecl_file_set_kw_compression(), that happens on any later keyword
+  access through the ecl_file. Such pointers must therefore not be kept
+  across those accesses.
+*/
+
 #define ECL_KW_GET_TYPED_PTR(ctype, ECL_TYPE)                                  \
     ctype *ecl_kw_get_##ctype##_ptr(const ecl_kw_type *ecl_kw) {               \
         if (ecl_kw_get_type(ecl_kw) != ECL_TYPE)                               \
             util_abort("%s: Keyword: %s is wrong type - aborting \n",          \
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
-        return (ctype *)ecl_kw->data;                                          \
+        return (ctype *)ecl_kw_mutable_data(ecl_kw);                           \
     }
 
 ECL_KW_GET_TYPED_PTR(double, ECL_DOUBLE_TYPE);
@@ -1037,10 +1189,28 @@ ECL_KW_GET_TYPED_PTR(int, ECL_INT_TYPE);
 ECL_KW_GET_TYPED_PTR(bool, ECL_BOOL_TYPE);
 #undef ECL_KW_GET_TYPED_PTR
 
-void *ecl_kw_get_void_ptr(const ecl_kw_type *ecl_kw) { return ecl_kw->data; }
+#define ECL_KW_GET_TYPED_CONST_PTR(ctype, ECL_TYPE)                            \
+    const ctype *ecl_kw_get_const_##ctype##_ptr(const ecl_kw_type *ecl_kw) {   \
+        if (ecl_kw_get_type(ecl_kw) != ECL_TYPE)                               \
+            util_abort("%s: Keyword: %s is wrong type - aborting \n",          \
+                       __func__, ecl_kw_get_header8(ecl_kw));                  \
+        return (const ctype *)ecl_kw_data(ecl_kw);                             \
+    }
+
+ECL_KW_GET_TYPED_CONST_PTR(double, ECL_DOUBLE_TYPE);
+ECL_KW_GET_TYPED_CONST_PTR(float, ECL_FLOAT_TYPE);
+ECL_KW_GET_TYPED_CONST_PTR(int, ECL_INT_TYPE);
+ECL_KW_GET_TYPED_CONST_PTR(bool, ECL_BOOL_TYPE);
+#undef ECL_KW_GET_TYPED_CONST_PTR
+
+void *ecl_kw_get_void_ptr(const ecl_kw_type *ecl_kw) {
+    return ecl_kw_mutable_data(ecl_kw);
+}
 
 void *ecl_kw_iget_ptr(const ecl_kw_type *ecl_kw, int i) {
-    return ecl_kw_iget_ptr_static(ecl_kw, i);
+    ecl_kw_assert_index(ecl_kw, i, __func__);
+    return &ecl_kw_mutable_data(
+        ecl_kw)[(size_t)i * ecl_type_get_sizeof_ctype(ecl_kw->data_type)];
 }
 
 void ecl_kw_iset(ecl_kw_type *ecl_kw, int i, const void *iptr) {
@@ -1090,121 +1260,350 @@ static bool ecl_kw_fscanf_qstring(char *s, const char *fmt, int len,
 }
 
 /*
-  This rather painful parsing is because formatted eclipse double
-  format : 0.ddddD+01 - difficult to parse the 'D';
+  Reading formatted files with one fscanf() call per element is very
+  slow, and the result of parsing numbers with the stdio functions
+  depends on the current locale. The formatted data is therefore
+  parsed with a small tokenizer which reads the stream in large
+  chunks, and numbers are converted with std::from_chars(), which
+  does not depend on the locale. When the keyword has been read the
+  unconsumed part of the buffer is returned to the stream with a seek.
+
+  The tokenizer is lenient with respect to whitespace and line breaks,
+  i.e. it does not depend on the block and column layout written by
+  ecl_kw_fwrite(). Numbers can have exponent character 'E' or 'D', and
+  the Fortran form where the exponent character is omitted, like
+  0.12345-105, is also recognized.
 */
-/** Should be: NESTED */
 
-static double __fscanf_ECL_double(FILE *stream, const char *fmt) {
-    int read_count, power;
-    double value, arg;
-    read_count = fscanf(stream, fmt, &arg, &power);
-    if (read_count == 2)
-        value = arg * pow(10, power);
-    else {
-        util_abort("%s: read failed \n", __func__);
-        value = -1;
+#define FMT_READER_BUFFER_SIZE (1 << 16)
+#define FMT_READER_MIN_TOKEN 128
+
+typedef struct {
+    FILE *stream;
+    char *buffer;
+    size_t buffer_size;
+    size_t pos;
+    size_t len;
+    bool eof;
+} fmt_reader_type;
+
+static void fmt_reader_init(fmt_reader_type *reader, FILE *stream,
+                            size_t min_token) {
+    reader->stream = stream;
+    reader->buffer_size = util_size_t_max(FMT_READER_BUFFER_SIZE,
+                                          2 * (min_token + 2));
+    reader->buffer = (char *)util_malloc(reader->buffer_size);
+    reader->pos = 0;
+    reader->len = 0;
+    reader->eof = false;
+}
+
+/*
+  Returns the bytes which have been read from the stream, but not
+  consumed, back to the stream.
+*/
+static void fmt_reader_release(fmt_reader_type *reader, fortio_type *fortio) {
+    size_t unused = reader->len - reader->pos;
+    if (unused > 0)
+        fortio_fseek(fortio, -(offset_type)unused, SEEK_CUR);
+    free(reader->buffer);
+}
+
+/*
+  Makes sure that at least 'size' bytes are available in the buffer,
+  unless the stream has been exhausted; returns the number of available
+  bytes.
+*/
+static size_t fmt_reader_ensure(fmt_reader_type *reader, size_t size) {
+    size_t avail = reader->len - reader->pos;
+    if (avail < size && !reader->eof) {
+        memmove(reader->buffer, &reader->buffer[reader->pos], avail);
+        reader->pos = 0;
+        reader->len = avail;
+        while (reader->len < reader->buffer_size && !reader->eof) {
+            size_t bytes = fread(&reader->buffer[reader->len], 1,
+                                 reader->buffer_size - reader->len,
+                                 reader->stream);
+            if (bytes == 0)
+                reader->eof = true;
+            reader->len += bytes;
+        }
+        avail = reader->len;
+    }
+    return avail;
+}
+
+static bool fmt_reader_isspace(char c) {
+    return (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+}
+
+/*
+  Skips whitespace and returns the number of bytes available from the
+  start of the next token.
+*/
+static size_t fmt_reader_next_token(fmt_reader_type *reader) {
+    while (true) {
+        size_t avail = fmt_reader_ensure(reader, FMT_READER_MIN_TOKEN);
+        const char *p = &reader->buffer[reader->pos];
+        const char *end = p + avail;
+        while (p < end && fmt_reader_isspace(*p))
+            p++;
+
+        reader->pos = p - reader->buffer;
+        if (reader->eof || end - p >= FMT_READER_MIN_TOKEN)
+            return reader->len - reader->pos;
+    }
+}
+
+static bool fmt_reader_token_end(const char *p, const char *end) {
+    return (p == end || fmt_reader_isspace(*p));
+}
+
+static bool fmt_reader_read_int(fmt_reader_type *reader, int *value) {
+    size_t avail = fmt_reader_next_token(reader);
+    const char *p = &reader->buffer[reader->pos];
+    const char *end = p + avail;
+    bool negative = false;
+    int64_t result = 0;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (result <= INT_MAX)
+            result = 10 * result + (*p - '0');
+        p++;
+    }
+    if (!fmt_reader_token_end(p, end))
+        return false;
+
+    /* Values which do not fit in an int are an error, not saturated. */
+    if (negative)
+        result = -result;
+    if (result < INT_MIN || result > INT_MAX)
+        return false;
+
+    *value = (int)result;
+    reader->pos = p - reader->buffer;
+    return true;
+}
+
+/*
+  Floating point values are converted with std::from_chars(), which
+  rounds the decimal number correctly to the target type. The token is
+  first copied to a scratch buffer where a 'D' exponent is written as
+  'E', the 'E' which Fortran leaves out of three digit exponents, e.g.
+  0.12345678-105, is put back and a leading '+' is dropped. As with
+  strtod() values which overflow become infinite, and values which
+  underflow become zero.
+*/
+template <typename T>
+static bool fmt_reader_read_real(fmt_reader_type *reader, T *value) {
+    char token[FMT_READER_MIN_TOKEN + 2];
+    size_t avail = fmt_reader_next_token(reader);
+    const char *p = &reader->buffer[reader->pos];
+    const char *end = p + avail;
+    size_t len = 0;
+
+    if (p < end && *p == '+')
+        p++;
+
+    while (p < end && !fmt_reader_isspace(*p) && len < FMT_READER_MIN_TOKEN) {
+        char c = *p;
+        if (c == 'D' || c == 'd')
+            c = 'E';
+        else if ((c == '-' || c == '+') && len > 0 && token[len - 1] != 'E' &&
+                 token[len - 1] != 'e')
+            token[len++] = 'E';
+
+        token[len++] = c;
+        p++;
+    }
+    if (len == 0 || !fmt_reader_token_end(p, end))
+        return false;
+
+    {
+        const char *token_end = &token[len];
+        std::from_chars_result result =
+            std::from_chars(token, token_end, *value);
+        if (result.ptr != token_end)
+            return false;
+
+        if (result.ec == std::errc::result_out_of_range) {
+            long double wide;
+            bool overflow;
+            if (std::from_chars(token, token_end, wide).ec == std::errc())
+                overflow = fabsl(wide) > std::numeric_limits<T>::max();
+            else {
+                const char *exp = (const char *)memchr(token, 'E', len);
+                if (!exp)
+                    exp = (const char *)memchr(token, 'e', len);
+                overflow = !(exp && exp[1] == '-');
+            }
+
+            *value = overflow ? std::numeric_limits<T>::infinity() : 0;
+            if (token[0] == '-')
+                *value = -*value;
+        } else if (result.ec != std::errc())
+            return false;
+    }
+
+    reader->pos = p - reader->buffer;
+    return true;
+}
+
+static bool fmt_reader_read_float(fmt_reader_type *reader, float *value) {
+    return fmt_reader_read_real(reader, value);
+}
+
+static bool fmt_reader_read_double(fmt_reader_type *reader, double *value) {
+    return fmt_reader_read_real(reader, value);
+}
+
+static bool fmt_reader_read_bool(fmt_reader_type *reader, bool *value) {
+    size_t avail = fmt_reader_next_token(reader);
+    char c;
+    if (avail == 0)
+        return false;
+
+    c = reader->buffer[reader->pos];
+    if (c == BOOL_TRUE_CHAR)
+        *value = true;
+    else if (c == BOOL_FALSE_CHAR)
+        *value = false;
+    else
+        util_abort("%s: Logical value: [%c] not recogniced - aborting \n",
+                   __func__, c);
+
+    reader->pos++;
+    return true;
+}
+
+/*
+  Strings are quoted: 'XXXXXXXX', and the quotes are not part of the
+  string. Exactly 'len' characters are read, the closing quote is
+  skipped without checking.
+*/
+static bool fmt_reader_read_qstring(fmt_reader_type *reader, char *s,
+                                    int len) {
+    while (true) {
+        size_t avail = fmt_reader_next_token(reader);
+        if (avail == 0)
+            return false;
+
+        if (reader->buffer[reader->pos] == '\'') {
+            avail = fmt_reader_ensure(reader, len + 2);
+            if (avail < (size_t)len + 2)
+                return false;
+
+            memcpy(s, &reader->buffer[reader->pos + 1], len);
+            s[len] = '\0';
+            reader->pos += len + 2;
+            return true;
+        }
+        reader->pos++;
+    }
+}
+
+static void ecl_kw_fread_fmt_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
+    const int sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+    const int sizeof_iotype = ecl_type_get_sizeof_iotype(ecl_kw->data_type);
+    fmt_reader_type reader;
+    int index;
+
+    fmt_reader_init(&reader, fortio_get_FILE(fortio), sizeof_iotype);
+    for (index = 0; index < ecl_kw->size; index++) {
+        char *data = &ecl_kw_mutable_data(ecl_kw)[(size_t)index * sizeof_ctype];
+        bool OK;
+
+        switch (ecl_kw_get_type(ecl_kw)) {
+        case (ECL_CHAR_TYPE):
+        case (ECL_MESS_TYPE):
+        case (ECL_STRING_TYPE):
+            OK = fmt_reader_read_qstring(&reader, data, sizeof_iotype);
+            break;
+        case (ECL_INT_TYPE):
+            OK = fmt_reader_read_int(&reader, (int *)data);
+            break;
+        case (ECL_FLOAT_TYPE):
+            OK = fmt_reader_read_float(&reader, (float *)data);
+            break;
+        case (ECL_DOUBLE_TYPE):
+            OK = fmt_reader_read_double(&reader, (double *)data);
+            break;
+        case (ECL_BOOL_TYPE): {
+            bool value = false;
+            OK = fmt_reader_read_bool(&reader, &value);
+            ecl_kw_iset_bool(ecl_kw, index, value);
+        } break;
+        default:
+            util_abort("%s: Internal error: internal eclipse_type: %d not "
+                       "recognized - aborting \n",
+                       __func__, ecl_kw_get_type(ecl_kw));
+            OK = false;
+        }
+
+        if (!OK)
+            util_abort("%s: after reading %d values reading of keyword:%s "
+                       "from:%s failed - aborting \n",
+                       __func__, index, ecl_kw->header8,
+                       fortio_filename_ref(fortio));
+    }
+    fmt_reader_release(&reader, fortio);
+}
+
+/*
+  Skips the data of a formatted keyword without converting the numbers;
+  returns false if the file ends before all elements have been seen.
+*/
+static bool ecl_kw_fskip_fmt_data(ecl_data_type data_type, int element_count,
+                                  fortio_type *fortio) {
+    const int sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+    char *string = (char *)util_malloc(sizeof_iotype + 1);
+    fmt_reader_type reader;
+    bool OK = true;
+
+    fmt_reader_init(&reader, fortio_get_FILE(fortio), sizeof_iotype);
+    for (int index = 0; OK && index < element_count; index++) {
+        if (ecl_type_is_alpha(data_type))
+            OK = fmt_reader_read_qstring(&reader, string, sizeof_iotype);
+        else {
+            size_t avail = fmt_reader_next_token(&reader);
+            const char *p = &reader.buffer[reader.pos];
+            const char *end = p + avail;
+            if (avail == 0)
+                OK = false;
+
+            while (p < end && !fmt_reader_isspace(*p))
+                p++;
+            reader.pos = p - reader.buffer;
+        }
     }
-    return value;
+    fmt_reader_release(&reader, fortio);
+    free(string);
+    return OK;
 }
 
+#undef FMT_READER_BUFFER_SIZE
+#undef FMT_READER_MIN_TOKEN
+
 bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
     bool fmt_file = fortio_fmt_file(fortio);
     if (ecl_kw->size > 0) {
-        const int blocksize = get_blocksize(ecl_kw->data_type);
         if (fmt_file) {
-            const int blocks = ecl_kw->size / blocksize +
-                               (ecl_kw->size % blocksize == 0 ? 0 : 1);
-            char *read_fmt = alloc_read_fmt(ecl_kw->data_type);
-            FILE *stream = fortio_get_FILE(fortio);
-            int offset = 0;
-            int index = 0;
-            int ib, ir;
-            for (ib = 0; ib < blocks; ib++) {
-                int read_elm =
-                    util_int_min((ib + 1) * blocksize, ecl_kw->size) -
-                    ib * blocksize;
-                for (ir = 0; ir < read_elm; ir++) {
-                    switch (ecl_kw_get_type(ecl_kw)) {
-                    case (ECL_CHAR_TYPE):
-                        ecl_kw_fscanf_qstring(&ecl_kw->data[offset], read_fmt,
-                                              8, stream);
-                        break;
-                    case (ECL_STRING_TYPE):
-                        ecl_kw_fscanf_qstring(&ecl_kw->data[offset], read_fmt,
-                                              ecl_type_get_sizeof_iotype(
-                                                  ecl_kw_get_data_type(ecl_kw)),
-                                              stream);
-                        break;
-                    case (ECL_INT_TYPE): {
-                        int iread = fscanf(stream, read_fmt,
-                                           (int *)&ecl_kw->data[offset]);
-                        if (iread != 1)
-                            util_abort(
-                                "%s: after reading %d values reading of "
-                                "keyword:%s from:%s failed - aborting \n",
-                                __func__,
-                                offset / ecl_type_get_sizeof_ctype(
-                                             ecl_kw->data_type),
-                                ecl_kw->header8, fortio_filename_ref(fortio));
-                    } break;
-                    case (ECL_FLOAT_TYPE): {
-                        int iread = fscanf(stream, read_fmt,
-                                           (float *)&ecl_kw->data[offset]);
-                        if (iread != 1) {
-                            util_abort(
-                                "%s: after reading %d values reading of "
-                                "keyword:%s from:%s failed - aborting \n",
-                                __func__,
-                                offset / ecl_type_get_sizeof_ctype(
-                                             ecl_kw->data_type),
-                                ecl_kw->header8, fortio_filename_ref(fortio));
-                        }
-                    } break;
-                    case (ECL_DOUBLE_TYPE): {
-                        double value = __fscanf_ECL_double(stream, read_fmt);
-                        ecl_kw_iset(ecl_kw, index, &value);
-                    } break;
-                    case (ECL_BOOL_TYPE): {
-                        char bool_char;
-                        if (fscanf(stream, read_fmt, &bool_char) == 1) {
-                            if (bool_char == BOOL_TRUE_CHAR)
-                                ecl_kw_iset_bool(ecl_kw, index, true);
-                            else if (bool_char == BOOL_FALSE_CHAR)
-                                ecl_kw_iset_bool(ecl_kw, index, false);
-                            else
-                                util_abort("%s: Logical value: [%c] not "
-                                           "recogniced - aborting \n",
-                                           __func__, bool_char);
-                        } else
-                            util_abort(
-                                "%s: read failed - premature file end? \n",
-                                __func__);
-                    } break;
-                    case (ECL_MESS_TYPE):
-                        ecl_kw_fscanf_qstring(&ecl_kw->data[offset], read_fmt,
-                                              8, stream);
-                        break;
-                    default:
-                        util_abort("%s: Internal error: internal eclipse_type: "
-                                   "%d not recognized - aborting \n",
-                                   __func__, ecl_kw_get_type(ecl_kw));
-                    }
-                    offset += ecl_type_get_sizeof_ctype(ecl_kw->data_type);
-                    index++;
-                }
-            }
+            ecl_kw_fread_fmt_data(ecl_kw, fortio);
 
             /* Skip the trailing newline */
             fortio_fseek(fortio, 1, SEEK_CUR);
-            free(read_fmt);
             return true;
         } else {
             char *buffer = ecl_kw_alloc_input_buffer(ecl_kw);
-            const int sizeof_iotype =
-                ecl_type_get_sizeof_iotype(ecl_kw->data_type);
             bool read_ok = fortio_fread_buffer(fortio, buffer,
-                                               ecl_kw->size * sizeof_iotype);
+                                               ecl_kw_iotype_byte_size(ecl_kw));
 
             if (read_ok)
                 ecl_kw_load_from_input_buffer(ecl_kw, buffer);
@@ -1222,26 +1621,61 @@ void ecl_kw_fread_indexed_data(fortio_type *fortio, offset_type data_offset,
                                const int_vector_type *index_map,
                                char *io_buffer) {
     const int block_size = get_blocksize(data_type);
-    FILE *stream = fortio_get_FILE(fortio);
+    const int num_elements = int_vector_size(index_map);
+    const size_t sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+    offset_type *offsets =
+        (offset_type *)util_malloc(num_elements * sizeof *offsets);
     int index;
-    int sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
 
-    for (index = 0; index < int_vector_size(index_map); index++) {
+    for (index = 0; index < num_elements; index++) {
         int element_index = int_vector_iget(index_map, index);
 
         if (element_index < 0 || element_index >= element_count)
             util_abort("%s: Element index is out of range 0 <= %d < %d\n",
                        __func__, element_index, element_count);
 
-        fortio_data_fseek(fortio, data_offset, element_index, sizeof_iotype,
-                          element_count, block_size);
-        util_fread(&io_buffer[index * sizeof_iotype], sizeof_iotype, 1, stream,
-                   __func__);
+        offsets[index] = fortio_data_offset(data_offset, element_index,
+                                            sizeof_iotype, element_count,
+                                            block_size);
+    }
+    fortio_fread_gather(fortio, offsets, num_elements, sizeof_iotype,
+                        io_buffer);
+    free(offsets);
+
+    if (ECL_ENDIAN_FLIP)
+        util_endian_flip_vector(io_buffer, sizeof_iotype, num_elements);
+}
+
+/**
+   Reads element 'element_index' from each of 'num_kw' keywords of type
+   'data_type'. The data section of keyword nr i starts at file offset
+   data_offset[i] and has element_count[i] elements. The values are
+   stored in io_buffer in the io representation of the type, i.e. the
+   same as ecl_kw_fread_indexed_data().
+*/
+
+void ecl_kw_fread_element_multiple(fortio_type *fortio, ecl_data_type data_type,
+                                   int num_kw, const offset_type *data_offset,
+                                   const int *element_count, int element_index,
+                                   char *io_buffer) {
+    const int block_size = get_blocksize(data_type);
+    const size_t sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+    offset_type *offsets = (offset_type *)util_malloc(num_kw * sizeof *offsets);
+
+    for (int ikw = 0; ikw < num_kw; ikw++) {
+        if (element_index < 0 || element_index >= element_count[ikw])
+            util_abort("%s: Element index is out of range 0 <= %d < %d\n",
+                       __func__, element_index, element_count[ikw]);
+
+        offsets[ikw] =
+            fortio_data_offset(data_offset[ikw], element_index, sizeof_iotype,
+                               element_count[ikw], block_size);
     }
+    fortio_fread_gather(fortio, offsets, num_kw, sizeof_iotype, io_buffer);
+    free(offsets);
 
     if (ECL_ENDIAN_FLIP)
-        util_endian_flip_vector(io_buffer, sizeof_iotype,
-                                int_vector_size(index_map));
+        util_endian_flip_vector(io_buffer, sizeof_iotype, num_kw);
 }
 
 /**
@@ -1263,20 +1697,18 @@ bool ecl_kw_fskip_data__(ecl_data_type data_type, const int element_count,
 
     bool fmt_file = fortio_fmt_file(fortio);
     if (fmt_file) {
-        /* Formatted skipping actually involves reading the data - nice ??? */
-        ecl_kw_type *tmp_kw = ecl_kw_alloc_empty();
-        ecl_kw_initialize(tmp_kw, "WORK", element_count, data_type);
-        ecl_kw_alloc_data(tmp_kw);
-        ecl_kw_fread_data(tmp_kw, fortio);
-        ecl_kw_free(tmp_kw);
+        /* Formatted skipping must scan through the data. */
+        if (!ecl_kw_fskip_fmt_data(data_type, element_count, fortio))
+            return false;
+
+        /* Skip the trailing newline */
+        fortio_fseek(fortio, 1, SEEK_CUR);
     } else {
         const int blocksize = get_blocksize(data_type);
-        const int block_count =
-            element_count / blocksize + (element_count % blocksize != 0);
         int element_size = ecl_type_get_sizeof_iotype(data_type);
 
-        if (!fortio_data_fskip(fortio, element_size, element_count,
-                               block_count))
+        if (!fortio_data_fskip_checked(fortio, element_size, element_count,
+                                       blocksize))
             return false;
     }
 
@@ -1306,9 +1738,34 @@ void ecl_kw_fskip_header(fortio_type *fortio) {
         fortio_fskip_record(fortio);
 }
 
+/*
+  Initializes the keyword from the content of the header record of an
+  unformatted file, i.e. the 8 character name, the size and the 4
+  character type.
+*/
+static void ecl_kw_initialize_from_header_data(ecl_kw_type *ecl_kw,
+                                               const char *buffer) {
+    char header[ECL_STRING8_LENGTH + 1];
+    char ecl_type_str[ECL_TYPE_LENGTH + 1];
+    int size;
+
+    memcpy(header, &buffer[0], ECL_STRING8_LENGTH);
+    header[ECL_STRING8_LENGTH] = '\0';
+
+    memcpy(&size, &buffer[ECL_STRING8_LENGTH], sizeof size);
+    if (ECL_ENDIAN_FLIP)
+        util_endian_flip_vector(&size, sizeof size, 1);
+
+    memcpy(ecl_type_str, &buffer[ECL_STRING8_LENGTH + sizeof(size)],
+           ECL_TYPE_LENGTH);
+    ecl_type_str[ECL_TYPE_LENGTH] = '\0';
+
+    ecl_kw_initialize(ecl_kw, header, size,
+                      ecl_type_create_from_name(ecl_type_str));
+}
+
 ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw,
                                          fortio_type *fortio) {
-    const char null_char = '\0';
     FILE *stream = fortio_get_FILE(fortio);
     bool fmt_file = fortio_fmt_file(fortio);
     char header[ECL_STRING8_LENGTH + 1];
@@ -1329,8 +1786,6 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw,
 
         fgetc(stream); /* Reading the trailing newline ... */
     } else {
-        header[ECL_STRING8_LENGTH] = null_char;
-        ecl_type_str[ECL_TYPE_LENGTH] = null_char;
         record_size = fortio_init_read(fortio);
 
         if (record_size <= 0)
@@ -1342,18 +1797,11 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw,
         if (read_bytes != ECL_KW_HEADER_DATA_SIZE)
             return ECL_KW_READ_FAIL;
 
-        memcpy(header, &buffer[0], ECL_STRING8_LENGTH);
-        void *ptr = &buffer[ECL_STRING8_LENGTH];
-        size = *((int *)ptr);
-
-        memcpy(ecl_type_str, &buffer[ECL_STRING8_LENGTH + sizeof(size)],
-               ECL_TYPE_LENGTH);
-
         if (!fortio_complete_read(fortio, record_size))
             return ECL_KW_READ_FAIL;
 
-        if (ECL_ENDIAN_FLIP)
-            util_endian_flip_vector(&size, sizeof size, 1);
+        ecl_kw_initialize_from_header_data(ecl_kw, buffer);
+        return ECL_KW_READ_OK;
     }
 
     ecl_data_type data_type = ecl_type_create_from_name(ecl_type_str);
@@ -1449,10 +1897,21 @@ bool ecl_kw_fseek_last_kw(const char *kw, bool abort_on_error,
     return kw_found;
 }
 
+static void ecl_kw_free_zdata(ecl_kw_type *ecl_kw) {
+    free(ecl_kw->zdata);
+    ecl_kw->zdata = NULL;
+    ecl_kw->zsize = 0;
+}
+
 void ecl_kw_set_data_ptr(ecl_kw_type *ecl_kw, void *data) {
-    if (!ecl_kw->shared_data)
+    if (ecl_kw->cow)
+        ecl_kw_release_cow(ecl_kw);
+    else if (!ecl_kw->shared_data)
         free(ecl_kw->data);
+    ecl_kw_free_zdata(ecl_kw);
     ecl_kw->data = (char *)data;
+    ecl_kw->mapped = false;
+    ecl_kw->modified = true;
 }
 
 /**
@@ -1464,32 +1923,123 @@ void ecl_kw_alloc_data(ecl_kw_type *ecl_kw) {
                    "been declared with shared storage - aborting \n",
                    __func__);
 
+    ecl_kw_free_zdata(ecl_kw);
+    ecl_kw_release_cow(ecl_kw);
     {
-        size_t byte_size =
-            ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+        size_t byte_size = ecl_kw_ctype_byte_size(ecl_kw);
         ecl_kw->data = (char *)util_realloc(ecl_kw->data, byte_size);
         if (ecl_kw->data) {
             memset(ecl_kw->data, 0, byte_size);
         }
     }
+    ecl_kw->modified = true;
 }
 
 void ecl_kw_free_data(ecl_kw_type *ecl_kw) {
-    if (!ecl_kw->shared_data)
+    if (ecl_kw->cow)
+        ecl_kw_release_cow(ecl_kw);
+    else if (!ecl_kw->shared_data)
         free(ecl_kw->data);
 
+    ecl_kw_free_zdata(ecl_kw);
     ecl_kw->data = NULL;
 }
 
-void ecl_kw_set_header_name(ecl_kw_type *ecl_kw, const char *header) {
-    ecl_kw->header8 = (char *)realloc(ecl_kw->header8, ECL_STRING8_LENGTH + 1);
-    if (strlen(header) <= 8) {
-        sprintf(ecl_kw->header8, "%-8s", header);
+/**
+   Compresses the data of the keyword in memory with @codec; if the data
+   can not be compressed with the fast codec zlib is tried instead. When
+   zlib is available floating point data is always compressed with zlib,
+   at the fastest level, since the run length encoding of the fast codec
+   saves little on floating point fields. The data is decompressed again
+   automatically on the next access, i.e. calling ecl_kw_compress()
+   does not change the content of the keyword.
+   Observe that pointers to the data, e.g. from ecl_kw_get_ptr(), are
+   invalidated when the keyword is compressed.
+
+   Returns true if the keyword has been compressed. Keywords with shared
+   data, also data shared copy-on-write, and keywords where compression
+   does not save at least 1/8 of the memory, are not compressed.
+*/
 
-        /* Internalizing a header without the trailing spaces as well. */
-        free(ecl_kw->header);
-        ecl_kw->header = util_alloc_strip_copy(ecl_kw->header8);
-    } else {
+bool ecl_kw_compress(ecl_kw_type *ecl_kw, util_codec_enum codec) {
+    if (ecl_kw->zdata)
+        return true;
+
+    if (ecl_kw->shared_data || ecl_kw->cow || ecl_kw->data == NULL)
+        return false;
+
+    size_t byte_size = ecl_kw_ctype_byte_size(ecl_kw);
+    size_t max_size = byte_size - byte_size / 8;
+    int element_size = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+    char *zdata;
+
+    if (codec == UTIL_CODEC_FAST &&
+        (ecl_type_is_float(ecl_kw->data_type) ||
+         ecl_type_is_double(ecl_kw->data_type)) &&
+        util_codec_supported(UTIL_CODEC_ZLIB))
+        codec = UTIL_CODEC_ZLIB;
+
+    zdata = (char *)util_malloc(max_size);
+    size_t zsize = util_codec_compress(codec, element_size, ecl_kw->data,
+                                       byte_size, zdata, max_size);
+
+    if (zsize == 0 && codec == UTIL_CODEC_FAST) {
+        codec = UTIL_CODEC_ZLIB;
+        zsize = util_codec_compress(codec, element_size, ecl_kw->data,
+                                    byte_size, zdata, max_size);
+    }
+
+    if (zsize == 0) {
+        free(zdata);
+        return false;
+    }
+
+    free(ecl_kw->data);
+    ecl_kw->data = NULL;
+    ecl_kw->zdata = (char *)util_realloc(zdata, zsize);
+    ecl_kw->zsize = zsize;
+    ecl_kw->codec = codec;
+    return true;
+}
+
+bool ecl_kw_is_compressed(const ecl_kw_type *ecl_kw) {
+    return ecl_kw->zdata != NULL;
+}
+
+/**
+   Returns true if the data of the keyword has been accessed for
+   writing, e.g. through ecl_kw_iset_int() or ecl_kw_get_ptr(), since
+   the keyword was allocated or ecl_kw_clear_modified() was called.
+   Reading the keyword from file counts as a modification; the ecl_file
+   layer clears the flag after loading a keyword, so that it can tell
+   which loaded keywords must not be dropped.
+*/
+bool ecl_kw_is_modified(const ecl_kw_type *ecl_kw) { return ecl_kw->modified; }
+
+void ecl_kw_clear_modified(ecl_kw_type *ecl_kw) { ecl_kw->modified = false; }
+
+/**
+   The number of bytes currently used for the data of the keyword.
+*/
+size_t ecl_kw_get_data_memory_size(const ecl_kw_type *ecl_kw) {
+    if (ecl_kw->zdata)
+        return ecl_kw->zsize;
+
+    if (ecl_kw->data)
+        return ecl_kw_ctype_byte_size(ecl_kw);
+
+    return 0;
+}
+
+void ecl_kw_set_header_name(ecl_kw_type *ecl_kw, const char *header) {
+    ecl_kw->header8 = (char *)realloc(ecl_kw->header8, ECL_STRING8_LENGTH + 1);
+    if (strlen(header) <= 8) {
+        sprintf(ecl_kw->header8, "%-8s", header);
+
+        /* Internalizing a header without the trailing spaces as well. */
+        free(ecl_kw->header);
+        ecl_kw->header = util_alloc_strip_copy(ecl_kw->header8);
+    } else {
         ecl_kw->header = (char *)util_alloc_copy(header, strlen(header) + 1);
     }
 }
@@ -1529,6 +2079,130 @@ ecl_kw_type *ecl_kw_fread_alloc(fortio_type *fortio) {
     return ecl_kw;
 }
 
+/**
+   Reads the keyword starting at file offset @offset of an unformatted
+   file with positional reads, see fortio_pread_buffer(). The position
+   of the fortio instance is neither used nor changed, so several
+   threads can load keywords from the same fortio instance
+   concurrently with this function.
+
+   Returns NULL if the keyword can not be read this way, e.g. for a
+   formatted file; the caller can then seek to @offset and use
+   ecl_kw_fread_alloc() instead.
+*/
+
+ecl_kw_type *ecl_kw_pread_alloc(const fortio_type *fortio,
+                                offset_type offset) {
+    char header_buffer[ECL_KW_HEADER_DATA_SIZE];
+    if (!fortio_pread_buffer(fortio, offset, header_buffer,
+                             ECL_KW_HEADER_DATA_SIZE, 1, 1))
+        return NULL;
+
+    ecl_kw_type *ecl_kw = ecl_kw_alloc_empty();
+    ecl_kw_initialize_from_header_data(ecl_kw, header_buffer);
+    ecl_kw_alloc_data(ecl_kw);
+
+    if (ecl_kw->size > 0) {
+        char *buffer = ecl_kw_alloc_input_buffer(ecl_kw);
+        bool read_ok = fortio_pread_buffer(
+            fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, buffer,
+            ecl_type_get_sizeof_iotype(ecl_kw->data_type), ecl_kw->size,
+            get_blocksize(ecl_kw->data_type));
+
+        if (read_ok)
+            ecl_kw_load_from_input_buffer(ecl_kw, buffer);
+
+        free(buffer);
+        if (!read_ok) {
+            ecl_kw_free(ecl_kw);
+            return NULL;
+        }
+    }
+    return ecl_kw;
+}
+
+/**
+   Decodes the keyword whose header record starts at @records, which
+   holds @records_size raw bytes read with fortio_pread(). Several
+   keywords which are close together in the file can in this way be
+   read with one system call and decoded afterwards.
+
+   Returns NULL if the keyword is not valid or extends beyond
+   @records_size.
+*/
+
+ecl_kw_type *ecl_kw_unpack_alloc(const fortio_type *fortio,
+                                 const char *records, size_t records_size) {
+    char header_buffer[ECL_KW_HEADER_DATA_SIZE];
+    if (!fortio_unpack_buffer(fortio, records, records_size, header_buffer,
+                              ECL_KW_HEADER_DATA_SIZE, 1, 1))
+        return NULL;
+
+    ecl_kw_type *ecl_kw = ecl_kw_alloc_empty();
+    ecl_kw_initialize_from_header_data(ecl_kw, header_buffer);
+    ecl_kw_alloc_data(ecl_kw);
+
+    if (ecl_kw->size > 0) {
+        char *buffer = ecl_kw_alloc_input_buffer(ecl_kw);
+        bool unpack_ok = fortio_unpack_buffer(
+            fortio, &records[ECL_KW_HEADER_FORTIO_SIZE],
+            records_size - (ECL_KW_HEADER_FORTIO_SIZE), buffer,
+            ecl_type_get_sizeof_iotype(ecl_kw->data_type), ecl_kw->size,
+            get_blocksize(ecl_kw->data_type));
+
+        if (unpack_ok)
+            ecl_kw_load_from_input_buffer(ecl_kw, buffer);
+
+        free(buffer);
+        if (!unpack_ok) {
+            ecl_kw_free(ecl_kw);
+            return NULL;
+        }
+    }
+    return ecl_kw;
+}
+
+/**
+   Reads the keyword at the current position of a fortio instance
+   opened with fortio_open_reader_mmap(). For int, float and double
+   keywords which are stored in the native byte order in one record,
+   the data of the returned keyword is not copied; instead the keyword
+   points directly into the read only mapping, and gets a private copy
+   of the data when it is modified. Observe that such a keyword can
+   not outlive the fortio instance it was read from.
+
+   For the other keywords, e.g. data which must be byte swapped, the
+   function behaves as ecl_kw_fread_alloc().
+*/
+
+ecl_kw_type *ecl_kw_fread_alloc_mmap(fortio_type *fortio) {
+    if (!fortio_is_mmapped(fortio))
+        return ecl_kw_fread_alloc(fortio);
+
+    ecl_kw_type *ecl_kw = ecl_kw_alloc_empty();
+    if (ecl_kw_fread_header(ecl_kw, fortio) != ECL_KW_READ_OK) {
+        ecl_kw_free(ecl_kw);
+        return NULL;
+    }
+
+    if (!ECL_ENDIAN_FLIP && ecl_type_is_numeric(ecl_kw->data_type) &&
+        ecl_kw->size > 0) {
+        const char *data = fortio_mmap_fread_buffer(
+            fortio, ecl_type_get_sizeof_iotype(ecl_kw->data_type),
+            ecl_kw->size, get_blocksize(ecl_kw->data_type));
+        if (data) {
+            ecl_kw_set_mapped_ref(ecl_kw, data);
+            return ecl_kw;
+        }
+    }
+
+    if (ecl_kw_fread_realloc_data(ecl_kw, fortio))
+        return ecl_kw;
+
+    ecl_kw_free(ecl_kw);
+    return NULL;
+}
+
 void ecl_kw_fskip(fortio_type *fortio) {
     ecl_kw_type *tmp_kw;
     tmp_kw = ecl_kw_fread_alloc(fortio);
@@ -1538,7 +2212,7 @@ void ecl_kw_fskip(fortio_type *fortio) {
 static void ecl_kw_fwrite_data_unformatted(const ecl_kw_type *ecl_kw,
                                            fortio_type *fortio) {
     char *iobuffer = ecl_kw_alloc_output_buffer(ecl_kw);
-    int sizeof_iotype = ecl_type_get_sizeof_iotype(ecl_kw->data_type);
+    size_t sizeof_iotype = ecl_type_get_sizeof_iotype(ecl_kw->data_type);
     {
         const int blocksize = get_blocksize(ecl_kw->data_type);
         const int num_blocks =
@@ -1561,38 +2235,249 @@ static void ecl_kw_fwrite_data_unformatted(const ecl_kw_type *ecl_kw,
 }
 
 /**
-     The point of this awkward function is that I have not managed to
-     use C fprintf() syntax to reproduce the ECLIPSE
-     formatting. ECLIPSE expects the following formatting for float
-     and double values:
+     ECLIPSE expects the following formatting for float and double
+     values:
 
         0.ddddddddE+03       (float)
         0.ddddddddddddddD+03 (double)
 
-     The problem with printf have been:
-
-        1. To force the radix part to start with 0.
-        2. To use 'D' as the exponent start for double values.
-
-     If you are more proficient with C fprintf() format strings than I
-     am, the __fprintf_scientific() function should be removed, and
-     the WRITE_FMT_DOUBLE and WRITE_FMT_FLOAT format specifiers
-     updated accordingly.
-  */
+     This can not be achieved with C fprintf() format strings alone;
+     the value is therefore split in a prefix in the range [0.1,1) and
+     a power of ten before it is formatted with the WRITE_FMT_FLOAT or
+     WRITE_FMT_DOUBLE format.
+*/
 
-static void __fprintf_scientific(FILE *stream, const char *fmt, double x) {
-    double pow_x = ceil(log10(fabs(x)));
-    double arg_x = x / pow(10.0, pow_x);
+static void __split_scientific(double x, double *arg_x, double *pow_x) {
+    *pow_x = ceil(log10(fabs(x)));
+    *arg_x = x / pow(10.0, *pow_x);
     if (x != 0.0) {
-        if (fabs(arg_x) == 1.0) {
-            arg_x *= 0.10;
-            pow_x += 1;
+        if (fabs(*arg_x) == 1.0) {
+            *arg_x *= 0.10;
+            *pow_x += 1;
         }
     } else {
-        arg_x = 0.0;
-        pow_x = 0.0;
+        *arg_x = 0.0;
+        *pow_x = 0.0;
     }
-    fprintf(stream, fmt, arg_x, (int)pow_x);
+}
+
+/*
+  Formatted files are written to a memory buffer which is flushed to
+  the stream with large fwrite() calls; the elements are formatted with
+  hand written code instead of fprintf(). The output is identical to
+  what fprintf() with the WRITE_FMT_xxx formats produces.
+*/
+
+#define FMT_WRITER_BUFFER_SIZE (1 << 16)
+#define FMT_WRITER_MAX_NUMBER 64
+
+typedef struct {
+    FILE *stream;
+    char *buffer;
+    size_t buffer_size;
+    size_t len;
+} fmt_writer_type;
+
+static void fmt_writer_init(fmt_writer_type *writer, FILE *stream,
+                            size_t max_item) {
+    writer->stream = stream;
+    writer->buffer_size = util_size_t_max(
+        FMT_WRITER_BUFFER_SIZE, 2 * (max_item + FMT_WRITER_MAX_NUMBER));
+    writer->buffer = (char *)util_malloc(writer->buffer_size);
+    writer->len = 0;
+}
+
+static void fmt_writer_flush(fmt_writer_type *writer) {
+    util_fwrite(writer->buffer, 1, writer->len, writer->stream, __func__);
+    writer->len = 0;
+}
+
+static void fmt_writer_free(fmt_writer_type *writer) {
+    fmt_writer_flush(writer);
+    free(writer->buffer);
+}
+
+/*
+  Returns a pointer to the buffer with room for at least 'size' bytes;
+  the caller must update writer->len.
+*/
+static char *fmt_writer_reserve(fmt_writer_type *writer, size_t size) {
+    if (writer->len + size > writer->buffer_size)
+        fmt_writer_flush(writer);
+    return &writer->buffer[writer->len];
+}
+
+static void fmt_writer_char(fmt_writer_type *writer, char c) {
+    char *p = fmt_writer_reserve(writer, 1);
+    p[0] = c;
+    writer->len++;
+}
+
+/*
+  Writes the decimal digits of 'value' right aligned in a field of
+  'width' characters, the field is padded with 'pad' on the left.
+*/
+static char *fmt_writer_uint(char *p, uint64_t value, int width, char pad) {
+    char digits[24];
+    int num_digits = 0;
+
+    do {
+        digits[num_digits++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = num_digits; i < width; i++)
+        *p++ = pad;
+
+    while (num_digits > 0)
+        *p++ = digits[--num_digits];
+    return p;
+}
+
+/* WRITE_FMT_INT: " %11d" */
+static void fmt_writer_int(fmt_writer_type *writer, int value) {
+    char *start = fmt_writer_reserve(writer, FMT_WRITER_MAX_NUMBER);
+    char *p = start;
+    int64_t v = value;
+    char tmp[24];
+    char *end;
+    int len;
+
+    end = fmt_writer_uint(tmp, (uint64_t)(v < 0 ? -v : v), 0, ' ');
+    len = (int)(end - tmp) + (v < 0 ? 1 : 0);
+
+    *p++ = ' ';
+    for (int i = len; i < 11; i++)
+        *p++ = ' ';
+    if (v < 0)
+        *p++ = '-';
+    memcpy(p, tmp, end - tmp);
+    p += end - tmp;
+
+    writer->len += p - start;
+}
+
+/* WRITE_FMT_CHAR and the string formats: " '%-Ns'" */
+static void fmt_writer_string(fmt_writer_type *writer, const char *s,
+                              size_t width) {
+    size_t len = strlen(s);
+    char *p = fmt_writer_reserve(writer, util_size_t_max(len, width) + 3);
+
+    p[0] = ' ';
+    p[1] = '\'';
+    memcpy(&p[2], s, len);
+    for (size_t i = len; i < width; i++)
+        p[2 + i] = ' ';
+    p[2 + util_size_t_max(len, width)] = '\'';
+
+    writer->len += util_size_t_max(len, width) + 3;
+}
+
+/*
+  Calculates the product a * b as the unevaluated sum *p + *err
+  exactly, with the splitting algorithm of Dekker.
+*/
+static void fmt_writer_two_product(double a, double b, double *p,
+                                   double *err) {
+    const double split = 134217729.0; /* 2^27 + 1 */
+    double t, a_hi, a_lo, b_hi, b_lo;
+
+    *p = a * b;
+
+    t = split * a;
+    a_hi = t - (t - a);
+    a_lo = a - a_hi;
+
+    t = split * b;
+    b_hi = t - (t - b);
+    b_lo = b - b_hi;
+
+    *err = ((a_hi * b_hi - *p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+}
+
+/*
+  Rounds fabs(arg_x) * 10^decimals to the nearest integer. Returns false
+  if the value is so close to a tie between two integers that the
+  result must be found by fprintf().
+*/
+static bool fmt_writer_round(double arg_x, int decimals, uint64_t *result) {
+    double scale = 1;
+    double p, err, r, d;
+
+    for (int i = 0; i < decimals; i++)
+        scale *= 10;
+
+    fmt_writer_two_product(fabs(arg_x), scale, &p, &err);
+    r = floor(p);
+    d = (p - r) + err;
+    if (fabs(d - 0.5) < 1e-9)
+        return false;
+
+    if (d > 0.5)
+        r += 1;
+    *result = (uint64_t)r;
+    return true;
+}
+
+/*
+  Writes the value 'x' with one of the formats
+
+     WRITE_FMT_FLOAT  : "  %11.8fE%+03d"
+     WRITE_FMT_DOUBLE : "  %17.14fD%+03d"
+
+  The few values which can not be handled exactly by the fast path,
+  i.e. non finite values and ties in the rounding, are formatted with
+  snprintf().
+*/
+static void fmt_writer_scientific(fmt_writer_type *writer, const char *fmt,
+                                  double x, int width, int decimals,
+                                  char exp_char) {
+    char *start = fmt_writer_reserve(writer, FMT_WRITER_MAX_NUMBER);
+    char *p = start;
+    double arg_x, pow_x;
+    uint64_t scaled;
+
+    __split_scientific(x, &arg_x, &pow_x);
+    if (!isfinite(arg_x) || fabs(arg_x) >= 10 ||
+        !fmt_writer_round(arg_x, decimals, &scaled)) {
+        int len = snprintf(start, FMT_WRITER_MAX_NUMBER, fmt, arg_x,
+                           (int)pow_x);
+        writer->len += util_int_min(len, FMT_WRITER_MAX_NUMBER - 1);
+        return;
+    }
+
+    {
+        uint64_t unit = 1;
+        char digits[32];
+        char *end = digits;
+        int len;
+
+        for (int i = 0; i < decimals; i++)
+            unit *= 10;
+
+        if (signbit(arg_x))
+            *end++ = '-';
+        end = fmt_writer_uint(end, scaled / unit, 0, ' ');
+        *end++ = '.';
+        end = fmt_writer_uint(end, scaled % unit, decimals, '0');
+        len = (int)(end - digits);
+
+        *p++ = ' ';
+        *p++ = ' ';
+        for (int i = len; i < width; i++)
+            *p++ = ' ';
+        memcpy(p, digits, len);
+        p += len;
+    }
+
+    {
+        int power = (int)pow_x;
+        *p++ = exp_char;
+        *p++ = power < 0 ? '-' : '+';
+        p = fmt_writer_uint(p, (uint64_t)(power < 0 ? -(int64_t)power : power),
+                            2, '0');
+    }
+    writer->len += p - start;
 }
 
 static void ecl_kw_fwrite_data_formatted(ecl_kw_type *ecl_kw,
@@ -1600,14 +2485,16 @@ static void ecl_kw_fwrite_data_formatted(ecl_kw_type *ecl_kw,
 
     {
 
-        FILE *stream = fortio_get_FILE(fortio);
         const int blocksize = get_blocksize(ecl_kw->data_type);
         const int columns = get_columns(ecl_kw->data_type);
+        const int sizeof_iotype = ecl_type_get_sizeof_iotype(ecl_kw->data_type);
         char *write_fmt = alloc_write_fmt(ecl_kw->data_type);
         const int num_blocks =
             ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+        fmt_writer_type writer;
         int block_nr;
 
+        fmt_writer_init(&writer, fortio_get_FILE(fortio), sizeof_iotype);
         for (block_nr = 0; block_nr < num_blocks; block_nr++) {
             int this_blocksize =
                 util_int_min((block_nr + 1) * blocksize, ecl_kw->size) -
@@ -1623,32 +2510,39 @@ static void ecl_kw_fwrite_data_formatted(ecl_kw_type *ecl_kw,
                 for (col_nr = 0; col_nr < num_columns; col_nr++) {
                     int data_index =
                         block_nr * blocksize + line_nr * columns + col_nr;
-                    void *data_ptr = ecl_kw_iget_ptr_static(ecl_kw, data_index);
+                    const void *data_ptr =
+                        ecl_kw_iget_ptr_static(ecl_kw, data_index);
                     switch (ecl_kw_get_type(ecl_kw)) {
                     case (ECL_CHAR_TYPE):
-                        fprintf(stream, write_fmt, data_ptr);
+                        fmt_writer_string(&writer, (const char *)data_ptr,
+                                          ECL_STRING8_LENGTH);
                         break;
                     case (ECL_STRING_TYPE):
-                        fprintf(stream, write_fmt, data_ptr);
+                        fmt_writer_string(&writer, (const char *)data_ptr,
+                                          sizeof_iotype);
                         break;
                     case (ECL_INT_TYPE): {
-                        int int_value = ((int *)data_ptr)[0];
-                        fprintf(stream, write_fmt, int_value);
+                        int int_value = ((const int *)data_ptr)[0];
+                        fmt_writer_int(&writer, int_value);
                     } break;
                     case (ECL_BOOL_TYPE): {
-                        bool bool_value = ((bool *)data_ptr)[0];
+                        bool bool_value = ((const bool *)data_ptr)[0];
+                        fmt_writer_char(&writer, ' ');
+                        fmt_writer_char(&writer, ' ');
                         if (bool_value)
-                            fprintf(stream, write_fmt, BOOL_TRUE_CHAR);
+                            fmt_writer_char(&writer, BOOL_TRUE_CHAR);
                         else
-                            fprintf(stream, write_fmt, BOOL_FALSE_CHAR);
+                            fmt_writer_char(&writer, BOOL_FALSE_CHAR);
                     } break;
                     case (ECL_FLOAT_TYPE): {
-                        float float_value = ((float *)data_ptr)[0];
-                        __fprintf_scientific(stream, write_fmt, float_value);
+                        float float_value = ((const float *)data_ptr)[0];
+                        fmt_writer_scientific(&writer, write_fmt, float_value,
+                                              11, 8, 'E');
                     } break;
                     case (ECL_DOUBLE_TYPE): {
-                        double double_value = ((double *)data_ptr)[0];
-                        __fprintf_scientific(stream, write_fmt, double_value);
+                        double double_value = ((const double *)data_ptr)[0];
+                        fmt_writer_scientific(&writer, write_fmt, double_value,
+                                              17, 14, 'D');
                     } break;
                     case (ECL_MESS_TYPE):
                         util_abort("%s: Internal inconsistency : message type "
@@ -1657,14 +2551,18 @@ static void ecl_kw_fwrite_data_formatted(ecl_kw_type *ecl_kw,
                         break;
                     }
                 }
-                fprintf(stream, "\n");
+                fmt_writer_char(&writer, '\n');
             }
         }
 
+        fmt_writer_free(&writer);
         free(write_fmt);
     }
 }
 
+#undef FMT_WRITER_BUFFER_SIZE
+#undef FMT_WRITER_MAX_NUMBER
+
 void ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw, fortio_type *fortio) {
     ecl_kw_type *ecl_kw = (ecl_kw_type *)_ecl_kw;
     bool fmt_file = fortio_fmt_file(fortio);
@@ -1710,14 +2608,141 @@ bool ecl_kw_fwrite(const ecl_kw_type *ecl_kw, fortio_type *fortio) {
     return true;
 }
 
+/*
+  The ecl_kw_writer is used to write a keyword without holding all the
+  data in memory. The header is written when the writer is allocated,
+  thereafter the data is appended in chunks of arbitrary size with
+  ecl_kw_writer_append(). The data is collected in a buffer of one
+  block, i.e. 1000 elements for numeric types, and each block is
+  written as one Fortran record when it is full. The output is
+  identical to what ecl_kw_fwrite() produces for the same keyword.
+*/
+
+struct ecl_kw_writer_struct {
+    fortio_type *fortio;
+    ecl_kw_type *block_kw; /* Holds the data of the current block. */
+    int size;              /* The total number of elements in the keyword. */
+    int count;             /* The number of elements appended so far. */
+    int block_count;       /* The number of elements in the current block. */
+    int blocksize;
+};
+
+/*
+  Writes the keyword header for a keyword with @size elements of type
+  @data_type, and returns a writer for the data. Returns NULL, and
+  sets the fortio error flag, if @header is longer than eight
+  characters.
+*/
+ecl_kw_writer_type *ecl_kw_writer_alloc(fortio_type *fortio,
+                                        const char *header, int size,
+                                        ecl_data_type data_type) {
+    if (strlen(header) > ECL_STRING8_LENGTH) {
+        fortio_fwrite_error(fortio);
+        return NULL;
+    }
+
+    if (size < 0)
+        util_abort("%s: invalid size:%d for keyword:%s\n", __func__, size,
+                   header);
+
+    ecl_kw_writer_type *writer =
+        (ecl_kw_writer_type *)util_malloc(sizeof *writer);
+    writer->fortio = fortio;
+    writer->size = size;
+    writer->count = 0;
+    writer->block_count = 0;
+    writer->blocksize = get_blocksize(data_type);
+
+    writer->block_kw = ecl_kw_alloc_empty();
+    ecl_kw_initialize(writer->block_kw, header, size, data_type);
+    ecl_kw_fwrite_header(writer->block_kw, fortio);
+
+    writer->block_kw->size = util_int_min(size, writer->blocksize);
+    ecl_kw_alloc_data(writer->block_kw);
+    return writer;
+}
+
+static void ecl_kw_writer_flush_block(ecl_kw_writer_type *writer) {
+    writer->block_kw->size = writer->block_count;
+    ecl_kw_fwrite_data(writer->block_kw, writer->fortio);
+    writer->block_count = 0;
+}
+
+/*
+  Appends @count elements to the keyword. The @data pointer should
+  point to elements with the in-memory type of the keyword, i.e. the
+  same layout as ecl_kw_get_ptr() returns; for character data each
+  element is ecl_type_get_sizeof_ctype() bytes.
+*/
+void ecl_kw_writer_append(ecl_kw_writer_type *writer, const void *data,
+                          int count) {
+    if (count < 0 || count > writer->size - writer->count)
+        util_abort("%s: appending %d elements to keyword:%s - only %d of %d "
+                   "elements remaining\n",
+                   __func__, count, writer->block_kw->header,
+                   writer->size - writer->count, writer->size);
+    {
+        const char *src = (const char *)data;
+        const size_t sizeof_ctype =
+            ecl_type_get_sizeof_ctype(writer->block_kw->data_type);
+
+        while (count > 0) {
+            int n =
+                util_int_min(count, writer->blocksize - writer->block_count);
+            memcpy(&writer->block_kw->data[writer->block_count * sizeof_ctype],
+                   src, n * sizeof_ctype);
+
+            src += n * sizeof_ctype;
+            count -= n;
+            writer->count += n;
+            writer->block_count += n;
+            if (writer->block_count == writer->blocksize)
+                ecl_kw_writer_flush_block(writer);
+        }
+    }
+
+    if (writer->count == writer->size && writer->block_count > 0)
+        ecl_kw_writer_flush_block(writer);
+}
+
+int ecl_kw_writer_get_remaining(const ecl_kw_writer_type *writer) {
+    return writer->size - writer->count;
+}
+
+/*
+  Frees the writer; all the elements declared when the writer was
+  allocated must have been appended, otherwise the file would be
+  corrupt and the function aborts.
+*/
+void ecl_kw_writer_free(ecl_kw_writer_type *writer) {
+    if (writer->count != writer->size)
+        util_abort("%s: keyword:%s is incomplete - %d of %d elements "
+                   "written\n",
+                   __func__, writer->block_kw->header, writer->count,
+                   writer->size);
+
+    ecl_kw_free(writer->block_kw);
+    free(writer);
+}
+
 static void *ecl_kw_get_data_ref(const ecl_kw_type *ecl_kw) {
-    return ecl_kw->data;
+    return ecl_kw_mutable_data(ecl_kw);
 }
 
 void *ecl_kw_get_ptr(const ecl_kw_type *ecl_kw) {
     return ecl_kw_get_data_ref(ecl_kw);
 }
 
+/*
+  Read only access to the data; as opposed to ecl_kw_get_ptr() this
+  does not give the keyword a private copy of data which is shared
+  copy-on-write. Both pointers are invalidated when the keyword is
+  compressed, see ecl_kw_get_double_ptr().
+*/
+const void *ecl_kw_get_const_ptr(const ecl_kw_type *ecl_kw) {
+    return ecl_kw_data(ecl_kw);
+}
+
 int ecl_kw_get_size(const ecl_kw_type *ecl_kw) { return ecl_kw->size; }
 
 ecl_type_enum ecl_kw_get_type(const ecl_kw_type *ecl_kw) {
@@ -1738,7 +2763,7 @@ ecl_kw_type *ecl_kw_buffer_alloc(buffer_type *buffer) {
     ecl_kw_type *ecl_kw = ecl_kw_alloc_empty();
     ecl_kw_initialize(ecl_kw, header, size, data_type);
     ecl_kw_alloc_data(ecl_kw);
-    buffer_fread(buffer, ecl_kw->data,
+    buffer_fread(buffer, ecl_kw_mutable_data(ecl_kw),
                  ecl_type_get_sizeof_ctype(ecl_kw->data_type), ecl_kw->size);
     return ecl_kw;
 }
@@ -1748,7 +2773,7 @@ void ecl_kw_buffer_store(const ecl_kw_type *ecl_kw, buffer_type *buffer) {
     buffer_fwrite_int(buffer, ecl_kw->size);
     buffer_fwrite_int(buffer, ecl_type_get_type(ecl_kw->data_type));
     buffer_fwrite_int(buffer, ecl_type_get_sizeof_ctype(ecl_kw->data_type));
-    buffer_fwrite(buffer, ecl_kw->data,
+    buffer_fwrite(buffer, ecl_kw_data(ecl_kw),
                   ecl_type_get_sizeof_ctype(ecl_kw->data_type), ecl_kw->size);
 }
 
@@ -1776,10 +2801,10 @@ void ecl_kw_get_data_as_double(const ecl_kw_type *ecl_kw, double *double_data) {
         ecl_kw_get_memcpy_data(ecl_kw, double_data);
     else {
         if (ecl_type_is_float(ecl_kw->data_type)) {
-            const float *float_data = (const float *)ecl_kw->data;
+            const float *float_data = (const float *)ecl_kw_data(ecl_kw);
             util_float_to_double(double_data, float_data, ecl_kw->size);
         } else if (ecl_type_is_int(ecl_kw->data_type)) {
-            const int *int_data = (const int *)ecl_kw->data;
+            const int *int_data = (const int *)ecl_kw_data(ecl_kw);
             int i;
             for (i = 0; i < ecl_kw->size; i++)
                 double_data[i] = int_data[i];
@@ -1800,10 +2825,10 @@ void ecl_kw_get_data_as_float(const ecl_kw_type *ecl_kw, float *float_data) {
         ecl_kw_get_memcpy_data(ecl_kw, float_data);
     else {
         if (ecl_type_is_double(ecl_kw->data_type)) {
-            const double *double_data = (const double *)ecl_kw->data;
+            const double *double_data = (const double *)ecl_kw_data(ecl_kw);
             util_double_to_float(float_data, double_data, ecl_kw->size);
         } else if (ecl_type_is_int(ecl_kw->data_type)) {
-            const int *int_data = (const int *)ecl_kw->data;
+            const int *int_data = (const int *)ecl_kw_data(ecl_kw);
             int i;
             for (i = 0; i < ecl_kw->size; i++)
                 float_data[i] = (float)int_data[i];
@@ -1817,6 +2842,322 @@ void ecl_kw_get_data_as_float(const ecl_kw_type *ecl_kw, float *float_data) {
     }
 }
 
+/*
+  Converts @count numeric elements of type @src_type to float or
+  double, as given by @target_type.
+*/
+static void ecl_kw_convert_numeric(const char *src, ecl_data_type src_type,
+                                   int count, ecl_data_type target_type,
+                                   void *target) {
+    if (ecl_type_is_equal(src_type, target_type))
+        memcpy(target, src,
+               (size_t)count * ecl_type_get_sizeof_ctype(src_type));
+    else if (ecl_type_is_float(src_type) && ecl_type_is_double(target_type))
+        util_float_to_double((double *)target, (const float *)src, count);
+    else if (ecl_type_is_double(src_type) && ecl_type_is_float(target_type))
+        util_double_to_float((float *)target, (const double *)src, count);
+    else if (ecl_type_is_int(src_type)) {
+        const int *int_data = (const int *)src;
+        if (ecl_type_is_double(target_type)) {
+            double *double_data = (double *)target;
+            for (int i = 0; i < count; i++)
+                double_data[i] = int_data[i];
+        } else {
+            float *float_data = (float *)target;
+            for (int i = 0; i < count; i++)
+                float_data[i] = (float)int_data[i];
+        }
+    } else {
+        char *type_name = ecl_type_alloc_name(src_type);
+        util_abort("%s: type:%s can not be converted to a floating point "
+                   "type - aborting \n",
+                   __func__, type_name);
+        free(type_name);
+    }
+}
+
+static void ecl_kw_assert_slice(int element_count, int offset, int count) {
+    if (offset < 0 || count < 0 || offset > element_count - count)
+        util_abort("%s: invalid slice offset:%d count:%d of keyword with %d "
+                   "elements\n",
+                   __func__, offset, count, element_count);
+}
+
+static void ecl_kw_get_slice_as(const ecl_kw_type *ecl_kw, int offset,
+                                int count, ecl_data_type target_type,
+                                void *target) {
+    ecl_kw_assert_slice(ecl_kw->size, offset, count);
+    if (count > 0) {
+        const char *data = ecl_kw_data(ecl_kw);
+        size_t sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+        ecl_kw_convert_numeric(&data[offset * sizeof_ctype], ecl_kw->data_type,
+                               count, target_type, target);
+    }
+}
+
+/*
+  Copies the elements [offset, offset + count) of an int, float or
+  double keyword to @double_data / @float_data, converting the values.
+*/
+void ecl_kw_get_slice_as_double(const ecl_kw_type *ecl_kw, int offset,
+                                int count, double *double_data) {
+    ecl_kw_get_slice_as(ecl_kw, offset, count, ECL_DOUBLE, double_data);
+}
+
+void ecl_kw_get_slice_as_float(const ecl_kw_type *ecl_kw, int offset,
+                               int count, float *float_data) {
+    ecl_kw_get_slice_as(ecl_kw, offset, count, ECL_FLOAT, float_data);
+}
+
+typedef void(ecl_kw_range_func_type)(char *io_data, int range_index,
+                                     int count, void *arg);
+
+/*
+  Reads one record of exactly @record_size bytes into @buffer; returns
+  false if the record markers do not match @record_size.
+*/
+static bool ecl_kw_fread_record(fortio_type *fortio, char *buffer,
+                                int record_size) {
+    return fortio_init_read(fortio) == record_size &&
+           fread(buffer, 1, record_size, fortio_get_FILE(fortio)) ==
+               (size_t)record_size &&
+           fortio_complete_read(fortio, record_size);
+}
+
+/*
+  Reads the range by walking the records of the data section from the
+  start, whatever their size; records before the range are skipped
+  without reading the data. This is the fallback when the keyword has
+  not been written in blocks of get_blocksize() elements.
+*/
+static bool ecl_kw_fread_data_records(fortio_type *fortio,
+                                      offset_type data_offset,
+                                      int sizeof_iotype, int element_count,
+                                      int offset, int count,
+                                      ecl_kw_range_func_type *func,
+                                      void *arg) {
+    char *io_buffer = NULL;
+    int buffer_size = 0;
+    int index = 0;
+    bool read_ok = fortio_fseek(fortio, data_offset, SEEK_SET);
+
+    while (read_ok && index < offset + count) {
+        int record_size = fortio_init_read(fortio);
+        int elements = record_size / sizeof_iotype;
+
+        if (record_size <= 0 || record_size % sizeof_iotype != 0 ||
+            elements > element_count - index) {
+            read_ok = false;
+            break;
+        }
+
+        if (index + elements <= offset)
+            read_ok = fortio_fseek(fortio, record_size, SEEK_CUR) &&
+                      fortio_complete_read(fortio, record_size);
+        else {
+            int first = util_int_max(offset - index, 0);
+            int n = util_int_min(index + elements, offset + count) -
+                    (index + first);
+
+            if (record_size > buffer_size) {
+                io_buffer = (char *)util_realloc(io_buffer, record_size);
+                buffer_size = record_size;
+            }
+            read_ok = fread(io_buffer, 1, record_size,
+                            fortio_get_FILE(fortio)) == (size_t)record_size &&
+                      fortio_complete_read(fortio, record_size);
+            if (read_ok)
+                func(&io_buffer[first * sizeof_iotype], index + first - offset,
+                     n, arg);
+        }
+        index += elements;
+    }
+
+    free(io_buffer);
+    return read_ok;
+}
+
+/*
+  Reads the elements [offset, offset + count) of a keyword from an
+  unformatted file; the data section of the keyword starts at
+  @data_offset and the keyword has @element_count elements. For each
+  record @func is called with the part of the record which is inside
+  the range, and the position of that part in the range; the data is
+  in the on-disk representation, i.e. not byte swapped.
+
+  The keyword is assumed to be written in blocks of get_blocksize()
+  elements, so the records which cover the range are found with one
+  seek and read one at a time into a scratch buffer of one block. The
+  record markers are checked against the expected block size; if they
+  do not match, the range is read with ecl_kw_fread_data_records()
+  instead.
+*/
+static bool ecl_kw_fread_data_range(fortio_type *fortio,
+                                    offset_type data_offset,
+                                    ecl_data_type data_type, int element_count,
+                                    int offset, int count,
+                                    ecl_kw_range_func_type *func, void *arg) {
+    ecl_kw_assert_slice(element_count, offset, count);
+    if (count == 0)
+        return true;
+
+    {
+        const int blocksize = get_blocksize(data_type);
+        const int sizeof_iotype = ecl_type_get_sizeof_iotype(data_type);
+        const int first_block = offset / blocksize;
+        char *io_buffer = (char *)util_malloc(blocksize * sizeof_iotype);
+        bool blocked = true;
+        int index = offset;
+
+        /* The records are contiguous, one seek to the first one suffices. */
+        fortio_fseek(fortio,
+                     data_offset +
+                         (offset_type)first_block *
+                             (blocksize * sizeof_iotype + 2 * sizeof(int)),
+                     SEEK_SET);
+
+        while (blocked && index < offset + count) {
+            int block_start = (index / blocksize) * blocksize;
+            int block_size =
+                util_int_min(element_count - block_start, blocksize);
+            int first = index - block_start;
+            int n = util_int_min(block_size - first, offset + count - index);
+
+            blocked = ecl_kw_fread_record(fortio, io_buffer,
+                                          block_size * sizeof_iotype);
+            if (blocked) {
+                func(&io_buffer[first * sizeof_iotype], index - offset, n,
+                     arg);
+                index += n;
+            }
+        }
+        free(io_buffer);
+
+        if (blocked)
+            return true;
+
+        return ecl_kw_fread_data_records(fortio, data_offset, sizeof_iotype,
+                                         element_count, offset, count, func,
+                                         arg);
+    }
+}
+
+typedef struct {
+    ecl_data_type data_type;
+    ecl_data_type target_type;
+    char *target;
+} ecl_kw_convert_arg_type;
+
+static void ecl_kw_convert_range(char *io_data, int range_index, int count,
+                                 void *arg) {
+    ecl_kw_convert_arg_type *convert_arg = (ecl_kw_convert_arg_type *)arg;
+    int sizeof_ctype = ecl_type_get_sizeof_ctype(convert_arg->target_type);
+    char *target = &convert_arg->target[(size_t)range_index * sizeof_ctype];
+
+    if (ECL_ENDIAN_FLIP && ecl_type_is_float(convert_arg->data_type) &&
+        ecl_type_is_double(convert_arg->target_type)) {
+        /* Byte swapped float records are swapped and widened in one pass. */
+        util_endian_flip_float_to_double((double *)target, io_data, count);
+    } else {
+        if (ECL_ENDIAN_FLIP)
+            util_endian_flip_vector(
+                io_data, ecl_type_get_sizeof_iotype(convert_arg->data_type),
+                count);
+
+        ecl_kw_convert_numeric(io_data, convert_arg->data_type, count,
+                               convert_arg->target_type, target);
+    }
+}
+
+static bool ecl_kw_fread_data_as(fortio_type *fortio, offset_type data_offset,
+                                 ecl_data_type data_type, int element_count,
+                                 int offset, int count,
+                                 ecl_data_type target_type, void *target) {
+    if (!(ecl_type_is_int(data_type) || ecl_type_is_float(data_type) ||
+          ecl_type_is_double(data_type))) {
+        char *type_name = ecl_type_alloc_name(data_type);
+        util_abort("%s: type:%s can not be converted to a floating point "
+                   "type - aborting \n",
+                   __func__, type_name);
+        free(type_name);
+    }
+
+    {
+        ecl_kw_convert_arg_type arg = {data_type, target_type, (char *)target};
+        return ecl_kw_fread_data_range(fortio, data_offset, data_type,
+                                       element_count, offset, count,
+                                       ecl_kw_convert_range, &arg);
+    }
+}
+
+typedef struct {
+    size_t sizeof_iotype;
+    char *target;
+} ecl_kw_copy_arg_type;
+
+static void ecl_kw_copy_range(char *io_data, int range_index, int count,
+                              void *arg) {
+    ecl_kw_copy_arg_type *copy_arg = (ecl_kw_copy_arg_type *)arg;
+    memcpy(&copy_arg->target[range_index * copy_arg->sizeof_iotype], io_data,
+           count * copy_arg->sizeof_iotype);
+}
+
+/*
+  Reads the elements [offset, offset + size) of the keyword whose data
+  section starts at @data_offset in an unformatted file into @ecl_kw,
+  where size is the size of @ecl_kw. The keyword in the file has
+  @element_count elements, and must have the same type as @ecl_kw.
+  Only the records covering the slice are read, unless the keyword has
+  not been written in the standard blocks. Returns false if the
+  records in the file are not valid.
+*/
+bool ecl_kw_fread_data_slice(ecl_kw_type *ecl_kw, fortio_type *fortio,
+                             offset_type data_offset, int element_count,
+                             int offset) {
+    if (ecl_kw->size == 0)
+        return true;
+    {
+        char *buffer = ecl_kw_alloc_input_buffer(ecl_kw);
+        ecl_kw_copy_arg_type arg = {
+            (size_t)ecl_type_get_sizeof_iotype(ecl_kw->data_type), buffer};
+        bool read_ok = ecl_kw_fread_data_range(
+            fortio, data_offset, ecl_kw->data_type, element_count, offset,
+            ecl_kw->size, ecl_kw_copy_range, &arg);
+
+        if (read_ok)
+            ecl_kw_load_from_input_buffer(ecl_kw, buffer);
+
+        free(buffer);
+        return read_ok;
+    }
+}
+
+/*
+  Reads the elements [offset, offset + count) of an int, float or
+  double keyword directly from an unformatted file into the caller
+  supplied buffer, converting to double or float on the way. The data
+  section of the keyword, i.e. the first record after the header,
+  starts at file offset @data_offset and the keyword has
+  @element_count elements. With the standard blocking only the records
+  which contain the slice are read, and the data is read one record at
+  a time, so no buffer with the size of the keyword is allocated.
+
+  Returns false if the records in the file are not valid.
+*/
+bool ecl_kw_fread_data_as_double(fortio_type *fortio, offset_type data_offset,
+                                 ecl_data_type data_type, int element_count,
+                                 int offset, int count, double *double_data) {
+    return ecl_kw_fread_data_as(fortio, data_offset, data_type, element_count,
+                                offset, count, ECL_DOUBLE, double_data);
+}
+
+bool ecl_kw_fread_data_as_float(fortio_type *fortio, offset_type data_offset,
+                                ecl_data_type data_type, int element_count,
+                                int offset, int count, float *float_data) {
+    return ecl_kw_fread_data_as(fortio, data_offset, data_type, element_count,
+                                offset, count, ECL_FLOAT, float_data);
+}
+
 /**
    Will create a new keyword of the same type as src_kw, and size
    @target_size. The integer array mapping is a list sizeof(src_kw)
@@ -1869,12 +3210,12 @@ ecl_kw_type *ecl_kw_alloc_scatter_copy(const ecl_kw_type *src_kw,
     }
 
     {
-        int sizeof_ctype = ecl_type_get_sizeof_ctype(src_kw->data_type);
+        size_t sizeof_ctype = ecl_type_get_sizeof_ctype(src_kw->data_type);
         int i;
         for (i = 0; i < src_kw->size; i++) {
             int target_index = mapping[i];
-            memcpy(&new_kw->data[target_index * sizeof_ctype],
-                   &src_kw->data[i * sizeof_ctype], sizeof_ctype);
+            memcpy(&ecl_kw_mutable_data(new_kw)[target_index * sizeof_ctype],
+                   &ecl_kw_data(src_kw)[i * sizeof_ctype], sizeof_ctype);
         }
     }
 
@@ -1900,7 +3241,7 @@ ecl_kw_type *ecl_kw_alloc_global_copy(const ecl_kw_type *src,
                 global_copy = NULL;
                 break;
             }
-            const void *value_ptr = ecl_kw_iget_ptr(src, src_index);
+            const void *value_ptr = ecl_kw_iget_ptr_static(src, src_index);
             ecl_kw_iset_static(global_copy, global_index, value_ptr);
             src_index++;
         }
@@ -1919,15 +3260,38 @@ void ecl_kw_fread_double_param(const char *filename, bool fmt_file,
                                double *double_data) {
     fortio_type *fortio =
         fortio_open_reader(filename, fmt_file, ECL_ENDIAN_FLIP);
-    ecl_kw_type *ecl_kw = ecl_kw_fread_alloc(fortio);
+    ecl_kw_type *ecl_kw = ecl_kw_alloc_empty();
+    bool read_ok = false;
+
+    if (ecl_kw_fread_header(ecl_kw, fortio) == ECL_KW_READ_OK) {
+        /*
+          Binary float parameters which must be byte swapped are swapped
+          and converted to double in one pass, without going through the
+          float storage of the keyword.
+        */
+        if (!fmt_file && ECL_ENDIAN_FLIP &&
+            ecl_type_is_float(ecl_kw->data_type)) {
+            size_t byte_size = (size_t)ecl_kw->size * sizeof(float);
+            char *buffer = (char *)util_malloc(byte_size);
+            read_ok = fortio_fread_buffer(fortio, buffer, byte_size);
+            if (read_ok)
+                util_endian_flip_float_to_double(double_data, buffer,
+                                                 ecl_kw->size);
+            free(buffer);
+        } else {
+            ecl_kw_alloc_data(ecl_kw);
+            read_ok = ecl_kw_fread_data(ecl_kw, fortio);
+            if (read_ok)
+                ecl_kw_get_data_as_double(ecl_kw, double_data);
+        }
+    }
     fortio_fclose(fortio);
 
-    if (ecl_kw == NULL)
+    if (!read_ok)
         util_abort(
             "%s: fatal error: loading parameter from: %s failed - aborting \n",
             __func__, filename);
 
-    ecl_kw_get_data_as_double(ecl_kw, double_data);
     ecl_kw_free(ecl_kw);
 }
 
@@ -1969,24 +3333,96 @@ void ecl_kw_scalar_set_float_or_double(ecl_kw_type *ecl_kw, double value) {
   Untyped - low level alternative.
 */
 void ecl_kw_scalar_set__(ecl_kw_type *ecl_kw, const void *value) {
-    int sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
+    size_t sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw->data_type);
     int i;
     for (i = 0; i < ecl_kw->size; i++)
-        memcpy(&ecl_kw->data[i * sizeof_ctype], value, sizeof_ctype);
+        memcpy(&ecl_kw_mutable_data(ecl_kw)[i * sizeof_ctype], value,
+               sizeof_ctype);
 }
 
 void ecl_kw_alloc_double_data(ecl_kw_type *ecl_kw, double *values) {
     ecl_kw_alloc_data(ecl_kw);
-    memcpy(ecl_kw->data, values,
-           ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
+    memcpy(ecl_kw_mutable_data(ecl_kw), values, ecl_kw_ctype_byte_size(ecl_kw));
 }
 
 void ecl_kw_alloc_float_data(ecl_kw_type *ecl_kw, float *values) {
     ecl_kw_alloc_data(ecl_kw);
-    memcpy(ecl_kw->data, values,
-           ecl_kw->size * ecl_type_get_sizeof_ctype(ecl_kw->data_type));
+    memcpy(ecl_kw_mutable_data(ecl_kw), values, ecl_kw_ctype_byte_size(ecl_kw));
 }
 
+/*
+  The element wise arithmetic is done by the small kernels below. The
+  loops are annotated with 'omp simd', which is honoured when the
+  library is compiled with -fopenmp-simd (or full OpenMP), so the loops
+  are vectorized also without -O3 and without runtime alias checks;
+  the target and source may be the same keyword, but must not overlap
+  otherwise. When the compiler supports it (HAVE_TARGET_CLONES) the
+  kernels are compiled both for AVX2 and for the baseline instruction
+  set, and the version matching the cpu is selected at load time.
+*/
+
+#ifdef HAVE_TARGET_CLONES
+#define ECL_KW_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define ECL_KW_KERNEL
+#endif
+
+#define ECL_KW_UNARY_KERNEL(name, ctype, expr)                                 \
+    ECL_KW_KERNEL static void ecl_kw_##name##_kernel_##ctype(                  \
+        ctype *data, ctype value, int size) {                                  \
+        _Pragma("omp simd") for (int i = 0; i < size; i++) data[i] = expr;     \
+    }
+
+#define ECL_KW_BINARY_KERNEL(name, ctype, expr)                                \
+    ECL_KW_KERNEL static void ecl_kw_##name##_kernel_##ctype(                  \
+        ctype *target, const ctype *src, int size) {                           \
+        _Pragma("omp simd") for (int i = 0; i < size; i++) target[i] = expr;   \
+    }
+
+#define ECL_KW_KERNELS(ctype)                                                  \
+    ECL_KW_UNARY_KERNEL(scale, ctype, data[i] * value)                         \
+    ECL_KW_UNARY_KERNEL(shift, ctype, data[i] + value)                         \
+    ECL_KW_BINARY_KERNEL(add, ctype, target[i] + src[i])                       \
+    ECL_KW_BINARY_KERNEL(sub, ctype, target[i] - src[i])                       \
+    ECL_KW_BINARY_KERNEL(mul, ctype, target[i] * src[i])                       \
+    ECL_KW_BINARY_KERNEL(div, ctype, target[i] / src[i])                       \
+    ECL_KW_BINARY_KERNEL(add_squared, ctype, target[i] + src[i] * src[i])
+
+ECL_KW_KERNELS(int)
+ECL_KW_KERNELS(float)
+ECL_KW_KERNELS(double)
+#undef ECL_KW_KERNELS
+
+/* The squares of int values are accumulated in double, see
+   ecl_kw_inplace_add_moments(). */
+#define ECL_KW_ADD_MOMENTS_KERNEL(ctype, sum2_type)                            \
+    ECL_KW_KERNEL static void ecl_kw_add_moments_kernel_##ctype(               \
+        ctype *sum, sum2_type *sum2, const ctype *src, int size) {             \
+        _Pragma("omp simd") for (int i = 0; i < size; i++) {                   \
+            sum[i] += src[i];                                                  \
+            sum2[i] += (sum2_type)src[i] * src[i];                             \
+        }                                                                      \
+    }
+
+ECL_KW_ADD_MOMENTS_KERNEL(int, double)
+ECL_KW_ADD_MOMENTS_KERNEL(float, float)
+ECL_KW_ADD_MOMENTS_KERNEL(double, double)
+#undef ECL_KW_ADD_MOMENTS_KERNEL
+
+#define ECL_KW_ADD_SCALED_KERNEL(ctype)                                        \
+    ECL_KW_KERNEL static void ecl_kw_add_scaled_kernel_##ctype(                \
+        ctype *target, ctype scale, const ctype *src, int size) {              \
+        _Pragma("omp simd") for (int i = 0; i < size; i++) {                   \
+            target[i] += scale * src[i];                                       \
+        }                                                                      \
+    }
+
+ECL_KW_ADD_SCALED_KERNEL(float)
+ECL_KW_ADD_SCALED_KERNEL(double)
+#undef ECL_KW_ADD_SCALED_KERNEL
+#undef ECL_KW_BINARY_KERNEL
+#undef ECL_KW_UNARY_KERNEL
+
 #define ECL_KW_SCALE_TYPED(ctype, ECL_TYPE)                                    \
     void ecl_kw_scale_##ctype(ecl_kw_type *ecl_kw, ctype scale_factor) {       \
         if (ecl_kw_get_type(ecl_kw) != ECL_TYPE)                               \
@@ -1994,10 +3430,8 @@ void ecl_kw_alloc_float_data(ecl_kw_type *ecl_kw, float *values) {
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
         {                                                                      \
             ctype *data = (ctype *)ecl_kw_get_data_ref(ecl_kw);                \
-            int size = ecl_kw_get_size(ecl_kw);                                \
-            int i;                                                             \
-            for (i = 0; i < size; i++)                                         \
-                data[i] *= scale_factor;                                       \
+            ecl_kw_scale_kernel_##ctype(data, scale_factor,                    \
+                                        ecl_kw_get_size(ecl_kw));              \
         }                                                                      \
     }
 
@@ -2023,10 +3457,8 @@ void ecl_kw_scale_float_or_double(ecl_kw_type *ecl_kw, double scale_factor) {
                        __func__, ecl_kw_get_header8(ecl_kw));                  \
         {                                                                      \
             ctype *data = (ctype *)ecl_kw_get_data_ref(ecl_kw);                \
-            int size = ecl_kw_get_size(ecl_kw);                                \
-            int i;                                                             \
-            for (i = 0; i < size; i++)                                         \
-                data[i] += shift_value;                                        \
+            ecl_kw_shift_kernel_##ctype(data, shift_value,                     \
+                                        ecl_kw_get_size(ecl_kw));              \
         }                                                                      \
     }
 
@@ -2073,8 +3505,8 @@ void ecl_kw_copy_indexed(ecl_kw_type *target_kw,
         util_abort("%s: type/size  mismatch\n", __func__);
     {
         char *target_data = (char *)ecl_kw_get_data_ref(target_kw);
-        const char *src_data = (const char *)ecl_kw_get_data_ref(src_kw);
-        int sizeof_ctype = ecl_type_get_sizeof_ctype(target_kw->data_type);
+        const char *src_data = (const char *)ecl_kw_data(src_kw);
+        size_t sizeof_ctype = ecl_type_get_sizeof_ctype(target_kw->data_type);
         int set_size = int_vector_size(index_set);
         const int *index_data = int_vector_get_const_ptr(index_set);
         int i;
@@ -2094,8 +3526,7 @@ void ecl_kw_copy_indexed(ecl_kw_type *target_kw,
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *add_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(add_kw);                    \
+            const ctype *add_data = (const ctype *)ecl_kw_data(add_kw);        \
             int set_size = int_vector_size(index_set);                         \
             const int *index_data = int_vector_get_const_ptr(index_set);       \
             int i;                                                             \
@@ -2138,11 +3569,9 @@ void ecl_kw_inplace_add_indexed(ecl_kw_type *target_kw,
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *add_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(add_kw);                    \
-            int i;                                                             \
-            for (i = 0; i < target_kw->size; i++)                              \
-                target_data[i] += add_data[i];                                 \
+            const ctype *add_data = (const ctype *)ecl_kw_data(add_kw);        \
+            ecl_kw_add_kernel_##ctype(target_data, add_data,                   \
+                                      target_kw->size);                        \
         }                                                                      \
     }
 ECL_KW_TYPED_INPLACE_ADD(int)
@@ -2176,11 +3605,9 @@ void ecl_kw_inplace_add(ecl_kw_type *target_kw, const ecl_kw_type *add_kw) {
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *add_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(add_kw);                    \
-            int i;                                                             \
-            for (i = 0; i < target_kw->size; i++)                              \
-                target_data[i] += add_data[i] * add_data[i];                   \
+            const ctype *add_data = (const ctype *)ecl_kw_data(add_kw);        \
+            ecl_kw_add_squared_kernel_##ctype(target_data, add_data,           \
+                                              target_kw->size);                \
         }                                                                      \
     }
 ECL_KW_TYPED_INPLACE_ADD_SQUARED(int)
@@ -2208,6 +3635,83 @@ void ecl_kw_inplace_add_squared(ecl_kw_type *target_kw,
     }
 }
 
+/**
+   Will update @target_kw as target_kw += scale * add_kw in one pass
+   over the data. The keywords must be of the same size and of type
+   float or double.
+*/
+
+void ecl_kw_inplace_add_scaled(ecl_kw_type *target_kw, double scale,
+                               const ecl_kw_type *add_kw) {
+    if (!ecl_kw_size_and_numeric_type_equal(target_kw, add_kw))
+        util_abort("%s: type/size  mismatch\n", __func__);
+
+    switch (ecl_kw_get_type(target_kw)) {
+    case (ECL_FLOAT_TYPE):
+        ecl_kw_add_scaled_kernel_float(
+            (float *)ecl_kw_get_data_ref(target_kw), (float)scale,
+            (const float *)ecl_kw_data(add_kw), target_kw->size);
+        break;
+    case (ECL_DOUBLE_TYPE):
+        ecl_kw_add_scaled_kernel_double(
+            (double *)ecl_kw_get_data_ref(target_kw), scale,
+            (const double *)ecl_kw_data(add_kw), target_kw->size);
+        break;
+    default:
+        util_abort("%s: inplace add not implemented for type:%s \n", __func__,
+                   ecl_type_alloc_name(ecl_kw_get_data_type(target_kw)));
+    }
+}
+
+/**
+   Will add @add_kw to @sum_kw and the square of @add_kw to @sum2_kw,
+   reading @add_kw only once. This is the accumulation step when
+   calculating the mean and variance of an ensemble of keywords. All
+   three keywords must have the same size, and @sum_kw must have the
+   numeric type of @add_kw. The square of an int can overflow an int,
+   so for int keywords @sum2_kw must be of type double; otherwise it
+   has the type of @add_kw.
+*/
+
+void ecl_kw_inplace_add_moments(ecl_kw_type *sum_kw, ecl_kw_type *sum2_kw,
+                                const ecl_kw_type *add_kw) {
+    bool sum2_ok;
+    if (ecl_type_is_int(add_kw->data_type))
+        sum2_ok = ecl_type_is_double(sum2_kw->data_type) &&
+                  sum2_kw->size == add_kw->size;
+    else
+        sum2_ok = ecl_kw_size_and_type_equal(sum2_kw, add_kw);
+
+    if (!ecl_kw_size_and_numeric_type_equal(sum_kw, add_kw) || !sum2_ok)
+        util_abort("%s: type/size  mismatch\n", __func__);
+
+    {
+        void *sum = ecl_kw_get_data_ref(sum_kw);
+        void *sum2 = ecl_kw_get_data_ref(sum2_kw);
+        const void *data = ecl_kw_data(add_kw);
+
+        switch (ecl_kw_get_type(sum_kw)) {
+        case (ECL_FLOAT_TYPE):
+            ecl_kw_add_moments_kernel_float((float *)sum, (float *)sum2,
+                                            (const float *)data, sum_kw->size);
+            break;
+        case (ECL_DOUBLE_TYPE):
+            ecl_kw_add_moments_kernel_double((double *)sum, (double *)sum2,
+                                             (const double *)data,
+                                             sum_kw->size);
+            break;
+        case (ECL_INT_TYPE):
+            ecl_kw_add_moments_kernel_int((int *)sum, (double *)sum2,
+                                          (const int *)data, sum_kw->size);
+            break;
+        default:
+            util_abort("%s: inplace add not implemented for type:%s \n",
+                       __func__,
+                       ecl_type_alloc_name(ecl_kw_get_data_type(sum_kw)));
+        }
+    }
+}
+
 #define ECL_KW_TYPED_INPLACE_SUB(ctype)                                        \
     void ecl_kw_inplace_sub_##ctype(ecl_kw_type *target_kw,                    \
                                     const ecl_kw_type *sub_kw) {               \
@@ -2215,11 +3719,9 @@ void ecl_kw_inplace_add_squared(ecl_kw_type *target_kw,
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *sub_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(sub_kw);                    \
-            int i;                                                             \
-            for (i = 0; i < target_kw->size; i++)                              \
-                target_data[i] -= sub_data[i];                                 \
+            const ctype *sub_data = (const ctype *)ecl_kw_data(sub_kw);        \
+            ecl_kw_sub_kernel_##ctype(target_data, sub_data,                   \
+                                      target_kw->size);                        \
         }                                                                      \
     }
 ECL_KW_TYPED_INPLACE_SUB(int)
@@ -2253,8 +3755,7 @@ void ecl_kw_inplace_sub(ecl_kw_type *target_kw, const ecl_kw_type *sub_kw) {
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *sub_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(sub_kw);                    \
+            const ctype *sub_data = (const ctype *)ecl_kw_data(sub_kw);        \
             int set_size = int_vector_size(index_set);                         \
             const int *index_data = int_vector_get_const_ptr(index_set);       \
             int i;                                                             \
@@ -2293,8 +3794,7 @@ void ecl_kw_inplace_sub_indexed(ecl_kw_type *target_kw,
 #define ECL_KW_TYPED_INPLACE_ABS(ctype, abs_func)                              \
     void ecl_kw_inplace_abs_##ctype(ecl_kw_type *kw) {                         \
         ctype *data = (ctype *)ecl_kw_get_data_ref(kw);                        \
-        int i;                                                                 \
-        for (i = 0; i < kw->size; i++)                                         \
+        _Pragma("omp simd") for (int i = 0; i < kw->size; i++)                 \
             data[i] = abs_func(data[i]);                                       \
     }
 
@@ -2321,13 +3821,16 @@ void ecl_kw_inplace_abs(ecl_kw_type *kw) {
     }
 }
 
-static int sqrti(int x) { return round(sqrt(x)); }
+/*
+  The square root is never negative, so adding 0.5 and truncating
+  rounds like round(), but unlike round() it is vectorized.
+*/
+static inline int sqrti(int x) { return (int)(sqrt((double)x) + 0.5); }
 
 #define ECL_KW_TYPED_INPLACE_SQRT(ctype, sqrt_func)                            \
     void ecl_kw_inplace_sqrt_##ctype(ecl_kw_type *kw) {                        \
         ctype *data = (ctype *)ecl_kw_get_data_ref(kw);                        \
-        int i;                                                                 \
-        for (i = 0; i < kw->size; i++)                                         \
+        _Pragma("omp simd") for (int i = 0; i < kw->size; i++)                 \
             data[i] = sqrt_func(data[i]);                                      \
     }
 
@@ -2361,11 +3864,9 @@ void ecl_kw_inplace_sqrt(ecl_kw_type *kw) {
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *mul_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(mul_kw);                    \
-            int i;                                                             \
-            for (i = 0; i < target_kw->size; i++)                              \
-                target_data[i] *= mul_data[i];                                 \
+            const ctype *mul_data = (const ctype *)ecl_kw_data(mul_kw);        \
+            ecl_kw_mul_kernel_##ctype(target_data, mul_data,                   \
+                                      target_kw->size);                        \
         }                                                                      \
     }
 ECL_KW_TYPED_INPLACE_MUL(int)
@@ -2399,8 +3900,7 @@ void ecl_kw_inplace_mul(ecl_kw_type *target_kw, const ecl_kw_type *mul_kw) {
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *mul_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(mul_kw);                    \
+            const ctype *mul_data = (const ctype *)ecl_kw_data(mul_kw);        \
             int set_size = int_vector_size(index_set);                         \
             const int *index_data = int_vector_get_const_ptr(index_set);       \
             int i;                                                             \
@@ -2443,11 +3943,9 @@ void ecl_kw_inplace_mul_indexed(ecl_kw_type *target_kw,
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *div_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(div_kw);                    \
-            int i;                                                             \
-            for (i = 0; i < target_kw->size; i++)                              \
-                target_data[i] /= div_data[i];                                 \
+            const ctype *div_data = (const ctype *)ecl_kw_data(div_kw);        \
+            ecl_kw_div_kernel_##ctype(target_data, div_data,                   \
+                                      target_kw->size);                        \
         }                                                                      \
     }
 ECL_KW_TYPED_INPLACE_DIV(int)
@@ -2481,8 +3979,7 @@ void ecl_kw_inplace_div(ecl_kw_type *target_kw, const ecl_kw_type *div_kw) {
             util_abort("%s: type/size  mismatch\n", __func__);                 \
         {                                                                      \
             ctype *target_data = (ctype *)ecl_kw_get_data_ref(target_kw);      \
-            const ctype *div_data =                                            \
-                (const ctype *)ecl_kw_get_data_ref(div_kw);                    \
+            const ctype *div_data = (const ctype *)ecl_kw_data(div_kw);        \
             int set_size = int_vector_size(index_set);                         \
             const int *index_data = int_vector_get_const_ptr(index_set);       \
             int i;                                                             \
@@ -2527,7 +4024,7 @@ bool ecl_kw_inplace_safe_div(ecl_kw_type *target_kw,
         return false;
 
     float *target_data = (float *)ecl_kw_get_data_ref(target_kw);
-    const int *div_data = (const int *)ecl_kw_get_data_ref(divisor);
+    const int *div_data = (const int *)ecl_kw_data(divisor);
     for (int i = 0; i < target_kw->size; i++) {
         if (div_data[i] != 0)
             target_data[i] /= div_data[i];
@@ -2617,14 +4114,251 @@ bool ecl_kw_is_kw_file(fortio_type *fortio) {
     return kw_file;
 }
 
+/*
+  The reductions below are vectorized with the same kind of kernels as
+  the arithmetic functions above. Keywords with at least
+  ecl_kw_parallel_threshold elements are in addition split in one chunk
+  per thread; the chunks are reduced concurrently and the partial
+  results combined afterwards. The number of threads defaults to the
+  number of cpus, and both settings can be changed at runtime; with one
+  thread or a threshold <= 0 everything runs in the calling thread.
+
+  Sums are by default accumulated in the type of the keyword. With
+  ecl_kw_set_compensated_sum(true) the float and double sums are instead
+  accumulated in double precision with Kahan summation, which keeps the
+  result accurate also for very large keywords.
+*/
+
+#define ECL_KW_DEFAULT_PARALLEL_THRESHOLD (1 << 20)
+#define ECL_KW_SUM_LANES 8
+#define ECL_KW_COMPARE_BLOCK 1024
+
+static std::atomic<int>
+    ecl_kw_parallel_threshold(ECL_KW_DEFAULT_PARALLEL_THRESHOLD);
+static std::atomic<int> ecl_kw_reduce_threads(0);
+static std::atomic<bool> ecl_kw_compensated_sum(false);
+
+void ecl_kw_set_parallel_threshold(int threshold) {
+    ecl_kw_parallel_threshold = threshold;
+}
+
+int ecl_kw_get_parallel_threshold() { return ecl_kw_parallel_threshold; }
+
+/*
+  Sets the number of threads used for the reductions; a value <= 0
+  means one thread per cpu.
+*/
+void ecl_kw_set_reduce_threads(int num_threads) {
+    ecl_kw_reduce_threads = num_threads;
+}
+
+int ecl_kw_get_reduce_threads() {
+    int num_threads = ecl_kw_reduce_threads;
+    if (num_threads <= 0)
+        num_threads = std::thread::hardware_concurrency();
+    return util_int_max(num_threads, 1);
+}
+
+void ecl_kw_set_compensated_sum(bool compensated) {
+    ecl_kw_compensated_sum = compensated;
+}
+
+bool ecl_kw_get_compensated_sum() { return ecl_kw_compensated_sum; }
+
+static int ecl_kw_reduce_num_chunks(int size) {
+    int threshold = ecl_kw_parallel_threshold;
+    if (threshold <= 0 || size < threshold)
+        return 1;
+
+    return util_int_max(1, util_int_min(ecl_kw_get_reduce_threads(), size));
+}
+
+/*
+  Calls @reduce(start, end) for consecutive chunks covering [0, size)
+  and returns the partial results in chunk order. The first chunk is
+  reduced by the calling thread.
+*/
+template <typename T, typename F>
+static std::vector<T> ecl_kw_parallel_reduce(int size, F reduce) {
+    int num_chunks = ecl_kw_reduce_num_chunks(size);
+    std::vector<T> partial(num_chunks);
+    std::vector<std::thread> threads;
+
+    for (int chunk = 1; chunk < num_chunks; chunk++) {
+        int start = (int)((int64_t)size * chunk / num_chunks);
+        int end = (int)((int64_t)size * (chunk + 1) / num_chunks);
+        threads.emplace_back([&partial, &reduce, chunk, start, end]() {
+            partial[chunk] = reduce(start, end);
+        });
+    }
+
+    partial[0] = reduce(0, (int)((int64_t)size / num_chunks));
+    for (auto &thread : threads)
+        thread.join();
+
+    return partial;
+}
+
+/*
+  Neumaier's variant of Kahan summation, used to combine the lanes and
+  the chunks of the compensated sums.
+*/
+static double ecl_kw_neumaier_sum(const double *values, int size) {
+    double sum = 0;
+    double comp = 0;
+    for (int i = 0; i < size; i++) {
+        double t = sum + values[i];
+        if (fabs(sum) >= fabs(values[i]))
+            comp += (sum - t) + values[i];
+        else
+            comp += (values[i] - t) + sum;
+        sum = t;
+    }
+    return sum + comp;
+}
+
+#define ECL_KW_ELEMENT(i) data[i]
+#define ECL_KW_INDEXED_ELEMENT(i) data[index[i]]
+
+#define ECL_KW_SUM_KERNEL(name, ctype, ELEMENT)                                \
+    ECL_KW_KERNEL static ctype ecl_kw_##name##_kernel_##ctype(                 \
+        const ctype *data, const int *index, int size) {                       \
+        ctype sum = 0;                                                         \
+        _Pragma("omp simd reduction(+ : sum)") for (int i = 0; i < size; i++) \
+            sum += ELEMENT(i);                                                 \
+        return sum;                                                            \
+    }
+
+/*
+  The Kahan kernels run ECL_KW_SUM_LANES independent compensated sums
+  side by side, so that the inner loop can be vectorized without
+  reordering the operations within each lane.
+*/
+#define ECL_KW_KAHAN_KERNEL(name, ctype, ELEMENT)                              \
+    ECL_KW_KERNEL static double ecl_kw_##name##_kernel_##ctype(                \
+        const ctype *data, const int *index, int size) {                       \
+        double lanes[2 * ECL_KW_SUM_LANES] = {0};                              \
+        double *sum = &lanes[0];                                               \
+        double *comp = &lanes[ECL_KW_SUM_LANES];                               \
+        int i = 0;                                                             \
+        for (; i + ECL_KW_SUM_LANES <= size; i += ECL_KW_SUM_LANES) {          \
+            _Pragma("omp simd") for (int j = 0; j < ECL_KW_SUM_LANES; j++) {   \
+                double y = ELEMENT(i + j) - comp[j];                           \
+                double t = sum[j] + y;                                         \
+                comp[j] = (t - sum[j]) - y;                                    \
+                sum[j] = t;                                                    \
+            }                                                                  \
+        }                                                                      \
+        for (; i < size; i++) {                                                \
+            double y = ELEMENT(i) - comp[0];                                   \
+            double t = sum[0] + y;                                             \
+            comp[0] = (t - sum[0]) - y;                                        \
+            sum[0] = t;                                                        \
+        }                                                                      \
+        for (int j = 0; j < ECL_KW_SUM_LANES; j++)                             \
+            comp[j] = -comp[j];                                                \
+        return ecl_kw_neumaier_sum(lanes, 2 * ECL_KW_SUM_LANES);               \
+    }
+
+#define ECL_KW_REDUCE_KERNELS(ctype)                                           \
+    ECL_KW_SUM_KERNEL(sum, ctype, ECL_KW_ELEMENT)                              \
+    ECL_KW_SUM_KERNEL(sum_indexed, ctype, ECL_KW_INDEXED_ELEMENT)              \
+                                                                               \
+    ECL_KW_KERNEL static void ecl_kw_max_min_kernel_##ctype(                   \
+        const ctype *data, int size, ctype *_max, ctype *_min) {               \
+        ctype max = data[0];                                                   \
+        ctype min = data[0];                                                   \
+        _Pragma("omp simd reduction(max : max) reduction(min : min)") for (    \
+            int i = 1; i < size; i++) {                                        \
+            max = (data[i] > max) ? data[i] : max;                             \
+            min = (data[i] < min) ? data[i] : min;                             \
+        }                                                                      \
+        *_max = max;                                                           \
+        *_min = min;                                                           \
+    }
+
+ECL_KW_REDUCE_KERNELS(int)
+ECL_KW_REDUCE_KERNELS(float)
+ECL_KW_REDUCE_KERNELS(double)
+ECL_KW_KAHAN_KERNEL(kahan_sum, float, ECL_KW_ELEMENT)
+ECL_KW_KAHAN_KERNEL(kahan_sum, double, ECL_KW_ELEMENT)
+ECL_KW_KAHAN_KERNEL(kahan_sum_indexed, float, ECL_KW_INDEXED_ELEMENT)
+ECL_KW_KAHAN_KERNEL(kahan_sum_indexed, double, ECL_KW_INDEXED_ELEMENT)
+#undef ECL_KW_REDUCE_KERNELS
+#undef ECL_KW_KAHAN_KERNEL
+
+ECL_KW_KERNEL static int ecl_kw_sum_indexed_kernel_bool(const bool *data,
+                                                       const int *index,
+                                                       int size) {
+    int sum = 0;
+    _Pragma("omp simd reduction(+ : sum)") for (int i = 0; i < size; i++)
+        sum += data[index[i]];
+    return sum;
+}
+
+#undef ECL_KW_SUM_KERNEL
+#undef ECL_KW_INDEXED_ELEMENT
+#undef ECL_KW_ELEMENT
+
+/*
+  Runs a sum kernel over all the elements of @data, or over the elements
+  selected by @index when @index != NULL.
+*/
+template <typename R, typename T>
+static std::vector<R> ecl_kw_sum_chunks(R (*kernel)(const T *, const int *,
+                                                    int),
+                                        const T *data, const int *index,
+                                        int size) {
+    return ecl_kw_parallel_reduce<R>(size, [=](int start, int end) {
+        if (index)
+            return kernel(data, &index[start], end - start);
+        else
+            return kernel(&data[start], NULL, end - start);
+    });
+}
+
+template <typename R, typename T>
+static R ecl_kw_sum__(R (*kernel)(const T *, const int *, int), const T *data,
+                      const int *index, int size) {
+    std::vector<R> partial = ecl_kw_sum_chunks(kernel, data, index, size);
+    R sum = 0;
+    for (R value : partial)
+        sum += value;
+    return sum;
+}
+
+template <typename T>
+static double ecl_kw_kahan_sum__(double (*kernel)(const T *, const int *, int),
+                                 const T *data, const int *index, int size) {
+    std::vector<double> partial =
+        ecl_kw_sum_chunks(kernel, data, index, size);
+    return ecl_kw_neumaier_sum(partial.data(), partial.size());
+}
+
+template <typename T>
+static void ecl_kw_max_min__(void (*kernel)(const T *, int, T *, T *),
+                             const T *data, int size, T *max, T *min) {
+    std::vector<std::pair<T, T>> partial = ecl_kw_parallel_reduce<
+        std::pair<T, T>>(size, [=](int start, int end) {
+        std::pair<T, T> max_min;
+        kernel(&data[start], end - start, &max_min.first, &max_min.second);
+        return max_min;
+    });
+
+    *max = partial[0].first;
+    *min = partial[0].second;
+    for (const auto &max_min : partial) {
+        *max = (max_min.first > *max) ? max_min.first : *max;
+        *min = (max_min.second < *min) ? max_min.second : *min;
+    }
+}
+
 #define KW_MAX_MIN(type)                                                       \
     {                                                                          \
-        type *data = (type *)ecl_kw_get_data_ref(ecl_kw);                      \
-        type max = data[0];                                                    \
-        type min = data[0];                                                    \
-        int i;                                                                 \
-        for (i = 1; i < ecl_kw_get_size(ecl_kw); i++)                          \
-            util_update_##type##_max_min(data[i], &max, &min);                 \
+        type max, min;                                                         \
+        ecl_kw_max_min__(ecl_kw_max_min_kernel_##type,                         \
+                         (const type *)ecl_kw_data(ecl_kw),                    \
+                         ecl_kw_get_size(ecl_kw), &max, &min);                 \
         memcpy(_max, &max, ecl_type_get_sizeof_ctype(ecl_kw->data_type));      \
         memcpy(_min, &min, ecl_type_get_sizeof_ctype(ecl_kw->data_type));      \
     }
@@ -2684,12 +4418,21 @@ ECL_KW_MIN(double)
 
 #define KW_SUM_INDEXED(type)                                                   \
     {                                                                          \
-        const type *data = (const type *)ecl_kw_get_data_ref(ecl_kw);          \
-        type sum = 0;                                                          \
+        const type *data = (const type *)ecl_kw_data(ecl_kw);                  \
+        const int *index_ptr = int_vector_get_const_ptr(index_list);           \
         int size = int_vector_size(index_list);                                \
+        type sum = ecl_kw_sum__(ecl_kw_sum_indexed_kernel_##type, data,        \
+                                index_ptr, size);                              \
+        memcpy(_sum, &sum, ecl_type_get_sizeof_ctype(ecl_kw->data_type));      \
+    }
+
+#define KW_KAHAN_SUM_INDEXED(type)                                             \
+    {                                                                          \
+        const type *data = (const type *)ecl_kw_data(ecl_kw);                  \
         const int *index_ptr = int_vector_get_const_ptr(index_list);           \
-        for (int i = 0; i < size; i++)                                         \
-            sum += data[index_ptr[i]];                                         \
+        int size = int_vector_size(index_list);                                \
+        type sum = ecl_kw_kahan_sum__(ecl_kw_kahan_sum_indexed_kernel_##type,  \
+                                      data, index_ptr, size);                  \
         memcpy(_sum, &sum, ecl_type_get_sizeof_ctype(ecl_kw->data_type));      \
     }
 
@@ -2697,21 +4440,28 @@ void ecl_kw_element_sum_indexed(const ecl_kw_type *ecl_kw,
                                 const int_vector_type *index_list, void *_sum) {
     switch (ecl_kw_get_type(ecl_kw)) {
     case (ECL_FLOAT_TYPE):
-        KW_SUM_INDEXED(float);
+        if (ecl_kw_compensated_sum) {
+            KW_KAHAN_SUM_INDEXED(float);
+        } else {
+            KW_SUM_INDEXED(float);
+        }
         break;
     case (ECL_DOUBLE_TYPE):
-        KW_SUM_INDEXED(double);
+        if (ecl_kw_compensated_sum) {
+            KW_KAHAN_SUM_INDEXED(double);
+        } else {
+            KW_SUM_INDEXED(double);
+        }
         break;
     case (ECL_INT_TYPE):
         KW_SUM_INDEXED(int);
         break;
     case (ECL_BOOL_TYPE): {
-        const bool *data = (const bool *)ecl_kw_get_data_ref(ecl_kw);
+        const bool *data = (const bool *)ecl_kw_data(ecl_kw);
         const int *index_ptr = int_vector_get_const_ptr(index_list);
         const int size = int_vector_size(index_list);
-        int sum = 0;
-        for (int i = 0; i < size; i++)
-            sum += (data[index_ptr[i]]);
+        int sum = ecl_kw_sum__(ecl_kw_sum_indexed_kernel_bool, data,
+                               index_ptr, size);
 
         memcpy(_sum, &sum, sizeof sum);
     } break;
@@ -2719,24 +4469,43 @@ void ecl_kw_element_sum_indexed(const ecl_kw_type *ecl_kw,
         util_abort("%s: invalid type for element sum \n", __func__);
     }
 }
-#undef KW_SUM
+#undef KW_SUM_INDEXED
+#undef KW_KAHAN_SUM_INDEXED
 
 #define KW_SUM(type)                                                           \
     {                                                                          \
-        const type *data = (const type *)ecl_kw_get_data_ref(ecl_kw);          \
-        type sum = 0;                                                          \
-        for (int i = 0; i < ecl_kw_get_size(ecl_kw); i++)                      \
-            sum += data[i];                                                    \
+        const type *data = (const type *)ecl_kw_data(ecl_kw);                  \
+        type sum = ecl_kw_sum__(ecl_kw_sum_kernel_##type, data, NULL,          \
+                                ecl_kw_get_size(ecl_kw));                      \
         memcpy(_sum, &sum, ecl_type_get_sizeof_ctype(ecl_kw->data_type));      \
     }
 
+static double ecl_kw_element_kahan_sum(const ecl_kw_type *ecl_kw) {
+    if (ecl_type_is_double(ecl_kw->data_type))
+        return ecl_kw_kahan_sum__(ecl_kw_kahan_sum_kernel_double,
+                                  (const double *)ecl_kw_data(ecl_kw),
+                                  NULL, ecl_kw_get_size(ecl_kw));
+    else
+        return ecl_kw_kahan_sum__(ecl_kw_kahan_sum_kernel_float,
+                                  (const float *)ecl_kw_data(ecl_kw),
+                                  NULL, ecl_kw_get_size(ecl_kw));
+}
+
 void ecl_kw_element_sum(const ecl_kw_type *ecl_kw, void *_sum) {
     switch (ecl_kw_get_type(ecl_kw)) {
     case (ECL_FLOAT_TYPE):
-        KW_SUM(float);
+        if (ecl_kw_compensated_sum) {
+            float sum = ecl_kw_element_kahan_sum(ecl_kw);
+            memcpy(_sum, &sum, sizeof sum);
+        } else
+            KW_SUM(float);
         break;
     case (ECL_DOUBLE_TYPE):
-        KW_SUM(double);
+        if (ecl_kw_compensated_sum) {
+            double sum = ecl_kw_element_kahan_sum(ecl_kw);
+            memcpy(_sum, &sum, sizeof sum);
+        } else
+            KW_SUM(double);
         break;
     case (ECL_INT_TYPE):
         KW_SUM(int);
@@ -2747,6 +4516,10 @@ void ecl_kw_element_sum(const ecl_kw_type *ecl_kw, void *_sum) {
 }
 #undef KW_SUM
 
+/*
+  With compensated summation the sum of a float keyword is returned
+  without first rounding it to float.
+*/
 double ecl_kw_element_sum_float(const ecl_kw_type *ecl_kw) {
     float float_sum;
     double double_sum;
@@ -2759,6 +4532,9 @@ double ecl_kw_element_sum_float(const ecl_kw_type *ecl_kw) {
     else
         util_abort("%s: invalid type: \n", __func__);
 
+    if (ecl_kw_compensated_sum)
+        return ecl_kw_element_kahan_sum(ecl_kw);
+
     ecl_kw_element_sum(ecl_kw, sum_ptr);
 
     if (ecl_type_is_double(ecl_kw->data_type))
@@ -2779,7 +4555,7 @@ int ecl_kw_element_sum_int(const ecl_kw_type *ecl_kw) {
 #define ECL_KW_FPRINTF_DATA(ctype)                                             \
     static void ecl_kw_fprintf_data_##ctype(const ecl_kw_type *ecl_kw,         \
                                             const char *fmt, FILE *stream) {   \
-        const ctype *data = (const ctype *)ecl_kw->data;                       \
+        const ctype *data = (const ctype *)ecl_kw_data(ecl_kw);                \
         int i;                                                                 \
         for (i = 0; i < ecl_kw->size; i++)                                     \
             fprintf(stream, fmt, data[i]);                                     \
@@ -2793,11 +4569,11 @@ ECL_KW_FPRINTF_DATA(bool)
 
 static void ecl_kw_fprintf_data_string(const ecl_kw_type *ecl_kw,
                                        const char *fmt, FILE *stream) {
+    const char *data = ecl_kw_data(ecl_kw);
     int i;
     for (i = 0; i < ecl_kw->size; i++)
-        fprintf(
-            stream, fmt,
-            &ecl_kw->data[i * ecl_type_get_sizeof_ctype(ecl_kw->data_type)]);
+        fprintf(stream, fmt,
+                &data[i * ecl_type_get_sizeof_ctype(ecl_kw->data_type)]);
 }
 
 void ecl_kw_fprintf_data(const ecl_kw_type *ecl_kw, const char *fmt,
@@ -2815,23 +4591,72 @@ void ecl_kw_fprintf_data(const ecl_kw_type *ecl_kw, const char *fmt,
         ecl_kw_fprintf_data_string(ecl_kw, fmt, stream);
 }
 
-static bool ecl_kw_elm_equal_numeric__(const ecl_kw_type *ecl_kw1,
-                                       const ecl_kw_type *ecl_kw2, int offset,
-                                       double abs_epsilon, double rel_epsilon) {
-    double v1 = ecl_kw_iget_as_double(ecl_kw1, offset);
-    double v2 = ecl_kw_iget_as_double(ecl_kw2, offset);
-    return util_double_approx_equal__(v1, v2, rel_epsilon, abs_epsilon);
-}
+/*
+  The comparison in ecl_kw_first_different() is done block by block:
+  each block is first checked with memcmp(), or with a vectorized count
+  of the elements which are not approximately equal, and only the
+  first block with a difference is scanned element by element. Large
+  keywords are split in chunks which are compared concurrently.
+*/
 
-static bool ecl_kw_elm_equal__(const ecl_kw_type *ecl_kw1,
-                               const ecl_kw_type *ecl_kw2, int offset) {
-    size_t data_offset = ecl_type_get_sizeof_ctype(ecl_kw1->data_type) * offset;
-    int cmp = memcmp(&ecl_kw1->data[data_offset], &ecl_kw2->data[data_offset],
-                     ecl_type_get_sizeof_ctype(ecl_kw1->data_type));
-    if (cmp == 0)
-        return true;
-    else
-        return false;
+#define ECL_KW_APPROX_EQUAL(v1, v2)                                            \
+    (((fabs(v1) + fabs(v2)) == 0) |                                            \
+     (!((abs_epsilon > 0) & (fabs((v1) - (v2)) > abs_epsilon)) &               \
+      !((rel_epsilon > 0) &                                                    \
+        (fabs((v1) - (v2)) / (fabs(v1) + fabs(v2)) > rel_epsilon))))
+
+#define ECL_KW_COUNT_DIFFERENT_KERNEL(ctype)                                   \
+    ECL_KW_KERNEL static int ecl_kw_count_different_kernel_##ctype(           \
+        const ctype *data1, const ctype *data2, int size, double abs_epsilon,  \
+        double rel_epsilon) {                                                  \
+        int count = 0;                                                         \
+        _Pragma("omp simd reduction(+ : count)") for (int i = 0; i < size;     \
+                                                      i++) {                   \
+            double v1 = data1[i];                                              \
+            double v2 = data2[i];                                              \
+            count += !ECL_KW_APPROX_EQUAL(v1, v2);                             \
+        }                                                                      \
+        return count;                                                          \
+    }                                                                          \
+                                                                               \
+    static int ecl_kw_first_different_numeric_##ctype(                         \
+        const ctype *data1, const ctype *data2, int size, double abs_epsilon,  \
+        double rel_epsilon) {                                                  \
+        for (int block = 0; block < size; block += ECL_KW_COMPARE_BLOCK) {     \
+            int block_size = util_int_min(ECL_KW_COMPARE_BLOCK, size - block); \
+            if (ecl_kw_count_different_kernel_##ctype(                         \
+                    &data1[block], &data2[block], block_size, abs_epsilon,     \
+                    rel_epsilon) > 0) {                                        \
+                int index = block;                                             \
+                while (util_double_approx_equal__(data1[index], data2[index],  \
+                                                  rel_epsilon, abs_epsilon))   \
+                    index++;                                                   \
+                return index;                                                  \
+            }                                                                  \
+        }                                                                      \
+        return size;                                                           \
+    }
+
+ECL_KW_COUNT_DIFFERENT_KERNEL(float)
+ECL_KW_COUNT_DIFFERENT_KERNEL(double)
+#undef ECL_KW_COUNT_DIFFERENT_KERNEL
+#undef ECL_KW_APPROX_EQUAL
+
+static int ecl_kw_first_different_exact(const char *data1, const char *data2,
+                                        int size, size_t sizeof_ctype) {
+    for (int block = 0; block < size; block += ECL_KW_COMPARE_BLOCK) {
+        int block_size = util_int_min(ECL_KW_COMPARE_BLOCK, size - block);
+        size_t block_offset = sizeof_ctype * block;
+        if (memcmp(&data1[block_offset], &data2[block_offset],
+                   sizeof_ctype * block_size) != 0) {
+            int index = block;
+            while (memcmp(&data1[sizeof_ctype * index],
+                          &data2[sizeof_ctype * index], sizeof_ctype) == 0)
+                index++;
+            return index;
+        }
+    }
+    return size;
 }
 
 int ecl_kw_first_different(const ecl_kw_type *ecl_kw1,
@@ -2845,29 +4670,45 @@ int ecl_kw_first_different(const ecl_kw_type *ecl_kw1,
 
     {
         bool numeric_compare = false;
+        ecl_type_enum type = ecl_kw_get_type(ecl_kw1);
+        size_t sizeof_ctype = ecl_type_get_sizeof_ctype(ecl_kw1->data_type);
+        const char *data1 =
+            &ecl_kw_data(ecl_kw1)[sizeof_ctype * (size_t)offset];
+        const char *data2 =
+            &ecl_kw_data(ecl_kw2)[sizeof_ctype * (size_t)offset];
+        int size = ecl_kw_get_size(ecl_kw1) - offset;
 
         if (((abs_epsilon > 0) || (rel_epsilon > 0)) &&
-            ((ecl_kw_get_type(ecl_kw1) == ECL_FLOAT_TYPE) ||
-             (ecl_kw_get_type(ecl_kw1) == ECL_DOUBLE_TYPE)))
+            ((type == ECL_FLOAT_TYPE) || (type == ECL_DOUBLE_TYPE)))
             numeric_compare = true;
-        {
-            int index = offset;
 
-            while (true) {
-                bool equal =
-                    (numeric_compare)
-                        ? ecl_kw_elm_equal_numeric__(ecl_kw1, ecl_kw2, index,
-                                                     abs_epsilon, rel_epsilon)
-                        : ecl_kw_elm_equal__(ecl_kw1, ecl_kw2, index);
-                if (!equal)
-                    break;
-
-                index++;
-                if (index == ecl_kw_get_size(ecl_kw1))
-                    break;
-            }
-
-            return index;
+        {
+            std::vector<int> partial = ecl_kw_parallel_reduce<int>(
+                size, [=](int start, int end) {
+                    const char *chunk1 = &data1[sizeof_ctype * start];
+                    const char *chunk2 = &data2[sizeof_ctype * start];
+                    int index;
+
+                    if (!numeric_compare)
+                        index = ecl_kw_first_different_exact(
+                            chunk1, chunk2, end - start, sizeof_ctype);
+                    else if (type == ECL_FLOAT_TYPE)
+                        index = ecl_kw_first_different_numeric_float(
+                            (const float *)chunk1, (const float *)chunk2,
+                            end - start, abs_epsilon, rel_epsilon);
+                    else
+                        index = ecl_kw_first_different_numeric_double(
+                            (const double *)chunk1, (const double *)chunk2,
+                            end - start, abs_epsilon, rel_epsilon);
+
+                    return (index < end - start) ? start + index : size;
+                });
+
+            int index = size;
+            for (int value : partial)
+                index = util_int_min(index, value);
+
+            return offset + index;
         }
     }
 }
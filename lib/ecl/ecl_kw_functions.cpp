@@ -136,7 +136,7 @@ ecl_kw_type *ecl_kw_alloc_actnum(const ecl_kw_type *porv_kw, float porv_limit) {
 
     const int size = ecl_kw_get_size(porv_kw);
     ecl_kw_type *actnum_kw = ecl_kw_alloc(ACTNUM_KW, size, ECL_INT);
-    const float *porv_values = ecl_kw_get_float_ptr(porv_kw);
+    const float *porv_values = ecl_kw_get_const_float_ptr(porv_kw);
     int *actnum_values = ecl_kw_get_int_ptr(actnum_kw);
 
     for (int i = 0; i < size; i++) {
@@ -165,7 +165,7 @@ ecl_kw_type *ecl_kw_alloc_actnum_bitmask(const ecl_kw_type *porv_kw,
 
     const int size = ecl_kw_get_size(porv_kw);
     ecl_kw_type *actnum_kw = ecl_kw_alloc(ACTNUM_KW, size, ECL_INT);
-    const float *porv_values = ecl_kw_get_float_ptr(porv_kw);
+    const float *porv_values = ecl_kw_get_const_float_ptr(porv_kw);
     int *actnum_values = ecl_kw_get_int_ptr(actnum_kw);
 
     for (int i = 0; i < size; i++) {
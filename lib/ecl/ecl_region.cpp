@@ -267,7 +267,7 @@ static void ecl_region_select_equal__(ecl_region_type *region,
                    "integer keywords \n",
                    __func__);
     {
-        const int *kw_data = ecl_kw_get_int_ptr(ecl_kw);
+        const int *kw_data = ecl_kw_get_const_int_ptr(ecl_kw);
         if (global_kw) {
             int global_index;
             for (global_index = 0; global_index < region->grid_vol;
@@ -363,7 +363,7 @@ static void ecl_region_select_in_interval__(ecl_region_type *region,
                    "float keywords \n",
                    __func__);
     {
-        const float *kw_data = ecl_kw_get_float_ptr(ecl_kw);
+        const float *kw_data = ecl_kw_get_const_float_ptr(ecl_kw);
         if (global_kw) {
             int global_index;
             for (global_index = 0; global_index < region->grid_vol;
@@ -424,7 +424,7 @@ static void ecl_region_select_with_limit__(ecl_region_type *region,
 
     {
         if (ecl_type_is_float(data_type)) {
-            const float *kw_data = ecl_kw_get_float_ptr(ecl_kw);
+            const float *kw_data = ecl_kw_get_const_float_ptr(ecl_kw);
             float float_limit = limit;
             if (global_kw) {
                 int global_index;
@@ -458,7 +458,7 @@ static void ecl_region_select_with_limit__(ecl_region_type *region,
                 }
             }
         } else if (ecl_type_is_int(data_type)) {
-            const int *kw_data = ecl_kw_get_int_ptr(ecl_kw);
+            const int *kw_data = ecl_kw_get_const_int_ptr(ecl_kw);
             int int_limit = (int)limit;
             if (global_kw) {
                 int global_index;
@@ -567,8 +567,8 @@ static void ecl_region_cmp_select__(ecl_region_type *region,
     {
         if (ecl_kw_size_and_type_equal(kw1, kw2)) {
 
-            const float *kw1_data = ecl_kw_get_float_ptr(kw1);
-            const float *kw2_data = ecl_kw_get_float_ptr(kw2);
+            const float *kw1_data = ecl_kw_get_const_float_ptr(kw1);
+            const float *kw2_data = ecl_kw_get_const_float_ptr(kw2);
 
             if (global_kw) {
                 int global_index;
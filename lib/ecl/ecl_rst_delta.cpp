@@ -0,0 +1,452 @@
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ert/util/util.h>
+#include <ert/util/util_codec.h>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_util.hpp>
+#include <ert/ecl/ecl_type.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/ecl_rst_delta.hpp>
+
+/*
+  The delta archive is an archival format for restart files, where
+  consecutive report steps are often almost identical. Each keyword is
+  stored as the XOR of its bit pattern with the bit pattern of the
+  previous keyword with the same name, size and type, compressed with
+  util_codec_compress(); keywords which are unchanged compress to
+  almost nothing. To bound the work needed to reconstruct a keyword
+  every keyframe_interval'th occurence of a keyword is stored without
+  a base. The most recently reconstructed keywords are cached when the
+  archive is read, so loading the report steps in order decodes one
+  payload per keyword irrespective of the keyframe interval.
+
+  The data is split in blocks of block_size elements which are
+  compressed independently, so a slice of a keyword can be
+  reconstructed from the frames covering the slice, see
+  ecl_file_kw_alloc_slice().
+
+  The archive is an ordinary unformatted file; it starts with the
+  keyword:
+
+    ECLDELTA : INTE [version, keyframe_interval]
+
+  and each keyword of the original file is stored as two keywords:
+
+    DELTADSC : INTE [type, type size, size, codec, base, block_size]
+    <NAME>   : INTE [frame bytes ..., frames ...]
+
+  where type, type size and size describe the original keyword and
+  base is the index, counting original keywords only, of the keyword
+  the data has been XOR'ed with, or -1. The payload starts with the
+  size in bytes of each frame, followed by the frames, each padded to
+  a whole number of integers. A frame which does not compress is
+  stored as is, and its size is stored negated. The archive ends with:
+
+    DELTAIDX : INTE The descriptor, payload size and payload offset of
+                    every keyword, see ECL_RST_DELTA_INDEX_SIZE.
+    DELTANAM : CHAR The names of the keywords.
+    DELTAEND : INTE [offset of DELTAIDX]
+
+  where the offsets are stored as the low and high 32 bits. With the
+  index the archive is opened without scanning it; if the index is
+  missing, e.g. because the packing was interrupted, the keywords are
+  found from the descriptors. An archive is opened with
+  ecl_file_open() like any other file, and the keywords are
+  reconstructed when they are loaded, see ecl_file_kw_get_kw().
+*/
+
+typedef std::tuple<std::string, int, int, size_t> delta_key_type;
+
+typedef struct {
+    int index;
+    int depth;
+    ecl_kw_type *ecl_kw;
+} delta_base_type;
+
+typedef struct {
+    std::vector<std::string> names;
+    std::vector<int> entries;
+} delta_index_type;
+
+static size_t ecl_rst_delta_byte_size(const ecl_kw_type *ecl_kw) {
+    return (size_t)ecl_kw_get_size(ecl_kw) *
+           ecl_type_get_sizeof_ctype(ecl_kw_get_data_type(ecl_kw));
+}
+
+static void ecl_rst_delta_xor(char *data, const char *base_data,
+                              size_t byte_size) {
+    for (size_t i = 0; i < byte_size; i++)
+        data[i] ^= base_data[i];
+}
+
+/*
+  The number of frames of a keyword with @size elements.
+*/
+int ecl_rst_delta_num_frames(int size, int block_size) {
+    return (size + block_size - 1) / block_size;
+}
+
+/*
+  The number of integers a frame of @frame_bytes bytes, as stored in
+  the payload, occupies.
+*/
+int ecl_rst_delta_frame_ints(int frame_bytes) {
+    size_t bytes = frame_bytes < 0 ? -(int64_t)frame_bytes : frame_bytes;
+    return (bytes + sizeof(int) - 1) / sizeof(int);
+}
+
+/*
+  Allocates the payload keyword for @ecl_kw; the data is XOR'ed with
+  the data of @base_kw if that is not NULL.
+*/
+static ecl_kw_type *ecl_rst_delta_alloc_payload(const ecl_kw_type *ecl_kw,
+                                                const ecl_kw_type *base_kw,
+                                                util_codec_enum codec,
+                                                int block_size) {
+    const size_t byte_size = ecl_rst_delta_byte_size(ecl_kw);
+    const int element_size =
+        ecl_type_get_sizeof_ctype(ecl_kw_get_data_type(ecl_kw));
+    const size_t block_bytes = (size_t)block_size * element_size;
+    const int num_frames =
+        ecl_rst_delta_num_frames(ecl_kw_get_size(ecl_kw), block_size);
+    char *data = (char *)util_malloc(byte_size + 1);
+    char *buffer = (char *)util_malloc(block_bytes);
+    std::vector<int> payload(num_frames);
+
+    if (byte_size > 0) {
+        memcpy(data, ecl_kw_get_const_ptr(ecl_kw), byte_size);
+        if (base_kw)
+            ecl_rst_delta_xor(data, (const char *)ecl_kw_get_const_ptr(base_kw),
+                              byte_size);
+    }
+
+    for (int frame = 0; frame < num_frames; frame++) {
+        size_t offset = frame * block_bytes;
+        size_t frame_size = std::min(block_bytes, byte_size - offset);
+        size_t frame_bytes = util_codec_compress(
+            codec, element_size, &data[offset], frame_size, buffer, frame_size);
+
+        if (frame_bytes == 0) {
+            frame_bytes = frame_size;
+            memcpy(buffer, &data[offset], frame_size);
+            payload[frame] = -(int)frame_size;
+        } else
+            payload[frame] = frame_bytes;
+
+        {
+            size_t pos = payload.size();
+            payload.resize(pos + ecl_rst_delta_frame_ints(payload[frame]), 0);
+            memcpy(&payload[pos], buffer, frame_bytes);
+        }
+    }
+
+    {
+        ecl_kw_type *payload_kw =
+            ecl_kw_alloc(ecl_kw_get_header(ecl_kw), payload.size(), ECL_INT);
+        if (!payload.empty())
+            memcpy(ecl_kw_get_ptr(payload_kw), payload.data(),
+                   payload.size() * sizeof(int));
+
+        free(buffer);
+        free(data);
+        return payload_kw;
+    }
+}
+
+/*
+  Reconstructs the data of a keyword from the @num_frames consecutive
+  frames in @frames, which holds @frames_size integers, with the frame
+  sizes in @frame_bytes. Every frame except the last decodes to
+  @block_bytes bytes, and @byte_size must be the total size of the
+  decoded frames. @base_data is the corresponding data of the base
+  keyword, or NULL. Returns false if the frames are not valid.
+*/
+bool ecl_rst_delta_decode(const int *frame_bytes, int num_frames,
+                          const int *frames, int frames_size,
+                          util_codec_enum codec, int element_size,
+                          size_t block_bytes, const void *base_data,
+                          void *data, size_t byte_size) {
+    const char *frame = (const char *)frames;
+    size_t stored_bytes = frames_size < 0 ? 0 : frames_size * sizeof(int);
+    size_t offset = 0;
+
+    for (int i = 0; i < num_frames; i++) {
+        size_t frame_ints = ecl_rst_delta_frame_ints(frame_bytes[i]);
+        size_t frame_size = frame_bytes[i] < 0 ? -(int64_t)frame_bytes[i]
+                                               : frame_bytes[i];
+        size_t target_size;
+
+        if (offset >= byte_size || frame_ints * sizeof(int) > stored_bytes)
+            return false;
+
+        target_size = std::min(block_bytes, byte_size - offset);
+        if (frame_bytes[i] < 0) {
+            if (frame_size != target_size)
+                return false;
+            memcpy((char *)data + offset, frame, frame_size);
+        } else if (!util_codec_decompress(codec, element_size, frame,
+                                          frame_size, (char *)data + offset,
+                                          target_size))
+            return false;
+
+        frame += frame_ints * sizeof(int);
+        stored_bytes -= frame_ints * sizeof(int);
+        offset += target_size;
+    }
+
+    if (offset != byte_size)
+        return false;
+
+    if (base_data)
+        ecl_rst_delta_xor((char *)data, (const char *)base_data, byte_size);
+    return true;
+}
+
+static void ecl_rst_delta_fwrite_header(fortio_type *fortio,
+                                        int keyframe_interval) {
+    ecl_kw_type *delta_kw = ecl_kw_alloc(ECL_RST_DELTA_KW, ECL_RST_DELTA_SIZE,
+                                         ECL_INT);
+    ecl_kw_iset_int(delta_kw, ECL_RST_DELTA_VERSION_INDEX,
+                    ECL_RST_DELTA_VERSION);
+    ecl_kw_iset_int(delta_kw, ECL_RST_DELTA_KEYFRAME_INDEX, keyframe_interval);
+    ecl_kw_fwrite(delta_kw, fortio);
+    ecl_kw_free(delta_kw);
+}
+
+static void ecl_rst_delta_fwrite_kw(fortio_type *fortio,
+                                    const ecl_kw_type *ecl_kw,
+                                    const delta_base_type *base,
+                                    util_codec_enum codec, int block_size,
+                                    delta_index_type *index) {
+    ecl_data_type data_type = ecl_kw_get_data_type(ecl_kw);
+    int element_size = ecl_type_get_sizeof_ctype(data_type);
+    int size = ecl_kw_get_size(ecl_kw);
+    ecl_kw_type *desc_kw =
+        ecl_kw_alloc(ECL_RST_DELTA_DESC_KW, ECL_RST_DELTA_DESC_SIZE, ECL_INT);
+    ecl_kw_type *payload_kw;
+    offset_type payload_offset;
+
+    /* A single frame can not exceed 2GB. */
+    if (block_size <= 0 || block_size > size)
+        block_size = std::max(size, 1);
+    if (element_size > 0)
+        block_size = std::min(block_size, INT_MAX / element_size);
+    payload_kw = ecl_rst_delta_alloc_payload(
+        ecl_kw, base ? base->ecl_kw : NULL, codec, block_size);
+
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_TYPE_INDEX,
+                    ecl_type_get_type(data_type));
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_TYPE_SIZE_INDEX,
+                    ecl_type_get_sizeof_iotype(data_type));
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_SIZE_INDEX, size);
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_CODEC_INDEX, codec);
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_BASE_INDEX,
+                    base ? base->index : -1);
+    ecl_kw_iset_int(desc_kw, ECL_RST_DELTA_DESC_BLOCK_SIZE_INDEX, block_size);
+
+    ecl_kw_fwrite(desc_kw, fortio);
+    payload_offset = fortio_ftell(fortio);
+    ecl_kw_fwrite(payload_kw, fortio);
+
+    index->names.push_back(ecl_kw_get_header(ecl_kw));
+    {
+        const int *desc = ecl_kw_get_const_int_ptr(desc_kw);
+        index->entries.insert(index->entries.end(), desc,
+                              desc + ECL_RST_DELTA_DESC_SIZE);
+    }
+    index->entries.push_back(ecl_kw_get_size(payload_kw));
+    index->entries.push_back((int)(payload_offset & 0xFFFFFFFF));
+    index->entries.push_back((int)(payload_offset >> 32));
+
+    ecl_kw_free(desc_kw);
+    ecl_kw_free(payload_kw);
+}
+
+static void ecl_rst_delta_fwrite_index(fortio_type *fortio,
+                                       const delta_index_type *index) {
+    offset_type index_offset = fortio_ftell(fortio);
+    int num_kw = index->names.size();
+    ecl_kw_type *index_kw =
+        ecl_kw_alloc(ECL_RST_DELTA_INDEX_KW, index->entries.size(), ECL_INT);
+    ecl_kw_type *names_kw = ecl_kw_alloc(ECL_RST_DELTA_NAMES_KW, num_kw,
+                                         ECL_CHAR);
+    ecl_kw_type *end_kw =
+        ecl_kw_alloc(ECL_RST_DELTA_END_KW, ECL_RST_DELTA_END_SIZE, ECL_INT);
+
+    if (num_kw > 0)
+        memcpy(ecl_kw_get_ptr(index_kw), index->entries.data(),
+               index->entries.size() * sizeof(int));
+    for (int i = 0; i < num_kw; i++)
+        ecl_kw_iset_string8(names_kw, i, index->names[i].c_str());
+    ecl_kw_iset_int(end_kw, ECL_RST_DELTA_END_OFFSET_LOW_INDEX,
+                    (int)(index_offset & 0xFFFFFFFF));
+    ecl_kw_iset_int(end_kw, ECL_RST_DELTA_END_OFFSET_HIGH_INDEX,
+                    (int)(index_offset >> 32));
+
+    ecl_kw_fwrite(index_kw, fortio);
+    ecl_kw_fwrite(names_kw, fortio);
+    ecl_kw_fwrite(end_kw, fortio);
+
+    ecl_kw_free(end_kw);
+    ecl_kw_free(names_kw);
+    ecl_kw_free(index_kw);
+}
+
+/*
+  Checks whether the reading of @fortio stopped at @offset because the
+  end of the file was reached, and not because of a partial keyword.
+  Formatted files can end with whitespace.
+*/
+static bool ecl_rst_delta_at_end(fortio_type *fortio, offset_type offset) {
+    fortio_fseek(fortio, offset, SEEK_SET);
+    if (fortio_fmt_file(fortio)) {
+        FILE *stream = fortio_get_FILE(fortio);
+        int c;
+        while ((c = fgetc(stream)) != EOF) {
+            if (!isspace(c))
+                return false;
+        }
+        return true;
+    }
+    return fortio_read_at_eof(fortio);
+}
+
+/**
+   Writes the keywords of @src_file to the delta archive
+   @archive_file. Each keyword is stored as a delta to the previous
+   keyword with the same name, size and type, except every
+   @keyframe_interval'th occurence which is stored in full; with
+   @keyframe_interval <= 1 all keywords are stored in full. The data
+   is compressed in independent frames of @block_size elements; with
+   @block_size <= 0 every keyword is compressed as one frame. The
+   keywords are read sequentially and at most one keyword of each kind
+   is held in memory.
+
+   Returns false if @src_file can not be read, or if it ends with a
+   partial keyword; in the latter case the archive is still written,
+   with the keywords before the partial one, as ecl_file_open() would
+   load them.
+
+   The archive is read with ecl_file_open(), or converted back to the
+   original file with ecl_rst_delta_unpack().
+*/
+
+bool ecl_rst_delta_pack(const char *src_file, const char *archive_file,
+                        int keyframe_interval, int block_size) {
+    bool fmt_file;
+    if (!ecl_util_fmt_file(src_file, &fmt_file))
+        return false;
+
+    fortio_type *src = fortio_open_reader(src_file, fmt_file, ECL_ENDIAN_FLIP);
+    if (!src)
+        return false;
+
+    fortio_type *target =
+        fortio_open_writer(archive_file, false, ECL_ENDIAN_FLIP);
+    if (!target) {
+        fortio_fclose(src);
+        return false;
+    }
+
+    bool complete = false;
+    {
+        util_codec_enum codec = util_codec_supported(UTIL_CODEC_ZLIB)
+                                    ? UTIL_CODEC_ZLIB
+                                    : UTIL_CODEC_FAST;
+        std::map<delta_key_type, delta_base_type> bases;
+        delta_index_type delta_index;
+        int index = 0;
+
+        ecl_rst_delta_fwrite_header(target, keyframe_interval);
+        while (true) {
+            offset_type offset = fortio_ftell(src);
+            ecl_kw_type *ecl_kw = ecl_kw_fread_alloc(src);
+            if (!ecl_kw) {
+                complete = ecl_rst_delta_at_end(src, offset);
+                break;
+            }
+
+            {
+                ecl_data_type data_type = ecl_kw_get_data_type(ecl_kw);
+                delta_key_type key(ecl_kw_get_header(ecl_kw),
+                                   ecl_kw_get_size(ecl_kw),
+                                   ecl_type_get_type(data_type),
+                                   ecl_type_get_sizeof_iotype(data_type));
+                auto iter = bases.find(key);
+                delta_base_type *base = NULL;
+
+                if (iter != bases.end() &&
+                    iter->second.depth + 1 < keyframe_interval)
+                    base = &iter->second;
+
+                ecl_rst_delta_fwrite_kw(target, ecl_kw, base, codec,
+                                        block_size, &delta_index);
+
+                if (iter == bases.end())
+                    iter = bases.emplace(key, delta_base_type()).first;
+                else
+                    ecl_kw_free(iter->second.ecl_kw);
+
+                iter->second.depth = base ? base->depth + 1 : 0;
+                iter->second.index = index;
+                iter->second.ecl_kw = ecl_kw;
+            }
+            index++;
+        }
+        ecl_rst_delta_fwrite_index(target, &delta_index);
+
+        for (auto &iter : bases)
+            ecl_kw_free(iter.second.ecl_kw);
+    }
+
+    fortio_fclose(target);
+    fortio_fclose(src);
+    return complete;
+}
+
+/**
+   Writes the keywords stored in the delta archive @archive_file to the
+   ordinary file @target_file; @target_file is formatted if the name
+   indicates a formatted file. Returns false if @archive_file can not be
+   opened.
+*/
+
+bool ecl_rst_delta_unpack(const char *archive_file, const char *target_file) {
+    ecl_file_type *ecl_file = ecl_file_open(archive_file, 0);
+    if (!ecl_file)
+        return false;
+
+    {
+        bool fmt_file = false;
+        fortio_type *target;
+
+        ecl_util_fmt_file(target_file, &fmt_file);
+        target = fortio_open_writer(target_file, fmt_file, ECL_ENDIAN_FLIP);
+        if (!target) {
+            ecl_file_close(ecl_file);
+            return false;
+        }
+
+        /* Only keep the keyword which is being written in memory. */
+        ecl_file_set_memory_budget(ecl_file, 1);
+        for (int i = 0; i < ecl_file_get_size(ecl_file); i++)
+            ecl_kw_fwrite(ecl_file_iget_kw(ecl_file, i), target);
+
+        fortio_fclose(target);
+    }
+    ecl_file_close(ecl_file);
+    return true;
+}
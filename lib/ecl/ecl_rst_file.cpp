@@ -273,6 +273,17 @@ void ecl_rst_file_add_kw(ecl_rst_file_type *rst_file,
     ecl_kw_fwrite(ecl_kw, rst_file->fortio);
 }
 
+/*
+  Starts writing a keyword whose data is appended in chunks with
+  ecl_kw_writer_append(); the writer must be freed with
+  ecl_kw_writer_free() before anything else is written to the file.
+*/
+ecl_kw_writer_type *ecl_rst_file_alloc_kw_writer(ecl_rst_file_type *rst_file,
+                                                 const char *header, int size,
+                                                 ecl_data_type data_type) {
+    return ecl_kw_writer_alloc(rst_file->fortio, header, size, data_type);
+}
+
 offset_type ecl_rst_file_ftell(const ecl_rst_file_type *rst_file) {
     return fortio_ftell(rst_file->fortio);
 }
@@ -1170,21 +1170,26 @@ void ecl_sum_data_init_double_vector_interp(
     }
 }
 
+/*
+  The frame is filled one vector at a time, so the data is read
+  sequentially from the column storage of ecl_sum_file_data.
+*/
+
 void ecl_sum_data_init_double_frame(const ecl_sum_data_type *data,
                                     const ecl_sum_vector_type *keywords,
                                     double *output_data) {
     int time_stride = ecl_sum_vector_get_size(keywords);
     int key_stride = 1;
-    for (int time_index = 0; time_index < ecl_sum_data_get_length(data);
-         time_index++) {
-        for (int key_index = 0; key_index < ecl_sum_vector_get_size(keywords);
-             key_index++) {
-            int param_index =
-                ecl_sum_vector_iget_param_index(keywords, key_index);
+    std::vector<double> vector_data(ecl_sum_data_get_length(data));
+    for (int key_index = 0; key_index < ecl_sum_vector_get_size(keywords);
+         key_index++) {
+        int param_index = ecl_sum_vector_iget_param_index(keywords, key_index);
+
+        ecl_sum_data_init_double_vector(data, param_index, vector_data.data());
+        for (size_t time_index = 0; time_index < vector_data.size();
+             time_index++) {
             int data_index = key_index * key_stride + time_index * time_stride;
-
-            output_data[data_index] =
-                ecl_sum_data_iget(data, time_index, param_index);
+            output_data[data_index] = vector_data[time_index];
         }
     }
 }
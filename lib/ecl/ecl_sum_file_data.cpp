@@ -287,6 +287,7 @@ ecl_sum_tstep_type *ecl_sum_file_data::add_new_tstep(int report_step,
         report_step, ministep_nr, sim_seconds, ecl_smspec);
     ecl_sum_tstep_type *prev_tstep = NULL;
 
+    this->clear_columns();
     if (vector_get_size(data) > 0)
         prev_tstep = (ecl_sum_tstep_type *)vector_get_last(data);
 
@@ -373,6 +374,41 @@ void ecl_sum_file_data::build_index() {
     }
 }
 
+/*
+  When the data has been loaded from file the PARAMS vectors are
+  transposed to one contiguous array per summary vector, and the
+  tsteps become views of the rows. Extracting a vector is then a
+  sequential read, instead of one access to a separate tstep for each
+  time step.
+*/
+
+void ecl_sum_file_data::build_columns() {
+    int length = vector_get_size(data);
+    size_t params_size = ecl_smspec_get_params_size(this->ecl_smspec);
+
+    this->clear_columns();
+    if (params_size == 0 || length == 0)
+        return;
+
+    this->columns.resize(params_size * length);
+    for (int time_index = 0; time_index < length; time_index++)
+        ecl_sum_tstep_set_storage(iget_ministep(time_index),
+                                  &this->columns[time_index], length);
+}
+
+/*
+  Before new tsteps are added the tsteps must own their values again.
+*/
+
+void ecl_sum_file_data::clear_columns() {
+    if (this->columns.empty())
+        return;
+
+    for (int time_index = 0; time_index < vector_get_size(data); time_index++)
+        ecl_sum_tstep_clear_storage(iget_ministep(time_index));
+    std::vector<float>().swap(this->columns);
+}
+
 void ecl_sum_file_data::get_time(int length, time_t *data) {
     for (int time_index = 0; time_index < length; time_index++)
         data[time_index] = this->iget_sim_time(time_index);
@@ -399,6 +435,11 @@ void ecl_sum_file_data::get_data(int params_index, int length, double *data) {
     if (this->loader) {
         const auto tmp_data = loader->get_vector(params_index);
         memcpy(data, tmp_data.data(), length * sizeof data);
+    } else if (!this->columns.empty()) {
+        const float *column =
+            &this->columns[(size_t)params_index * vector_get_size(this->data)];
+        for (int time_index = 0; time_index < length; time_index++)
+            data[time_index] = column[time_index];
     } else {
         for (int time_index = 0; time_index < length; time_index++)
             data[time_index] = this->iget(time_index, params_index);
@@ -628,6 +669,8 @@ bool ecl_sum_file_data::fread(const stringlist_type *filelist, bool lazy_load,
     }
 
     build_index();
+    if (!this->loader)
+        build_columns();
     return (length() > 0);
 }
 
@@ -31,7 +31,10 @@ Header direction: ecl_smspec   DAYS     WWCT:OP_3     FOPT     BPR:15,10,25
                                --------------------------------------------
 
   The ecl_sum_tstep structure corresponds to one 'horizontal line' in
-  the summary data.
+  the summary data. The values are either owned by the tstep, or the
+  tstep is a view of a row in external storage, typically where the
+  summary data is stored with one contiguous array per vector; see
+  ecl_sum_tstep_set_storage().
 
   These timesteps correspond exactly to the simulators timesteps,
   i.e. when convergence is poor they are closely spaced. In the
@@ -51,8 +54,29 @@ struct ecl_sum_tstep_struct {
     int internal_index; /* Used for lookups of the next / previous ministep based on an existing ministep. */
     const ecl_smspec_type *
         smspec; /* The smespec header information for this tstep - must be compatible. */
+    float *storage; /* External storage of the values, or NULL. */
+    int storage_stride; /* Distance between the values in the storage. */
+    int storage_size; /* Number of values in the storage. */
 };
 
+static int ecl_sum_tstep_get_size(const ecl_sum_tstep_type *tstep) {
+    if (tstep->storage)
+        return tstep->storage_size;
+    return tstep->data.size();
+}
+
+static float *ecl_sum_tstep_value_ptr(ecl_sum_tstep_type *tstep, int index) {
+    if (tstep->storage)
+        return &tstep->storage[(size_t)index * tstep->storage_stride];
+    return &tstep->data[index];
+}
+
+static float ecl_sum_tstep_value(const ecl_sum_tstep_type *tstep, int index) {
+    if (tstep->storage)
+        return tstep->storage[(size_t)index * tstep->storage_stride];
+    return tstep->data[index];
+}
+
 ecl_sum_tstep_type *
 ecl_sum_tstep_alloc_remap_copy(const ecl_sum_tstep_type *src,
                                const ecl_smspec_type *new_smspec,
@@ -62,13 +86,14 @@ ecl_sum_tstep_alloc_remap_copy(const ecl_sum_tstep_type *src,
     UTIL_TYPE_ID_INIT(target, ECL_SUM_TSTEP_ID);
     target->report_step = src->report_step;
     target->ministep = src->ministep;
+    target->storage = NULL;
 
     target->smspec = new_smspec;
     target->data.resize(params_size);
     for (int i = 0; i < params_size; i++) {
 
         if (params_map[i] >= 0)
-            target->data[i] = src->data[params_map[i]];
+            target->data[i] = ecl_sum_tstep_value(src, params_map[i]);
         else
             target->data[i] = default_value;
     }
@@ -81,7 +106,10 @@ ecl_sum_tstep_type *ecl_sum_tstep_alloc_copy(const ecl_sum_tstep_type *src) {
     target->smspec = src->smspec;
     target->report_step = src->report_step;
     target->ministep = src->ministep;
-    target->data = src->data;
+    target->storage = NULL;
+    target->data.resize(ecl_sum_tstep_get_size(src));
+    for (size_t i = 0; i < target->data.size(); i++)
+        target->data[i] = ecl_sum_tstep_value(src, i);
     return target;
 }
 
@@ -92,6 +120,7 @@ static ecl_sum_tstep_type *ecl_sum_tstep_alloc(int report_step, int ministep_nr,
     tstep->smspec = smspec;
     tstep->report_step = report_step;
     tstep->ministep = ministep_nr;
+    tstep->storage = NULL;
     tstep->data.resize(ecl_smspec_get_params_size(smspec));
     return tstep;
 }
@@ -219,12 +248,46 @@ ecl_sum_tstep_type *ecl_sum_tstep_alloc_new(int report_step, int ministep,
     return tstep;
 }
 
+/*
+  Moves the values of the tstep to the external @storage, where value
+  i is stored at storage[i * stride]; the tstep becomes a view of the
+  storage, which must outlive the tstep or be released with
+  ecl_sum_tstep_clear_storage().
+*/
+
+void ecl_sum_tstep_set_storage(ecl_sum_tstep_type *tstep, float *storage,
+                               int stride) {
+    int size = ecl_sum_tstep_get_size(tstep);
+    for (int i = 0; i < size; i++)
+        storage[(size_t)i * stride] = ecl_sum_tstep_value(tstep, i);
+
+    std::vector<float>().swap(tstep->data);
+    tstep->storage = storage;
+    tstep->storage_stride = stride;
+    tstep->storage_size = size;
+}
+
+/*
+  Copies the values from the external storage back into the tstep,
+  see ecl_sum_tstep_set_storage().
+*/
+
+void ecl_sum_tstep_clear_storage(ecl_sum_tstep_type *tstep) {
+    if (!tstep->storage)
+        return;
+
+    tstep->data.resize(tstep->storage_size);
+    for (int i = 0; i < tstep->storage_size; i++)
+        tstep->data[i] = ecl_sum_tstep_value(tstep, i);
+    tstep->storage = NULL;
+}
+
 double ecl_sum_tstep_iget(const ecl_sum_tstep_type *ministep, int index) {
-    if ((index >= 0) && (index < (int)ministep->data.size()))
-        return ministep->data[index];
+    if ((index >= 0) && (index < ecl_sum_tstep_get_size(ministep)))
+        return ecl_sum_tstep_value(ministep, index);
     else {
         util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",
-                   __func__, index, ministep->data.size());
+                   __func__, index, ecl_sum_tstep_get_size(ministep));
         return -1;
     }
 }
@@ -269,7 +332,7 @@ void ecl_sum_tstep_fwrite(const ecl_sum_tstep_type *ministep,
         {
             int i;
             for (i = 0; i < compact_size; i++)
-                data[i] = ministep->data[index_map[i]];
+                data[i] = ecl_sum_tstep_value(ministep, index_map[i]);
         }
         ecl_kw_fwrite(params_kw, fortio);
         ecl_kw_free(params_kw);
@@ -277,11 +340,11 @@ void ecl_sum_tstep_fwrite(const ecl_sum_tstep_type *ministep,
 }
 
 void ecl_sum_tstep_iset(ecl_sum_tstep_type *tstep, int index, float value) {
-    if ((index < static_cast<int>(tstep->data.size())) && (index >= 0))
-        tstep->data[index] = value;
+    if ((index < ecl_sum_tstep_get_size(tstep)) && (index >= 0))
+        *ecl_sum_tstep_value_ptr(tstep, index) = value;
     else
         util_abort("%s: index:%d invalid. Valid range: [0,%d) \n", __func__,
-                   index, tstep->data.size());
+                   index, ecl_sum_tstep_get_size(tstep));
 }
 
 void ecl_sum_tstep_iscale(ecl_sum_tstep_type *tstep, int index, float scalar) {
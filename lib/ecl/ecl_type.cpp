@@ -120,6 +120,20 @@ ecl_data_type ecl_type_create_from_name(const char *type_name) {
     }
 }
 
+/*
+  Checks if @type_name, which need not be zero terminated, is one of the
+  type names accepted by ecl_type_create_from_name().
+*/
+bool ecl_type_is_valid_name(const char *type_name) {
+    return (strncmp(type_name, ECL_TYPE_NAME_FLOAT, ECL_TYPE_LENGTH) == 0 ||
+            strncmp(type_name, ECL_TYPE_NAME_INT, ECL_TYPE_LENGTH) == 0 ||
+            strncmp(type_name, ECL_TYPE_NAME_DOUBLE, ECL_TYPE_LENGTH) == 0 ||
+            strncmp(type_name, ECL_TYPE_NAME_CHAR, ECL_TYPE_LENGTH) == 0 ||
+            is_ecl_string_name(type_name) ||
+            strncmp(type_name, ECL_TYPE_NAME_MESSAGE, ECL_TYPE_LENGTH) == 0 ||
+            strncmp(type_name, ECL_TYPE_NAME_BOOL, ECL_TYPE_LENGTH) == 0);
+}
+
 int ecl_type_get_sizeof_ctype(const ecl_data_type ecl_type) {
     return ecl_type.element_size;
 }
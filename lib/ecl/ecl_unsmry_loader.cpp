@@ -50,17 +50,10 @@ std::vector<double> unsmry_loader::get_vector(int pos) const {
             "unsmry_loader::get_vector pos: " + std::to_string(pos) +
             " PARAMS_SIZE: " + std::to_string(size));
 
-    std::vector<double> data(this->length());
-    int_vector_type *index_map = int_vector_alloc(1, pos);
-    char buffer[4];
-
-    for (int index = 0; index < this->length(); index++) {
-        ecl_file_view_index_fload_kw(file_view, PARAMS_KW, index, index_map,
-                                     buffer);
-        float *data_value = (float *)buffer;
-        data[index] = *data_value;
-    }
-    int_vector_free(index_map);
+    std::vector<float> buffer(this->length());
+    ecl_file_view_fload_named_element(file_view, PARAMS_KW, pos,
+                                      (char *)buffer.data());
+    std::vector<double> data(buffer.begin(), buffer.end());
 
     if (ecl_file_view_flags_set(file_view, ECL_FILE_CLOSE_STREAM))
         ecl_file_view_fclose_stream(file_view);
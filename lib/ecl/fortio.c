@@ -22,12 +22,29 @@
 #include <string.h>
 #include <errno.h>
 
+#include <ert/util/build_config.h>
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
 #include <ert/ecl/fortio.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+#endif
+
+#ifdef HAVE_PREADV
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 #define FORTIO_ID 345116
 
+/* Maximum number of records read with one preadv() call. */
+#define FORTIO_PREAD_BATCH 256
+
 /**
 The fortio struct is implemented to handle fortran io. The problem is
 that when a Fortran program writes unformatted data to file in a
@@ -87,6 +104,26 @@ struct fortio_struct {
     bool writable;
     offset_type read_size;
     char opts[3];
+
+    /*
+    When the file is opened with fortio_open_reader_mmap() the whole
+    file is mapped read only into memory, and mmap_data points to the
+    start of the mapping. The mapping is never modified.
+  */
+    const char *mmap_data;
+    size_t mmap_size;
+
+    /*
+    When read-ahead is enabled with fortio_set_read_ahead() the kernel
+    is asked to prefetch the next read_ahead bytes of the file;
+    read_ahead_end is the end of the region which has been requested.
+    read_ahead_pos tracks the file position without a system call; it
+    is exact after a seek, and advanced past the record when a record
+    header is read.
+  */
+    size_t read_ahead;
+    offset_type read_ahead_end;
+    offset_type read_ahead_pos;
 };
 
 UTIL_IS_INSTANCE_FUNCTION(fortio, FORTIO_ID);
@@ -103,6 +140,11 @@ static fortio_type *fortio_alloc__(const char *filename, bool fmt_file,
     fortio->stream_owner = stream_owner;
     fortio->writable = writable;
     fortio->read_size = 0;
+    fortio->mmap_data = NULL;
+    fortio->mmap_size = 0;
+    fortio->read_ahead = 0;
+    fortio->read_ahead_end = 0;
+    fortio->read_ahead_pos = 0;
     strcpy(fortio->opts, endian_flip_header ? "c" : "ce");
 
     return fortio;
@@ -328,6 +370,57 @@ fortio_type *fortio_open_append(const char *filename, bool fmt_file,
         return NULL;
 }
 
+/*
+  Will open the file for reading and in addition map the complete file
+  read only into memory. All the ordinary fortio read functions still
+  go through the FILE * stream; the mapping is used by the positional
+  reads, fortio_pread_buffer() and fortio_pread(), which then copy the
+  data from memory instead of calling into the kernel, also after the
+  stream has been closed with fortio_fclose_stream(). In addition
+  fortio_mmap_fread_buffer() can return a pointer to data in the
+  mapping.
+
+  Observe that the process gets SIGBUS if the file is truncated by
+  another process while it is mapped.
+
+  If mmap() is not available, or fails, the function will return an
+  ordinary reader.
+*/
+
+fortio_type *fortio_open_reader_mmap(const char *filename, bool fmt_file,
+                                     bool endian_flip_header) {
+    fortio_type *fortio =
+        fortio_open_reader(filename, fmt_file, endian_flip_header);
+#ifdef HAVE_MMAP
+    if (fortio && !fmt_file && fortio->read_size > 0) {
+        void *data = mmap(NULL, fortio->read_size, PROT_READ, MAP_PRIVATE,
+                          fortio_fileno(fortio), 0);
+        if (data != MAP_FAILED) {
+            fortio->mmap_data = (const char *)data;
+            fortio->mmap_size = fortio->read_size;
+        }
+    }
+#endif
+    return fortio;
+}
+
+bool fortio_is_mmapped(const fortio_type *fortio) {
+    if (fortio->mmap_data)
+        return true;
+    else
+        return false;
+}
+
+static void fortio_munmap(fortio_type *fortio) {
+#ifdef HAVE_MMAP
+    if (fortio->mmap_data) {
+        munmap((void *)fortio->mmap_data, fortio->mmap_size);
+        fortio->mmap_data = NULL;
+        fortio->mmap_size = 0;
+    }
+#endif
+}
+
 bool fortio_fclose_stream(fortio_type *fortio) {
     if (fortio->stream_owner) {
         if (fortio->stream) {
@@ -346,9 +439,11 @@ bool fortio_fclose_stream(fortio_type *fortio) {
 bool fortio_fopen_stream(fortio_type *fortio) {
     if (fortio->stream == NULL) {
         fortio->stream = fopen(fortio->filename, fortio->fopen_mode);
-        if (fortio->stream)
+        if (fortio->stream) {
+            if (fortio->read_ahead > 0)
+                fortio_set_read_ahead(fortio, fortio->read_ahead);
             return true;
-        else
+        } else
             return false;
     } else
         return false;
@@ -370,7 +465,63 @@ bool fortio_assert_stream_open(fortio_type *fortio) {
     }
 }
 
+/*
+  Read-ahead for sequential scans through a file, e.g. when building
+  the index in ecl_file_open() or when converting a file keyword by
+  keyword. With read-ahead enabled the kernel is asked, with
+  posix_fadvise(), to start reading the next 'read_ahead' bytes of the
+  file in the background; when half of that window has been consumed
+  the next window is requested. This way the reads and seeks issued
+  while parsing will normally be served from the page cache, which
+  makes a large difference on network file systems.
+
+  Read-ahead is only available on platforms with posix_fadvise(); the
+  function returns false if read-ahead could not be enabled. A
+  read_ahead value of zero disables read-ahead.
+*/
+
+static void fortio_read_ahead(fortio_type *fortio, offset_type pos) {
+    fortio->read_ahead_pos = pos;
+#ifdef HAVE_POSIX_FADVISE
+    if (fortio->read_ahead > 0 && fortio->stream) {
+        offset_type window = fortio->read_ahead;
+        offset_type end = fortio->read_ahead_end;
+        offset_type start = pos;
+
+        /* Inside the current window - the part up to end is underway. */
+        if (pos >= end - window && pos < end) {
+            if (end - pos > window / 2)
+                return;
+            start = end;
+        }
+
+        posix_fadvise(fortio_fileno(fortio), start, pos + window - start,
+                      POSIX_FADV_WILLNEED);
+        fortio->read_ahead_end = pos + window;
+    }
+#endif
+}
+
+bool fortio_set_read_ahead(fortio_type *fortio, size_t read_ahead) {
+#ifdef HAVE_POSIX_FADVISE
+    if (fortio->stream) {
+        int advice = read_ahead > 0 ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_NORMAL;
+        fortio->read_ahead = read_ahead;
+        fortio->read_ahead_end = 0;
+        posix_fadvise(fortio_fileno(fortio), 0, 0, advice);
+        fortio_read_ahead(fortio, fortio_ftell(fortio));
+        return (read_ahead > 0);
+    }
+#endif
+    return false;
+}
+
+size_t fortio_get_read_ahead(const fortio_type *fortio) {
+    return fortio->read_ahead;
+}
+
 static void fortio_free__(fortio_type *fortio) {
+    fortio_munmap(fortio);
     free(fortio->filename);
     free(fortio);
 }
@@ -424,11 +575,14 @@ int fortio_init_read(fortio_type *fortio) {
     int elm_read;
     int record_size;
 
+    fortio_read_ahead(fortio, fortio->read_ahead_pos);
     elm_read = fread(&record_size, sizeof(record_size), 1, fortio->stream);
     if (elm_read == 1) {
         if (fortio->endian_flip_header)
             util_endian_flip_vector(&record_size, sizeof record_size, 1);
 
+        if (record_size >= 0)
+            fortio->read_ahead_pos += record_size + 2 * sizeof record_size;
         return record_size;
     } else
         return -1;
@@ -436,29 +590,192 @@ int fortio_init_read(fortio_type *fortio) {
 
 bool fortio_data_fskip(fortio_type *fortio, const int element_size,
                        const int element_count, const int block_count) {
-    int headers = block_count * 4;
-    int trailers = block_count * 4;
-    int bytes_to_skip = headers + trailers + (element_size * element_count);
+    offset_type headers = (offset_type)block_count * 4;
+    offset_type trailers = (offset_type)block_count * 4;
+    offset_type bytes_to_skip =
+        headers + trailers + ((offset_type)element_size * element_count);
 
     return fortio_fseek(fortio, bytes_to_skip, SEEK_CUR);
 }
 
-void fortio_data_fseek(fortio_type *fortio, offset_type data_offset,
-                       size_t data_element, const int element_size,
-                       const int element_count, const int block_size) {
+/*
+  Skips the data section of a keyword which has been written in blocks
+  of block_size elements, each block in a separate record. The length
+  of the data section follows from the keyword header, so the
+  position after the keyword is computed directly. Only the header of
+  the first record and the trailer of the last record are read to
+  validate the skip. That is O(1) I/O operations, compared to reading
+  the markers of every record.
+
+  If the validation fails, e.g. because the keyword has been written by
+  an application with a different record blocking, the records are
+  walked one by one; any record structure which adds up to the
+  expected number of bytes is accepted. The function returns false if
+  the data section is not valid, and the file position is then
+  undefined.
+*/
+
+bool fortio_data_fskip_checked(fortio_type *fortio, const int element_size,
+                               const int element_count, const int block_size) {
+    const offset_type data_start = fortio_ftell(fortio);
+    const offset_type data_bytes = (offset_type)element_size * element_count;
+
+    if (element_count <= 0)
+        return true;
+
+    {
+        const int block_count =
+            element_count / block_size + (element_count % block_size != 0);
+        const int first_block = util_int_min(block_size, element_count);
+        const int last_block = element_count - (block_count - 1) * block_size;
+        const offset_type data_end =
+            data_start + data_bytes + (offset_type)block_count * 8;
+        int header, trailer;
+
+        if (__read_int(fortio->stream, &header, fortio->endian_flip_header) &&
+            header == first_block * element_size &&
+            fortio_fseek(fortio, data_end - 4, SEEK_SET) &&
+            __read_int(fortio->stream, &trailer, fortio->endian_flip_header) &&
+            trailer == last_block * element_size)
+            return true;
+    }
+
+    /* Fall back to walking the records. */
+    if (!fortio_fseek(fortio, data_start, SEEK_SET))
+        return false;
+    {
+        offset_type bytes_skipped = 0;
+        while (bytes_skipped < data_bytes) {
+            int record_size = fortio_init_read(fortio);
+            if (record_size <= 0 || bytes_skipped + record_size > data_bytes)
+                return false;
+
+            if (!fortio_fseek(fortio, (offset_type)record_size, SEEK_CUR))
+                return false;
+
+            if (!fortio_complete_read(fortio, record_size))
+                return false;
+
+            bytes_skipped += record_size;
+        }
+    }
+    return true;
+}
+
+/**
+   Returns the file offset of element nr 'data_element' in a data
+   section starting at 'data_offset', where the elements are split in
+   records of 'block_size' elements.
+*/
+
+offset_type fortio_data_offset(offset_type data_offset, size_t data_element,
+                               const int element_size, const int element_count,
+                               const int block_size) {
     if (data_element >= element_count) {
-        util_abort("%s: Element index is out of range: 0 <= %d < %d \n",
+        util_abort("%s: Element index is out of range: 0 <= %zu < %d \n",
                    __func__, data_element, element_count);
     }
     {
-        int block_index = data_element / block_size;
-        int headers = (block_index + 1) * 4;
-        int trailers = block_index * 4;
-        offset_type bytes_to_skip =
-            data_offset + headers + trailers + (data_element * element_size);
+        offset_type block_index = data_element / block_size;
+        offset_type headers = (block_index + 1) * 4;
+        offset_type trailers = block_index * 4;
+
+        return data_offset + headers + trailers + (data_element * element_size);
+    }
+}
+
+void fortio_data_fseek(fortio_type *fortio, offset_type data_offset,
+                       size_t data_element, const int element_size,
+                       const int element_count, const int block_size) {
+    offset_type offset = fortio_data_offset(
+        data_offset, data_element, element_size, element_count, block_size);
+    fortio_fseek(fortio, offset, SEEK_SET);
+}
+
+/*
+  Reads 'count' elements of 'element_size' bytes, found at the file
+  offsets given by the 'offsets' array, into 'buffer'; element i is
+  stored at buffer[i * element_size]. The offsets are sorted and
+  elements which are close together in the file are read with one
+  fread() of at most FORTIO_GATHER_CHUNK_SIZE bytes into a scratch
+  buffer, and then copied out to their position in 'buffer'. A gap of
+  more than FORTIO_GATHER_MAX_GAP bytes between two elements will
+  always start a new chunk. The file position is undefined when the
+  function returns.
+*/
+
+#define FORTIO_GATHER_CHUNK_SIZE (1 << 20)
+#define FORTIO_GATHER_MAX_GAP (1 << 16)
+
+typedef struct {
+    offset_type offset;
+    int index;
+} fortio_gather_node_type;
+
+static int fortio_gather_node_cmp(const void *arg1, const void *arg2) {
+    const fortio_gather_node_type *node1 =
+        (const fortio_gather_node_type *)arg1;
+    const fortio_gather_node_type *node2 =
+        (const fortio_gather_node_type *)arg2;
+
+    if (node1->offset < node2->offset)
+        return -1;
+    else if (node1->offset > node2->offset)
+        return 1;
+    else
+        return 0;
+}
+
+void fortio_fread_gather(fortio_type *fortio, const offset_type *offsets,
+                         int count, int element_size, char *buffer) {
+    if (count <= 0)
+        return;
+
+    fortio_gather_node_type *nodes =
+        (fortio_gather_node_type *)util_malloc(count * sizeof *nodes);
+    char *scratch = NULL;
+    size_t scratch_size = 0;
+    int i;
 
-        fortio_fseek(fortio, bytes_to_skip, SEEK_SET);
+    for (i = 0; i < count; i++) {
+        nodes[i].offset = offsets[i];
+        nodes[i].index = i;
     }
+    qsort(nodes, count, sizeof *nodes, fortio_gather_node_cmp);
+
+    i = 0;
+    while (i < count) {
+        const offset_type chunk_start = nodes[i].offset;
+        int last = i;
+        size_t chunk_size;
+
+        while (last + 1 < count) {
+            offset_type next_end = nodes[last + 1].offset + element_size;
+            offset_type gap =
+                nodes[last + 1].offset - (nodes[last].offset + element_size);
+
+            if (next_end - chunk_start > FORTIO_GATHER_CHUNK_SIZE)
+                break;
+            if (gap > FORTIO_GATHER_MAX_GAP)
+                break;
+            last++;
+        }
+
+        chunk_size = nodes[last].offset + element_size - chunk_start;
+        if (chunk_size > scratch_size) {
+            scratch = (char *)util_realloc(scratch, chunk_size);
+            scratch_size = chunk_size;
+        }
+
+        fortio_fseek(fortio, chunk_start, SEEK_SET);
+        util_fread(scratch, 1, chunk_size, fortio->stream, __func__);
+        for (; i <= last; i++)
+            memcpy(&buffer[(size_t)nodes[i].index * element_size],
+                   &scratch[nodes[i].offset - chunk_start], element_size);
+    }
+
+    free(scratch);
+    free(nodes);
 }
 
 int fortio_fclean(fortio_type *fortio) {
@@ -517,8 +834,9 @@ static int fortio_fread_record(fortio_type *fortio, char *buffer) {
    transparent, low-level way.
 */
 
-bool fortio_fread_buffer(fortio_type *fortio, char *buffer, int buffer_size) {
-    int total_bytes_read = 0;
+bool fortio_fread_buffer(fortio_type *fortio, char *buffer,
+                         size_t buffer_size) {
+    size_t total_bytes_read = 0;
 
     while (true) {
         char *buffer_ptr = &buffer[total_bytes_read];
@@ -539,11 +857,273 @@ bool fortio_fread_buffer(fortio_type *fortio, char *buffer, int buffer_size) {
     if (total_bytes_read < buffer_size)
         return false;
 
-    util_abort("%s: internal inconsistency: buffer_size:%d  read %d bytes \n",
+    util_abort("%s: internal inconsistency: buffer_size:%zu  read %zu bytes \n",
                __func__, buffer_size, total_bytes_read);
     return false;
 }
 
+static bool fortio_mmap_check_record(const fortio_type *fortio,
+                                     size_t offset, size_t record_size) {
+    int header, tail;
+
+    if (offset > fortio->mmap_size ||
+        fortio->mmap_size - offset < record_size + 2 * sizeof header)
+        return false;
+
+    memcpy(&header, &fortio->mmap_data[offset], sizeof header);
+    memcpy(&tail, &fortio->mmap_data[offset + sizeof header + record_size],
+           sizeof tail);
+    if (fortio->endian_flip_header) {
+        util_endian_flip_vector(&header, sizeof header, 1);
+        util_endian_flip_vector(&tail, sizeof tail, 1);
+    }
+
+    return ((size_t)header == record_size) && ((size_t)tail == record_size);
+}
+
+/*
+  Copies the data section at file offset 'offset' from the mapping into
+  'buffer', with the record markers stripped; see fortio_pread_buffer()
+  for the arguments. Returns false if the data section is not valid or
+  extends beyond the mapping.
+*/
+
+static bool fortio_mmap_read_buffer(const fortio_type *fortio, size_t offset,
+                                    char *buffer, size_t element_size,
+                                    size_t element_count, size_t block_size) {
+    const size_t header_size = sizeof(int);
+    size_t elements_left = element_count;
+    size_t target = 0;
+
+    while (elements_left > 0) {
+        size_t elements = elements_left < block_size ? elements_left
+                                                     : block_size;
+        size_t record_size = elements * element_size;
+        if (!fortio_mmap_check_record(fortio, offset, record_size))
+            return false;
+
+        memcpy(&buffer[target], &fortio->mmap_data[offset + header_size],
+               record_size);
+        target += record_size;
+        offset += record_size + 2 * header_size;
+        elements_left -= elements;
+    }
+    return true;
+}
+
+/**
+   Zero copy alternative to fortio_fread_buffer() for files opened with
+   fortio_open_reader_mmap(). If the data section starting at the
+   current position, consisting of 'element_count' elements of
+   'element_size' bytes split in records of at most 'block_size'
+   elements, is one record whose data is aligned to 'element_size', the
+   function returns a pointer to the data in the mapping and positions
+   the file at the end of the data section. The data is in the on-disk
+   representation, and must not be modified; the pointer is valid until
+   the fortio instance is closed.
+
+   The function returns NULL, and leaves the position unchanged, if the
+   fortio instance is not memory mapped, or the data section spans
+   several records, is not aligned or is not valid; the caller must
+   then read the data with e.g. fortio_fread_buffer().
+*/
+
+const char *fortio_mmap_fread_buffer(fortio_type *fortio, int element_size,
+                                     size_t element_count, int block_size) {
+    if (!fortio->mmap_data || element_count == 0 ||
+        element_count > (size_t)block_size)
+        return NULL;
+    {
+        const size_t start = fortio_ftell(fortio);
+        const size_t data_offset = start + sizeof(int);
+        const size_t record_size = element_count * element_size;
+
+        if (data_offset % element_size != 0 ||
+            !fortio_mmap_check_record(fortio, start, record_size))
+            return NULL;
+
+        fortio_fseek(fortio, data_offset + record_size + sizeof(int),
+                     SEEK_SET);
+        return &fortio->mmap_data[data_offset];
+    }
+}
+
+/**
+   Positional alternative to fortio_fread_buffer(). The data section at
+   file offset 'offset', consisting of 'element_count' elements of
+   'element_size' bytes split in records of at most 'block_size'
+   elements, is read into 'buffer' with the record markers stripped.
+
+   The data is read with preadv(), which neither uses nor changes the
+   position of the stream; several threads can therefore read from the
+   same fortio instance concurrently with this function, as long as
+   the stream is not closed or repositioned for writing meanwhile. For
+   a file opened with fortio_open_reader_mmap() the data is copied
+   from the mapping, which also works when the stream is closed.
+
+   The function returns false if the record markers are not valid or
+   the file is too short. It also returns false, without reading
+   anything, for formatted files, for files opened for writing and on
+   platforms without preadv(); the caller must then fall back to
+   seeking and reading through the stream.
+*/
+
+bool fortio_pread_buffer(const fortio_type *fortio, offset_type offset,
+                         char *buffer, int element_size, size_t element_count,
+                         int block_size) {
+    if (fortio->mmap_data &&
+        fortio_mmap_read_buffer(fortio, offset, buffer, element_size,
+                                element_count, block_size))
+        return true;
+#ifdef HAVE_PREADV
+    if (fortio->fmt_file || fortio->writable || fortio->stream == NULL)
+        return false;
+    {
+        const int fd = fileno(fortio->stream);
+        int markers[2 * FORTIO_PREAD_BATCH];
+        struct iovec iov[3 * FORTIO_PREAD_BATCH];
+        size_t elements_left = element_count;
+        size_t target = 0;
+
+        while (elements_left > 0) {
+            int num_records = 0;
+            size_t batch_size = 0;
+            ssize_t read_size;
+
+            while (elements_left > 0 && num_records < FORTIO_PREAD_BATCH) {
+                size_t elements = elements_left < (size_t)block_size
+                                      ? elements_left
+                                      : block_size;
+                int record_size = elements * element_size;
+                struct iovec *record_iov = &iov[3 * num_records];
+
+                record_iov[0].iov_base = &markers[2 * num_records];
+                record_iov[0].iov_len = sizeof(int);
+                record_iov[1].iov_base = &buffer[target];
+                record_iov[1].iov_len = record_size;
+                record_iov[2].iov_base = &markers[2 * num_records + 1];
+                record_iov[2].iov_len = sizeof(int);
+
+                batch_size += record_size + 2 * sizeof(int);
+                target += record_size;
+                elements_left -= elements;
+                num_records++;
+            }
+
+            do {
+                read_size = preadv(fd, iov, 3 * num_records, offset);
+            } while (read_size < 0 && errno == EINTR);
+
+            if (read_size != (ssize_t)batch_size)
+                return false;
+
+            if (fortio->endian_flip_header)
+                util_endian_flip_vector(markers, sizeof(int), 2 * num_records);
+
+            for (int irec = 0; irec < num_records; irec++) {
+                int record_size = iov[3 * irec + 1].iov_len;
+                if (markers[2 * irec] != record_size ||
+                    markers[2 * irec + 1] != record_size)
+                    return false;
+            }
+            offset += batch_size;
+        }
+        return true;
+    }
+#else
+    return false;
+#endif
+}
+
+/**
+   Reads 'size' raw bytes, i.e. including the record markers, starting
+   at file offset 'offset' into 'buffer' with pread(); the records can
+   subsequently be decoded with fortio_unpack_buffer(). This makes it
+   possible to read a range of the file spanning several keywords with
+   one system call. The same restrictions as for fortio_pread_buffer()
+   apply, and the function returns false if the file is too short.
+*/
+
+bool fortio_pread(const fortio_type *fortio, offset_type offset,
+                  char *buffer, size_t size) {
+    if (fortio->mmap_data && (size_t)offset <= fortio->mmap_size &&
+        fortio->mmap_size - offset >= size) {
+        memcpy(buffer, &fortio->mmap_data[offset], size);
+        return true;
+    }
+#ifdef HAVE_PREADV
+    if (fortio->fmt_file || fortio->writable || fortio->stream == NULL)
+        return false;
+    {
+        const int fd = fileno(fortio->stream);
+        size_t total_read = 0;
+
+        while (total_read < size) {
+            ssize_t read_size = pread(fd, &buffer[total_read],
+                                      size - total_read, offset + total_read);
+            if (read_size < 0 && errno == EINTR)
+                continue;
+
+            if (read_size <= 0)
+                return false;
+
+            total_read += read_size;
+        }
+        return true;
+    }
+#else
+    return false;
+#endif
+}
+
+/**
+   Decodes a data section from 'records', which holds 'records_size'
+   raw bytes read with fortio_pread(), starting at the first record
+   marker of the section. The layout of the data section is given by
+   'element_size', 'element_count' and 'block_size' as for
+   fortio_pread_buffer(); the data is copied to 'buffer' with the
+   record markers stripped.
+
+   Returns false if the record markers are not valid or the data
+   section extends beyond 'records_size'.
+*/
+
+bool fortio_unpack_buffer(const fortio_type *fortio, const char *records,
+                          size_t records_size, char *buffer, int element_size,
+                          int element_count, int block_size) {
+    const size_t header_size = sizeof(int);
+    int elements_left = element_count;
+    size_t record_offset = 0;
+    size_t target = 0;
+
+    while (elements_left > 0) {
+        int record_size =
+            util_int_min(elements_left, block_size) * element_size;
+        int header, tail;
+
+        if (record_offset + record_size + 2 * header_size > records_size)
+            return false;
+
+        memcpy(&header, &records[record_offset], sizeof header);
+        memcpy(&tail, &records[record_offset + header_size + record_size],
+               sizeof tail);
+        if (fortio->endian_flip_header) {
+            util_endian_flip_vector(&header, sizeof header, 1);
+            util_endian_flip_vector(&tail, sizeof tail, 1);
+        }
+
+        if (header != record_size || tail != record_size)
+            return false;
+
+        memcpy(&buffer[target], &records[record_offset + header_size],
+               record_size);
+        target += record_size;
+        record_offset += record_size + 2 * header_size;
+        elements_left -= block_size;
+    }
+    return true;
+}
+
 int fortio_fskip_record(fortio_type *fortio) {
     int record_size = fortio_init_read(fortio);
     fortio_fseek(fortio, (offset_type)record_size, SEEK_CUR);
@@ -551,12 +1131,16 @@ int fortio_fskip_record(fortio_type *fortio) {
     return record_size;
 }
 
-void fortio_fskip_buffer(fortio_type *fortio, int buffer_size) {
-    int bytes_skipped = 0;
-    while (bytes_skipped < buffer_size)
-        bytes_skipped += fortio_fskip_record(fortio);
+void fortio_fskip_buffer(fortio_type *fortio, size_t buffer_size) {
+    size_t bytes_skipped = 0;
+    while (bytes_skipped < buffer_size) {
+        int record_size = fortio_fskip_record(fortio);
+        if (record_size < 0)
+            break;
+        bytes_skipped += record_size;
+    }
 
-    if (bytes_skipped > buffer_size)
+    if (bytes_skipped != buffer_size)
         util_abort("%s: hmmmm - something is broken. The individual records in "
                    "%s did not sum up to the expected buffer size \n",
                    __func__, fortio->filename);
@@ -753,9 +1337,11 @@ bool fortio_fseek(fortio_type *fortio, offset_type offset, int whence) {
             util_abort("%s: invalid seek flag \n", __func__);
         }
 
-        if (new_offset <= fortio->read_size)
-            return fortio_fseek__(fortio, new_offset, SEEK_SET);
-        else
+        if (new_offset <= fortio->read_size) {
+            bool seek_ok = fortio_fseek__(fortio, new_offset, SEEK_SET);
+            fortio_read_ahead(fortio, new_offset);
+            return seek_ok;
+        } else
             return false;
     }
 }
@@ -779,8 +1365,9 @@ int fortio_fileno(fortio_type *fortio) { return fileno(fortio->stream); }
 */
 
 bool fortio_read_at_eof(fortio_type *fortio) {
-
-    if (fortio_ftell(fortio) == fortio->read_size)
+    offset_type pos = fortio_ftell(fortio);
+    fortio_read_ahead(fortio, pos);
+    if (pos == fortio->read_size)
         return true;
     else
         return false;
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <thread>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 25000
+#define NUM_STEPS 4
+#define NUM_THREADS 8
+
+static std::vector<ecl_kw_type *> alloc_kw_list() {
+    const char *names[] = {"PRESSURE", "SWAT", "SGAS", "RS"};
+    std::vector<ecl_kw_type *> kw_list;
+
+    for (int step = 0; step < NUM_STEPS; step++) {
+        for (int i = 0; i < 4; i++) {
+            ecl_kw_type *kw = ecl_kw_alloc(names[i], SIZE, ECL_FLOAT);
+            for (int j = 0; j < SIZE; j++)
+                ecl_kw_iset_float(kw, j, step * 1000 + i * 100 + j * 0.25);
+            kw_list.push_back(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("ACTNUM", SIZE + step, ECL_INT);
+            for (int j = 0; j < SIZE + step; j++)
+                ecl_kw_iset_int(kw, j, j % 3);
+            kw_list.push_back(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("WELLS", 3, ECL_CHAR);
+            ecl_kw_iset_string8(kw, 0, "OP_1");
+            ecl_kw_iset_string8(kw, 1, "OP_2");
+            ecl_kw_iset_string8(kw, 2, "INJ");
+            kw_list.push_back(kw);
+        }
+    }
+    return kw_list;
+}
+
+static std::vector<offset_type>
+fwrite_kw_list(const char *filename, bool fmt_file,
+               const std::vector<ecl_kw_type *> &kw_list) {
+    std::vector<offset_type> offsets;
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (const ecl_kw_type *kw : kw_list) {
+        offsets.push_back(fortio_ftell(fortio));
+        ecl_kw_fwrite(kw, fortio);
+    }
+    fortio_fclose(fortio);
+    return offsets;
+}
+
+void test_pread_alloc(const std::vector<ecl_kw_type *> &kw_list) {
+    ecl::util::TestArea ta("pread_alloc");
+    std::vector<offset_type> offsets =
+        fwrite_kw_list("FILE.UNRST", false, kw_list);
+    fwrite_kw_list("FILE.FUNRST", true, kw_list);
+    {
+        fortio_type *fortio =
+            fortio_open_reader("FILE.UNRST", false, ECL_ENDIAN_FLIP);
+        for (int i = kw_list.size() - 1; i >= 0; i--) {
+            ecl_kw_type *kw = ecl_kw_pread_alloc(fortio, offsets[i]);
+            test_assert_not_NULL(kw);
+            test_assert_true(ecl_kw_equal(kw, kw_list[i]));
+            ecl_kw_free(kw);
+        }
+        test_assert_true(fortio_ftell(fortio) == 0);
+
+        /* Offset which is not the start of a keyword. */
+        test_assert_NULL(ecl_kw_pread_alloc(fortio, offsets[1] + 4));
+        fortio_fclose(fortio);
+    }
+    {
+        fortio_type *fortio =
+            fortio_open_reader("FILE.FUNRST", true, ECL_ENDIAN_FLIP);
+        test_assert_NULL(ecl_kw_pread_alloc(fortio, 0));
+        fortio_fclose(fortio);
+    }
+}
+
+static void load_all(ecl_file_type *ecl_file, int first,
+                     std::vector<ecl_kw_type *> *result) {
+    int size = ecl_file_get_size(ecl_file);
+    for (int i = 0; i < size; i++) {
+        int index = (first + i) % size;
+        (*result)[index] = ecl_file_iget_kw(ecl_file, index);
+    }
+}
+
+void test_concurrent_load(const char *filename, bool fmt_file, int flags,
+                          const std::vector<ecl_kw_type *> &kw_list) {
+    ecl::util::TestArea ta("concurrent_load");
+    fwrite_kw_list(filename, fmt_file, kw_list);
+
+    for (int iter = 0; iter < 5; iter++) {
+        ecl_file_type *ecl_file = ecl_file_open(filename, flags);
+        std::vector<std::vector<ecl_kw_type *>> results(
+            NUM_THREADS, std::vector<ecl_kw_type *>(kw_list.size()));
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < NUM_THREADS; t++)
+            threads.emplace_back(load_all, ecl_file, t * 3 + iter,
+                                 &results[t]);
+        for (auto &thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < kw_list.size(); i++) {
+            test_assert_true(ecl_kw_equal(results[0][i], kw_list[i]));
+            for (int t = 1; t < NUM_THREADS; t++)
+                test_assert_ptr_equal(results[0][i], results[t][i]);
+            test_assert_ptr_equal(results[0][i],
+                                  ecl_file_iget_kw(ecl_file, i));
+        }
+        ecl_file_close(ecl_file);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<ecl_kw_type *> kw_list = alloc_kw_list();
+
+    test_pread_alloc(kw_list);
+    test_concurrent_load("FILE.UNRST", false, 0, kw_list);
+    test_concurrent_load("FILE.FUNRST", true, 0, kw_list);
+    test_concurrent_load("FILE.UNRST", false, ECL_FILE_CLOSE_STREAM, kw_list);
+    test_concurrent_load("FILE.FUNRST", true, ECL_FILE_CLOSE_STREAM, kw_list);
+    test_concurrent_load("FILE.UNRST", false, ECL_FILE_MMAP, kw_list);
+
+    for (ecl_kw_type *kw : kw_list)
+        ecl_kw_free(kw);
+    exit(0);
+}
@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+static void write_file(const char *filename, bool fmt_file,
+                       ecl_kw_type **kw_list, int num_kw) {
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (int i = 0; i < num_kw; i++)
+        ecl_kw_fwrite(kw_list[i], fortio);
+    fortio_fclose(fortio);
+}
+
+static void test_slice(const ecl_file_type *ecl_file, const ecl_kw_type *ecl_kw,
+                       int offset, int count) {
+    const char *header = ecl_kw_get_header(ecl_kw);
+    double *double_data = (double *)util_calloc(count + 1, sizeof *double_data);
+    float *float_data = (float *)util_calloc(count + 1, sizeof *float_data);
+
+    test_assert_true(ecl_file_fread_named_kw_as_double(
+        ecl_file, header, 0, offset, count, double_data));
+    test_assert_true(ecl_file_fread_named_kw_as_float(
+        ecl_file, header, 0, offset, count, float_data));
+    for (int i = 0; i < count; i++) {
+        double expected = ecl_kw_iget_as_double(ecl_kw, offset + i);
+        test_assert_double_equal(expected, double_data[i]);
+        test_assert_float_equal((float)expected, float_data[i]);
+    }
+
+    free(double_data);
+    free(float_data);
+}
+
+static void test_kw(const ecl_file_type *ecl_file, const ecl_kw_type *ecl_kw) {
+    int size = ecl_kw_get_size(ecl_kw);
+    test_slice(ecl_file, ecl_kw, 0, size);
+    test_slice(ecl_file, ecl_kw, 0, 0);
+    test_slice(ecl_file, ecl_kw, size - 1, 1);
+    test_slice(ecl_file, ecl_kw, size / 3, size / 2);
+    test_slice(ecl_file, ecl_kw, 999, 2);
+}
+
+static void test_file(bool fmt_file) {
+    ecl::util::TestArea ta("fread_as");
+    ecl_kw_type *kw_list[3];
+    const char *filename = fmt_file ? "FILE.FUNRST" : "FILE.UNRST";
+
+    kw_list[0] = ecl_kw_alloc("PRESSURE", 2500, ECL_FLOAT);
+    kw_list[1] = ecl_kw_alloc("ACTNUM", 1200, ECL_INT);
+    kw_list[2] = ecl_kw_alloc("DOUBLE", 1500, ECL_DOUBLE);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(kw_list[0], i, 100 + i * 0.25);
+    for (int i = 0; i < 1200; i++)
+        ecl_kw_iset_int(kw_list[1], i, i - 600);
+    for (int i = 0; i < 1500; i++)
+        ecl_kw_iset_double(kw_list[2], i, i / 7.0);
+
+    write_file(filename, fmt_file, kw_list, 3);
+    {
+        ecl_file_type *ecl_file = ecl_file_open(filename, 0);
+        for (int i = 0; i < 3; i++)
+            test_kw(ecl_file, kw_list[i]);
+
+        /* Keywords which are already loaded are served from memory. */
+        ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+        test_kw(ecl_file, kw_list[0]);
+        ecl_file_close(ecl_file);
+    }
+
+    for (int i = 0; i < 3; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+/*
+  With ECL_FILE_CLOSE_STREAM the stream is reopened for the read and
+  closed again afterwards; when the file has gone the read fails.
+*/
+static void test_close_stream() {
+    ecl::util::TestArea ta("fread_as_close");
+    ecl_kw_type *ecl_kw = ecl_kw_alloc("PRESSURE", 2500, ECL_FLOAT);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(ecl_kw, i, 100 + i * 0.25);
+    write_file("FILE.UNRST", false, &ecl_kw, 1);
+    {
+        ecl_file_type *ecl_file =
+            ecl_file_open("FILE.UNRST", ECL_FILE_CLOSE_STREAM);
+        double double_data[10];
+
+        test_kw(ecl_file, ecl_kw);
+        unlink("FILE.UNRST");
+        test_assert_false(ecl_file_fread_named_kw_as_double(
+            ecl_file, "PRESSURE", 0, 0, 10, double_data));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(ecl_kw);
+}
+
+static void read_all(const ecl_file_type *ecl_file, ecl_kw_type **kw_list,
+                     int num_kw, bool *read_ok) {
+    for (int iter = 0; iter < 20; iter++) {
+        for (int i = 0; i < num_kw; i++) {
+            int size = ecl_kw_get_size(kw_list[i]);
+            int offset = (iter * 97) % size;
+            int count = std::min(size - offset, 1100);
+            std::vector<double> data(count);
+
+            if (!ecl_file_fread_named_kw_as_double(
+                    ecl_file, ecl_kw_get_header(kw_list[i]), 0, offset, count,
+                    data.data())) {
+                *read_ok = false;
+                return;
+            }
+            for (int j = 0; j < count; j++)
+                if (data[j] != ecl_kw_iget_as_double(kw_list[i], offset + j))
+                    *read_ok = false;
+        }
+    }
+}
+
+/*
+  Several threads read from the same file; the reads seek in the shared
+  stream, so they must be serialized by the file.
+*/
+static void test_concurrent(int flags) {
+    ecl::util::TestArea ta("fread_as_concurrent");
+    const int num_kw = 4;
+    const int num_threads = 4;
+    ecl_kw_type *kw_list[num_kw];
+    const char *names[] = {"PRESSURE", "SWAT", "SGAS", "RS"};
+
+    for (int i = 0; i < num_kw; i++) {
+        kw_list[i] = ecl_kw_alloc(names[i], 5000 + i, ECL_FLOAT);
+        for (int j = 0; j < 5000 + i; j++)
+            ecl_kw_iset_float(kw_list[i], j, i * 10000 + j * 0.5);
+    }
+    write_file("FILE.UNRST", false, kw_list, num_kw);
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", flags);
+        std::vector<std::thread> threads;
+        bool read_ok[num_threads];
+
+        for (int t = 0; t < num_threads; t++) {
+            read_ok[t] = true;
+            threads.emplace_back(read_all, ecl_file, kw_list, num_kw,
+                                 &read_ok[t]);
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        for (int t = 0; t < num_threads; t++)
+            test_assert_true(read_ok[t]);
+        ecl_file_close(ecl_file);
+    }
+
+    for (int i = 0; i < num_kw; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+int main(int argc, char **argv) {
+    test_file(false);
+    test_file(true);
+    test_close_stream();
+    test_concurrent(0);
+    test_concurrent(ECL_FILE_CLOSE_STREAM);
+    exit(0);
+}
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define NUM_KW 4
+
+static void test_slice(const ecl_file_type *ecl_file, const ecl_kw_type *ecl_kw,
+                       int start, int end) {
+    ecl_kw_type *slice_kw = ecl_file_iget_named_kw_slice(
+        ecl_file, ecl_kw_get_header(ecl_kw), 0, start, end);
+
+    test_assert_not_NULL(slice_kw);
+    test_assert_int_equal(end - start, ecl_kw_get_size(slice_kw));
+    test_assert_true(ecl_type_is_equal(ecl_kw_get_data_type(ecl_kw),
+                                       ecl_kw_get_data_type(slice_kw)));
+    test_assert_string_equal(ecl_kw_get_header(ecl_kw),
+                             ecl_kw_get_header(slice_kw));
+    if (start < end) {
+        ecl_kw_type *expected =
+            ecl_kw_alloc_sub_copy(ecl_kw, NULL, start, end - start);
+        test_assert_true(ecl_kw_equal(expected, slice_kw));
+        ecl_kw_free(expected);
+    }
+    ecl_kw_free(slice_kw);
+}
+
+static void test_kw(const ecl_file_type *ecl_file, const ecl_kw_type *ecl_kw) {
+    int size = ecl_kw_get_size(ecl_kw);
+    test_slice(ecl_file, ecl_kw, 0, size);
+    test_slice(ecl_file, ecl_kw, 0, 1);
+    test_slice(ecl_file, ecl_kw, size - 1, size);
+    test_slice(ecl_file, ecl_kw, size / 3, size / 2);
+    test_slice(ecl_file, ecl_kw, 104, 106);
+    test_slice(ecl_file, ecl_kw, 999, 1001);
+    test_slice(ecl_file, ecl_kw, 10, 10);
+}
+
+static void test_file(bool fmt_file) {
+    ecl::util::TestArea ta("kw_slice");
+    const char *filename = fmt_file ? "FILE.FEGRID" : "FILE.EGRID";
+    ecl_kw_type *kw_list[NUM_KW];
+
+    kw_list[0] = ecl_kw_alloc("ZCORN", 2500, ECL_FLOAT);
+    kw_list[1] = ecl_kw_alloc("ACTNUM", 1200, ECL_INT);
+    kw_list[2] = ecl_kw_alloc("LOGIHEAD", 1100, ECL_BOOL);
+    kw_list[3] = ecl_kw_alloc("NAMES", 1050, ECL_CHAR);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(kw_list[0], i, i * 0.5);
+    for (int i = 0; i < 1200; i++)
+        ecl_kw_iset_int(kw_list[1], i, i % 5);
+    for (int i = 0; i < 1100; i++)
+        ecl_kw_iset_bool(kw_list[2], i, i % 3 == 0);
+    for (int i = 0; i < 1050; i++) {
+        char name[16];
+        sprintf(name, "N%d", i);
+        ecl_kw_iset_char_ptr(kw_list[3], i, name);
+    }
+
+    {
+        fortio_type *fortio =
+            fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+        for (int i = 0; i < NUM_KW; i++)
+            ecl_kw_fwrite(kw_list[i], fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open(filename, 0);
+        for (int i = 0; i < NUM_KW; i++)
+            test_kw(ecl_file, kw_list[i]);
+
+        /* Slices of loaded keywords are copied from memory. */
+        ecl_file_iget_named_kw(ecl_file, "ZCORN", 0);
+        test_kw(ecl_file, kw_list[0]);
+        ecl_file_close(ecl_file);
+    }
+
+    for (int i = 0; i < NUM_KW; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+/*
+  Writes the float keyword @ecl_kw with @record_size elements in each
+  record, instead of the blocks of 1000 elements of ecl_kw_fwrite().
+*/
+static void fwrite_blocked(const ecl_kw_type *ecl_kw, fortio_type *fortio,
+                           int record_size) {
+    int size = ecl_kw_get_size(ecl_kw);
+    char header[16];
+    float *data = (float *)util_calloc(size, sizeof *data);
+
+    memcpy(header, ecl_kw_get_header8(ecl_kw), 8);
+    memcpy(&header[8], &size, 4);
+    memcpy(&header[12], "REAL", 4);
+    ecl_kw_get_memcpy_data(ecl_kw, data);
+    if (ECL_ENDIAN_FLIP) {
+        util_endian_flip_vector(&header[8], 4, 1);
+        util_endian_flip_vector(data, sizeof *data, size);
+    }
+
+    fortio_fwrite_record(fortio, header, sizeof header);
+    for (int i = 0; i < size; i += record_size)
+        fortio_fwrite_record(fortio, (const char *)&data[i],
+                             util_int_min(record_size, size - i) *
+                                 sizeof *data);
+    free(data);
+}
+
+/*
+  Keywords written by other applications need not use the standard
+  blocking; the slices are then read by walking the records.
+*/
+static void test_blocking(int record_size) {
+    ecl::util::TestArea ta("kw_slice_blocking");
+    ecl_kw_type *zcorn_kw = ecl_kw_alloc("ZCORN", 2500, ECL_FLOAT);
+    ecl_kw_type *actnum_kw = ecl_kw_alloc("ACTNUM", 1200, ECL_INT);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(zcorn_kw, i, i * 0.5);
+    for (int i = 0; i < 1200; i++)
+        ecl_kw_iset_int(actnum_kw, i, i % 5);
+
+    {
+        fortio_type *fortio =
+            fortio_open_writer("FILE.EGRID", false, ECL_ENDIAN_FLIP);
+        fwrite_blocked(zcorn_kw, fortio, record_size);
+        ecl_kw_fwrite(actnum_kw, fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE.EGRID", 0);
+        double double_data[3];
+
+        test_kw(ecl_file, zcorn_kw);
+        test_kw(ecl_file, actnum_kw);
+        test_assert_true(ecl_file_fread_named_kw_as_double(
+            ecl_file, "ZCORN", 0, 1499, 3, double_data));
+        for (int i = 0; i < 3; i++)
+            test_assert_double_equal((1499 + i) * 0.5, double_data[i]);
+        ecl_file_close(ecl_file);
+    }
+
+    ecl_kw_free(zcorn_kw);
+    ecl_kw_free(actnum_kw);
+}
+
+/*
+  With ECL_FILE_CLOSE_STREAM the stream is reopened for the read and
+  closed again afterwards; when the file has gone the read fails.
+*/
+static void test_close_stream() {
+    ecl::util::TestArea ta("kw_slice_close");
+    ecl_kw_type *ecl_kw = ecl_kw_alloc("ZCORN", 2500, ECL_FLOAT);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(ecl_kw, i, i * 0.5);
+    {
+        fortio_type *fortio =
+            fortio_open_writer("FILE.EGRID", false, ECL_ENDIAN_FLIP);
+        ecl_kw_fwrite(ecl_kw, fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file =
+            ecl_file_open("FILE.EGRID", ECL_FILE_CLOSE_STREAM);
+        test_kw(ecl_file, ecl_kw);
+        unlink("FILE.EGRID");
+        test_assert_NULL(
+            ecl_file_iget_named_kw_slice(ecl_file, "ZCORN", 0, 0, 10));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(ecl_kw);
+}
+
+int main(int argc, char **argv) {
+    test_file(false);
+    test_file(true);
+    test_close_stream();
+    test_blocking(300);
+    test_blocking(2500);
+    exit(0);
+}
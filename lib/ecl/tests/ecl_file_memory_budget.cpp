@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_file_view.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 10000
+#define NUM_KW 6
+#define KW_BYTES (SIZE * sizeof(float))
+
+static ecl_kw_type *alloc_kw(int offset) {
+    ecl_kw_type *kw = ecl_kw_alloc("PRESSURE", SIZE, ECL_FLOAT);
+    for (int i = 0; i < SIZE; i++)
+        ecl_kw_iset_float(kw, i, offset * 1000 + i);
+    return kw;
+}
+
+static void write_file(const char *filename) {
+    fortio_type *fortio = fortio_open_writer(filename, false, ECL_ENDIAN_FLIP);
+    for (int i = 0; i < NUM_KW; i++) {
+        ecl_kw_type *kw = alloc_kw(i);
+        ecl_kw_fwrite(kw, fortio);
+        ecl_kw_free(kw);
+    }
+    fortio_fclose(fortio);
+}
+
+static bool is_loaded(const ecl_file_type *ecl_file, int index) {
+    return ecl_file_kw_peek_kw(
+               ecl_file_iget_named_file_kw(ecl_file, "PRESSURE", index)) !=
+           NULL;
+}
+
+static void assert_kw(ecl_file_type *ecl_file, int index) {
+    ecl_kw_type *expected = alloc_kw(index);
+    test_assert_true(ecl_kw_equal(
+        ecl_file_iget_named_kw(ecl_file, "PRESSURE", index), expected));
+    ecl_kw_free(expected);
+}
+
+void test_lru_eviction() {
+    ecl::util::TestArea ta("memory_budget");
+    write_file("FILE.UNRST");
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+    test_assert_size_t_equal(0, ecl_file_get_memory_budget(ecl_file));
+    ecl_file_set_memory_budget(ecl_file, 3 * KW_BYTES);
+    test_assert_size_t_equal(3 * KW_BYTES,
+                             ecl_file_get_memory_budget(ecl_file));
+
+    for (int i = 0; i < NUM_KW; i++)
+        assert_kw(ecl_file, i);
+
+    test_assert_size_t_equal(0, ecl_file_get_kw_hits(ecl_file));
+    test_assert_size_t_equal(NUM_KW, ecl_file_get_kw_misses(ecl_file));
+    test_assert_size_t_equal(NUM_KW - 3, ecl_file_get_kw_evictions(ecl_file));
+    for (int i = 0; i < NUM_KW; i++)
+        test_assert_true((i >= NUM_KW - 3) == is_loaded(ecl_file, i));
+
+    /* Keyword 3 is accessed a second time, and is then held; the least
+       recently used keyword 4 is evicted instead. */
+    assert_kw(ecl_file, 3);
+    test_assert_size_t_equal(1, ecl_file_get_kw_hits(ecl_file));
+    assert_kw(ecl_file, 0);
+    test_assert_size_t_equal(NUM_KW + 1, ecl_file_get_kw_misses(ecl_file));
+    test_assert_size_t_equal(NUM_KW - 2, ecl_file_get_kw_evictions(ecl_file));
+    test_assert_true(is_loaded(ecl_file, 0));
+    test_assert_true(is_loaded(ecl_file, 3));
+    test_assert_false(is_loaded(ecl_file, 4));
+    test_assert_true(is_loaded(ecl_file, 5));
+
+    /* A keyword larger than the budget is still loaded, and the held
+       keyword 3 is not evicted. */
+    ecl_file_set_memory_budget(ecl_file, KW_BYTES / 2);
+    assert_kw(ecl_file, 1);
+    for (int i = 0; i < NUM_KW; i++)
+        test_assert_true((i == 1 || i == 3) == is_loaded(ecl_file, i));
+
+    ecl_file_set_memory_budget(ecl_file, 0);
+    for (int i = 0; i < NUM_KW; i++)
+        assert_kw(ecl_file, i);
+    for (int i = 0; i < NUM_KW; i++)
+        test_assert_true(is_loaded(ecl_file, i));
+
+    ecl_file_close(ecl_file);
+}
+
+void test_transaction() {
+    ecl::util::TestArea ta("memory_budget_transaction");
+    write_file("FILE.UNRST");
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+    ecl_file_set_memory_budget(ecl_file, KW_BYTES);
+
+    assert_kw(ecl_file, 0);
+    {
+        ecl_file_transaction_type *t = ecl_file_view_start_transaction(view);
+        const ecl_kw_type *kw0 =
+            ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+        const ecl_kw_type *kw1 =
+            ecl_file_iget_named_kw(ecl_file, "PRESSURE", 1);
+
+        /* The keywords of the transaction are held, and not evicted. */
+        assert_kw(ecl_file, 2);
+        test_assert_size_t_equal(0, ecl_file_get_kw_evictions(ecl_file));
+        test_assert_float_equal(ecl_kw_iget_float(kw0, 1), 1);
+        test_assert_float_equal(ecl_kw_iget_float(kw1, 1), 1001);
+        ecl_file_view_end_transaction(view, t);
+    }
+    /* The keywords loaded during the transaction are dropped. */
+    for (int i = 0; i < NUM_KW; i++)
+        test_assert_true((i == 0) == is_loaded(ecl_file, i));
+
+    assert_kw(ecl_file, 0);
+    test_assert_true(is_loaded(ecl_file, 0));
+    ecl_file_close(ecl_file);
+}
+
+void test_modified() {
+    ecl::util::TestArea ta("memory_budget_modified");
+    write_file("FILE.UNRST");
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+    ecl_file_set_memory_budget(ecl_file, KW_BYTES);
+
+    ecl_kw_type *kw0 = ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+    ecl_kw_iset_float(kw0, 0, -1);
+    for (int i = 1; i < NUM_KW; i++)
+        assert_kw(ecl_file, i);
+
+    /* The modified keyword is never evicted. */
+    test_assert_true(is_loaded(ecl_file, 0));
+    test_assert_ptr_equal(kw0,
+                          ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0));
+    test_assert_float_equal(ecl_kw_iget_float(kw0, 0), -1);
+    test_assert_size_t_equal(NUM_KW - 1, ecl_file_get_kw_evictions(ecl_file));
+    ecl_file_close(ecl_file);
+}
+
+void test_writable() {
+    ecl::util::TestArea ta("memory_budget_writable");
+    write_file("FILE.UNRST");
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", ECL_FILE_WRITABLE);
+    ecl_file_set_memory_budget(ecl_file, KW_BYTES);
+    for (int i = 0; i < NUM_KW; i++)
+        assert_kw(ecl_file, i);
+
+    test_assert_size_t_equal(0, ecl_file_get_kw_evictions(ecl_file));
+    for (int i = 0; i < NUM_KW; i++)
+        test_assert_true(is_loaded(ecl_file, i));
+    ecl_file_close(ecl_file);
+}
+
+int main(int argc, char **argv) {
+    test_lru_eviction();
+    test_transaction();
+    test_modified();
+    test_writable();
+    exit(0);
+}
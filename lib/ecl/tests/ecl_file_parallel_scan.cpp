@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define NUM_STEPS 10
+
+/*
+  The data of the FAKE keyword is a complete keyword with header "FAKE"
+  and three integers, to check that the scan is not fooled by keyword
+  data which looks like a keyword.
+*/
+static void fwrite_fake_kw(fortio_type *fortio) {
+    const int fake[] = {16, 0x46414B45, 0x20202020, 3, 0x494E5445, 16,
+                        12, 1,          2,          3, 12};
+    const int num_fake = sizeof fake / sizeof fake[0];
+    ecl_kw_type *kw = ecl_kw_alloc("FAKE", 4 * num_fake, ECL_INT);
+
+    for (int i = 0; i < 4 * num_fake; i++)
+        ecl_kw_iset_int(kw, i, fake[i % num_fake]);
+    ecl_kw_fwrite(kw, fortio);
+    ecl_kw_free(kw);
+}
+
+static void write_file(const char *filename, bool fmt_file) {
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (int step = 0; step < NUM_STEPS; step++) {
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("SEQNUM", 1, ECL_INT);
+            ecl_kw_iset_int(kw, 0, step);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("PRESSURE", 1500 + step, ECL_FLOAT);
+            ecl_kw_scalar_set_float(kw, step);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("DOUBHEAD", 30, ECL_DOUBLE);
+            ecl_kw_scalar_set_double(kw, step);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("ZWEL", 3 * step, ECL_CHAR);
+            for (int i = 0; i < 3 * step; i++)
+                ecl_kw_iset_string8(kw, i, "OP_1");
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("LOGIHEAD", 20, ECL_BOOL);
+            ecl_kw_scalar_set_bool(kw, true);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("ENDSOL", 0, ECL_MESS);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        fwrite_fake_kw(fortio);
+    }
+    fortio_fclose(fortio);
+}
+
+static void append_garbage(const char *filename) {
+    FILE *stream = util_fopen(filename, "a");
+    for (int i = 0; i < 100; i++)
+        fputc(i % 7 == 0 ? 16 : 0, stream);
+    fclose(stream);
+}
+
+static void truncate_file(const char *filename, size_t size) {
+    char *buffer = (char *)util_malloc(size);
+    FILE *stream = util_fopen(filename, "r");
+    test_assert_size_t_equal(size, fread(buffer, 1, size, stream));
+    fclose(stream);
+
+    stream = util_fopen(filename, "w");
+    fwrite(buffer, 1, size, stream);
+    fclose(stream);
+    free(buffer);
+}
+
+static void assert_scan(const char *filename, size_t range_size) {
+    ecl_file_type *serial = ecl_file_open(filename, 0);
+
+    ecl_file_set_scan_range_size(range_size);
+    test_assert_size_t_equal(range_size, ecl_file_get_scan_range_size());
+    {
+        ecl_file_type *parallel =
+            ecl_file_open(filename, ECL_FILE_PARALLEL_SCAN);
+
+        test_assert_int_equal(ecl_file_get_size(serial),
+                              ecl_file_get_size(parallel));
+        for (int i = 0; i < ecl_file_get_size(serial); i++)
+            test_assert_true(
+                ecl_file_kw_equal(ecl_file_iget_file_kw(serial, i),
+                                  ecl_file_iget_file_kw(parallel, i)));
+        test_assert_int_equal(ecl_file_get_num_named_kw(serial, "FAKE"),
+                              ecl_file_get_num_named_kw(parallel, "FAKE"));
+        test_assert_int_equal(
+            ecl_file_get_num_distinct_kw(serial),
+            ecl_file_get_num_distinct_kw(parallel));
+        ecl_file_close(parallel);
+    }
+    ecl_file_close(serial);
+}
+
+static void assert_range_sizes(const char *filename) {
+    size_t file_size = util_file_size(filename);
+
+    for (size_t range_size = 16; range_size < 400; range_size += 13)
+        assert_scan(filename, range_size);
+
+    for (size_t range_size = 400; range_size < file_size;
+         range_size = range_size * 3 / 2 + 1)
+        assert_scan(filename, range_size);
+
+    assert_scan(filename, file_size);
+}
+
+void test_parallel_scan() {
+    ecl::util::TestArea ta("parallel_scan");
+    write_file("FILE.UNRST", false);
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+        test_assert_int_equal(7 * NUM_STEPS, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+    }
+    assert_range_sizes("FILE.UNRST");
+}
+
+void test_broken_file() {
+    ecl::util::TestArea ta("parallel_scan_broken");
+    write_file("FILE.UNRST", false);
+    append_garbage("FILE.UNRST");
+    assert_range_sizes("FILE.UNRST");
+
+    truncate_file("FILE.UNRST", util_file_size("FILE.UNRST") / 2);
+    assert_range_sizes("FILE.UNRST");
+}
+
+void test_formatted() {
+    ecl::util::TestArea ta("parallel_scan_formatted");
+    write_file("FILE.FUNRST", true);
+    assert_scan("FILE.FUNRST", 100);
+}
+
+int main(int argc, char **argv) {
+    test_parallel_scan();
+    test_broken_file();
+    test_formatted();
+    exit(0);
+}
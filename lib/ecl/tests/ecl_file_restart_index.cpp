@@ -0,0 +1,238 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <thread>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_kw_magic.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_file_view.hpp>
+#include <ert/ecl/ecl_util.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define NUM_BLOCKS 50
+
+static int report_step(int block) { return 5 * block + 3; }
+
+static time_t sim_time(int block) {
+    return ecl_util_make_date(1 + block % 28, 1 + block % 12, 2000 + block);
+}
+
+static double sim_days(int block) { return 30.5 * block; }
+
+static void fwrite_intehead(fortio_type *fortio, time_t date) {
+    int mday, month, year;
+    ecl_kw_type *intehead_kw =
+        ecl_kw_alloc(INTEHEAD_KW, INTEHEAD_RESTART_SIZE, ECL_INT);
+    ecl_util_set_date_values(date, &mday, &month, &year);
+    ecl_kw_scalar_set_int(intehead_kw, 0);
+    ecl_kw_iset_int(intehead_kw, INTEHEAD_DAY_INDEX, mday);
+    ecl_kw_iset_int(intehead_kw, INTEHEAD_MONTH_INDEX, month);
+    ecl_kw_iset_int(intehead_kw, INTEHEAD_YEAR_INDEX, year);
+    ecl_kw_fwrite(intehead_kw, fortio);
+    ecl_kw_free(intehead_kw);
+}
+
+/*
+  Every fifth block has an extra INTEHEAD keyword for an LGR, with the
+  date of the following block.
+*/
+static void write_file(const char *filename, bool fmt_file) {
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        {
+            ecl_kw_type *seqnum_kw = ecl_kw_alloc(SEQNUM_KW, 1, ECL_INT);
+            ecl_kw_iset_int(seqnum_kw, 0, report_step(block));
+            ecl_kw_fwrite(seqnum_kw, fortio);
+            ecl_kw_free(seqnum_kw);
+        }
+        fwrite_intehead(fortio, sim_time(block));
+        {
+            ecl_kw_type *doubhead_kw =
+                ecl_kw_alloc(DOUBHEAD_KW, 10, ECL_DOUBLE);
+            ecl_kw_scalar_set_double(doubhead_kw, 0);
+            ecl_kw_iset_double(doubhead_kw, DOUBHEAD_DAYS_INDEX,
+                               sim_days(block));
+            ecl_kw_fwrite(doubhead_kw, fortio);
+            ecl_kw_free(doubhead_kw);
+        }
+        {
+            ecl_kw_type *pressure_kw = ecl_kw_alloc("PRESSURE", 100, ECL_FLOAT);
+            ecl_kw_scalar_set_float(pressure_kw, block);
+            ecl_kw_fwrite(pressure_kw, fortio);
+            ecl_kw_free(pressure_kw);
+        }
+        if (block % 5 == 0)
+            fwrite_intehead(fortio, sim_time(block + 1));
+    }
+    fortio_fclose(fortio);
+}
+
+static void assert_none_loaded(const ecl_file_type *ecl_file) {
+    for (int i = 0; i < ecl_file_get_size(ecl_file); i++)
+        test_assert_NULL(
+            ecl_file_kw_peek_kw(ecl_file_iget_file_kw(ecl_file, i)));
+}
+
+static void assert_block(ecl_file_type *ecl_file, int block) {
+    ecl_kw_type *pressure_kw = ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+    test_assert_int_equal(1, ecl_file_get_num_named_kw(ecl_file, SEQNUM_KW));
+    test_assert_float_equal(block, ecl_kw_iget_float(pressure_kw, 0));
+}
+
+void test_lookup(const char *filename, bool fmt_file) {
+    ecl::util::TestArea ta("restart_index");
+    write_file(filename, fmt_file);
+
+    ecl_file_type *ecl_file = ecl_file_open(filename, 0);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        int seqnum_value = report_step(block);
+        test_assert_true(
+            ecl_file_has_report_step(ecl_file, report_step(block)));
+        test_assert_false(
+            ecl_file_has_report_step(ecl_file, report_step(block) + 1));
+        test_assert_int_equal(block,
+                              ecl_file_view_seqnum_index_from_report_step(
+                                  view, report_step(block)));
+        test_assert_int_equal(
+            ecl_file_view_get_global_index(view, SEQNUM_KW, block),
+            ecl_file_view_find_kw_value(view, SEQNUM_KW, &seqnum_value));
+
+        test_assert_true(ecl_file_has_sim_time(ecl_file, sim_time(block)));
+        test_assert_int_equal(block, ecl_file_view_seqnum_index_from_sim_time(
+                                         view, sim_time(block)));
+        test_assert_int_equal(block, ecl_file_view_seqnum_index_from_sim_days(
+                                         view, sim_days(block)));
+        test_assert_time_t_equal(
+            sim_time(block), ecl_file_view_iget_restart_sim_date(view, block));
+        test_assert_double_equal(
+            sim_days(block), ecl_file_view_iget_restart_sim_days(view, block));
+    }
+
+    /* The INTEHEAD occurence; with one extra INTEHEAD every fifth block. */
+    test_assert_int_equal(0, ecl_file_get_restart_index(ecl_file, sim_time(0)));
+    test_assert_int_equal(1, ecl_file_get_restart_index(ecl_file, sim_time(1)));
+    test_assert_int_equal(3, ecl_file_get_restart_index(ecl_file, sim_time(2)));
+    test_assert_int_equal(
+        NUM_BLOCKS + NUM_BLOCKS / 5 - 1,
+        ecl_file_get_restart_index(ecl_file, sim_time(NUM_BLOCKS - 1)));
+
+    test_assert_false(ecl_file_has_sim_time(ecl_file, sim_time(NUM_BLOCKS)));
+    test_assert_int_equal(-1, ecl_file_view_seqnum_index_from_sim_days(
+                                  view, sim_days(NUM_BLOCKS)));
+    test_assert_int_equal(-1, ecl_file_view_seqnum_index_from_report_step(
+                                  view, report_step(NUM_BLOCKS)));
+    test_assert_time_t_equal(
+        -1, ecl_file_view_iget_restart_sim_date(view, NUM_BLOCKS));
+
+    /* The index is built without loading any keywords. */
+    assert_none_loaded(ecl_file);
+
+    test_assert_true(ecl_file_select_rstblock_report_step(ecl_file,
+                                                          report_step(17)));
+    assert_block(ecl_file, 17);
+    test_assert_true(ecl_file_has_report_step(ecl_file, report_step(17)));
+    test_assert_false(ecl_file_has_report_step(ecl_file, report_step(18)));
+
+    test_assert_true(
+        ecl_file_select_rstblock_sim_time(ecl_file, sim_time(33)));
+    assert_block(ecl_file, 33);
+    test_assert_true(ecl_file_has_sim_time(ecl_file, sim_time(33)));
+    test_assert_false(ecl_file_has_sim_time(ecl_file, sim_time(17)));
+
+    test_assert_false(ecl_file_select_rstblock_report_step(ecl_file, 2));
+    test_assert_false(
+        ecl_file_select_rstblock_sim_time(ecl_file, sim_time(NUM_BLOCKS)));
+
+    ecl_file_close(ecl_file);
+}
+
+void test_restart_view() {
+    ecl::util::TestArea ta("restart_view");
+    write_file("FILE.UNRST", false);
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+    {
+        ecl_file_view_type *block_view = ecl_file_view_add_restart_view(
+            view, -1, report_step(41), -1, -1);
+        test_assert_not_NULL(block_view);
+        test_assert_true(ecl_file_view_has_report_step(block_view,
+                                                       report_step(41)));
+        test_assert_false(ecl_file_view_has_report_step(block_view,
+                                                        report_step(40)));
+        test_assert_true(ecl_file_view_has_sim_time(block_view, sim_time(41)));
+    }
+    {
+        ecl_file_view_type *block_view =
+            ecl_file_view_add_restart_view(view, -1, -1, sim_time(12), -1);
+        test_assert_not_NULL(block_view);
+        test_assert_true(ecl_file_view_has_report_step(block_view,
+                                                       report_step(12)));
+    }
+    {
+        ecl_file_view_type *block_view =
+            ecl_file_view_add_restart_view(view, -1, -1, -1, sim_days(7));
+        test_assert_not_NULL(block_view);
+        test_assert_true(ecl_file_view_has_sim_days(block_view, sim_days(7)));
+    }
+    test_assert_NULL(
+        ecl_file_view_add_restart_view(view, -1, report_step(0) + 1, -1, -1));
+    ecl_file_close(ecl_file);
+}
+
+static void read_pressure(const ecl_file_type *ecl_file, bool *read_ok) {
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        double value;
+        if (!ecl_file_fread_named_kw_as_double(ecl_file, "PRESSURE", block,
+                                               block % 100, 1, &value) ||
+            value != block)
+            *read_ok = false;
+    }
+}
+
+/*
+  The restart index is built, reading through the shared stream, while
+  other threads read from the same file.
+*/
+void test_concurrent(int flags) {
+    ecl::util::TestArea ta("restart_index_concurrent");
+    write_file("FILE.UNRST", false);
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", flags);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+    bool read_ok[2] = {true, true};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 2; t++)
+        threads.emplace_back(read_pressure, ecl_file, &read_ok[t]);
+    for (int block = 0; block < NUM_BLOCKS; block++)
+        test_assert_int_equal(block,
+                              ecl_file_view_seqnum_index_from_report_step(
+                                  view, report_step(block)));
+    for (auto &thread : threads)
+        thread.join();
+
+    test_assert_true(read_ok[0]);
+    test_assert_true(read_ok[1]);
+    ecl_file_close(ecl_file);
+}
+
+int main(int argc, char **argv) {
+    test_lookup("FILE.UNRST", false);
+    test_lookup("FILE.FUNRST", true);
+    test_restart_view();
+    test_concurrent(0);
+    test_concurrent(ECL_FILE_CLOSE_STREAM);
+    exit(0);
+}
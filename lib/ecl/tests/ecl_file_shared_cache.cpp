@@ -0,0 +1,224 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 1000
+
+static void write_file(const char *filename) {
+    fortio_type *fortio = fortio_open_writer(filename, false, ECL_ENDIAN_FLIP);
+    {
+        ecl_kw_type *kw = ecl_kw_alloc("PORV", SIZE, ECL_FLOAT);
+        for (int i = 0; i < SIZE; i++)
+            ecl_kw_iset_float(kw, i, i * 0.25);
+        ecl_kw_fwrite(kw, fortio);
+        ecl_kw_free(kw);
+    }
+    {
+        ecl_kw_type *kw = ecl_kw_alloc("ACTNUM", SIZE, ECL_INT);
+        ecl_kw_scalar_set_int(kw, 1);
+        ecl_kw_fwrite(kw, fortio);
+        ecl_kw_free(kw);
+    }
+    fortio_fclose(fortio);
+}
+
+void test_cow_copy() {
+    ecl_kw_type *src = ecl_kw_alloc("PORV", SIZE, ECL_FLOAT);
+    ecl_kw_scalar_set_float(src, 1.5);
+    test_assert_false(ecl_kw_is_cow_shared(src));
+    {
+        ecl_kw_type *copy1 = ecl_kw_alloc_cow_copy(src);
+        ecl_kw_type *copy2 = ecl_kw_alloc_cow_copy(src);
+
+        test_assert_true(ecl_kw_equal(src, copy1));
+        test_assert_true(ecl_kw_is_cow_shared(src));
+        test_assert_ptr_equal(ecl_kw_get_const_ptr(src),
+                              ecl_kw_get_const_ptr(copy1));
+
+        ecl_kw_iset_float(copy1, 0, 99);
+        test_assert_float_equal(99, ecl_kw_iget_float(copy1, 0));
+        test_assert_float_equal(1.5, ecl_kw_iget_float(src, 0));
+        test_assert_float_equal(1.5, ecl_kw_iget_float(copy2, 0));
+        test_assert_ptr_not_equal(ecl_kw_get_const_ptr(src),
+                                  ecl_kw_get_const_ptr(copy1));
+        test_assert_false(ecl_kw_is_cow_shared(copy1));
+
+        ecl_kw_free(src);
+        test_assert_false(ecl_kw_is_cow_shared(copy2));
+        test_assert_float_equal(1.5, ecl_kw_iget_float(copy2, SIZE - 1));
+
+        /* The last owner takes over the data without copying. */
+        {
+            const void *data = ecl_kw_get_const_ptr(copy2);
+            test_assert_ptr_equal(data, ecl_kw_get_ptr(copy2));
+        }
+        ecl_kw_free(copy1);
+        ecl_kw_free(copy2);
+    }
+}
+
+void test_shared_files() {
+    ecl::util::TestArea ta("shared_cache");
+    write_file("CASE.INIT");
+
+    ecl_file_set_shared_cache(true);
+    test_assert_true(ecl_file_get_shared_cache());
+    {
+        ecl_file_type *file1 = ecl_file_open("CASE.INIT", 0);
+        ecl_file_type *file2 = ecl_file_open("CASE.INIT", 0);
+        ecl_kw_type *porv1 = ecl_file_iget_named_kw(file1, "PORV", 0);
+        ecl_kw_type *porv2 = ecl_file_iget_named_kw(file2, "PORV", 0);
+
+        test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+        test_assert_ptr_not_equal(porv1, porv2);
+        test_assert_ptr_equal(ecl_kw_get_const_float_ptr(porv1),
+                              ecl_kw_get_const_float_ptr(porv2));
+        test_assert_true(ecl_kw_is_cow_shared(porv1));
+        test_assert_size_t_equal(1, ecl_file_get_kw_misses(file2));
+
+        ecl_kw_iset_float(porv1, 10, -1);
+        test_assert_float_equal(-1, ecl_kw_iget_float(porv1, 10));
+        test_assert_float_equal(2.5, ecl_kw_iget_float(porv2, 10));
+        {
+            ecl_file_type *file3 = ecl_file_open("CASE.INIT", 0);
+            ecl_kw_type *porv3 = ecl_file_iget_named_kw(file3, "PORV", 0);
+            test_assert_float_equal(2.5, ecl_kw_iget_float(porv3, 10));
+            test_assert_ptr_equal(ecl_kw_get_const_float_ptr(porv2),
+                                  ecl_kw_get_const_float_ptr(porv3));
+            ecl_file_close(file3);
+        }
+
+        ecl_file_iget_named_kw(file2, "ACTNUM", 0);
+        test_assert_int_equal(2, ecl_file_get_shared_cache_size());
+
+        ecl_file_close(file1);
+        test_assert_int_equal(2, ecl_file_get_shared_cache_size());
+
+        /* Writable files do not take part in the cache, and opening one
+           drops the keywords of the file from the cache. */
+        {
+            ecl_file_type *file4 =
+                ecl_file_open("CASE.INIT", ECL_FILE_WRITABLE);
+            ecl_kw_type *porv4 = ecl_file_iget_named_kw(file4, "PORV", 0);
+            test_assert_false(ecl_kw_is_cow_shared(porv4));
+            test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+            ecl_file_close(file4);
+        }
+        test_assert_float_equal(2.5, ecl_kw_iget_float(porv2, 10));
+        ecl_file_close(file2);
+        test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+    }
+
+    ecl_file_set_shared_cache(false);
+    {
+        ecl_file_type *file1 = ecl_file_open("CASE.INIT", 0);
+        ecl_file_type *file2 = ecl_file_open("CASE.INIT", 0);
+        ecl_kw_type *porv1 = ecl_file_iget_named_kw(file1, "PORV", 0);
+        ecl_kw_type *porv2 = ecl_file_iget_named_kw(file2, "PORV", 0);
+
+        test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+        test_assert_false(ecl_kw_is_cow_shared(porv1));
+        test_assert_ptr_not_equal(ecl_kw_get_const_float_ptr(porv1),
+                                  ecl_kw_get_const_float_ptr(porv2));
+        ecl_file_close(file1);
+        ecl_file_close(file2);
+    }
+}
+
+/*
+  Evicting a keyword must release the cached keyword as well when no
+  other file shares it; otherwise the memory budget frees nothing.
+*/
+void test_shared_budget() {
+    ecl::util::TestArea ta("shared_budget");
+    write_file("CASE.INIT");
+
+    ecl_file_set_shared_cache(true);
+    {
+        ecl_file_type *file1 = ecl_file_open("CASE.INIT", 0);
+        ecl_file_type *file2 = ecl_file_open("CASE.INIT", 0);
+        ecl_file_set_memory_budget(file1, 1);
+
+        ecl_file_iget_named_kw(file1, "PORV", 0);
+        ecl_file_iget_named_kw(file1, "ACTNUM", 0);
+        test_assert_size_t_equal(1, ecl_file_get_kw_evictions(file1));
+        test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+
+        /* A keyword still loaded by another file stays in the cache. */
+        ecl_file_iget_named_kw(file2, "PORV", 0);
+        test_assert_int_equal(2, ecl_file_get_shared_cache_size());
+        {
+            ecl_kw_type *porv1 = ecl_file_iget_named_kw(file1, "PORV", 0);
+            ecl_kw_type *porv2 = ecl_file_iget_named_kw(file2, "PORV", 0);
+            test_assert_size_t_equal(2, ecl_file_get_kw_evictions(file1));
+            test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+            test_assert_ptr_equal(ecl_kw_get_const_float_ptr(porv1),
+                                  ecl_kw_get_const_float_ptr(porv2));
+            test_assert_float_equal(2.5, ecl_kw_iget_float(porv1, 10));
+        }
+
+        ecl_file_close(file2);
+        test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+        ecl_file_close(file1);
+        test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+    }
+    ecl_file_set_shared_cache(false);
+}
+
+/*
+  Opening a file for writing and saving keywords to it drop the
+  keywords of the file from the cache, so a file which is modified
+  within the resolution of the modification time is not served from
+  the cache.
+*/
+void test_shared_writable() {
+    ecl::util::TestArea ta("shared_writable");
+    write_file("CASE.INIT");
+
+    ecl_file_set_shared_cache(true);
+    {
+        ecl_file_type *reader = ecl_file_open("CASE.INIT", 0);
+        const ecl_kw_type *porv = ecl_file_iget_named_kw(reader, "PORV", 0);
+        test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+
+        ecl_file_type *writer = ecl_file_open("CASE.INIT", ECL_FILE_WRITABLE);
+        test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+        test_assert_float_equal(2.5, ecl_kw_iget_float(porv, 10));
+        ecl_file_close(reader);
+
+        reader = ecl_file_open("CASE.INIT", 0);
+        ecl_file_iget_named_kw(reader, "PORV", 0);
+        test_assert_int_equal(1, ecl_file_get_shared_cache_size());
+        {
+            ecl_kw_type *new_porv = ecl_file_iget_named_kw(writer, "PORV", 0);
+            ecl_kw_iset_float(new_porv, 10, -1);
+            test_assert_true(ecl_file_save_kw(writer, new_porv));
+        }
+        test_assert_int_equal(0, ecl_file_get_shared_cache_size());
+        {
+            ecl_file_type *reader2 = ecl_file_open("CASE.INIT", 0);
+            porv = ecl_file_iget_named_kw(reader2, "PORV", 0);
+            test_assert_float_equal(-1, ecl_kw_iget_float(porv, 10));
+            ecl_file_close(reader2);
+        }
+        ecl_file_close(reader);
+        ecl_file_close(writer);
+    }
+    ecl_file_set_shared_cache(false);
+}
+
+int main(int argc, char **argv) {
+    test_cow_copy();
+    test_shared_files();
+    test_shared_budget();
+    test_shared_writable();
+    exit(0);
+}
@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_file_view.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 5000
+#define NUM_STEPS 3
+#define NUM_KW 5
+
+static const char *kw_names[NUM_KW] = {"PRESSURE", "SWAT", "SGAS", "RS",
+                                       "RV"};
+
+static ecl_kw_type *alloc_kw(const char *name, int step, int size) {
+    ecl_kw_type *kw = ecl_kw_alloc(name, size, ECL_FLOAT);
+    for (int i = 0; i < size; i++)
+        ecl_kw_iset_float(kw, i, step * 100 + name[0] + i * 0.5);
+    return kw;
+}
+
+/*
+  Every report step is followed by a large keyword, which makes the
+  prefetch of each step a separate read.
+*/
+static void write_file(const char *filename, bool fmt_file) {
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (int step = 0; step < NUM_STEPS; step++) {
+        for (int i = 0; i < NUM_KW; i++) {
+            ecl_kw_type *kw = alloc_kw(kw_names[i], step, SIZE);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = alloc_kw("LARGE", step, 100000);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+    }
+    fortio_fclose(fortio);
+}
+
+static bool is_loaded(const ecl_file_type *ecl_file, const char *kw,
+                      int step) {
+    return ecl_file_kw_peek_kw(ecl_file_iget_named_file_kw(
+               ecl_file, kw, step)) != NULL;
+}
+
+static void assert_kw(ecl_file_type *ecl_file, const char *name, int step) {
+    ecl_kw_type *expected = alloc_kw(name, step, SIZE);
+    test_assert_true(ecl_kw_equal(
+        ecl_file_iget_named_kw(ecl_file, name, step), expected));
+    ecl_kw_free(expected);
+}
+
+static stringlist_type *alloc_prefetch_list() {
+    stringlist_type *kw_list = stringlist_alloc_new();
+    stringlist_append_copy(kw_list, "RV");
+    stringlist_append_copy(kw_list, "PRESSURE");
+    stringlist_append_copy(kw_list, "SWAT");
+    stringlist_append_copy(kw_list, "MISSING");
+    stringlist_append_copy(kw_list, "SWAT");
+    return kw_list;
+}
+
+void test_unpack() {
+    ecl::util::TestArea ta("unpack");
+    write_file("FILE.UNRST", false);
+
+    fortio_type *fortio =
+        fortio_open_reader("FILE.UNRST", false, ECL_ENDIAN_FLIP);
+    ecl_kw_type *expected = alloc_kw(kw_names[0], 0, SIZE);
+    size_t size = ecl_kw_fortio_size(expected);
+    char *records = (char *)util_malloc(size);
+
+    test_assert_size_t_equal(size, ecl_kw_fortio_size__(ECL_FLOAT, SIZE));
+    test_assert_true(fortio_pread(fortio, 0, records, size));
+    {
+        ecl_kw_type *kw = ecl_kw_unpack_alloc(fortio, records, size);
+        test_assert_true(ecl_kw_equal(kw, expected));
+        ecl_kw_free(kw);
+    }
+    test_assert_NULL(ecl_kw_unpack_alloc(fortio, records, size - 1));
+    test_assert_NULL(ecl_kw_unpack_alloc(fortio, &records[4], size - 4));
+
+    free(records);
+    ecl_kw_free(expected);
+    fortio_fclose(fortio);
+}
+
+void test_prefetch(const char *filename, bool fmt_file, int flags) {
+    ecl::util::TestArea ta("prefetch");
+    write_file(filename, fmt_file);
+
+    ecl_file_type *ecl_file = ecl_file_open(filename, flags);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+    stringlist_type *kw_list = alloc_prefetch_list();
+
+    test_assert_true(ecl_file_view_prefetch(view, kw_list));
+    for (int step = 0; step < NUM_STEPS; step++) {
+        test_assert_true(is_loaded(ecl_file, "PRESSURE", step));
+        test_assert_true(is_loaded(ecl_file, "SWAT", step));
+        test_assert_true(is_loaded(ecl_file, "RV", step));
+        test_assert_false(is_loaded(ecl_file, "SGAS", step));
+        test_assert_false(is_loaded(ecl_file, "LARGE", step));
+    }
+    test_assert_size_t_equal(0, ecl_file_get_kw_misses(ecl_file));
+
+    for (int step = 0; step < NUM_STEPS; step++)
+        for (int i = 0; i < NUM_KW; i++)
+            assert_kw(ecl_file, kw_names[i], step);
+
+    test_assert_size_t_equal(3 * NUM_STEPS, ecl_file_get_kw_hits(ecl_file));
+    test_assert_size_t_equal(2 * NUM_STEPS, ecl_file_get_kw_misses(ecl_file));
+
+    stringlist_free(kw_list);
+    ecl_file_close(ecl_file);
+}
+
+void test_prefetch_background(const char *filename, bool fmt_file,
+                              int flags) {
+    ecl::util::TestArea ta("prefetch_background");
+    write_file(filename, fmt_file);
+
+    for (int iter = 0; iter < 5; iter++) {
+        ecl_file_type *ecl_file = ecl_file_open(filename, flags);
+        ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+        stringlist_type *kw_list = alloc_prefetch_list();
+        std::vector<ecl_kw_type *> kw_ptr;
+
+        ecl_file_prefetch_type *prefetch =
+            ecl_file_view_start_prefetch(view, kw_list);
+        for (int step = 0; step < NUM_STEPS; step++) {
+            kw_ptr.push_back(ecl_file_iget_named_kw(ecl_file, "SWAT", step));
+            assert_kw(ecl_file, "SWAT", step);
+            assert_kw(ecl_file, "SGAS", step);
+        }
+        test_assert_true(ecl_file_view_end_prefetch(view, prefetch));
+
+        for (int step = 0; step < NUM_STEPS; step++) {
+            test_assert_ptr_equal(
+                kw_ptr[step], ecl_file_iget_named_kw(ecl_file, "SWAT", step));
+            test_assert_true(is_loaded(ecl_file, "PRESSURE", step));
+            test_assert_true(is_loaded(ecl_file, "RV", step));
+            test_assert_false(is_loaded(ecl_file, "RS", step));
+            for (int i = 0; i < NUM_KW; i++)
+                assert_kw(ecl_file, kw_names[i], step);
+        }
+
+        stringlist_free(kw_list);
+        ecl_file_close(ecl_file);
+    }
+}
+
+int main(int argc, char **argv) {
+    test_unpack();
+
+    test_prefetch("FILE.UNRST", false, 0);
+    test_prefetch("FILE.FUNRST", true, 0);
+    test_prefetch("FILE.UNRST", false, ECL_FILE_CLOSE_STREAM);
+    test_prefetch("FILE.UNRST", false, ECL_FILE_MMAP);
+
+    test_prefetch_background("FILE.UNRST", false, 0);
+    test_prefetch_background("FILE.FUNRST", true, 0);
+    test_prefetch_background("FILE.UNRST", false, ECL_FILE_CLOSE_STREAM);
+    test_prefetch_background("FILE.UNRST", false, ECL_FILE_MMAP);
+    exit(0);
+}
@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.hpp>
+
+/* An odd size, so the remainder after the vectorized part is exercised. */
+#define SIZE 1003
+
+static ecl_kw_type *alloc_kw(ecl_data_type data_type, int offset) {
+    ecl_kw_type *kw = ecl_kw_alloc("KW", SIZE, data_type);
+    for (int i = 0; i < SIZE; i++) {
+        int value = 1 + (i + offset) % 17;
+        if (ecl_type_is_float(data_type))
+            ecl_kw_iset_float(kw, i, value * 0.5);
+        else if (ecl_type_is_double(data_type))
+            ecl_kw_iset_double(kw, i, value * 0.25);
+        else
+            ecl_kw_iset_int(kw, i, value);
+    }
+    return kw;
+}
+
+static void assert_values(const ecl_kw_type *kw, const double *expected) {
+    for (int i = 0; i < SIZE; i++)
+        test_assert_double_equal(expected[i], ecl_kw_iget_as_double(kw, i));
+}
+
+void test_binary(ecl_data_type data_type) {
+    ecl_kw_type *a = alloc_kw(data_type, 0);
+    ecl_kw_type *b = alloc_kw(data_type, 5);
+    double expected[SIZE];
+
+    for (int i = 0; i < SIZE; i++)
+        expected[i] = ecl_kw_iget_as_double(a, i);
+
+    ecl_kw_inplace_add(a, b);
+    for (int i = 0; i < SIZE; i++)
+        expected[i] += ecl_kw_iget_as_double(b, i);
+    assert_values(a, expected);
+
+    ecl_kw_inplace_mul(a, b);
+    for (int i = 0; i < SIZE; i++)
+        expected[i] *= ecl_kw_iget_as_double(b, i);
+    assert_values(a, expected);
+
+    ecl_kw_inplace_sub(a, b);
+    for (int i = 0; i < SIZE; i++)
+        expected[i] -= ecl_kw_iget_as_double(b, i);
+    assert_values(a, expected);
+
+    ecl_kw_inplace_add_squared(a, b);
+    for (int i = 0; i < SIZE; i++) {
+        double value = ecl_kw_iget_as_double(b, i);
+        expected[i] += value * value;
+    }
+    assert_values(a, expected);
+
+    /* The target and the source can be the same keyword. */
+    ecl_kw_inplace_add(a, a);
+    for (int i = 0; i < SIZE; i++)
+        expected[i] *= 2;
+    assert_values(a, expected);
+
+    ecl_kw_inplace_div(a, b);
+    for (int i = 0; i < SIZE; i++) {
+        if (ecl_type_is_int(data_type))
+            expected[i] = (int)expected[i] / (int)ecl_kw_iget_as_double(b, i);
+        else
+            expected[i] /= ecl_kw_iget_as_double(b, i);
+    }
+    for (int i = 0; i < SIZE; i++)
+        test_assert_double_equal(expected[i], ecl_kw_iget_as_double(a, i));
+
+    ecl_kw_free(a);
+    ecl_kw_free(b);
+}
+
+void test_scale_shift() {
+    ecl_kw_type *kw = alloc_kw(ECL_FLOAT, 0);
+    double expected[SIZE];
+
+    for (int i = 0; i < SIZE; i++)
+        expected[i] = ecl_kw_iget_as_double(kw, i) * 2 + 0.5;
+
+    ecl_kw_scale_float_or_double(kw, 2);
+    ecl_kw_shift_float_or_double(kw, 0.5);
+    assert_values(kw, expected);
+    ecl_kw_free(kw);
+}
+
+void test_sqrt(ecl_data_type data_type) {
+    ecl_kw_type *kw = alloc_kw(data_type, 0);
+    double expected[SIZE];
+
+    for (int i = 0; i < SIZE; i++) {
+        expected[i] = sqrt(ecl_kw_iget_as_double(kw, i));
+        if (ecl_type_is_int(data_type))
+            expected[i] = round(expected[i]);
+    }
+
+    ecl_kw_inplace_sqrt(kw);
+    assert_values(kw, expected);
+    ecl_kw_free(kw);
+}
+
+void test_add_scaled(ecl_data_type data_type) {
+    ecl_kw_type *a = alloc_kw(data_type, 0);
+    ecl_kw_type *b = alloc_kw(data_type, 3);
+    double expected[SIZE];
+
+    for (int i = 0; i < SIZE; i++)
+        expected[i] =
+            ecl_kw_iget_as_double(a, i) - 0.5 * ecl_kw_iget_as_double(b, i);
+
+    ecl_kw_inplace_add_scaled(a, -0.5, b);
+    assert_values(a, expected);
+
+    ecl_kw_free(a);
+    ecl_kw_free(b);
+}
+
+void test_add_moments(ecl_data_type data_type) {
+    ecl_data_type sum2_type =
+        ecl_type_is_int(data_type) ? ECL_DOUBLE : data_type;
+    ecl_kw_type *sum = ecl_kw_alloc("SUM", SIZE, data_type);
+    ecl_kw_type *sum2 = ecl_kw_alloc("SUM2", SIZE, sum2_type);
+    ecl_kw_type *ref_sum = ecl_kw_alloc("SUM", SIZE, data_type);
+    double expected[SIZE] = {0};
+
+    for (int iens = 0; iens < 10; iens++) {
+        ecl_kw_type *kw = alloc_kw(data_type, iens);
+        ecl_kw_inplace_add_moments(sum, sum2, kw);
+        ecl_kw_inplace_add(ref_sum, kw);
+        for (int i = 0; i < SIZE; i++) {
+            double value = ecl_kw_iget_as_double(kw, i);
+            expected[i] += value * value;
+        }
+        ecl_kw_free(kw);
+    }
+
+    test_assert_true(ecl_kw_equal(sum, ref_sum));
+    assert_values(sum2, expected);
+
+    ecl_kw_free(sum);
+    ecl_kw_free(sum2);
+    ecl_kw_free(ref_sum);
+}
+
+/* The squares of int values are accumulated in double without overflow. */
+void test_add_moments_int_overflow() {
+    ecl_kw_type *sum = ecl_kw_alloc("SUM", SIZE, ECL_INT);
+    ecl_kw_type *sum2 = ecl_kw_alloc("SUM2", SIZE, ECL_DOUBLE);
+    ecl_kw_type *kw = ecl_kw_alloc("KW", SIZE, ECL_INT);
+
+    ecl_kw_scalar_set_int(kw, 100000);
+    for (int iens = 0; iens < 3; iens++)
+        ecl_kw_inplace_add_moments(sum, sum2, kw);
+
+    for (int i = 0; i < SIZE; i++) {
+        test_assert_int_equal(300000, ecl_kw_iget_int(sum, i));
+        test_assert_double_equal(3e10, ecl_kw_iget_double(sum2, i));
+    }
+
+    ecl_kw_free(sum);
+    ecl_kw_free(sum2);
+    ecl_kw_free(kw);
+}
+
+int main(int argc, char **argv) {
+    test_binary(ECL_FLOAT);
+    test_binary(ECL_DOUBLE);
+    test_binary(ECL_INT);
+    test_scale_shift();
+    test_sqrt(ECL_FLOAT);
+    test_sqrt(ECL_DOUBLE);
+    test_sqrt(ECL_INT);
+    test_add_scaled(ECL_FLOAT);
+    test_add_scaled(ECL_DOUBLE);
+    test_add_moments(ECL_FLOAT);
+    test_add_moments(ECL_DOUBLE);
+    test_add_moments(ECL_INT);
+    test_add_moments_int_overflow();
+    exit(0);
+}
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/util_codec.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 10000
+#define NUM_KW 4
+
+static ecl_kw_type *alloc_smooth_kw(const char *name, int offset) {
+    ecl_kw_type *kw = ecl_kw_alloc(name, SIZE, ECL_FLOAT);
+    for (int i = 0; i < SIZE; i++)
+        ecl_kw_iset_float(kw, i, 200.0 + offset + (i / 100));
+    return kw;
+}
+
+void test_compress_kw() {
+    ecl_kw_type *kw = alloc_smooth_kw("PRESSURE", 0);
+    ecl_kw_type *copy = ecl_kw_alloc_copy(kw);
+    size_t byte_size = SIZE * sizeof(float);
+
+    test_assert_false(ecl_kw_is_compressed(kw));
+    test_assert_size_t_equal(byte_size, ecl_kw_get_data_memory_size(kw));
+
+    test_assert_true(ecl_kw_compress(kw, UTIL_CODEC_FAST));
+    test_assert_true(ecl_kw_is_compressed(kw));
+    test_assert_true(ecl_kw_get_data_memory_size(kw) < byte_size / 4);
+    test_assert_int_equal(SIZE, ecl_kw_get_size(kw));
+
+    test_assert_float_equal(ecl_kw_iget_float(kw, SIZE - 1),
+                            ecl_kw_iget_float(copy, SIZE - 1));
+    test_assert_false(ecl_kw_is_compressed(kw));
+    test_assert_true(ecl_kw_equal(kw, copy));
+
+    test_assert_true(ecl_kw_compress(kw, UTIL_CODEC_FAST));
+    ecl_kw_iset_float(kw, 0, 0);
+    test_assert_false(ecl_kw_is_compressed(kw));
+    test_assert_float_equal(0, ecl_kw_iget_float(kw, 0));
+
+    ecl_kw_free(copy);
+    ecl_kw_free(kw);
+}
+
+/*
+  A floating point field with noise in the low bits; the run length
+  encoding saves little on such data, and it is compressed with zlib
+  when that is available.
+*/
+void test_compress_noisy_float() {
+    ecl_kw_type *kw = ecl_kw_alloc("PRESSURE", SIZE, ECL_FLOAT);
+    size_t byte_size = SIZE * sizeof(float);
+    for (int i = 0; i < SIZE; i++)
+        ecl_kw_iset_float(kw, i,
+                          250 + 10 * sin(i * 0.01) +
+                              ((i * 2654435761u) % 1000) * 0.001);
+
+    {
+        ecl_kw_type *copy = ecl_kw_alloc_copy(kw);
+        char *buffer = (char *)util_malloc(byte_size);
+        size_t rle_size =
+            util_codec_compress(UTIL_CODEC_FAST, sizeof(float),
+                                ecl_kw_get_const_ptr(kw), byte_size, buffer,
+                                byte_size);
+        double rle_ratio = (double)rle_size / byte_size;
+
+        test_assert_true(rle_ratio > 0.6);
+        test_assert_true(ecl_kw_compress(kw, UTIL_CODEC_FAST));
+        if (util_codec_supported(UTIL_CODEC_ZLIB)) {
+            double ratio = (double)ecl_kw_get_data_memory_size(kw) / byte_size;
+            test_assert_true(ratio < 0.6);
+            test_assert_true(ratio < rle_ratio - 0.05);
+        }
+        test_assert_true(ecl_kw_equal(kw, copy));
+
+        free(buffer);
+        ecl_kw_free(copy);
+    }
+    ecl_kw_free(kw);
+}
+
+void test_compress_shared() {
+    float data[SIZE] = {0};
+    ecl_kw_type *kw = ecl_kw_alloc_new_shared("SHARED", SIZE, ECL_FLOAT, data);
+    test_assert_false(ecl_kw_compress(kw, UTIL_CODEC_FAST));
+    test_assert_false(ecl_kw_is_compressed(kw));
+    ecl_kw_free(kw);
+}
+
+void test_compress_file() {
+    ecl::util::TestArea ta("compress_file");
+    ecl_kw_type *kw_list[NUM_KW];
+    {
+        fortio_type *fortio =
+            fortio_open_writer("FILE.UNRST", false, ECL_ENDIAN_FLIP);
+        for (int i = 0; i < NUM_KW; i++) {
+            kw_list[i] = alloc_smooth_kw("PRESSURE", i);
+            ecl_kw_fwrite(kw_list[i], fortio);
+        }
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+        ecl_file_set_kw_compression(ecl_file, UTIL_CODEC_FAST,
+                                    2 * SIZE * sizeof(float));
+
+        ecl_kw_type *file_kw[NUM_KW];
+        for (int i = 0; i < NUM_KW; i++) {
+            file_kw[i] = ecl_file_iget_named_kw(ecl_file, "PRESSURE", i);
+            test_assert_true(ecl_kw_equal(file_kw[i], kw_list[i]));
+        }
+
+        /* Only the two most recently accessed keywords are kept hot. */
+        test_assert_true(ecl_kw_is_compressed(file_kw[0]));
+        test_assert_true(ecl_kw_is_compressed(file_kw[1]));
+        test_assert_false(ecl_kw_is_compressed(file_kw[2]));
+        test_assert_false(ecl_kw_is_compressed(file_kw[3]));
+
+        test_assert_true(ecl_kw_equal(file_kw[0], kw_list[0]));
+        test_assert_true(ecl_kw_equal(
+            ecl_file_iget_named_kw(ecl_file, "PRESSURE", 1), kw_list[1]));
+        test_assert_true(ecl_kw_is_compressed(file_kw[2]));
+
+        /* Keywords which have been accessed twice are held by the caller,
+           and are not compressed again. */
+        ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+        ecl_file_iget_named_kw(ecl_file, "PRESSURE", 2);
+        test_assert_false(ecl_kw_is_compressed(file_kw[0]));
+        test_assert_false(ecl_kw_is_compressed(file_kw[1]));
+        test_assert_false(ecl_kw_is_compressed(file_kw[2]));
+        test_assert_true(ecl_kw_is_compressed(file_kw[3]));
+        ecl_file_close(ecl_file);
+    }
+    for (int i = 0; i < NUM_KW; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+int main(int argc, char **argv) {
+    test_compress_kw();
+    test_compress_noisy_float();
+    test_compress_shared();
+    test_compress_file();
+    exit(0);
+}
@@ -0,0 +1,458 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <locale.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/rng.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/fortio.h>
+
+static ecl_kw_type *read_fmt_kw(const char *filename) {
+    fortio_type *fortio = fortio_open_reader(filename, true, false);
+    ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+    test_assert_true(ecl_kw_is_instance(kw));
+    fortio_fclose(fortio);
+    return kw;
+}
+
+static void write_text(const char *filename, const char *text) {
+    FILE *stream = util_fopen(filename, "w");
+    fprintf(stream, "%s", text);
+    fclose(stream);
+}
+
+/*
+  Formatted files from other simulators need not follow the exact
+  column layout written by ecl_kw_fwrite().
+*/
+void test_read_foreign_layout() {
+    ecl::util::TestArea ta("fmt_foreign");
+    write_text("DOUBLE.FINIT", " 'DOUBLE  '           6 'DOUB'\n"
+                               "  0.10000000000000D+01 -0.25D-01\n"
+                               "\t1.5E2 +3 0.12345-105 -2.5d+300\n");
+    {
+        ecl_kw_type *kw = read_fmt_kw("DOUBLE.FINIT");
+        test_assert_int_equal(6, ecl_kw_get_size(kw));
+        test_assert_double_equal(1.0, ecl_kw_iget_double(kw, 0));
+        test_assert_double_equal(-0.025, ecl_kw_iget_double(kw, 1));
+        test_assert_double_equal(150, ecl_kw_iget_double(kw, 2));
+        test_assert_double_equal(3, ecl_kw_iget_double(kw, 3));
+        test_assert_double_equal(0.12345e-105, ecl_kw_iget_double(kw, 4));
+        test_assert_double_equal(-2.5e300, ecl_kw_iget_double(kw, 5));
+        ecl_kw_free(kw);
+    }
+
+    write_text("MIXED.FINIT", " 'INTS    '           3 'INTE'\n"
+                              " 1\n -20 +300\n"
+                              " 'LOGI    '           3 'LOGI'\n"
+                              "  T  F\n  T\n"
+                              " 'NAMES   '           2 'CHAR'\n"
+                              " 'A       ' 'B C     '\n");
+    {
+        fortio_type *fortio = fortio_open_reader("MIXED.FINIT", true, false);
+        ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+        test_assert_int_equal(1, ecl_kw_iget_int(kw, 0));
+        test_assert_int_equal(-20, ecl_kw_iget_int(kw, 1));
+        test_assert_int_equal(300, ecl_kw_iget_int(kw, 2));
+        ecl_kw_free(kw);
+
+        kw = ecl_kw_fread_alloc(fortio);
+        test_assert_true(ecl_kw_iget_bool(kw, 0));
+        test_assert_false(ecl_kw_iget_bool(kw, 1));
+        test_assert_true(ecl_kw_iget_bool(kw, 2));
+        ecl_kw_free(kw);
+
+        kw = ecl_kw_fread_alloc(fortio);
+        test_assert_string_equal("A       ", ecl_kw_iget_char_ptr(kw, 0));
+        test_assert_string_equal("B C     ", ecl_kw_iget_char_ptr(kw, 1));
+        ecl_kw_free(kw);
+
+        test_assert_NULL(ecl_kw_fread_alloc(fortio));
+        fortio_fclose(fortio);
+    }
+}
+
+/*
+  Float values are rounded once, directly from the decimal number. The
+  first value is just above the midpoint between 1 and the next float,
+  but rounds to the midpoint as a double.
+*/
+void test_read_float() {
+    ecl::util::TestArea ta("fmt_float");
+    write_text("FLOAT.FINIT", " 'FLOAT   '           5 'REAL'\n"
+                              "  1.0000000596046448 -0.25D-01\n"
+                              "  0.12345678-05 1.5E2 3\n");
+    {
+        ecl_kw_type *kw = read_fmt_kw("FLOAT.FINIT");
+        test_assert_true(ecl_kw_iget_float(kw, 0) == nextafterf(1.0f, 2.0f));
+        test_assert_true(ecl_kw_iget_float(kw, 1) == -0.025f);
+        test_assert_true(ecl_kw_iget_float(kw, 2) == 0.12345678e-5f);
+        test_assert_true(ecl_kw_iget_float(kw, 3) == 150.0f);
+        test_assert_true(ecl_kw_iget_float(kw, 4) == 3.0f);
+        ecl_kw_free(kw);
+    }
+}
+
+/*
+  Double values which need more than the 15-16 significant digits of a
+  double are rounded correctly, and values out of range become
+  infinite or zero.
+*/
+void test_read_rounding() {
+    ecl::util::TestArea ta("fmt_rounding");
+    write_text("ROUND.FINIT",
+               " 'DOUBLE  '           5 'DOUB'\n"
+               "  0.1000000000000000055511151231257827021181583404541015625\n"
+               "  2.2250738585072011D-308 0.17976931348623157D+309\n"
+               "  0.1D+400 -0.1-400\n"
+               " 'FLOAT   '           3 'REAL'\n"
+               "  0.1E+40 -0.1E-50 0.3402823466E+39\n");
+    {
+        fortio_type *fortio = fortio_open_reader("ROUND.FINIT", true, false);
+        ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+        test_assert_true(ecl_kw_iget_double(kw, 0) == 0.1);
+        test_assert_true(ecl_kw_iget_double(kw, 1) == 2.2250738585072011e-308);
+        test_assert_true(ecl_kw_iget_double(kw, 2) == DBL_MAX);
+        test_assert_true(isinf(ecl_kw_iget_double(kw, 3)));
+        test_assert_true(ecl_kw_iget_double(kw, 4) == 0);
+        test_assert_true(signbit(ecl_kw_iget_double(kw, 4)));
+        ecl_kw_free(kw);
+
+        kw = ecl_kw_fread_alloc(fortio);
+        test_assert_true(isinf(ecl_kw_iget_float(kw, 0)));
+        test_assert_true(ecl_kw_iget_float(kw, 1) == 0);
+        test_assert_true(ecl_kw_iget_float(kw, 2) == FLT_MAX);
+        ecl_kw_free(kw);
+        fortio_fclose(fortio);
+    }
+}
+
+static void read_fmt_kw_abort(void *arg) {
+    read_fmt_kw((const char *)arg);
+}
+
+/* Integers which do not fit in an int can not be read. */
+void test_read_int_range() {
+    ecl::util::TestArea ta("fmt_int_range");
+    write_text("LIMITS.FINIT", " 'INTS    '           2 'INTE'\n"
+                               " -2147483648 2147483647\n");
+    {
+        ecl_kw_type *kw = read_fmt_kw("LIMITS.FINIT");
+        test_assert_int_equal(INT_MIN, ecl_kw_iget_int(kw, 0));
+        test_assert_int_equal(INT_MAX, ecl_kw_iget_int(kw, 1));
+        ecl_kw_free(kw);
+    }
+
+    write_text("LARGE.FINIT", " 'INTS    '           2 'INTE'\n"
+                              " 1 2147483648\n");
+    test_assert_util_abort("ecl_kw_fread_fmt_data", read_fmt_kw_abort,
+                           (void *)"LARGE.FINIT");
+
+    write_text("SMALL.FINIT", " 'INTS    '           2 'INTE'\n"
+                              " -2147483649 1\n");
+    test_assert_util_abort("ecl_kw_fread_fmt_data", read_fmt_kw_abort,
+                           (void *)"SMALL.FINIT");
+}
+
+/*
+  The keywords are larger than the buffer used by the formatted reader,
+  and the keywords following them must be positioned correctly.
+*/
+void test_read_large() {
+    ecl::util::TestArea ta("fmt_large");
+    const int size = 100003;
+    ecl_kw_type *kw_list[4];
+
+    kw_list[0] = ecl_kw_alloc("FLOAT", size, ECL_FLOAT);
+    kw_list[1] = ecl_kw_alloc("DOUBLE", size, ECL_DOUBLE);
+    kw_list[2] = ecl_kw_alloc("INT", size, ECL_INT);
+    kw_list[3] = ecl_kw_alloc("STRING", 1000, ECL_STRING(20));
+    for (int i = 0; i < size; i++) {
+        ecl_kw_iset_float(kw_list[0], i, (i - 5000) * 0.125f);
+        ecl_kw_iset_double(kw_list[1], i, (i - 5000) * 0.0078125);
+        ecl_kw_iset_int(kw_list[2], i, size - 2 * i);
+    }
+    for (int i = 0; i < 1000; i++) {
+        char *s = util_alloc_sprintf("STRING:%d", i);
+        ecl_kw_iset_string_ptr(kw_list[3], i, s);
+        free(s);
+    }
+
+    {
+        fortio_type *fortio = fortio_open_writer("LARGE.FINIT", true, false);
+        for (int i = 0; i < 4; i++)
+            ecl_kw_fwrite(kw_list[i], fortio);
+        fortio_fclose(fortio);
+    }
+
+    {
+        fortio_type *fortio = fortio_open_reader("LARGE.FINIT", true, false);
+        for (int i = 0; i < 4; i++) {
+            ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+            test_assert_true(ecl_kw_equal(kw, kw_list[i]));
+            ecl_kw_free(kw);
+        }
+        test_assert_NULL(ecl_kw_fread_alloc(fortio));
+        fortio_fclose(fortio);
+    }
+
+    for (int i = 0; i < 4; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+/*
+  Skipping formatted data only scans the tokens, without converting the
+  numbers; the following keyword must still be positioned correctly.
+*/
+void test_skip() {
+    ecl::util::TestArea ta("fmt_skip");
+    write_text("SKIP.FINIT", " 'DOUBLE  '           4 'DOUB'\n"
+                             "  0.10000000000000D+01 -0.25D-01\n"
+                             "\t1.5E2 +3\n"
+                             " 'NAMES   '           2 'CHAR'\n"
+                             " 'A       ' 'B C     '\n"
+                             " 'LOGI    '           3 'LOGI'\n"
+                             "  T  F\n  T\n"
+                             " 'LAST    '           2 'INTE'\n"
+                             " 7 -8\n");
+    {
+        fortio_type *fortio = fortio_open_reader("SKIP.FINIT", true, false);
+        for (int i = 0; i < 3; i++)
+            ecl_kw_fskip(fortio);
+        {
+            ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+            test_assert_true(ecl_kw_name_equal(kw, "LAST"));
+            test_assert_int_equal(7, ecl_kw_iget_int(kw, 0));
+            test_assert_int_equal(-8, ecl_kw_iget_int(kw, 1));
+            ecl_kw_free(kw);
+        }
+        fortio_fclose(fortio);
+    }
+
+    {
+        const int size = 100003;
+        ecl_kw_type *large_kw = ecl_kw_alloc("LARGE", size, ECL_FLOAT);
+        ecl_kw_type *last_kw = ecl_kw_alloc("LAST", 10, ECL_INT);
+        ecl_kw_scalar_set_float(large_kw, -1.25);
+        ecl_kw_scalar_set_int(last_kw, 3);
+        {
+            fortio_type *fortio =
+                fortio_open_writer("LARGE.FINIT", true, false);
+            ecl_kw_fwrite(large_kw, fortio);
+            ecl_kw_fwrite(last_kw, fortio);
+            fortio_fclose(fortio);
+        }
+        {
+            fortio_type *fortio =
+                fortio_open_reader("LARGE.FINIT", true, false);
+            ecl_kw_fskip(fortio);
+            {
+                ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+                test_assert_true(ecl_kw_equal(kw, last_kw));
+                ecl_kw_free(kw);
+            }
+            fortio_fclose(fortio);
+        }
+        ecl_kw_free(large_kw);
+        ecl_kw_free(last_kw);
+    }
+
+    write_text("SHORT.FINIT", " 'DOUBLE  '           6 'DOUB'\n"
+                              "  1.0 2.0 3.0\n");
+    {
+        fortio_type *fortio = fortio_open_reader("SHORT.FINIT", true, false);
+        ecl_kw_type *kw = ecl_kw_alloc_empty();
+        test_assert_int_equal(ECL_KW_READ_OK, ecl_kw_fread_header(kw, fortio));
+        test_assert_false(ecl_kw_fskip_data(kw, fortio));
+        ecl_kw_free(kw);
+        fortio_fclose(fortio);
+    }
+}
+
+/*
+  Reference implementation of the formatted writer, with one fprintf()
+  call per element.
+*/
+static void fprintf_scientific(FILE *stream, const char *fmt, double x) {
+    double pow_x = ceil(log10(fabs(x)));
+    double arg_x = x / pow(10.0, pow_x);
+    if (x != 0.0) {
+        if (fabs(arg_x) == 1.0) {
+            arg_x *= 0.10;
+            pow_x += 1;
+        }
+    } else {
+        arg_x = 0.0;
+        pow_x = 0.0;
+    }
+    fprintf(stream, fmt, arg_x, (int)pow_x);
+}
+
+static void fwrite_reference(const ecl_kw_type *kw, FILE *stream) {
+    ecl_data_type data_type = ecl_kw_get_data_type(kw);
+    int size = ecl_kw_get_size(kw);
+    int blocksize = ecl_type_is_alpha(data_type) ? 105 : 1000;
+    int columns;
+
+    fprintf(stream, " '%-8s' %11d '%-4s'\n", ecl_kw_get_header8(kw), size,
+            ecl_type_alloc_name(data_type));
+    switch (ecl_kw_get_type(kw)) {
+    case (ECL_INT_TYPE):
+        columns = 6;
+        break;
+    case (ECL_FLOAT_TYPE):
+        columns = 4;
+        break;
+    case (ECL_DOUBLE_TYPE):
+        columns = 3;
+        break;
+    case (ECL_BOOL_TYPE):
+        columns = 25;
+        break;
+    default:
+        columns = 7;
+    }
+
+    for (int block_start = 0; block_start < size; block_start += blocksize) {
+        int block_end = util_int_min(block_start + blocksize, size);
+        for (int i = block_start; i < block_end; i++) {
+            switch (ecl_kw_get_type(kw)) {
+            case (ECL_INT_TYPE):
+                fprintf(stream, " %11d", ecl_kw_iget_int(kw, i));
+                break;
+            case (ECL_FLOAT_TYPE):
+                fprintf_scientific(stream, "  %11.8fE%+03d",
+                                   ecl_kw_iget_float(kw, i));
+                break;
+            case (ECL_DOUBLE_TYPE):
+                fprintf_scientific(stream, "  %17.14fD%+03d",
+                                   ecl_kw_iget_double(kw, i));
+                break;
+            case (ECL_BOOL_TYPE):
+                fprintf(stream, "  %c", ecl_kw_iget_bool(kw, i) ? 'T' : 'F');
+                break;
+            case (ECL_CHAR_TYPE):
+                fprintf(stream, " '%-8s'", ecl_kw_iget_char_ptr(kw, i));
+                break;
+            default:
+                fprintf(stream, " '%-*s'",
+                        ecl_type_get_sizeof_iotype(data_type),
+                        ecl_kw_iget_string_ptr(kw, i));
+            }
+            if ((i - block_start) % columns == columns - 1 ||
+                i == block_end - 1)
+                fprintf(stream, "\n");
+        }
+    }
+}
+
+static void test_fwrite_identical(const ecl_kw_type *kw) {
+    fortio_type *fortio = fortio_open_writer("FAST.FINIT", true, false);
+    FILE *stream = util_fopen("REFERENCE.FINIT", "w");
+
+    ecl_kw_fwrite(kw, fortio);
+    fortio_fclose(fortio);
+    fwrite_reference(kw, stream);
+    fclose(stream);
+
+    test_assert_true(util_files_equal("FAST.FINIT", "REFERENCE.FINIT"));
+    {
+        ecl_kw_type *kw2 = read_fmt_kw("FAST.FINIT");
+        test_assert_true(ecl_kw_numeric_equal(kw, kw2, 0, 1e-7));
+        ecl_kw_free(kw2);
+    }
+}
+
+/*
+  The output of ecl_kw_fwrite() for formatted files must be identical to
+  the output of the reference implementation.
+*/
+void test_fwrite() {
+    ecl::util::TestArea ta("fmt_fwrite");
+    const float special[] = {0,        -0.0f,     1,       -1,       10,
+                             1000,     0.1f,      0.5e-8f, 1e-30f,   FLT_MAX,
+                             -FLT_MAX, FLT_MIN,   1e-45f,  99.99999f,
+                             0.999999999f, 123456789.0f, 0.125f, -7.5e12f};
+    const int num_special = sizeof special / sizeof special[0];
+    const int size = 20000;
+    rng_type *rng = rng_alloc(MZRAN, INIT_DEFAULT);
+    ecl_kw_type *float_kw = ecl_kw_alloc("FLOAT", size, ECL_FLOAT);
+    ecl_kw_type *double_kw = ecl_kw_alloc("DOUBLE", size, ECL_DOUBLE);
+    ecl_kw_type *int_kw = ecl_kw_alloc("INT", size, ECL_INT);
+    ecl_kw_type *bool_kw = ecl_kw_alloc("BOOL", size, ECL_BOOL);
+    ecl_kw_type *char_kw = ecl_kw_alloc("CHAR", 250, ECL_CHAR);
+    ecl_kw_type *string_kw = ecl_kw_alloc("STRING", 250, ECL_STRING(12));
+
+    for (int i = 0; i < size; i++) {
+        double mantissa = 2 * rng_get_double(rng) - 1;
+        int exponent = rng_get_int(rng, 70) - 35;
+        double value = mantissa * pow(10, exponent);
+        if (i < num_special)
+            value = special[i];
+        ecl_kw_iset_float(float_kw, i, value);
+
+        exponent = rng_get_int(rng, 600) - 300;
+        value = mantissa * pow(10, exponent);
+        if (i < num_special)
+            value = special[i];
+        else if (i < 2 * num_special)
+            value = 0.5 * pow(10, i - num_special - 14);
+        ecl_kw_iset_double(double_kw, i, value);
+
+        ecl_kw_iset_int(int_kw, i, rng_forward(rng) - INT_MAX / 2);
+        ecl_kw_iset_bool(bool_kw, i, (i % 3) == 0);
+    }
+    ecl_kw_iset_int(int_kw, 0, INT_MIN);
+    ecl_kw_iset_int(int_kw, 1, INT_MAX);
+    ecl_kw_iset_int(int_kw, 2, 0);
+    for (int i = 0; i < 250; i++) {
+        char *s = util_alloc_sprintf("S%d", i * i * i);
+        ecl_kw_iset_string8(char_kw, i, s);
+        ecl_kw_iset_string_ptr(string_kw, i, s);
+        free(s);
+    }
+
+    test_fwrite_identical(float_kw);
+    test_fwrite_identical(double_kw);
+    test_fwrite_identical(int_kw);
+    test_fwrite_identical(bool_kw);
+    test_fwrite_identical(char_kw);
+    test_fwrite_identical(string_kw);
+
+    ecl_kw_free(float_kw);
+    ecl_kw_free(double_kw);
+    ecl_kw_free(int_kw);
+    ecl_kw_free(bool_kw);
+    ecl_kw_free(char_kw);
+    ecl_kw_free(string_kw);
+    rng_free(rng);
+}
+
+/* The parsing of numbers must not depend on the decimal separator of the
+   current locale. */
+void test_read_locale() {
+    if (setlocale(LC_NUMERIC, "de_DE.UTF-8") != NULL) {
+        test_read_foreign_layout();
+        test_read_float();
+        test_read_rounding();
+        setlocale(LC_NUMERIC, "C");
+    }
+}
+
+int main(int argc, char **argv) {
+    test_read_foreign_layout();
+    test_read_float();
+    test_read_rounding();
+    test_read_int_range();
+    test_read_large();
+    test_skip();
+    test_read_locale();
+    test_fwrite();
+    exit(0);
+}
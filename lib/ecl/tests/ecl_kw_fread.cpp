@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <ert/util/test_util.hpp>
 #include <ert/util/util.h>
@@ -104,8 +105,166 @@ void test_kw_io_charlength() {
     }
 }
 
+void test_fread_indexed() {
+    ecl::util::TestArea ta("fread_indexed");
+    const int size = 2500;
+    ecl_kw_type *kw = ecl_kw_alloc("FLOAT", size, ECL_FLOAT);
+    for (int i = 0; i < size; i++)
+        ecl_kw_iset_float(kw, i, i * 0.5);
+
+    {
+        fortio_type *fortio = fortio_open_writer("FILE", false, true);
+        ecl_kw_fwrite(kw, fortio);
+        ecl_kw_fwrite(kw, fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        const int index_list[] = {2499, 0, 1000, 999, 0, 1500, 1001};
+        const int num_index = sizeof index_list / sizeof index_list[0];
+        int_vector_type *index_map = int_vector_alloc(0, 0);
+        float values[num_index];
+        fortio_type *fortio = fortio_open_reader("FILE", false, true);
+
+        for (int i = 0; i < num_index; i++)
+            int_vector_append(index_map, index_list[i]);
+
+        ecl_kw_fread_indexed_data(fortio, ECL_KW_HEADER_FORTIO_SIZE, ECL_FLOAT,
+                                  size, index_map, (char *)values);
+        for (int i = 0; i < num_index; i++)
+            test_assert_float_equal(values[i],
+                                    ecl_kw_iget_float(kw, index_list[i]));
+
+        int_vector_free(index_map);
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE", 0);
+        ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+        float values[2];
+
+        ecl_file_view_fload_named_element(view, "FLOAT", 1999,
+                                          (char *)values);
+        test_assert_float_equal(values[0], ecl_kw_iget_float(kw, 1999));
+        test_assert_float_equal(values[1], ecl_kw_iget_float(kw, 1999));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(kw);
+}
+
+/*
+  Keywords written by other applications need not use the standard
+  block size for the data records; skipping the data must then fall
+  back to walking the records.
+*/
+void test_fskip_data() {
+    ecl::util::TestArea ta("fskip_data");
+    const int size = 2500;
+    ecl_kw_type *kw = ecl_kw_alloc("FLOAT", size, ECL_FLOAT);
+    ecl_kw_type *int_kw = ecl_kw_alloc("INT", 10, ECL_INT);
+    for (int i = 0; i < size; i++)
+        ecl_kw_iset_float(kw, i, i * 0.5);
+    for (int i = 0; i < 10; i++)
+        ecl_kw_iset_int(int_kw, i, i);
+
+    {
+        fortio_type *fortio = fortio_open_writer("FILE", false, true);
+        float *data = (float *)util_malloc(size * sizeof *data);
+        memcpy(data, ecl_kw_get_void_ptr(kw), size * sizeof *data);
+        util_endian_flip_vector(data, sizeof *data, size);
+
+        ecl_kw_fwrite(int_kw, fortio);
+        {
+            char header[ECL_KW_HEADER_DATA_SIZE];
+            int kw_size = size;
+            util_endian_flip_vector(&kw_size, sizeof kw_size, 1);
+            memcpy(&header[0], "FLOAT   ", ECL_STRING8_LENGTH);
+            memcpy(&header[ECL_STRING8_LENGTH], &kw_size, sizeof kw_size);
+            memcpy(&header[ECL_STRING8_LENGTH + 4], "REAL", ECL_TYPE_LENGTH);
+            fortio_fwrite_record(fortio, header, ECL_KW_HEADER_DATA_SIZE);
+        }
+        fortio_fwrite_record(fortio, (char *)data, 1500 * sizeof *data);
+        fortio_fwrite_record(fortio, (char *)&data[1500], 1000 * sizeof *data);
+        ecl_kw_fwrite(int_kw, fortio);
+        fortio_fclose(fortio);
+        free(data);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE", 0);
+        test_assert_int_equal(3, ecl_file_get_size(ecl_file));
+        test_assert_true(
+            ecl_kw_equal(kw, ecl_file_iget_named_kw(ecl_file, "FLOAT", 0)));
+        test_assert_true(
+            ecl_kw_equal(int_kw, ecl_file_iget_named_kw(ecl_file, "INT", 1)));
+        ecl_file_close(ecl_file);
+    }
+
+    /* A broken trailer of the last data record stops the scan. */
+    {
+        FILE *stream = util_fopen("FILE", "r+");
+        offset_type int_kw_size = (ECL_KW_HEADER_FORTIO_SIZE) + 10 * 4 + 8;
+        offset_type offset = int_kw_size + (ECL_KW_HEADER_FORTIO_SIZE) +
+                             (1500 * 4 + 8) + (1000 * 4 + 4);
+        int marker = -1;
+        util_fseek(stream, offset, SEEK_SET);
+        util_fwrite(&marker, sizeof marker, 1, stream, __func__);
+        fclose(stream);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE", 0);
+        test_assert_int_equal(1, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(kw);
+    ecl_kw_free(int_kw);
+}
+
+void test_read_ahead() {
+    ecl::util::TestArea ta("read_ahead");
+    const int num_kw = 50;
+    ecl_kw_type *kw = ecl_kw_alloc("DOUBLE", 1500, ECL_DOUBLE);
+    for (int i = 0; i < 1500; i++)
+        ecl_kw_iset_double(kw, i, i * 0.25);
+
+    {
+        fortio_type *fortio = fortio_open_writer("FILE.UNRST", false, true);
+        for (int i = 0; i < num_kw; i++)
+            ecl_kw_fwrite(kw, fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        /* A small window to move the read-ahead window many times. */
+        fortio_type *fortio = fortio_open_reader("FILE.UNRST", false, true);
+        if (fortio_set_read_ahead(fortio, 16384)) {
+            test_assert_size_t_equal(16384, fortio_get_read_ahead(fortio));
+            test_assert_true(fortio_fclose_stream(fortio));
+            test_assert_true(fortio_fopen_stream(fortio));
+            test_assert_size_t_equal(16384, fortio_get_read_ahead(fortio));
+        }
+
+        for (int i = 0; i < num_kw; i++) {
+            ecl_kw_type *kw2 = ecl_kw_fread_alloc(fortio);
+            test_assert_true(ecl_kw_equal(kw, kw2));
+            ecl_kw_free(kw2);
+        }
+        test_assert_true(fortio_read_at_eof(fortio));
+        fortio_fclose(fortio);
+    }
+    {
+        ecl_file_type *ecl_file = ecl_file_open(
+            "FILE.UNRST", ECL_FILE_READ_AHEAD | ECL_FILE_CLOSE_STREAM);
+        test_assert_int_equal(num_kw, ecl_file_get_size(ecl_file));
+        test_assert_true(
+            ecl_kw_equal(kw, ecl_file_iget_named_kw(ecl_file, "DOUBLE", 49)));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(kw);
+}
+
 int main(int argc, char **argv) {
     test_fread_alloc();
     test_kw_io_charlength();
+    test_fread_indexed();
+    test_read_ahead();
+    test_fskip_data();
     exit(0);
 }
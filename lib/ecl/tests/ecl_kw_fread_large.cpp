@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/int_vector.hpp>
+
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/fortio.h>
+
+/*
+  The files created in this test are several GB large, but they are
+  sparse: only the record markers and a few values are actually
+  written, the rest of the file is holes created with fseek().
+*/
+
+#define BIG_SIZE 600000000
+#define BLOCK_SIZE 1000
+
+static void fwrite_marker(fortio_type *fortio, int record_size) {
+    fortio_init_write(fortio, record_size);
+}
+
+static void fwrite_big_header(fortio_type *fortio, int size) {
+    char buffer[ECL_KW_HEADER_DATA_SIZE];
+    memcpy(&buffer[0], "BIG     ", ECL_STRING8_LENGTH);
+    if (ECL_ENDIAN_FLIP)
+        util_endian_flip_vector(&size, sizeof size, 1);
+    memcpy(&buffer[ECL_STRING8_LENGTH], &size, sizeof size);
+    memcpy(&buffer[ECL_STRING8_LENGTH + sizeof size], "REAL", ECL_TYPE_LENGTH);
+    fortio_fwrite_record(fortio, buffer, ECL_KW_HEADER_DATA_SIZE);
+}
+
+void test_fskip_large_buffer() {
+    ecl::util::TestArea ta("fskip_large");
+    const int record_size = 1500000000;
+    {
+        fortio_type *fortio =
+            fortio_open_writer("FILE", false, ECL_ENDIAN_FLIP);
+        for (int i = 0; i < 2; i++) {
+            fwrite_marker(fortio, record_size);
+            fortio_fseek(fortio, record_size, SEEK_CUR);
+            fwrite_marker(fortio, record_size);
+        }
+        fortio_fclose(fortio);
+    }
+    {
+        fortio_type *fortio =
+            fortio_open_reader("FILE", false, ECL_ENDIAN_FLIP);
+        fortio_fskip_buffer(fortio, 2 * (size_t)record_size);
+        test_assert_true(fortio_read_at_eof(fortio));
+        fortio_fclose(fortio);
+    }
+}
+
+void test_large_keyword() {
+    ecl::util::TestArea ta("large_kw");
+    const int block_count = BIG_SIZE / BLOCK_SIZE;
+    const offset_type data_offset = ECL_KW_HEADER_FORTIO_SIZE;
+    const offset_type data_size =
+        (offset_type)block_count * 8 + (offset_type)BIG_SIZE * sizeof(float);
+    const float last_value = 1.25;
+    ecl_kw_type *small_kw = ecl_kw_alloc("SMALL", 10, ECL_INT);
+
+    for (int i = 0; i < 10; i++)
+        ecl_kw_iset_int(small_kw, i, i);
+
+    {
+        fortio_type *fortio =
+            fortio_open_writer("LARGE.INIT", false, ECL_ENDIAN_FLIP);
+        const int record_size = BLOCK_SIZE * sizeof(float);
+        float value = last_value;
+
+        fwrite_big_header(fortio, BIG_SIZE);
+        fwrite_marker(fortio, record_size);
+        fortio_fseek(fortio, data_offset + data_size - 2 * 4 - record_size,
+                     SEEK_SET);
+        fwrite_marker(fortio, record_size);
+        fortio_fseek(fortio, record_size - sizeof value, SEEK_CUR);
+        if (ECL_ENDIAN_FLIP)
+            util_endian_flip_vector(&value, sizeof value, 1);
+        util_fwrite(&value, sizeof value, 1, fortio_get_FILE(fortio), __func__);
+        fwrite_marker(fortio, record_size);
+        test_assert_true(fortio_ftell(fortio) == data_offset + data_size);
+
+        ecl_kw_fwrite(small_kw, fortio);
+        fortio_fclose(fortio);
+    }
+
+    {
+        fortio_type *fortio =
+            fortio_open_reader("LARGE.INIT", false, ECL_ENDIAN_FLIP);
+        ecl_kw_type *big_kw = ecl_kw_alloc_empty();
+        test_assert_true(ecl_kw_fread_header(big_kw, fortio) == ECL_KW_READ_OK);
+        test_assert_int_equal(BIG_SIZE, ecl_kw_get_size(big_kw));
+        test_assert_true(ecl_kw_fortio_size(big_kw) ==
+                         (size_t)(data_offset + data_size));
+        test_assert_true(ecl_kw_fskip_data(big_kw, fortio));
+        {
+            ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+            test_assert_true(ecl_kw_equal(kw, small_kw));
+            ecl_kw_free(kw);
+        }
+        {
+            int_vector_type *index_map = int_vector_alloc(0, 0);
+            float values[2];
+            int_vector_append(index_map, 0);
+            int_vector_append(index_map, BIG_SIZE - 1);
+            ecl_kw_fread_indexed_data(fortio, data_offset, ECL_FLOAT, BIG_SIZE,
+                                      index_map, (char *)values);
+            test_assert_float_equal(values[0], 0);
+            test_assert_float_equal(values[1], last_value);
+            int_vector_free(index_map);
+        }
+        ecl_kw_free(big_kw);
+        fortio_fclose(fortio);
+    }
+
+    {
+        ecl_file_type *ecl_file = ecl_file_open("LARGE.INIT", 0);
+        test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+        test_assert_int_equal(BIG_SIZE,
+                              ecl_file_iget_named_size(ecl_file, "BIG", 0));
+        test_assert_true(
+            ecl_kw_equal(ecl_file_iget_named_kw(ecl_file, "SMALL", 0),
+                         small_kw));
+        ecl_file_close(ecl_file);
+    }
+    ecl_kw_free(small_kw);
+}
+
+int main(int argc, char **argv) {
+    test_fskip_large_buffer();
+    test_large_keyword();
+    exit(0);
+}
@@ -0,0 +1,142 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/fortio.h>
+
+void write_file(const char *filename, ecl_kw_type **kw_list, int num_kw) {
+    fortio_type *fortio = fortio_open_writer(filename, false, ECL_ENDIAN_FLIP);
+    for (int i = 0; i < num_kw; i++)
+        ecl_kw_fwrite(kw_list[i], fortio);
+    fortio_fclose(fortio);
+}
+
+void read_and_compare(fortio_type *fortio, ecl_kw_type **kw_list, int num_kw) {
+    for (int i = 0; i < num_kw; i++) {
+        ecl_kw_type *kw = ecl_kw_fread_alloc_mmap(fortio);
+        test_assert_true(ecl_kw_is_instance(kw));
+        test_assert_true(ecl_kw_equal(kw, kw_list[i]));
+        ecl_kw_free(kw);
+    }
+    test_assert_NULL(ecl_kw_fread_alloc_mmap(fortio));
+}
+
+void test_mmap_read() {
+    ecl::util::TestArea ta("fread_mmap");
+    const int num_kw = 5;
+    ecl_kw_type *kw_list[5];
+
+    kw_list[0] = ecl_kw_alloc("INT", 10, ECL_INT);
+    kw_list[1] = ecl_kw_alloc("FLOAT", 2500, ECL_FLOAT);
+    kw_list[2] = ecl_kw_alloc("DOUBLE", 1001, ECL_DOUBLE);
+    kw_list[3] = ecl_kw_alloc("CHAR", 3, ECL_CHAR);
+    kw_list[4] = ecl_kw_alloc("EMPTY", 0, ECL_FLOAT);
+
+    for (int i = 0; i < 10; i++)
+        ecl_kw_iset_int(kw_list[0], i, i);
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(kw_list[1], i, i * 0.25);
+    for (int i = 0; i < 1001; i++)
+        ecl_kw_iset_double(kw_list[2], i, i * 1.5);
+    ecl_kw_iset_string8(kw_list[3], 0, "A");
+    ecl_kw_iset_string8(kw_list[3], 1, "BB");
+    ecl_kw_iset_string8(kw_list[3], 2, "CCC");
+
+    write_file("FILE", kw_list, num_kw);
+    {
+        fortio_type *fortio =
+            fortio_open_reader_mmap("FILE", false, ECL_ENDIAN_FLIP);
+        test_assert_true(fortio_is_mmapped(fortio));
+        read_and_compare(fortio, kw_list, num_kw);
+
+        /* Modifying a keyword must not change the mapping. */
+        fortio_rewind(fortio);
+        {
+            ecl_kw_type *kw = ecl_kw_fread_alloc_mmap(fortio);
+            ecl_kw_iset_int(kw, 0, 100);
+            test_assert_int_equal(ecl_kw_iget_int(kw, 0), 100);
+            ecl_kw_free(kw);
+        }
+        fortio_rewind(fortio);
+        read_and_compare(fortio, kw_list, num_kw);
+
+        /* Positional reads are served from the mapping without a stream. */
+        fortio_fclose_stream(fortio);
+        {
+            ecl_kw_type *kw = ecl_kw_pread_alloc(fortio, 0);
+            test_assert_true(ecl_kw_equal(kw, kw_list[0]));
+            ecl_kw_free(kw);
+        }
+        fortio_fopen_stream(fortio);
+
+        /* The ordinary read path is not affected by the mapping. */
+        fortio_rewind(fortio);
+        for (int i = 0; i < num_kw; i++) {
+            ecl_kw_type *kw = ecl_kw_fread_alloc(fortio);
+            test_assert_true(ecl_kw_equal(kw, kw_list[i]));
+            ecl_kw_free(kw);
+        }
+        fortio_fclose(fortio);
+    }
+
+    {
+        offset_type file_size = util_file_size("FILE");
+        FILE *stream = util_fopen("FILE", "r+");
+        util_ftruncate(stream, file_size - 4);
+        fclose(stream);
+    }
+    {
+        fortio_type *fortio =
+            fortio_open_reader_mmap("FILE", false, ECL_ENDIAN_FLIP);
+        for (int i = 0; i < 2; i++) {
+            ecl_kw_type *kw = ecl_kw_fread_alloc_mmap(fortio);
+            test_assert_true(ecl_kw_equal(kw, kw_list[i]));
+            ecl_kw_free(kw);
+        }
+        ecl_kw_fskip(fortio);
+        ecl_kw_fskip(fortio);
+        test_assert_NULL(ecl_kw_fread_alloc_mmap(fortio));
+        fortio_fclose(fortio);
+    }
+
+    for (int i = 0; i < num_kw; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+void test_file_mmap() {
+    ecl::util::TestArea ta("file_mmap");
+    ecl_kw_type *kw_list[2];
+
+    kw_list[0] = ecl_kw_alloc("PRESSURE", 2500, ECL_FLOAT);
+    kw_list[1] = ecl_kw_alloc("SWAT", 2500, ECL_FLOAT);
+    for (int i = 0; i < 2500; i++) {
+        ecl_kw_iset_float(kw_list[0], i, i);
+        ecl_kw_iset_float(kw_list[1], i, i * 0.5);
+    }
+    write_file("FILE.UNRST", kw_list, 2);
+
+    {
+        ecl_file_type *ecl_file =
+            ecl_file_open("FILE.UNRST", ECL_FILE_MMAP | ECL_FILE_CLOSE_STREAM);
+        test_assert_true(ecl_kw_equal(
+            ecl_file_iget_named_kw(ecl_file, "SWAT", 0), kw_list[1]));
+        test_assert_true(ecl_kw_equal(
+            ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0), kw_list[0]));
+        ecl_file_close(ecl_file);
+    }
+
+    for (int i = 0; i < 2; i++)
+        ecl_kw_free(kw_list[i]);
+}
+
+int main(int argc, char **argv) {
+    test_mmap_read();
+    test_file_mmap();
+    exit(0);
+}
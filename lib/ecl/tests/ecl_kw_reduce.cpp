@@ -0,0 +1,185 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+
+#define SIZE 100003
+
+static ecl_kw_type *alloc_kw(ecl_data_type data_type) {
+    ecl_kw_type *kw = ecl_kw_alloc("KW", SIZE, data_type);
+    for (int i = 0; i < SIZE; i++) {
+        int value = ((i * 7919) % 1013) - 500;
+        if (ecl_type_is_int(data_type))
+            ecl_kw_iset_int(kw, i, value);
+        else if (ecl_type_is_float(data_type))
+            ecl_kw_iset_float(kw, i, value);
+        else
+            ecl_kw_iset_double(kw, i, value);
+    }
+    return kw;
+}
+
+static double reference_sum(const ecl_kw_type *kw) {
+    double sum = 0;
+    for (int i = 0; i < ecl_kw_get_size(kw); i++)
+        sum += ecl_kw_iget_as_double(kw, i);
+    return sum;
+}
+
+void test_max_min() {
+    ecl_kw_type *kw = alloc_kw(ECL_DOUBLE);
+    ecl_kw_iset_double(kw, 77777, 1000);
+    ecl_kw_iset_double(kw, SIZE - 1, -1000);
+    {
+        double max, min;
+        ecl_kw_max_min(kw, &max, &min);
+        test_assert_double_equal(1000, max);
+        test_assert_double_equal(-1000, min);
+    }
+    ecl_kw_free(kw);
+
+    kw = alloc_kw(ECL_INT);
+    ecl_kw_iset_int(kw, 0, 9999);
+    {
+        int max, min;
+        ecl_kw_max_min_int(kw, &max, &min);
+        test_assert_int_equal(9999, max);
+        test_assert_int_equal(-500, min);
+    }
+    ecl_kw_free(kw);
+
+    kw = alloc_kw(ECL_FLOAT);
+    ecl_kw_iset_float(kw, 12345, -4321);
+    {
+        float max, min;
+        ecl_kw_max_min_float(kw, &max, &min);
+        test_assert_float_equal(512, max);
+        test_assert_float_equal(-4321, min);
+    }
+    ecl_kw_free(kw);
+}
+
+void test_sum() {
+    {
+        ecl_kw_type *kw = alloc_kw(ECL_INT);
+        test_assert_int_equal(reference_sum(kw), ecl_kw_element_sum_int(kw));
+        ecl_kw_free(kw);
+    }
+    {
+        ecl_kw_type *kw = alloc_kw(ECL_DOUBLE);
+        test_assert_double_equal(reference_sum(kw),
+                                 ecl_kw_element_sum_float(kw));
+        ecl_kw_free(kw);
+    }
+    {
+        ecl_kw_type *kw = alloc_kw(ECL_FLOAT);
+        test_assert_double_equal(reference_sum(kw),
+                                 ecl_kw_element_sum_float(kw));
+        ecl_kw_free(kw);
+    }
+}
+
+void test_sum_indexed() {
+    ecl_kw_type *kw = alloc_kw(ECL_DOUBLE);
+    ecl_kw_type *bool_kw = ecl_kw_alloc("BOOL", SIZE, ECL_BOOL);
+    int_vector_type *index_list = int_vector_alloc(0, 0);
+    double expected = 0;
+    int expected_count = 0;
+
+    for (int i = 0; i < SIZE; i++)
+        ecl_kw_iset_bool(bool_kw, i, (i % 3) == 0);
+
+    for (int i = 0; i < SIZE; i += 2) {
+        int_vector_append(index_list, i);
+        expected += ecl_kw_iget_double(kw, i);
+        expected_count += ((i % 3) == 0);
+    }
+    int_vector_append(index_list, 5);
+    expected += ecl_kw_iget_double(kw, 5);
+
+    {
+        double sum;
+        ecl_kw_element_sum_indexed(kw, index_list, &sum);
+        test_assert_double_equal(expected, sum);
+    }
+    {
+        int count;
+        ecl_kw_element_sum_indexed(bool_kw, index_list, &count);
+        test_assert_int_equal(expected_count, count);
+    }
+
+    int_vector_free(index_list);
+    ecl_kw_free(bool_kw);
+    ecl_kw_free(kw);
+}
+
+void test_compensated_sum() {
+    ecl_kw_type *kw = ecl_kw_alloc("KW", 10 * SIZE, ECL_FLOAT);
+    double expected = 10.0 * SIZE * (double)0.1f;
+    ecl_kw_scalar_set_float(kw, 0.1f);
+
+    test_assert_false(ecl_kw_get_compensated_sum());
+    ecl_kw_set_compensated_sum(true);
+    test_assert_true(fabs(ecl_kw_element_sum_float(kw) - expected) < 1e-6);
+    {
+        float sum;
+        ecl_kw_element_sum(kw, &sum);
+        test_assert_float_equal((float)expected, sum);
+    }
+    ecl_kw_set_compensated_sum(false);
+
+    ecl_kw_free(kw);
+}
+
+void test_first_different() {
+    ecl_kw_type *kw1 = alloc_kw(ECL_FLOAT);
+    ecl_kw_type *kw2 = ecl_kw_alloc_copy(kw1);
+
+    test_assert_int_equal(SIZE, ecl_kw_first_different(kw1, kw2, 0, 0, 0));
+    test_assert_int_equal(SIZE, ecl_kw_first_different(kw1, kw2, SIZE - 1,
+                                                       1e-6, 1e-6));
+
+    ecl_kw_iset_float(kw2, 90000, ecl_kw_iget_float(kw1, 90000) + 0.01);
+    test_assert_int_equal(90000, ecl_kw_first_different(kw1, kw2, 0, 0, 0));
+    test_assert_int_equal(SIZE,
+                          ecl_kw_first_different(kw1, kw2, 0, 0.1, 0));
+    test_assert_int_equal(90000,
+                          ecl_kw_first_different(kw1, kw2, 0, 1e-3, 0));
+
+    ecl_kw_iset_float(kw2, 1234, ecl_kw_iget_float(kw1, 1234) + 100);
+    test_assert_int_equal(1234, ecl_kw_first_different(kw1, kw2, 0, 0, 0));
+    test_assert_int_equal(1234,
+                          ecl_kw_first_different(kw1, kw2, 0, 1e-3, 1e-3));
+    test_assert_int_equal(90000, ecl_kw_first_different(kw1, kw2, 1235, 0, 0));
+
+    ecl_kw_free(kw2);
+    ecl_kw_free(kw1);
+}
+
+static void run_tests() {
+    test_max_min();
+    test_sum();
+    test_sum_indexed();
+    test_compensated_sum();
+    test_first_different();
+}
+
+int main(int argc, char **argv) {
+    run_tests();
+
+    ecl_kw_set_parallel_threshold(1000);
+    ecl_kw_set_reduce_threads(4);
+    test_assert_int_equal(1000, ecl_kw_get_parallel_threshold());
+    test_assert_int_equal(4, ecl_kw_get_reduce_threads());
+    run_tests();
+
+    ecl_kw_set_parallel_threshold(1);
+    ecl_kw_set_reduce_threads(7);
+    run_tests();
+    exit(0);
+}
@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+/*
+  Writes the keyword with ecl_kw_fwrite() and with an ecl_kw_writer
+  appending chunks of @chunk_size elements, and verifies that the
+  files are identical.
+*/
+static void test_writer(const ecl_kw_type *ecl_kw, bool fmt_file,
+                        int chunk_size) {
+    ecl::util::TestArea ta("kw_writer");
+    ecl_data_type data_type = ecl_kw_get_data_type(ecl_kw);
+    size_t sizeof_ctype = ecl_type_get_sizeof_ctype(data_type);
+    int size = ecl_kw_get_size(ecl_kw);
+    {
+        fortio_type *fortio =
+            fortio_open_writer("KW_FWRITE", fmt_file, ECL_ENDIAN_FLIP);
+        ecl_kw_fwrite(ecl_kw, fortio);
+        ecl_kw_fwrite(ecl_kw, fortio);
+        fortio_fclose(fortio);
+    }
+    {
+        fortio_type *fortio =
+            fortio_open_writer("KW_WRITER", fmt_file, ECL_ENDIAN_FLIP);
+        const char *data = (const char *)ecl_kw_get_ptr(ecl_kw);
+
+        for (int i = 0; i < 2; i++) {
+            ecl_kw_writer_type *writer = ecl_kw_writer_alloc(
+                fortio, ecl_kw_get_header(ecl_kw), size, data_type);
+            int offset = 0;
+            while (offset < size) {
+                int n = util_int_min(chunk_size, size - offset);
+                ecl_kw_writer_append(writer, &data[offset * sizeof_ctype], n);
+                offset += n;
+                test_assert_int_equal(size - offset,
+                                      ecl_kw_writer_get_remaining(writer));
+            }
+            ecl_kw_writer_free(writer);
+        }
+        fortio_fclose(fortio);
+    }
+    test_assert_true(util_files_equal("KW_FWRITE", "KW_WRITER"));
+}
+
+static void test_kw(const ecl_kw_type *ecl_kw) {
+    int chunk_sizes[] = {1, 7, 1000, 1001, ecl_kw_get_size(ecl_kw) + 1};
+    for (int fmt = 0; fmt < 2; fmt++)
+        for (int chunk_size : chunk_sizes)
+            test_writer(ecl_kw, fmt == 1, chunk_size);
+}
+
+void test_numeric() {
+    ecl_kw_type *float_kw = ecl_kw_alloc("PRESSURE", 2500, ECL_FLOAT);
+    ecl_kw_type *int_kw = ecl_kw_alloc("ACTNUM", 3000, ECL_INT);
+    ecl_kw_type *double_kw = ecl_kw_alloc("DOUBLE", 10, ECL_DOUBLE);
+    ecl_kw_type *bool_kw = ecl_kw_alloc("LOGIHEAD", 1234, ECL_BOOL);
+
+    for (int i = 0; i < 2500; i++)
+        ecl_kw_iset_float(float_kw, i, i * 0.25);
+    for (int i = 0; i < 3000; i++)
+        ecl_kw_iset_int(int_kw, i, i % 3);
+    for (int i = 0; i < 10; i++)
+        ecl_kw_iset_double(double_kw, i, i / 3.0);
+    for (int i = 0; i < 1234; i++)
+        ecl_kw_iset_bool(bool_kw, i, i % 2 == 0);
+
+    test_kw(float_kw);
+    test_kw(int_kw);
+    test_kw(double_kw);
+    test_kw(bool_kw);
+
+    ecl_kw_free(float_kw);
+    ecl_kw_free(int_kw);
+    ecl_kw_free(double_kw);
+    ecl_kw_free(bool_kw);
+}
+
+void test_char() {
+    ecl_kw_type *char_kw = ecl_kw_alloc("NAMES", 250, ECL_CHAR);
+    for (int i = 0; i < 250; i++) {
+        char name[16];
+        sprintf(name, "W%d", i);
+        ecl_kw_iset_char_ptr(char_kw, i, name);
+    }
+    test_kw(char_kw);
+    ecl_kw_free(char_kw);
+}
+
+void test_empty() {
+    ecl_kw_type *empty_kw = ecl_kw_alloc("EMPTY", 0, ECL_INT);
+    test_writer(empty_kw, false, 1);
+    test_writer(empty_kw, true, 1);
+    ecl_kw_free(empty_kw);
+}
+
+void test_long_header() {
+    ecl::util::TestArea ta("kw_writer_header");
+    fortio_type *fortio = fortio_open_writer("FILE", false, ECL_ENDIAN_FLIP);
+    test_assert_NULL(ecl_kw_writer_alloc(fortio, "LONG_HEADER", 10, ECL_INT));
+    fortio_fclose(fortio);
+}
+
+int main(int argc, char **argv) {
+    test_numeric();
+    test_char();
+    test_empty();
+    test_long_header();
+    exit(0);
+}
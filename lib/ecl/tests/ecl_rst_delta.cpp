@@ -0,0 +1,364 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_kw_magic.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_file_kw.hpp>
+#include <ert/ecl/ecl_file_view.hpp>
+#include <ert/ecl/ecl_rst_delta.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/fortio.h>
+
+#define NUM_STEPS 12
+#define SIZE 20000
+
+/*
+  Every step has the same IWEL and ZWEL keywords, a PRESSURE field which
+  changes slightly, and a PRESSURE field of a different size which does
+  not share base with the first.
+*/
+static void write_file(const char *filename, bool fmt_file) {
+    fortio_type *fortio =
+        fortio_open_writer(filename, fmt_file, ECL_ENDIAN_FLIP);
+    for (int step = 0; step < NUM_STEPS; step++) {
+        {
+            ecl_kw_type *kw = ecl_kw_alloc(SEQNUM_KW, 1, ECL_INT);
+            ecl_kw_iset_int(kw, 0, step);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("IWEL", SIZE, ECL_INT);
+            for (int i = 0; i < SIZE; i++)
+                ecl_kw_iset_int(kw, i, i % 97);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("PRESSURE", SIZE, ECL_FLOAT);
+            for (int i = 0; i < SIZE; i++)
+                ecl_kw_iset_float(kw, i, 200 + (i % 13) + (i == step));
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("PRESSURE", 100, ECL_DOUBLE);
+            for (int i = 0; i < 100; i++)
+                ecl_kw_iset_double(kw, i, i * 0.5 + step);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("ZWEL", 30, ECL_CHAR);
+            for (int i = 0; i < 30; i++)
+                ecl_kw_iset_string8(kw, i, i == step ? "OP_2" : "OP_1");
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("LOGIHEAD", 20, ECL_BOOL);
+            ecl_kw_scalar_set_bool(kw, step % 2 == 0);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+        {
+            ecl_kw_type *kw = ecl_kw_alloc("ENDSOL", 0, ECL_MESS);
+            ecl_kw_fwrite(kw, fortio);
+            ecl_kw_free(kw);
+        }
+    }
+    fortio_fclose(fortio);
+}
+
+static void assert_equal_files(const char *filename, const char *archive,
+                               int flags) {
+    ecl_file_type *ecl_file = ecl_file_open(filename, 0);
+    ecl_file_type *delta_file = ecl_file_open(archive, flags);
+
+    test_assert_int_equal(ecl_file_get_size(ecl_file),
+                          ecl_file_get_size(delta_file));
+    test_assert_int_equal(ecl_file_get_num_distinct_kw(ecl_file),
+                          ecl_file_get_num_distinct_kw(delta_file));
+
+    /* Load in reverse order, so the bases are not loaded first. */
+    for (int i = ecl_file_get_size(ecl_file) - 1; i >= 0; i--)
+        test_assert_true(ecl_kw_equal(ecl_file_iget_kw(ecl_file, i),
+                                      ecl_file_iget_kw(delta_file, i)));
+
+    ecl_file_close(delta_file);
+    ecl_file_close(ecl_file);
+}
+
+static void copy_prefix(const char *src_file, const char *target_file,
+                        size_t size) {
+    char *buffer = (char *)util_malloc(size);
+    FILE *stream = util_fopen(src_file, "r");
+    util_fread(buffer, 1, size, stream, __func__);
+    fclose(stream);
+
+    stream = util_fopen(target_file, "w");
+    util_fwrite(buffer, 1, size, stream, __func__);
+    fclose(stream);
+    free(buffer);
+}
+
+void test_pack(const char *filename, bool fmt_file) {
+    ecl::util::TestArea ta("rst_delta");
+    write_file(filename, fmt_file);
+
+    test_assert_true(ecl_rst_delta_pack(filename, "ARCHIVE", 4,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+    test_assert_true(5 * util_file_size("ARCHIVE") < util_file_size(filename));
+
+    assert_equal_files(filename, "ARCHIVE", 0);
+    assert_equal_files(filename, "ARCHIVE", ECL_FILE_CLOSE_STREAM);
+
+    test_assert_true(ecl_rst_delta_unpack("ARCHIVE", "UNPACKED.UNRST"));
+    assert_equal_files(filename, "UNPACKED.UNRST", 0);
+    if (!fmt_file)
+        test_assert_true(util_files_equal(filename, "UNPACKED.UNRST"));
+
+    test_assert_true(ecl_rst_delta_pack(filename, "ARCHIVE_FULL", 1,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+    test_assert_true(util_file_size("ARCHIVE") <
+                     util_file_size("ARCHIVE_FULL"));
+    assert_equal_files(filename, "ARCHIVE_FULL", 0);
+
+    /* A file which ends with a partial keyword is packed up to that
+       keyword, but the pack fails. */
+    {
+        const char *truncated =
+            fmt_file ? "TRUNCATED.FUNRST" : "TRUNCATED.UNRST";
+        copy_prefix(filename, truncated, util_file_size(filename) - 10);
+        test_assert_false(ecl_rst_delta_pack(truncated, "ARCHIVE_TRUNCATED", 4,
+                                             ECL_RST_DELTA_BLOCK_SIZE));
+        assert_equal_files(truncated, "ARCHIVE_TRUNCATED", 0);
+    }
+
+    test_assert_false(ecl_rst_delta_pack("MISSING.UNRST", "ARCHIVE2", 4,
+                                         ECL_RST_DELTA_BLOCK_SIZE));
+    test_assert_false(ecl_rst_delta_unpack("MISSING", "UNPACKED2.UNRST"));
+}
+
+void test_file_api() {
+    ecl::util::TestArea ta("rst_delta_api");
+    write_file("FILE.UNRST", false);
+    test_assert_true(ecl_rst_delta_pack("FILE.UNRST", "ARCHIVE",
+                                        ECL_RST_DELTA_KEYFRAME_INTERVAL,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+
+    ecl_file_type *ecl_file = ecl_file_open("ARCHIVE", 0);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+
+    test_assert_false(ecl_file_write_index(ecl_file, "ARCHIVE.index"));
+    test_assert_true(ecl_file_has_report_step(ecl_file, NUM_STEPS - 1));
+    {
+        ecl_kw_type *slice =
+            ecl_file_view_iget_named_kw_slice(view, "IWEL", 9, 100, 110);
+        test_assert_int_equal(10, ecl_kw_get_size(slice));
+        test_assert_int_equal(100 % 97, ecl_kw_iget_int(slice, 0));
+        ecl_kw_free(slice);
+    }
+    {
+        int values[NUM_STEPS];
+        ecl_file_view_fload_named_element(view, SEQNUM_KW, 0, (char *)values);
+        for (int step = 0; step < NUM_STEPS; step++)
+            test_assert_int_equal(step, values[step]);
+    }
+    {
+        double values[3];
+        test_assert_true(ecl_file_view_fread_named_kw_as_double(
+            view, "PRESSURE", 2 * 5, 4, 3, values));
+        test_assert_double_equal(204, values[0]);
+        test_assert_double_equal(206, values[2]);
+    }
+    {
+        stringlist_type *kw_list = stringlist_alloc_new();
+        stringlist_append_copy(kw_list, "ZWEL");
+        test_assert_true(ecl_file_view_prefetch(view, kw_list));
+        for (int step = 0; step < NUM_STEPS; step++) {
+            ecl_kw_type *kw = ecl_file_iget_named_kw(ecl_file, "ZWEL", step);
+            test_assert_string_equal("OP_2    ",
+                                     ecl_kw_iget_char_ptr(kw, step));
+        }
+        stringlist_free(kw_list);
+    }
+
+    test_assert_true(ecl_file_select_rstblock_report_step(ecl_file, 7));
+    {
+        ecl_kw_type *kw = ecl_file_iget_named_kw(ecl_file, "PRESSURE", 0);
+        test_assert_int_equal(SIZE, ecl_kw_get_size(kw));
+        test_assert_float_equal(201, ecl_kw_iget_float(kw, 1));
+        test_assert_float_equal(201 + 7 % 13, ecl_kw_iget_float(kw, 7));
+    }
+    ecl_file_close(ecl_file);
+}
+
+/*
+  The slices are decoded from the frames covering the slice, also for
+  keywords which are deltas to other keywords.
+*/
+void test_frames() {
+    ecl::util::TestArea ta("rst_delta_frames");
+    write_file("FILE.UNRST", false);
+    test_assert_true(ecl_rst_delta_pack("FILE.UNRST", "ARCHIVE", 4,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+    test_assert_true(ecl_rst_delta_pack("FILE.UNRST", "ARCHIVE_SINGLE", 4, 0));
+    assert_equal_files("FILE.UNRST", "ARCHIVE_SINGLE", 0);
+
+    ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+    ecl_file_type *delta_file = ecl_file_open("ARCHIVE", 0);
+    ecl_file_view_type *view = ecl_file_get_global_view(ecl_file);
+    ecl_file_view_type *delta_view = ecl_file_get_global_view(delta_file);
+    const int ranges[][2] = {
+        {0, 1}, {990, 1010}, {2500, 4000}, {SIZE - 5, SIZE}, {0, SIZE}};
+
+    for (int step : {0, 3, 9}) {
+        for (const auto &range : ranges) {
+            ecl_kw_type *slice = ecl_file_view_iget_named_kw_slice(
+                view, "PRESSURE", 2 * step, range[0], range[1]);
+            ecl_kw_type *delta_slice = ecl_file_view_iget_named_kw_slice(
+                delta_view, "PRESSURE", 2 * step, range[0], range[1]);
+            test_assert_true(ecl_kw_equal(slice, delta_slice));
+            ecl_kw_free(delta_slice);
+            ecl_kw_free(slice);
+        }
+    }
+    test_assert_size_t_equal(0, ecl_file_get_kw_misses(delta_file));
+
+    /*
+      Loading the steps in order reconstructs each keyword from the
+      cached previous step; the slices are then taken from the cache.
+    */
+    for (int step = 0; step < NUM_STEPS; step++)
+        test_assert_true(ecl_kw_equal(
+            ecl_file_iget_named_kw(ecl_file, "PRESSURE", 2 * step),
+            ecl_file_iget_named_kw(delta_file, "PRESSURE", 2 * step)));
+    for (const auto &range : ranges) {
+        ecl_kw_type *slice = ecl_file_view_iget_named_kw_slice(
+            view, "IWEL", 10, range[0], range[1]);
+        ecl_kw_type *delta_slice = ecl_file_view_iget_named_kw_slice(
+            delta_view, "IWEL", 10, range[0], range[1]);
+        test_assert_true(ecl_kw_equal(slice, delta_slice));
+        ecl_kw_free(delta_slice);
+        ecl_kw_free(slice);
+    }
+
+    ecl_file_close(delta_file);
+    ecl_file_close(ecl_file);
+}
+
+/*
+  Sets the base of the first keyword in the archive to an invalid
+  value, so the archive can only be opened from the index.
+*/
+static void corrupt_first_desc(const char *filename) {
+    const unsigned char invalid_base[4] = {0x7f, 0, 0, 0};
+    FILE *stream = util_fopen(filename, "r+");
+    fseek(stream,
+          ecl_kw_fortio_size__(ECL_INT, ECL_RST_DELTA_SIZE) +
+              ECL_KW_HEADER_FORTIO_SIZE + 4 +
+              4 * ECL_RST_DELTA_DESC_BASE_INDEX,
+          SEEK_SET);
+    util_fwrite(invalid_base, 1, sizeof invalid_base, stream, __func__);
+    fclose(stream);
+}
+
+void test_index() {
+    ecl::util::TestArea ta("rst_delta_index");
+    const size_t end_size =
+        ecl_kw_fortio_size__(ECL_INT, ECL_RST_DELTA_END_SIZE);
+    write_file("FILE.UNRST", false);
+    test_assert_true(ecl_rst_delta_pack("FILE.UNRST", "ARCHIVE",
+                                        ECL_RST_DELTA_KEYFRAME_INTERVAL,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+
+    /* Without the index the archive is scanned. */
+    copy_prefix("ARCHIVE", "TRUNCATED", util_file_size("ARCHIVE") - end_size);
+    assert_equal_files("FILE.UNRST", "TRUNCATED", 0);
+    assert_equal_files("FILE.UNRST", "TRUNCATED", ECL_FILE_PARALLEL_SCAN);
+
+    test_assert_true(util_copy_file("ARCHIVE", "CORRUPT"));
+    corrupt_first_desc("CORRUPT");
+    assert_equal_files("FILE.UNRST", "CORRUPT", 0);
+
+    copy_prefix("CORRUPT", "CORRUPT_TRUNCATED",
+                util_file_size("CORRUPT") - end_size);
+    {
+        ecl_file_type *ecl_file = ecl_file_open("CORRUPT_TRUNCATED", 0);
+        test_assert_int_equal(0, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+    }
+
+    /* An archive written with another version of the format. */
+    {
+        const unsigned char version[4] = {0, 0, 0, 99};
+        FILE *stream;
+
+        test_assert_true(util_copy_file("ARCHIVE", "OTHER_VERSION"));
+        stream = util_fopen("OTHER_VERSION", "r+");
+        fseek(stream, ECL_KW_HEADER_FORTIO_SIZE + 4, SEEK_SET);
+        util_fwrite(version, 1, sizeof version, stream, __func__);
+        fclose(stream);
+        test_assert_NULL(ecl_file_open("OTHER_VERSION", 0));
+    }
+}
+
+/*
+  Every report step has seven keywords, so the steps interleave seven
+  delta chains. Loading the steps in order reads every payload once:
+  each keyword is decoded from the cached keyword of the previous step
+  in the same chain. Random access reads the chain back to the
+  keyframe.
+*/
+void test_delta_reads() {
+    ecl::util::TestArea ta("rst_delta_reads");
+    write_file("FILE.UNRST", false);
+    test_assert_true(ecl_rst_delta_pack("FILE.UNRST", "ARCHIVE",
+                                        ECL_RST_DELTA_KEYFRAME_INTERVAL,
+                                        ECL_RST_DELTA_BLOCK_SIZE));
+    {
+        ecl_file_type *ecl_file = ecl_file_open("FILE.UNRST", 0);
+        ecl_file_type *delta_file = ecl_file_open("ARCHIVE", 0);
+        size_t num_delta = 0;
+
+        test_assert_int_equal(7 * NUM_STEPS, ecl_file_get_size(delta_file));
+        for (int i = 0; i < ecl_file_get_size(delta_file); i++) {
+            if (ecl_file_kw_is_delta(ecl_file_iget_file_kw(delta_file, i)))
+                num_delta++;
+            test_assert_true(ecl_kw_equal(ecl_file_iget_kw(ecl_file, i),
+                                          ecl_file_iget_kw(delta_file, i)));
+        }
+        test_assert_true(num_delta > 2 * NUM_STEPS);
+        test_assert_size_t_equal(num_delta,
+                                 ecl_file_get_delta_reads(delta_file));
+
+        ecl_file_close(delta_file);
+        ecl_file_close(ecl_file);
+    }
+    {
+        const int step = ECL_RST_DELTA_KEYFRAME_INTERVAL - 1;
+        ecl_file_type *delta_file = ecl_file_open("ARCHIVE", 0);
+        ecl_file_iget_named_kw(delta_file, "IWEL", step);
+        test_assert_size_t_equal(step + 1,
+                                 ecl_file_get_delta_reads(delta_file));
+        ecl_file_close(delta_file);
+    }
+}
+
+int main(int argc, char **argv) {
+    test_pack("FILE.UNRST", false);
+    test_pack("FILE.FUNRST", true);
+    test_file_api();
+    test_frames();
+    test_index();
+    test_delta_reads();
+    exit(0);
+}
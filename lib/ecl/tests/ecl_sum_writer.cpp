@@ -1,13 +1,16 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdexcept>
+#include <vector>
 
 #include <ert/util/test_util.hpp>
 #include <ert/util/time_t_vector.hpp>
+#include <ert/util/double_vector.hpp>
 #include <ert/util/util.h>
 #include <ert/util/test_work_area.hpp>
 
 #include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_vector.hpp>
 #include <ert/ecl/ecl_grid.hpp>
 #include <ert/ecl/ecl_file.hpp>
 #include <ert/ecl/ecl_kw_magic.hpp>
@@ -237,10 +240,75 @@ void test_long_restart_names() {
     }
 }
 
+/*
+  Data which is not lazy loaded is stored with one array per vector;
+  the values must be equal to the lazy loaded values, also when read
+  through the tsteps when the case is written.
+*/
+void test_columnar_read() {
+    ecl::util::TestArea ta("sum_columnar_read");
+    const char *keys[] = {"TIME", "FOPT", "BPR:567", "WWCT:OP-1"};
+    time_t start_time = util_make_date_utc(1, 1, 2010);
+    write_summary("CASE", start_time, 10, 11, 12, 5, 10, 86400);
+
+    ecl_sum_type *lazy_sum =
+        ecl_sum_fread_alloc_case2__("CASE", ":", true, true, 0);
+    ecl_sum_type *ecl_sum =
+        ecl_sum_fread_alloc_case2__("CASE", ":", true, false, 0);
+    int length = ecl_sum_get_data_length(ecl_sum);
+    test_assert_int_equal(50, length);
+
+    for (const char *key : keys) {
+        int params_index = ecl_sum_get_general_var_params_index(ecl_sum, key);
+        double_vector_type *lazy_vector =
+            ecl_sum_alloc_data_vector(lazy_sum, params_index, false);
+        double_vector_type *vector =
+            ecl_sum_alloc_data_vector(ecl_sum, params_index, false);
+
+        test_assert_true(double_vector_equal(lazy_vector, vector));
+        for (int time_index = 0; time_index < length; time_index++)
+            test_assert_double_equal(
+                double_vector_iget(vector, time_index),
+                ecl_sum_iget(ecl_sum, time_index, params_index));
+
+        double_vector_free(vector);
+        double_vector_free(lazy_vector);
+    }
+
+    {
+        ecl_sum_vector_type *keywords = ecl_sum_vector_alloc(ecl_sum, true);
+        int num_keywords = ecl_sum_vector_get_size(keywords);
+        std::vector<double> frame(length * num_keywords);
+
+        ecl_sum_init_double_frame(ecl_sum, keywords, frame.data());
+        for (int time_index = 0; time_index < length; time_index++)
+            for (int key_index = 0; key_index < num_keywords; key_index++)
+                test_assert_double_equal(
+                    frame[time_index * num_keywords + key_index],
+                    ecl_sum_iget(lazy_sum, time_index,
+                                 ecl_sum_vector_iget_param_index(keywords,
+                                                                 key_index)));
+        ecl_sum_vector_free(keywords);
+    }
+    ecl_sum_free(lazy_sum);
+
+    ecl_sum_fwrite(ecl_sum);
+    ecl_sum_free(ecl_sum);
+
+    ecl_sum = ecl_sum_fread_alloc_case2__("CASE", ":", true, false, 0);
+    test_assert_int_equal(50, ecl_sum_get_data_length(ecl_sum));
+    for (int time_index = 0; time_index < length; time_index++)
+        test_assert_double_equal(
+            time_index * 86400.0,
+            ecl_sum_get_general_var(ecl_sum, time_index, "FOPT"));
+    ecl_sum_free(ecl_sum);
+}
+
 int main(int argc, char **argv) {
     util_install_signals();
     test_write_read();
     test_ecl_sum_alloc_restart_writer();
     test_long_restart_names();
+    test_columnar_read();
     exit(0);
 }
@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include <utime.h>
 
+#include <thread>
+#include <vector>
+
 #include <ert/util/test_util.hpp>
 #include <ert/util/util.h>
 #include <ert/util/test_work_area.hpp>
@@ -49,13 +52,12 @@ void test_create_and_load_index_file() {
         test_assert_false(ecl_file_index_valid(file_name, "nofile"));
         test_assert_false(ecl_file_index_valid("nofile", index_file_name));
 
+        time_t mtime = util_file_mtime(file_name);
         struct utimbuf tm1 = {1, 1};
-        struct utimbuf tm2 = {2, 2};
-        utime(file_name, &tm2);
-        utime(index_file_name, &tm1);
-        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        struct utimbuf tm2 = {mtime, mtime};
         utime(file_name, &tm1);
-        utime(index_file_name, &tm2);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        utime(file_name, &tm2);
         test_assert_true(ecl_file_index_valid(file_name, index_file_name));
 
         ecl_file_type *ecl_file_index =
@@ -84,8 +86,273 @@ void test_create_and_load_index_file() {
     }
 }
 
+static void write_data_file(const char *file_name, int size) {
+    ecl_kw_type *kw1 = ecl_kw_alloc("TEST1_KW", size, ECL_INT);
+    ecl_kw_type *kw2 = ecl_kw_alloc("TEST2_KW", size, ECL_FLOAT);
+    for (int i = 0; i < size; ++i) {
+        ecl_kw_iset_int(kw1, i, i);
+        ecl_kw_iset_float(kw2, i, 0.25 * i);
+    }
+
+    fortio_type *fortio = fortio_open_writer(file_name, false, ECL_ENDIAN_FLIP);
+    ecl_kw_fwrite(kw1, fortio);
+    ecl_kw_fwrite(kw2, fortio);
+    fortio_fclose(fortio);
+
+    ecl_kw_free(kw1);
+    ecl_kw_free(kw2);
+}
+
+static void write_index_file(const char *file_name,
+                             const char *index_file_name) {
+    ecl_file_type *ecl_file = ecl_file_open(file_name, 0);
+    test_assert_true(ecl_file_write_index(ecl_file, index_file_name));
+    ecl_file_close(ecl_file);
+}
+
+static void flip_byte(const char *file_name, offset_type offset) {
+    FILE *stream = util_fopen(file_name, "r+b");
+    util_fseek(stream, offset, SEEK_SET);
+    int c = fgetc(stream);
+    util_fseek(stream, offset, SEEK_SET);
+    fputc(c ^ 0x20, stream);
+    fclose(stream);
+}
+
+void test_damaged_index() {
+    ecl::util::TestArea ta("damaged_index");
+    const char *file_name = "DATA_FILE";
+    const char *index_file_name = "index_file";
+    write_data_file(file_name, 10);
+    write_index_file(file_name, index_file_name);
+    test_assert_true(ecl_file_index_valid(file_name, index_file_name));
+
+    size_t index_size = util_file_size(index_file_name);
+    {
+        /* One of the keyword headers in the index is modified. */
+        flip_byte(index_file_name, index_size - 10);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        test_assert_NULL(ecl_file_fast_open(file_name, index_file_name, 0));
+        flip_byte(index_file_name, index_size - 10);
+        test_assert_true(ecl_file_index_valid(file_name, index_file_name));
+    }
+    {
+        /* Truncated index file. */
+        FILE *stream = util_fopen(index_file_name, "r+b");
+        util_ftruncate(stream, index_size - 20);
+        fclose(stream);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        test_assert_NULL(ecl_file_fast_open(file_name, index_file_name, 0));
+    }
+}
+
+void test_modified_data_file() {
+    ecl::util::TestArea ta("modified_data");
+    const char *file_name = "DATA_FILE";
+    const char *index_file_name = "index_file";
+
+    write_data_file(file_name, 10);
+    write_index_file(file_name, index_file_name);
+
+    /* Different size */
+    write_data_file(file_name, 11);
+    test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+
+    /*
+      Same size and modification time, but the header of the last
+      keyword is different.
+    */
+    write_data_file(file_name, 10);
+    write_index_file(file_name, index_file_name);
+    {
+        time_t mtime = util_file_mtime(file_name);
+        struct utimbuf tm = {mtime, mtime};
+        ecl_file_type *ecl_file = ecl_file_open(file_name, 0);
+        offset_type offset =
+            ecl_file_kw_get_offset(ecl_file_iget_file_kw(ecl_file, 1));
+        ecl_file_close(ecl_file);
+
+        flip_byte(file_name, offset + 4);
+        utime(file_name, &tm);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        test_assert_NULL(ecl_file_fast_open(file_name, index_file_name, 0));
+    }
+}
+
+static offset_type kw_offset(const char *file_name, int index) {
+    ecl_file_type *ecl_file = ecl_file_open(file_name, 0);
+    offset_type offset =
+        ecl_file_kw_get_offset(ecl_file_iget_file_kw(ecl_file, index));
+    ecl_file_close(ecl_file);
+    return offset;
+}
+
+/*
+  A sample of the keyword headers, not only the last one, is compared
+  with the index.
+*/
+void test_modified_header_sample() {
+    ecl::util::TestArea ta("modified_sample");
+    const char *file_name = "CASE.INIT";
+    const char *index_file_name = "index_file";
+
+    write_data_file(file_name, 10);
+    write_index_file(file_name, index_file_name);
+    {
+        time_t mtime = util_file_mtime(file_name);
+        struct utimbuf tm = {mtime, mtime};
+        flip_byte(file_name, kw_offset(file_name, 0) + 4);
+        utime(file_name, &tm);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+        test_assert_NULL(ecl_file_fast_open(file_name, index_file_name, 0));
+    }
+
+    /* With 100 keywords, 16 evenly spread headers are checked. */
+    {
+        ecl_kw_type *kw = ecl_kw_alloc("TEST_KW", 10, ECL_INT);
+        fortio_type *fortio =
+            fortio_open_writer(file_name, false, ECL_ENDIAN_FLIP);
+        for (int i = 0; i < 100; i++)
+            ecl_kw_fwrite(kw, fortio);
+        fortio_fclose(fortio);
+        ecl_kw_free(kw);
+    }
+    write_index_file(file_name, index_file_name);
+    test_assert_true(ecl_file_index_valid(file_name, index_file_name));
+    {
+        time_t mtime = util_file_mtime(file_name);
+        struct utimbuf tm = {mtime, mtime};
+        flip_byte(file_name, kw_offset(file_name, 33) + 4);
+        utime(file_name, &tm);
+        test_assert_false(ecl_file_index_valid(file_name, index_file_name));
+    }
+}
+
+/*
+  Index files written by older versions started directly with the name
+  of the data file.
+*/
+void test_old_index_format() {
+    ecl::util::TestArea ta("old_index");
+    const char *file_name = "DATA_FILE";
+    const char *index_file_name = "index_file";
+    write_data_file(file_name, 10);
+    {
+        ecl_file_type *ecl_file = ecl_file_open(file_name, 0);
+        FILE *stream = util_fopen(index_file_name, "wb");
+        util_fwrite_string(file_name, stream);
+        ecl_file_view_write_index(ecl_file_get_global_view(ecl_file), stream);
+        fclose(stream);
+        ecl_file_close(ecl_file);
+    }
+    test_assert_true(ecl_file_index_valid(file_name, index_file_name));
+    {
+        ecl_file_type *ecl_file =
+            ecl_file_fast_open(file_name, index_file_name, 0);
+        test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+    }
+}
+
+void test_auto_index() {
+    ecl::util::TestArea ta("auto_index");
+    util_make_path("data");
+    write_data_file("data/DATA_FILE", 10);
+    ecl_file_set_index_cache_dir(NULL);
+    {
+        char *index_file = ecl_file_alloc_index_filename("data/DATA_FILE");
+        test_assert_string_equal(index_file, "data/.DATA_FILE.ecl_index");
+
+        ecl_file_type *ecl_file =
+            ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+        test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+        test_assert_true(ecl_file_index_valid("data/DATA_FILE", index_file));
+
+        ecl_file = ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+        test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+        test_assert_true(ecl_file_has_kw(ecl_file, "TEST2_KW"));
+        ecl_file_close(ecl_file);
+
+        /* The stale index is replaced when the data file changes. */
+        write_data_file("data/DATA_FILE", 20);
+        ecl_file = ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+        test_assert_int_equal(
+            20, ecl_file_iget_named_size(ecl_file, "TEST1_KW", 0));
+        ecl_file_close(ecl_file);
+        test_assert_true(ecl_file_index_valid("data/DATA_FILE", index_file));
+
+        /*
+          The index can not be written next to the data file when there
+          is a directory with the name of the index file; the index is
+          then written to the cache directory.
+        */
+        remove(index_file);
+        util_make_path(index_file);
+        test_assert_NULL(
+            ecl_file_alloc_index_cache_filename("data/DATA_FILE"));
+        ecl_file_set_index_cache_dir("cache");
+        char *cache_file =
+            ecl_file_alloc_index_cache_filename("data/DATA_FILE");
+        test_assert_not_NULL(cache_file);
+
+        ecl_file = ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+        test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+        ecl_file_close(ecl_file);
+        test_assert_true(ecl_file_index_valid("data/DATA_FILE", cache_file));
+
+        ecl_file = ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+        test_assert_true(ecl_file_has_kw(ecl_file, "TEST1_KW"));
+        ecl_file_close(ecl_file);
+
+        ecl_file_set_index_cache_dir(NULL);
+        free(cache_file);
+        free(index_file);
+    }
+}
+
+/*
+  The cache directory is changed while other threads open files with
+  ECL_FILE_AUTO_INDEX.
+*/
+void test_concurrent_cache_dir() {
+    ecl::util::TestArea ta("concurrent_cache_dir");
+    util_make_path("data");
+    write_data_file("data/DATA_FILE", 10);
+    {
+        char *index_file = ecl_file_alloc_index_filename("data/DATA_FILE");
+        util_make_path(index_file);
+        free(index_file);
+    }
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+            threads.emplace_back([]() {
+                for (int iter = 0; iter < 50; iter++) {
+                    ecl_file_type *ecl_file =
+                        ecl_file_open("data/DATA_FILE", ECL_FILE_AUTO_INDEX);
+                    test_assert_int_equal(2, ecl_file_get_size(ecl_file));
+                    ecl_file_close(ecl_file);
+                }
+            });
+
+        for (int iter = 0; iter < 200; iter++)
+            ecl_file_set_index_cache_dir(iter % 2 ? "cache1" : "cache2");
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+    ecl_file_set_index_cache_dir(NULL);
+}
+
 int main(int argc, char **argv) {
     util_install_signals();
     test_load_nonexisting_file();
     test_create_and_load_index_file();
+    test_damaged_index();
+    test_modified_data_file();
+    test_modified_header_sample();
+    test_old_index_format();
+    test_auto_index();
+    test_concurrent_cache_dir();
 }
@@ -29,6 +29,15 @@ ecl_file_type *ecl_file_fast_open(const char *filename,
 bool ecl_file_write_index(const ecl_file_type *ecl_file,
                           const char *index_filename);
 bool ecl_file_index_valid(const char *file_name, const char *index_file_name);
+void ecl_file_set_index_cache_dir(const char *path);
+char *ecl_file_alloc_index_cache_dir(void);
+void ecl_file_set_scan_range_size(size_t range_size);
+size_t ecl_file_get_scan_range_size(void);
+void ecl_file_set_shared_cache(bool enabled);
+bool ecl_file_get_shared_cache(void);
+int ecl_file_get_shared_cache_size(void);
+char *ecl_file_alloc_index_filename(const char *filename);
+char *ecl_file_alloc_index_cache_filename(const char *filename);
 void ecl_file_close(ecl_file_type *ecl_file);
 void ecl_file_fortio_detach(ecl_file_type *ecl_file);
 void ecl_file_free__(void *arg);
@@ -57,6 +66,15 @@ bool ecl_file_writable(const ecl_file_type *ecl_file);
 int ecl_file_get_flags(const ecl_file_type *ecl_file);
 void ecl_file_set_flags(ecl_file_type *ecl_file, int new_flags);
 bool ecl_file_flags_set(const ecl_file_type *ecl_file, int flags);
+void ecl_file_set_kw_compression(ecl_file_type *ecl_file,
+                                 util_codec_enum codec, size_t hot_size);
+void ecl_file_set_memory_budget(ecl_file_type *ecl_file,
+                                size_t memory_budget);
+size_t ecl_file_get_memory_budget(const ecl_file_type *ecl_file);
+size_t ecl_file_get_kw_hits(const ecl_file_type *ecl_file);
+size_t ecl_file_get_kw_misses(const ecl_file_type *ecl_file);
+size_t ecl_file_get_kw_evictions(const ecl_file_type *ecl_file);
+size_t ecl_file_get_delta_reads(const ecl_file_type *ecl_file);
 
 ecl_file_kw_type *ecl_file_iget_file_kw(const ecl_file_type *file,
                                         int global_index);
@@ -75,6 +93,15 @@ int ecl_file_iget_named_size(const ecl_file_type *file, const char *kw,
                              int ith);
 void ecl_file_indexed_read(const ecl_file_type *file, const char *kw, int index,
                            const int_vector_type *index_map, char *buffer);
+ecl_kw_type *ecl_file_iget_named_kw_slice(const ecl_file_type *file,
+                                          const char *kw, int ith, int start,
+                                          int end);
+bool ecl_file_fread_named_kw_as_double(const ecl_file_type *file,
+                                       const char *kw, int ith, int offset,
+                                       int count, double *data);
+bool ecl_file_fread_named_kw_as_float(const ecl_file_type *file,
+                                      const char *kw, int ith, int offset,
+                                      int count, float *data);
 
 ecl_file_view_type *ecl_file_get_global_blockview(ecl_file_type *ecl_file,
                                                   const char *kw,
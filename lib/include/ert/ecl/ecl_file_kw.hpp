@@ -19,6 +19,21 @@ inv_map_type *inv_map_alloc(void);
 ecl_file_kw_type *inv_map_get_file_kw(inv_map_type *inv_map,
                                       const ecl_kw_type *ecl_kw);
 void inv_map_free(inv_map_type *map);
+void inv_map_set_compression(inv_map_type *map, util_codec_enum codec,
+                             size_t hot_size);
+void inv_map_set_memory_budget(inv_map_type *map, size_t memory_budget);
+size_t inv_map_get_memory_budget(const inv_map_type *map);
+size_t inv_map_get_hits(const inv_map_type *map);
+size_t inv_map_get_misses(const inv_map_type *map);
+size_t inv_map_get_evictions(const inv_map_type *map);
+size_t inv_map_get_delta_reads(const inv_map_type *map);
+void inv_map_lock_stream(inv_map_type *map);
+void inv_map_unlock_stream(inv_map_type *map);
+void inv_map_set_shared_cache(inv_map_type *map, const char *filename);
+void ecl_file_kw_set_shared_cache(bool enabled);
+bool ecl_file_kw_get_shared_cache(void);
+int ecl_file_kw_get_shared_cache_size(void);
+void ecl_file_kw_drop_shared_cache(const char *filename);
 bool ecl_file_kw_equal(const ecl_file_kw_type *kw1,
                        const ecl_file_kw_type *kw2);
 ecl_file_kw_type *ecl_file_kw_alloc(const ecl_kw_type *ecl_kw,
@@ -26,11 +41,28 @@ ecl_file_kw_type *ecl_file_kw_alloc(const ecl_kw_type *ecl_kw,
 ecl_file_kw_type *ecl_file_kw_alloc0(const char *header,
                                      ecl_data_type data_type, int size,
                                      offset_type offset);
+void ecl_file_kw_set_delta(ecl_file_kw_type *file_kw, util_codec_enum codec,
+                           int payload_size, int block_size,
+                           const ecl_file_kw_type *base);
+bool ecl_file_kw_is_delta(const ecl_file_kw_type *file_kw);
 void ecl_file_kw_free(ecl_file_kw_type *file_kw);
 void ecl_file_kw_free__(void *arg);
 ecl_kw_type *ecl_file_kw_get_kw(ecl_file_kw_type *file_kw, fortio_type *fortio,
                                 inv_map_type *inv_map);
 ecl_kw_type *ecl_file_kw_get_kw_ptr(ecl_file_kw_type *file_kw);
+ecl_kw_type *ecl_file_kw_alloc_kw(const ecl_file_kw_type *file_kw,
+                                  fortio_type *fortio);
+void ecl_file_kw_prefetch(ecl_file_kw_type *const *kw_list, int num_kw,
+                          fortio_type *fortio, inv_map_type *inv_map);
+ecl_kw_type *ecl_file_kw_get_loaded_kw(ecl_file_kw_type *file_kw,
+                                       inv_map_type *inv_map);
+const ecl_kw_type *ecl_file_kw_peek_kw(const ecl_file_kw_type *file_kw);
+ecl_kw_type *ecl_file_kw_alloc_slice(const ecl_file_kw_type *file_kw,
+                                     fortio_type *fortio,
+                                     inv_map_type *inv_map, int start,
+                                     int end);
+void ecl_file_kw_mark_access(ecl_file_kw_type *file_kw, inv_map_type *inv_map,
+                             bool evict);
 ecl_file_kw_type *ecl_file_kw_alloc_copy(const ecl_file_kw_type *src);
 const char *ecl_file_kw_get_header(const ecl_file_kw_type *file_kw);
 int ecl_file_kw_get_size(const ecl_file_kw_type *file_kw);
@@ -38,8 +70,8 @@ ecl_data_type ecl_file_kw_get_data_type(const ecl_file_kw_type *);
 offset_type ecl_file_kw_get_offset(const ecl_file_kw_type *file_kw);
 bool ecl_file_kw_ptr_eq(const ecl_file_kw_type *file_kw,
                         const ecl_kw_type *ecl_kw);
-void ecl_file_kw_replace_kw(ecl_file_kw_type *file_kw, fortio_type *target,
-                            ecl_kw_type *new_kw);
+void ecl_file_kw_replace_kw(ecl_file_kw_type *file_kw, inv_map_type *inv_map,
+                            fortio_type *target, ecl_kw_type *new_kw);
 bool ecl_file_kw_fskip_data(const ecl_file_kw_type *file_kw,
                             fortio_type *fortio);
 void ecl_file_kw_inplace_fwrite(ecl_file_kw_type *file_kw, fortio_type *fortio);
@@ -48,9 +80,9 @@ void ecl_file_kw_fwrite(const ecl_file_kw_type *file_kw, FILE *stream);
 ecl_file_kw_type **ecl_file_kw_fread_alloc_multiple(FILE *stream, int num);
 ecl_file_kw_type *ecl_file_kw_fread_alloc(FILE *stream);
 
-void ecl_file_kw_start_transaction(const ecl_file_kw_type *file_kw,
-                                   int *ref_count);
-void ecl_file_kw_end_transaction(ecl_file_kw_type *file_kw, int ref_count);
+void ecl_file_kw_start_transaction(ecl_file_kw_type *file_kw, int *ref_count);
+void ecl_file_kw_end_transaction(ecl_file_kw_type *file_kw,
+                                 inv_map_type *inv_map, int ref_count);
 
 #ifdef __cplusplus
 }
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include <ert/util/stringlist.hpp>
+
 #include <ert/ecl/ecl_kw.hpp>
 #include <ert/ecl/ecl_file_kw.hpp>
 #include <ert/ecl/ecl_type.hpp>
@@ -17,16 +19,39 @@ typedef enum {
                                     This flag will close the underlying FILE object between each access; this is
                                     mainly to save filedescriptors in cases where many ecl_file instances are open at
                                     the same time. */
-    ECL_FILE_WRITABLE = 2      /*
+    ECL_FILE_WRITABLE = 2,     /*
                                     This flag opens the file in a mode where it can be updated and modified, but it
                                     must still exist and be readable. I.e. this should not compared with the normal:
                                     fopen(filename , "w") where an existing file is truncated to zero upon successfull
                                     open.
                                  */
+    ECL_FILE_READ_AHEAD = 4,   /*
+                                    This flag enables read-ahead on the underlying fortio instance, see
+                                    fortio_set_read_ahead(); this speeds up building the index and loading the
+                                    keywords in file order, in particular on network file systems.
+                                 */
+    ECL_FILE_AUTO_INDEX = 8,   /*
+                                    With this flag ecl_file_open() will load the keyword index from an index file
+                                    instead of scanning the file, and write the index file when it does not exist
+                                    or is out of date. The index file is stored next to the data file, or in the
+                                    directory set with ecl_file_set_index_cache_dir() if that is not possible.
+                                 */
+    ECL_FILE_PARALLEL_SCAN = 16, /*
+                                    With this flag the index of an unformatted file is built by scanning ranges of
+                                    the file concurrently, see ecl_file_set_scan_range_size(); the index is the same
+                                    as with the normal sequential scan.
+                                 */
+    ECL_FILE_MMAP = 32          /*
+                                    With this flag an unformatted file which is opened read only is also mapped into
+                                    memory, see fortio_open_reader_mmap(); keywords are then loaded by copying from
+                                    the mapping instead of reading from the file. The process gets SIGBUS if the file
+                                    is truncated while it is open.
+                                 */
 } ecl_file_flag_type;
 
 typedef struct ecl_file_view_struct ecl_file_view_type;
 typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
+typedef struct ecl_file_prefetch_struct ecl_file_prefetch_type;
 
 bool ecl_file_view_flags_set(const ecl_file_view_type *file_view,
                              int query_flags);
@@ -51,6 +76,18 @@ void ecl_file_view_index_fload_kw(const ecl_file_view_type *ecl_file_view,
                                   const char *kw, int index,
                                   const int_vector_type *index_map,
                                   char *buffer);
+void ecl_file_view_fload_named_element(const ecl_file_view_type *ecl_file_view,
+                                       const char *kw, int element_index,
+                                       char *io_buffer);
+ecl_kw_type *
+ecl_file_view_iget_named_kw_slice(const ecl_file_view_type *ecl_file_view,
+                                  const char *kw, int ith, int start, int end);
+bool ecl_file_view_fread_named_kw_as_double(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int offset, int count, double *data);
+bool ecl_file_view_fread_named_kw_as_float(
+    const ecl_file_view_type *ecl_file_view, const char *kw, int ith,
+    int offset, int count, float *data);
 int ecl_file_view_find_kw_value(const ecl_file_view_type *ecl_file_view,
                                 const char *kw, const void *value);
 const char *
@@ -114,8 +151,14 @@ void ecl_file_view_add_flag(ecl_file_view_type *file_view, int flag);
 
 int ecl_file_view_seqnum_index_from_sim_time(ecl_file_view_type *parent_map,
                                              time_t sim_time);
+int ecl_file_view_seqnum_index_from_report_step(
+    const ecl_file_view_type *ecl_file_view, int report_step);
+int ecl_file_view_seqnum_index_from_sim_days(ecl_file_view_type *file_view,
+                                             double sim_days);
 bool ecl_file_view_has_sim_time(const ecl_file_view_type *ecl_file_view,
                                 time_t sim_time);
+bool ecl_file_view_has_sim_days(const ecl_file_view_type *ecl_file_view,
+                                double sim_days);
 int ecl_file_view_find_sim_time(const ecl_file_view_type *ecl_file_view,
                                 time_t sim_time);
 double
@@ -143,6 +186,14 @@ ecl_file_view_start_transaction(ecl_file_view_type *file_view);
 void ecl_file_view_end_transaction(ecl_file_view_type *file_view,
                                    ecl_file_transaction_type *transaction);
 
+bool ecl_file_view_prefetch(const ecl_file_view_type *ecl_file_view,
+                            const stringlist_type *kw_list);
+ecl_file_prefetch_type *
+ecl_file_view_start_prefetch(const ecl_file_view_type *ecl_file_view,
+                             const stringlist_type *kw_list);
+bool ecl_file_view_end_prefetch(const ecl_file_view_type *ecl_file_view,
+                                ecl_file_prefetch_type *prefetch);
+
 #ifdef __cplusplus
 }
 #endif
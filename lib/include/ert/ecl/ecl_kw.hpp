@@ -10,6 +10,7 @@ extern "C" {
 
 #include <ert/util/buffer.hpp>
 #include <ert/util/type_macros.hpp>
+#include <ert/util/util_codec.h>
 
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_util.hpp>
@@ -44,7 +45,9 @@ typedef enum { ECL_KW_READ_OK = 0, ECL_KW_READ_FAIL = 1 } ecl_read_status_enum;
 int ecl_kw_first_different(const ecl_kw_type *kw1, const ecl_kw_type *kw2,
                            int offset, double abs_epsilon, double rel_epsilon);
 size_t ecl_kw_fortio_size(const ecl_kw_type *ecl_kw);
+size_t ecl_kw_fortio_size__(ecl_data_type data_type, int size);
 void *ecl_kw_get_ptr(const ecl_kw_type *ecl_kw);
+const void *ecl_kw_get_const_ptr(const ecl_kw_type *ecl_kw);
 void ecl_kw_set_data_ptr(ecl_kw_type *ecl_kw, void *data);
 void ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw, fortio_type *fortio);
 bool ecl_kw_fread_realloc_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
@@ -64,16 +67,32 @@ void ecl_kw_alloc_float_data(ecl_kw_type *ecl_kw, float *values);
 bool ecl_kw_fread_realloc(ecl_kw_type *, fortio_type *);
 void ecl_kw_fread(ecl_kw_type *, fortio_type *);
 ecl_kw_type *ecl_kw_fread_alloc(fortio_type *);
+ecl_kw_type *ecl_kw_fread_alloc_mmap(fortio_type *fortio);
+ecl_kw_type *ecl_kw_pread_alloc(const fortio_type *fortio,
+                                offset_type offset);
+ecl_kw_type *ecl_kw_unpack_alloc(const fortio_type *fortio,
+                                 const char *records, size_t records_size);
 ecl_kw_type *ecl_kw_alloc_actnum(const ecl_kw_type *porv_kw, float porv_limit);
 ecl_kw_type *ecl_kw_alloc_actnum_bitmask(const ecl_kw_type *porv_kw,
                                          float porv_limit, int actnum_bitmask);
 void ecl_kw_free_data(ecl_kw_type *);
+bool ecl_kw_compress(ecl_kw_type *ecl_kw, util_codec_enum codec);
+bool ecl_kw_is_compressed(const ecl_kw_type *ecl_kw);
+bool ecl_kw_is_modified(const ecl_kw_type *ecl_kw);
+void ecl_kw_clear_modified(ecl_kw_type *ecl_kw);
+size_t ecl_kw_get_data_memory_size(const ecl_kw_type *ecl_kw);
 void ecl_kw_fread_indexed_data(fortio_type *fortio, offset_type data_offset,
                                ecl_data_type, int element_count,
                                const int_vector_type *index_map, char *buffer);
+void ecl_kw_fread_element_multiple(fortio_type *fortio, ecl_data_type data_type,
+                                   int num_kw, const offset_type *data_offset,
+                                   const int *element_count, int element_index,
+                                   char *io_buffer);
 void ecl_kw_free(ecl_kw_type *);
 void ecl_kw_free__(void *);
 ecl_kw_type *ecl_kw_alloc_copy(const ecl_kw_type *);
+ecl_kw_type *ecl_kw_alloc_cow_copy(const ecl_kw_type *src);
+bool ecl_kw_is_cow_shared(const ecl_kw_type *ecl_kw);
 ecl_kw_type *ecl_kw_alloc_sub_copy(const ecl_kw_type *src, const char *new_kw,
                                    int offset, int count);
 const void *ecl_kw_copyc__(const void *);
@@ -89,6 +108,15 @@ void ecl_kw_get_memcpy_double_data(const ecl_kw_type *ecl_kw, double *target);
 void ecl_kw_get_memcpy_int_data(const ecl_kw_type *ecl_kw, int *target);
 void ecl_kw_set_memcpy_data(ecl_kw_type *, const void *);
 bool ecl_kw_fwrite(const ecl_kw_type *, fortio_type *);
+
+typedef struct ecl_kw_writer_struct ecl_kw_writer_type;
+ecl_kw_writer_type *ecl_kw_writer_alloc(fortio_type *fortio,
+                                        const char *header, int size,
+                                        ecl_data_type data_type);
+void ecl_kw_writer_append(ecl_kw_writer_type *writer, const void *data,
+                          int count);
+int ecl_kw_writer_get_remaining(const ecl_kw_writer_type *writer);
+void ecl_kw_writer_free(ecl_kw_writer_type *writer);
 void ecl_kw_iget(const ecl_kw_type *, int, void *);
 void ecl_kw_iset(ecl_kw_type *ecl_kw, int i, const void *iptr);
 void ecl_kw_iset_char_ptr(ecl_kw_type *ecl_kw, int index, const char *s);
@@ -114,6 +142,19 @@ float ecl_kw_iget_as_float(const ecl_kw_type *ecl_kw, int i);
 double ecl_kw_iget_as_double(const ecl_kw_type *ecl_kw, int i);
 void ecl_kw_get_data_as_double(const ecl_kw_type *, double *);
 void ecl_kw_get_data_as_float(const ecl_kw_type *ecl_kw, float *float_data);
+void ecl_kw_get_slice_as_double(const ecl_kw_type *ecl_kw, int offset,
+                                int count, double *double_data);
+void ecl_kw_get_slice_as_float(const ecl_kw_type *ecl_kw, int offset,
+                               int count, float *float_data);
+bool ecl_kw_fread_data_as_double(fortio_type *fortio, offset_type data_offset,
+                                 ecl_data_type data_type, int element_count,
+                                 int offset, int count, double *double_data);
+bool ecl_kw_fread_data_as_float(fortio_type *fortio, offset_type data_offset,
+                                ecl_data_type data_type, int element_count,
+                                int offset, int count, float *float_data);
+bool ecl_kw_fread_data_slice(ecl_kw_type *ecl_kw, fortio_type *fortio,
+                             offset_type data_offset, int element_count,
+                             int offset);
 bool ecl_kw_name_equal(const ecl_kw_type *ecl_kw, const char *name);
 bool ecl_kw_header_eq(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2);
 bool ecl_kw_equal(const ecl_kw_type *ecl_kw1, const ecl_kw_type *ecl_kw2);
@@ -148,6 +189,12 @@ void ecl_kw_element_sum(const ecl_kw_type *, void *);
 void ecl_kw_element_sum_indexed(const ecl_kw_type *ecl_kw,
                                 const int_vector_type *index_list, void *_sum);
 void ecl_kw_max_min(const ecl_kw_type *, void *, void *);
+void ecl_kw_set_parallel_threshold(int threshold);
+int ecl_kw_get_parallel_threshold();
+void ecl_kw_set_reduce_threads(int num_threads);
+int ecl_kw_get_reduce_threads();
+void ecl_kw_set_compensated_sum(bool compensated);
+bool ecl_kw_get_compensated_sum();
 void *ecl_kw_get_void_ptr(const ecl_kw_type *ecl_kw);
 
 ecl_kw_type *ecl_kw_buffer_alloc(buffer_type *buffer);
@@ -177,6 +224,10 @@ ecl_kw_type *ecl_kw_alloc_scatter_copy(const ecl_kw_type *src_kw,
 
 void ecl_kw_inplace_add_squared(ecl_kw_type *target_kw,
                                 const ecl_kw_type *add_kw);
+void ecl_kw_inplace_add_scaled(ecl_kw_type *target_kw, double scale,
+                               const ecl_kw_type *add_kw);
+void ecl_kw_inplace_add_moments(ecl_kw_type *sum_kw, ecl_kw_type *sum2_kw,
+                                const ecl_kw_type *add_kw);
 void ecl_kw_inplace_add(ecl_kw_type *target_kw, const ecl_kw_type *add_kw);
 void ecl_kw_inplace_sub(ecl_kw_type *target_kw, const ecl_kw_type *sub_kw);
 void ecl_kw_inplace_div(ecl_kw_type *target_kw, const ecl_kw_type *div_kw);
@@ -249,6 +300,14 @@ ECL_KW_GET_TYPED_PTR_HEADER(int);
 ECL_KW_GET_TYPED_PTR_HEADER(bool);
 #undef ECL_KW_GET_TYPED_PTR_HEADER
 
+#define ECL_KW_GET_TYPED_CONST_PTR_HEADER(type)                                \
+    const type *ecl_kw_get_const_##type##_ptr(const ecl_kw_type *)
+ECL_KW_GET_TYPED_CONST_PTR_HEADER(double);
+ECL_KW_GET_TYPED_CONST_PTR_HEADER(float);
+ECL_KW_GET_TYPED_CONST_PTR_HEADER(int);
+ECL_KW_GET_TYPED_CONST_PTR_HEADER(bool);
+#undef ECL_KW_GET_TYPED_CONST_PTR_HEADER
+
 #define ECL_KW_SET_INDEXED_HEADER(ctype)                                       \
     void ecl_kw_set_indexed_##ctype(                                           \
         ecl_kw_type *ecl_kw, const int_vector_type *index_list, ctype value)
@@ -0,0 +1,68 @@
+#ifndef ERT_ECL_RST_DELTA_H
+#define ERT_ECL_RST_DELTA_H
+
+#include <stdbool.h>
+
+#include <ert/util/util_codec.h>
+
+#include <ert/ecl/ecl_kw.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Layout of the delta archive, see ecl_rst_delta.cpp. The archive
+  starts with the ECL_RST_DELTA_KW keyword, and every keyword of the
+  original file is stored as a descriptor keyword followed by the
+  payload keyword. The archive ends with the index, names and end
+  keywords, which give the offset of every payload keyword.
+*/
+
+#define ECL_RST_DELTA_KW "ECLDELTA"
+#define ECL_RST_DELTA_DESC_KW "DELTADSC"
+#define ECL_RST_DELTA_INDEX_KW "DELTAIDX"
+#define ECL_RST_DELTA_NAMES_KW "DELTANAM"
+#define ECL_RST_DELTA_END_KW "DELTAEND"
+
+#define ECL_RST_DELTA_VERSION 2
+#define ECL_RST_DELTA_KEYFRAME_INTERVAL 10
+#define ECL_RST_DELTA_BLOCK_SIZE 1000
+
+#define ECL_RST_DELTA_VERSION_INDEX 0
+#define ECL_RST_DELTA_KEYFRAME_INDEX 1
+#define ECL_RST_DELTA_SIZE 2
+
+#define ECL_RST_DELTA_DESC_TYPE_INDEX 0
+#define ECL_RST_DELTA_DESC_TYPE_SIZE_INDEX 1
+#define ECL_RST_DELTA_DESC_SIZE_INDEX 2
+#define ECL_RST_DELTA_DESC_CODEC_INDEX 3
+#define ECL_RST_DELTA_DESC_BASE_INDEX 4
+#define ECL_RST_DELTA_DESC_BLOCK_SIZE_INDEX 5
+#define ECL_RST_DELTA_DESC_SIZE 6
+
+/* An index entry is the descriptor followed by these fields. */
+#define ECL_RST_DELTA_INDEX_PAYLOAD_SIZE_INDEX 6
+#define ECL_RST_DELTA_INDEX_OFFSET_LOW_INDEX 7
+#define ECL_RST_DELTA_INDEX_OFFSET_HIGH_INDEX 8
+#define ECL_RST_DELTA_INDEX_SIZE 9
+
+#define ECL_RST_DELTA_END_OFFSET_LOW_INDEX 0
+#define ECL_RST_DELTA_END_OFFSET_HIGH_INDEX 1
+#define ECL_RST_DELTA_END_SIZE 2
+
+bool ecl_rst_delta_pack(const char *src_file, const char *archive_file,
+                        int keyframe_interval, int block_size);
+bool ecl_rst_delta_unpack(const char *archive_file, const char *target_file);
+int ecl_rst_delta_num_frames(int size, int block_size);
+int ecl_rst_delta_frame_ints(int frame_bytes);
+bool ecl_rst_delta_decode(const int *frame_bytes, int num_frames,
+                          const int *frames, int frames_size,
+                          util_codec_enum codec, int element_size,
+                          size_t block_bytes, const void *base_data,
+                          void *data, size_t byte_size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
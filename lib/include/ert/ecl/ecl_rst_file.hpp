@@ -22,6 +22,9 @@ void ecl_rst_file_fwrite_header(ecl_rst_file_type *rst_file, int seqnum,
                                 ecl_rsthead_type *rsthead_data);
 void ecl_rst_file_add_kw(ecl_rst_file_type *rst_file,
                          const ecl_kw_type *ecl_kw);
+ecl_kw_writer_type *ecl_rst_file_alloc_kw_writer(ecl_rst_file_type *rst_file,
+                                                 const char *header, int size,
+                                                 ecl_data_type data_type);
 offset_type ecl_rst_file_ftell(const ecl_rst_file_type *rst_file);
 
 #ifdef __cplusplus
@@ -18,6 +18,9 @@ ecl_sum_tstep_alloc_remap_copy(const ecl_sum_tstep_type *src,
                                float default_value, const int *params_map);
 ecl_sum_tstep_type *ecl_sum_tstep_alloc_copy(const ecl_sum_tstep_type *src);
 void ecl_sum_tstep_free(ecl_sum_tstep_type *ministep);
+void ecl_sum_tstep_set_storage(ecl_sum_tstep_type *tstep, float *storage,
+                               int stride);
+void ecl_sum_tstep_clear_storage(ecl_sum_tstep_type *tstep);
 void ecl_sum_tstep_free__(void *__ministep);
 ecl_sum_tstep_type *ecl_sum_tstep_alloc_from_file(
     int report_step, int ministep_nr, const ecl_kw_type *params_kw,
@@ -41,6 +41,9 @@ typedef enum {
 
 typedef struct fortio_struct fortio_type;
 
+/* Default read-ahead window, see fortio_set_read_ahead(). */
+#define FORTIO_DEFAULT_READ_AHEAD (32 << 20)
+
 fortio_status_type fortio_check_buffer(FILE *stream, bool endian_flip,
                                        size_t buffer_size);
 fortio_status_type fortio_check_file(const char *filename, bool endian_flip);
@@ -54,6 +57,19 @@ fortio_type *fortio_open_readwrite(const char *, bool fmt_file,
                                    bool endian_flip_header);
 fortio_type *fortio_open_append(const char *filename, bool fmt_file,
                                 bool endian_flip_header);
+fortio_type *fortio_open_reader_mmap(const char *filename, bool fmt_file,
+                                     bool endian_flip_header);
+bool fortio_is_mmapped(const fortio_type *fortio);
+const char *fortio_mmap_fread_buffer(fortio_type *fortio, int element_size,
+                                     size_t element_count, int block_size);
+bool fortio_pread_buffer(const fortio_type *fortio, offset_type offset,
+                         char *buffer, int element_size, size_t element_count,
+                         int block_size);
+bool fortio_pread(const fortio_type *fortio, offset_type offset,
+                  char *buffer, size_t size);
+bool fortio_unpack_buffer(const fortio_type *fortio, const char *records,
+                          size_t records_size, char *buffer, int element_size,
+                          int element_count, int block_size);
 fortio_type *fortio_alloc_FILE_wrapper(const char *, bool, bool, bool, FILE *);
 void fortio_free_FILE_wrapper(fortio_type *);
 void fortio_fclose(fortio_type *);
@@ -61,9 +77,9 @@ int fortio_init_read(fortio_type *);
 bool fortio_complete_read(fortio_type *, int record_size);
 void fortio_init_write(fortio_type *, int);
 void fortio_complete_write(fortio_type *, int record_size);
-void fortio_fskip_buffer(fortio_type *, int);
+void fortio_fskip_buffer(fortio_type *, size_t buffer_size);
 int fortio_fskip_record(fortio_type *);
-bool fortio_fread_buffer(fortio_type *, char *buffer, int buffer_size);
+bool fortio_fread_buffer(fortio_type *, char *buffer, size_t buffer_size);
 void fortio_fwrite_record(fortio_type *, const char *buffer, int buffer_size);
 FILE *fortio_get_FILE(const fortio_type *);
 void fortio_fflush(fortio_type *);
@@ -76,9 +92,16 @@ offset_type fortio_ftell(const fortio_type *fortio);
 bool fortio_fseek(fortio_type *fortio, offset_type offset, int whence);
 bool fortio_data_fskip(fortio_type *fortio, const int element_size,
                        const int element_count, const int block_count);
+bool fortio_data_fskip_checked(fortio_type *fortio, const int element_size,
+                               const int element_count, const int block_size);
+offset_type fortio_data_offset(offset_type data_offset, size_t data_element,
+                               const int element_size, const int element_count,
+                               const int block_size);
 void fortio_data_fseek(fortio_type *fortio, offset_type data_offset,
                        size_t data_element, const int element_size,
                        const int element_count, const int block_size);
+void fortio_fread_gather(fortio_type *fortio, const offset_type *offsets,
+                         int count, int element_size, char *buffer);
 int fortio_fileno(fortio_type *fortio);
 bool fortio_ftruncate(fortio_type *fortio, offset_type size);
 int fortio_fclean(fortio_type *fortio);
@@ -87,6 +110,8 @@ bool fortio_fclose_stream(fortio_type *fortio);
 bool fortio_fopen_stream(fortio_type *fortio);
 bool fortio_stream_is_open(const fortio_type *fortio);
 bool fortio_assert_stream_open(fortio_type *fortio);
+bool fortio_set_read_ahead(fortio_type *fortio, size_t read_ahead);
+size_t fortio_get_read_ahead(const fortio_type *fortio);
 bool fortio_read_at_eof(fortio_type *fortio);
 void fortio_fwrite_error(fortio_type *fortio);
 
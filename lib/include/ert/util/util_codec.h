@@ -0,0 +1,45 @@
+#ifndef ERT_UTIL_CODEC_H
+#define ERT_UTIL_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Codecs for compressing vectors of fixed size elements in memory. Both
+  codecs first transform the data to make it more compressible: 4 and 8
+  byte elements are XOR'ed with the previous element, and then the bytes
+  are regrouped so that byte 0 of all elements come first, then byte 1
+  and so on.
+
+    UTIL_CODEC_FAST : The transformed data is run length encoded; this
+                      is fast, and works well for integer data and for
+                      fields with many equal values, but saves little on
+                      floating point fields with noise.
+
+    UTIL_CODEC_ZLIB : The transformed data is compressed with zlib at
+                      the fastest level. This is slower, but compresses
+                      better. Only available when compiled with zlib.
+*/
+
+typedef enum {
+    UTIL_CODEC_NONE = 0,
+    UTIL_CODEC_FAST = 1,
+    UTIL_CODEC_ZLIB = 2
+} util_codec_enum;
+
+bool util_codec_supported(util_codec_enum codec);
+size_t util_codec_compress(util_codec_enum codec, int element_size,
+                           const void *src, size_t src_size, void *target,
+                           size_t target_size);
+bool util_codec_decompress(util_codec_enum codec, int element_size,
+                           const void *src, size_t src_size, void *target,
+                           size_t target_size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
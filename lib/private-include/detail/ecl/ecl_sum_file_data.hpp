@@ -128,10 +128,18 @@ private:
     TimeIndex index;
     vector_type *data;
 
+    /*
+      Column major copy of the PARAMS of the tsteps in data, which are
+      views of the rows; empty when the tsteps own the values.
+    */
+    std::vector<float> columns;
+
     std::unique_ptr<ecl::unsmry_loader> loader;
 
     void append_tstep(ecl_sum_tstep_type *tstep);
     void build_index();
+    void build_columns();
+    void clear_columns();
     void fwrite_report(int report_step, fortio_type *fortio) const;
     bool check_file(ecl_file_type *ecl_file);
     void add_ecl_file(int report_step, const ecl_file_view_type *summary_view);
@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+#include <ert/util/util_codec.h>
+
+#define SIZE 10000
+
+static void test_roundtrip(util_codec_enum codec, int element_size,
+                           const void *data, size_t size) {
+    char *zdata = (char *)util_malloc(2 * size + 16);
+    char *copy = (char *)util_malloc(size + 1);
+    size_t zsize = util_codec_compress(codec, element_size, data, size, zdata,
+                                       2 * size + 16);
+
+    test_assert_true(zsize > 0);
+    test_assert_true(util_codec_decompress(codec, element_size, zdata, zsize,
+                                           copy, size));
+    test_assert_int_equal(0, memcmp(data, copy, size));
+
+    /* Truncated input and wrong output size are detected. */
+    test_assert_false(util_codec_decompress(codec, element_size, zdata,
+                                            zsize - 1, copy, size));
+    test_assert_false(util_codec_decompress(codec, element_size, zdata, zsize,
+                                            copy, size + element_size));
+
+    free(copy);
+    free(zdata);
+}
+
+void test_smooth_float(util_codec_enum codec) {
+    float *data = (float *)util_malloc(SIZE * sizeof *data);
+    for (int i = 0; i < SIZE; i++)
+        data[i] = 200.0 + (i / 100);
+
+    test_roundtrip(codec, sizeof *data, data, SIZE * sizeof *data);
+    {
+        char *zdata = (char *)util_malloc(SIZE * sizeof *data);
+        size_t zsize =
+            util_codec_compress(codec, sizeof *data, data, SIZE * sizeof *data,
+                                zdata, SIZE * sizeof *data);
+        test_assert_true(zsize > 0);
+        test_assert_true(zsize < SIZE * sizeof *data / 4);
+        free(zdata);
+    }
+    free(data);
+}
+
+void test_types(util_codec_enum codec) {
+    {
+        int *data = (int *)util_malloc(SIZE * sizeof *data);
+        for (int i = 0; i < SIZE; i++)
+            data[i] = i % 7;
+        test_roundtrip(codec, sizeof *data, data, SIZE * sizeof *data);
+        free(data);
+    }
+    {
+        double *data = (double *)util_malloc(SIZE * sizeof *data);
+        for (int i = 0; i < SIZE; i++)
+            data[i] = sin(i * 0.001);
+        test_roundtrip(codec, sizeof *data, data, SIZE * sizeof *data);
+        free(data);
+    }
+    {
+        char data[9 * 100];
+        for (size_t i = 0; i < sizeof data; i++)
+            data[i] = (i % 9 == 8) ? '\0' : 'A' + (i % 9);
+        test_roundtrip(codec, 9, data, sizeof data);
+    }
+    {
+        char data[1] = {'X'};
+        test_roundtrip(codec, 1, data, sizeof data);
+    }
+}
+
+/*
+  Random data can not be compressed; when the target buffer is smaller
+  than the input compression fails.
+*/
+void test_random(util_codec_enum codec) {
+    uint32_t *data = (uint32_t *)util_malloc(SIZE * sizeof *data);
+    uint32_t state = 12345;
+    for (int i = 0; i < SIZE; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        data[i] = state;
+    }
+
+    test_roundtrip(codec, sizeof *data, data, SIZE * sizeof *data);
+    {
+        size_t size = SIZE * sizeof *data;
+        char *zdata = (char *)util_malloc(size);
+        test_assert_size_t_equal(0, util_codec_compress(codec, sizeof *data,
+                                                        data, size, zdata,
+                                                        size - size / 8));
+        free(zdata);
+    }
+    free(data);
+}
+
+int main(int argc, char **argv) {
+    test_assert_true(util_codec_supported(UTIL_CODEC_FAST));
+    test_assert_false(util_codec_supported(UTIL_CODEC_NONE));
+
+    test_smooth_float(UTIL_CODEC_FAST);
+    test_types(UTIL_CODEC_FAST);
+    test_random(UTIL_CODEC_FAST);
+
+    if (util_codec_supported(UTIL_CODEC_ZLIB)) {
+        test_smooth_float(UTIL_CODEC_ZLIB);
+        test_types(UTIL_CODEC_ZLIB);
+        test_random(UTIL_CODEC_ZLIB);
+    }
+    exit(0);
+}
@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+
+#define MAX_SIZE 100
+
+/*
+  The vectorized kernels only handle the leading part of the vector
+  which fills complete SIMD registers; the sizes and offsets are varied
+  to also exercise the scalar tail and unaligned access.
+*/
+
+static void reverse_bytes(char *data, int element_size, int elements) {
+    for (int i = 0; i < elements; i++) {
+        char *elm = &data[i * element_size];
+        for (int j = 0; j < element_size / 2; j++) {
+            char tmp = elm[j];
+            elm[j] = elm[element_size - 1 - j];
+            elm[element_size - 1 - j] = tmp;
+        }
+    }
+}
+
+void test_flip(int element_size) {
+    char input[MAX_SIZE * 8 + 1];
+    char expected[MAX_SIZE * 8 + 1];
+    char data[MAX_SIZE * 8 + 1];
+
+    for (size_t i = 0; i < sizeof input; i++)
+        input[i] = (char)(i * 7 + 3);
+
+    for (int offset = 0; offset < 2; offset++) {
+        for (int size = 0; size <= MAX_SIZE; size++) {
+            memcpy(expected, input, sizeof input);
+            memcpy(data, input, sizeof input);
+            reverse_bytes(&expected[offset], element_size, size);
+            util_endian_flip_vector(&data[offset], element_size, size);
+            test_assert_int_equal(0, memcmp(data, expected, sizeof data));
+
+            util_endian_flip_vector(&data[offset], element_size, size);
+            test_assert_int_equal(0, memcmp(data, input, sizeof data));
+        }
+    }
+}
+
+void test_float_to_double() {
+    float values[MAX_SIZE + 1];
+    char swapped[(MAX_SIZE + 1) * sizeof(float) + 1];
+    double target[MAX_SIZE + 1];
+
+    for (int i = 0; i <= MAX_SIZE; i++)
+        values[i] = (i - 50) * 0.37f;
+
+    for (int offset = 0; offset < 2; offset++) {
+        memcpy(&swapped[offset], values, sizeof values);
+        reverse_bytes(&swapped[offset], sizeof(float), MAX_SIZE + 1);
+        for (int size = 0; size <= MAX_SIZE; size++) {
+            for (int i = 0; i <= MAX_SIZE; i++)
+                target[i] = -1;
+
+            util_endian_flip_float_to_double(target, &swapped[offset], size);
+            for (int i = 0; i < size; i++)
+                test_assert_double_equal(target[i], values[i]);
+            test_assert_double_equal(target[size], -1);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    test_flip(2);
+    test_flip(4);
+    test_flip(8);
+    test_float_to_double();
+    exit(0);
+}
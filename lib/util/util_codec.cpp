@@ -0,0 +1,236 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ert/util/ert_api_config.hpp>
+#include <ert/util/util.h>
+#include <ert/util/util_codec.h>
+
+#ifdef ERT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/*
+  The run length encoding is a variant of PackBits. The encoded stream
+  is a sequence of blocks starting with a control byte c:
+
+    c < 128  : The c + 1 following bytes are copied verbatim.
+    c >= 128 : The following byte is repeated c - 128 + RLE_MIN_RUN times.
+*/
+
+#define RLE_MIN_RUN 3
+#define RLE_MAX_RUN (127 + RLE_MIN_RUN)
+#define RLE_MAX_LITERAL 128
+
+static size_t util_codec_rle_encode(const unsigned char *src, size_t size,
+                                    unsigned char *target,
+                                    size_t target_size) {
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < RLE_MAX_RUN && src[i + run] == src[i])
+            run++;
+
+        if (run >= RLE_MIN_RUN) {
+            if (pos + 2 > target_size)
+                return 0;
+            target[pos++] = (unsigned char)(128 + run - RLE_MIN_RUN);
+            target[pos++] = src[i];
+            i += run;
+        } else {
+            size_t end = i;
+            while (end < size && end - i < RLE_MAX_LITERAL) {
+                if (end + 2 < size && src[end] == src[end + 1] &&
+                    src[end] == src[end + 2])
+                    break;
+                end++;
+            }
+
+            size_t length = end - i;
+            if (pos + 1 + length > target_size)
+                return 0;
+            target[pos++] = (unsigned char)(length - 1);
+            memcpy(&target[pos], &src[i], length);
+            pos += length;
+            i = end;
+        }
+    }
+    return pos;
+}
+
+static bool util_codec_rle_decode(const unsigned char *src, size_t src_size,
+                                  unsigned char *target, size_t size) {
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < src_size) {
+        unsigned int control = src[i++];
+        if (control < 128) {
+            size_t length = control + 1;
+            if (i + length > src_size || pos + length > size)
+                return false;
+            memcpy(&target[pos], &src[i], length);
+            i += length;
+            pos += length;
+        } else {
+            size_t run = control - 128 + RLE_MIN_RUN;
+            if (i >= src_size || pos + run > size)
+                return false;
+            memset(&target[pos], src[i++], run);
+            pos += run;
+        }
+    }
+    return pos == size;
+}
+
+/*
+  XOR each element with the previous element; the first element is
+  left unchanged. The filter is applied in reverse order so it can be
+  done in place.
+*/
+template <typename T> static void util_codec_xor_encode(T *data, size_t n) {
+    for (size_t i = n; i > 1; i--)
+        data[i - 1] ^= data[i - 2];
+}
+
+template <typename T> static void util_codec_xor_decode(T *data, size_t n) {
+    for (size_t i = 1; i < n; i++)
+        data[i] ^= data[i - 1];
+}
+
+static void util_codec_shuffle(const unsigned char *src, unsigned char *target,
+                               size_t elements, int element_size) {
+    for (int j = 0; j < element_size; j++) {
+        unsigned char *plane = &target[j * elements];
+        for (size_t i = 0; i < elements; i++)
+            plane[i] = src[i * element_size + j];
+    }
+}
+
+static void util_codec_unshuffle(const unsigned char *src,
+                                 unsigned char *target, size_t elements,
+                                 int element_size) {
+    for (int j = 0; j < element_size; j++) {
+        const unsigned char *plane = &src[j * elements];
+        for (size_t i = 0; i < elements; i++)
+            target[i * element_size + j] = plane[i];
+    }
+}
+
+/*
+  Returns a newly allocated transformed copy of the input data.
+*/
+static unsigned char *util_codec_alloc_filtered(const void *src, size_t size,
+                                                int element_size) {
+    size_t elements = size / element_size;
+    unsigned char *tmp = (unsigned char *)util_malloc(size);
+    unsigned char *filtered = (unsigned char *)util_malloc(size);
+
+    memcpy(tmp, src, size);
+    if (element_size == 4)
+        util_codec_xor_encode((uint32_t *)tmp, elements);
+    else if (element_size == 8)
+        util_codec_xor_encode((uint64_t *)tmp, elements);
+
+    util_codec_shuffle(tmp, filtered, elements, element_size);
+    free(tmp);
+    return filtered;
+}
+
+static void util_codec_unfilter(const unsigned char *filtered, void *target,
+                                size_t size, int element_size) {
+    size_t elements = size / element_size;
+    util_codec_unshuffle(filtered, (unsigned char *)target, elements,
+                         element_size);
+    if (element_size == 4)
+        util_codec_xor_decode((uint32_t *)target, elements);
+    else if (element_size == 8)
+        util_codec_xor_decode((uint64_t *)target, elements);
+}
+
+bool util_codec_supported(util_codec_enum codec) {
+    switch (codec) {
+    case (UTIL_CODEC_FAST):
+        return true;
+    case (UTIL_CODEC_ZLIB):
+#ifdef ERT_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+/*
+  Compresses @src_size bytes from @src into the buffer @target, and
+  returns the number of bytes written. If the compressed data does not
+  fit in @target_size bytes, or the codec is not supported, the function
+  returns 0. @src_size must be a multiple of @element_size.
+*/
+size_t util_codec_compress(util_codec_enum codec, int element_size,
+                           const void *src, size_t src_size, void *target,
+                           size_t target_size) {
+    if (!util_codec_supported(codec) || src_size == 0)
+        return 0;
+
+    if (element_size <= 0 || src_size % element_size != 0)
+        util_abort("%s: size:%zu is not a multiple of element size:%d\n",
+                   __func__, src_size, element_size);
+
+    size_t compressed_size = 0;
+    unsigned char *filtered =
+        util_codec_alloc_filtered(src, src_size, element_size);
+
+    if (codec == UTIL_CODEC_FAST)
+        compressed_size = util_codec_rle_encode(
+            filtered, src_size, (unsigned char *)target, target_size);
+#ifdef ERT_HAVE_ZLIB
+    else {
+        uLongf zlib_size = target_size;
+        if (compress2((Bytef *)target, &zlib_size, (const Bytef *)filtered,
+                      src_size, Z_BEST_SPEED) == Z_OK)
+            compressed_size = zlib_size;
+    }
+#endif
+
+    free(filtered);
+    return compressed_size;
+}
+
+/*
+  Decompresses data compressed with util_codec_compress(); the
+  @target_size must be the original size. Returns false if the
+  compressed data is not valid.
+*/
+bool util_codec_decompress(util_codec_enum codec, int element_size,
+                           const void *src, size_t src_size, void *target,
+                           size_t target_size) {
+    if (!util_codec_supported(codec))
+        return false;
+
+    if (target_size == 0)
+        return src_size == 0;
+
+    bool valid = false;
+    unsigned char *filtered = (unsigned char *)util_malloc(target_size);
+
+    if (codec == UTIL_CODEC_FAST)
+        valid = util_codec_rle_decode((const unsigned char *)src, src_size,
+                                      filtered, target_size);
+#ifdef ERT_HAVE_ZLIB
+    else {
+        uLongf zlib_size = target_size;
+        valid = (uncompress((Bytef *)filtered, &zlib_size,
+                            (const Bytef *)src, src_size) == Z_OK) &&
+                (zlib_size == target_size);
+    }
+#endif
+
+    if (valid)
+        util_codec_unfilter(filtered, target, target_size, element_size);
+
+    free(filtered);
+    return valid;
+}
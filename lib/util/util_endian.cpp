@@ -1,38 +1,44 @@
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
-#if UINTPTR_MAX == 0xFFFFFFFF
-#define ARCH32
-#elif UINTPTR_MAX == 0xFFFFFFFFFFFFFFFF
-#define ARCH64
-#else
-#error "Could not determine if this is a 32 bit or 64 bit computer?"
-#endif
+#include <ert/util/util.h>
+#include <ert/util/util_endian.h>
 
 /*
-   Macros for endian flipping. The macros create a new endian-flipped
-   value, and should be used as:
+  The bulk of the endian flipping is done on numeric keywords loaded
+  from binary ECLIPSE files, i.e. vectors of 4 and 8 byte elements. For
+  these element sizes there are SIMD kernels:
 
-     flipped_value = FLIP32( value )
+    x86 : SSE2 is always available on x86_64 and is the baseline. If
+          the compiler supports function level target attributes an
+          AVX2 kernel is also compiled, and used if the cpu supports it
+          - this is checked at runtime.
 
-   The macros are not exported and only available through the function
-   util_endian_flip_vector().
-*/
+    ARM : NEON kernels when compiling with NEON support.
 
-#define FLIP16(var) (((var >> 8) & 0x00ff) | ((var << 8) & 0xff00))
+  The kernels only handle the part of the vector which fills complete
+  SIMD registers; the remaining elements are flipped with the scalar
+  code.
+*/
 
-#define FLIP32(var)                                                            \
-    (((var >> 24) & 0x000000ff) | ((var >> 8) & 0x0000ff00) |                  \
-     ((var << 8) & 0x00ff0000) | ((var << 24) & 0xff000000))
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTIL_ENDIAN_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTIL_ENDIAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
 
-#define FLIP64(var)                                                            \
-    (((var >> 56) & 0x00000000000000ff) | ((var >> 40) & 0x000000000000ff00) | \
-     ((var >> 24) & 0x0000000000ff0000) | ((var >> 8) & 0x00000000ff000000) |  \
-     ((var << 8) & 0x000000ff00000000) | ((var << 24) & 0x0000ff0000000000) |  \
-     ((var << 40) & 0x00ff000000000000) | ((var << 56) & 0xff00000000000000))
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define UTIL_ENDIAN_NEON
+#include <arm_neon.h>
+#endif
 
 static uint16_t util_endian_convert16(uint16_t u) {
-    return ((u >> 8U) & 0xFFU) | ((u & 0xFFU) >> 8U);
+    return ((u >> 8U) & 0xFFU) | ((u & 0xFFU) << 8U);
 }
 
 static uint32_t util_endian_convert32(uint32_t u) {
@@ -55,6 +61,9 @@ static uint64_t util_endian_convert64(uint64_t u) {
     return u;
 }
 
+/*
+   Swaps the bytes of two 32 bit elements packed in one 64 bit word.
+*/
 static uint64_t util_endian_convert32_64(uint64_t u) {
     const uint64_t m8 = (uint64_t)0x00FF00FF00FF00FFULL;
     const uint64_t m16 = (uint64_t)0x0000FFFF0000FFFFULL;
@@ -64,52 +73,233 @@ static uint64_t util_endian_convert32_64(uint64_t u) {
     return u;
 }
 
+/*
+  The scalar flips work on char pointers, and load and store the
+  elements with memcpy(), because the data need not be aligned to the
+  element size; e.g. the tail after the SIMD kernels, or a buffer
+  which is a slice of a larger io buffer.
+*/
+static void util_endian_flip16(char *data, size_t elements) {
+    for (size_t i = 0; i < elements; i++) {
+        uint16_t u;
+        memcpy(&u, &data[2 * i], sizeof u);
+        u = util_endian_convert16(u);
+        memcpy(&data[2 * i], &u, sizeof u);
+    }
+}
+
+/*
+  Swapping two 32 bit elements in one 64 bit operation is faster than
+  swapping them one by one.
+*/
+static void util_endian_flip32(char *data, size_t elements) {
+    size_t i = 0;
+    for (; i + 2 <= elements; i += 2) {
+        uint64_t u;
+        memcpy(&u, &data[4 * i], sizeof u);
+        u = util_endian_convert32_64(u);
+        memcpy(&data[4 * i], &u, sizeof u);
+    }
+
+    if (i < elements) {
+        uint32_t u;
+        memcpy(&u, &data[4 * i], sizeof u);
+        u = util_endian_convert32(u);
+        memcpy(&data[4 * i], &u, sizeof u);
+    }
+}
+
+static void util_endian_flip64(char *data, size_t elements) {
+    for (size_t i = 0; i < elements; i++) {
+        uint64_t u;
+        memcpy(&u, &data[8 * i], sizeof u);
+        u = util_endian_convert64(u);
+        memcpy(&data[8 * i], &u, sizeof u);
+    }
+}
+
+static double util_endian_float_to_double(uint32_t u) {
+    float f;
+    u = util_endian_convert32(u);
+    memcpy(&f, &u, sizeof f);
+    return f;
+}
+
+#ifdef UTIL_ENDIAN_SSE2
+
+/*
+  SSE2 does not have a general byte shuffle; the bytes are swapped
+  pairwise within 16 bit words with shifts, and then the 16 bit words
+  are reordered.
+*/
+static inline __m128i util_endian_sse2_swap16(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline __m128i util_endian_sse2_swap32(__m128i v) {
+    v = util_endian_sse2_swap16(v);
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static inline __m128i util_endian_sse2_swap64(__m128i v) {
+    v = util_endian_sse2_swap16(v);
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static size_t util_endian_flip_sse2(char *data, size_t bytes,
+                                    int element_size) {
+    size_t offset = 0;
+    for (; offset + 16 <= bytes; offset += 16) {
+        __m128i *ptr = (__m128i *)&data[offset];
+        __m128i v = _mm_loadu_si128(ptr);
+        if (element_size == 4)
+            v = util_endian_sse2_swap32(v);
+        else
+            v = util_endian_sse2_swap64(v);
+        _mm_storeu_si128(ptr, v);
+    }
+    return offset;
+}
+
+static size_t util_endian_float_to_double_sse2(double *target, const char *src,
+                                               size_t elements) {
+    size_t i = 0;
+    for (; i + 4 <= elements; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&src[4 * i]);
+        __m128 f = _mm_castsi128_ps(util_endian_sse2_swap32(v));
+        _mm_storeu_pd(&target[i], _mm_cvtps_pd(f));
+        _mm_storeu_pd(&target[i + 2], _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+    }
+    return i;
+}
+
+#endif
+
+#ifdef UTIL_ENDIAN_AVX2
+
+static bool util_endian_have_avx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+util_endian_avx2_mask(int element_size) {
+    if (element_size == 4)
+        return _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8,
+                                15, 14, 13, 12);
+    else
+        return _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10,
+                                9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12,
+                                11, 10, 9, 8);
+}
+
+__attribute__((target("avx2"))) static size_t
+util_endian_flip_avx2(char *data, size_t bytes, int element_size) {
+    const __m256i mask = util_endian_avx2_mask(element_size);
+    size_t offset = 0;
+    for (; offset + 32 <= bytes; offset += 32) {
+        __m256i *ptr = (__m256i *)&data[offset];
+        __m256i v = _mm256_loadu_si256(ptr);
+        _mm256_storeu_si256(ptr, _mm256_shuffle_epi8(v, mask));
+    }
+    return offset;
+}
+
+__attribute__((target("avx2"))) static size_t
+util_endian_float_to_double_avx2(double *target, const char *src,
+                                 size_t elements) {
+    const __m256i mask = util_endian_avx2_mask(4);
+    size_t i = 0;
+    for (; i + 8 <= elements; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&src[4 * i]);
+        __m256 f = _mm256_castsi256_ps(_mm256_shuffle_epi8(v, mask));
+        _mm256_storeu_pd(&target[i],
+                         _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+        _mm256_storeu_pd(&target[i + 4],
+                         _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+    }
+    return i;
+}
+
+#endif
+
+#ifdef UTIL_ENDIAN_NEON
+
+static size_t util_endian_flip_neon(char *data, size_t bytes,
+                                    int element_size) {
+    size_t offset = 0;
+    for (; offset + 16 <= bytes; offset += 16) {
+        uint8_t *ptr = (uint8_t *)&data[offset];
+        uint8x16_t v = vld1q_u8(ptr);
+        if (element_size == 4)
+            v = vrev32q_u8(v);
+        else
+            v = vrev64q_u8(v);
+        vst1q_u8(ptr, v);
+    }
+    return offset;
+}
+
+#ifdef __aarch64__
+static size_t util_endian_float_to_double_neon(double *target, const char *src,
+                                               size_t elements) {
+    size_t i = 0;
+    for (; i + 4 <= elements; i += 4) {
+        uint8x16_t v = vrev32q_u8(vld1q_u8((const uint8_t *)&src[4 * i]));
+        float32x4_t f = vreinterpretq_f32_u8(v);
+        vst1q_f64(&target[i], vcvt_f64_f32(vget_low_f32(f)));
+        vst1q_f64(&target[i + 2], vcvt_high_f64_f32(f));
+    }
+    return i;
+}
+#endif
+
+#endif
+
+/*
+  Flips the 4 or 8 byte elements in the leading part of the vector with
+  the best available SIMD kernel, and returns the number of bytes which
+  have been flipped.
+*/
+static size_t util_endian_flip_simd(char *data, size_t bytes,
+                                    int element_size) {
+#ifdef UTIL_ENDIAN_AVX2
+    if (util_endian_have_avx2())
+        return util_endian_flip_avx2(data, bytes, element_size);
+#endif
+
+#ifdef UTIL_ENDIAN_SSE2
+    return util_endian_flip_sse2(data, bytes, element_size);
+#elif defined(UTIL_ENDIAN_NEON)
+    return util_endian_flip_neon(data, bytes, element_size);
+#else
+    return 0;
+#endif
+}
+
 void util_endian_flip_vector(void *data, int element_size, int elements) {
-    int i;
+    char *char_data = (char *)data;
+    size_t num_elements = elements > 0 ? elements : 0;
     switch (element_size) {
     case (1):
         break;
-    case (2): {
-        uint16_t *tmp16 = (uint16_t *)data;
-
-        for (i = 0; i < elements; i++)
-            tmp16[i] = util_endian_convert16(tmp16[i]);
+    case (2):
+        util_endian_flip16(char_data, num_elements);
         break;
-    }
     case (4): {
-#ifdef ARCH64
-        /*
-        In the case of a 64 bit CPU the fastest way to swap 32 bit
-        variables will be by swapping two elements in one operation;
-        this is provided by the util_endian_convert32_64() function. In the case
-        of binary ECLIPSE files this case is quite common, and
-        therefore worth supporting as a special case.
-      */
-        uint64_t *tmp64 = (uint64_t *)data;
-
-        for (i = 0; i < elements / 2; i++)
-            tmp64[i] = util_endian_convert32_64(tmp64[i]);
-
-        if (elements & 1) {
-            // Odd number of elements - flip the last element as an ordinary 32 bit swap.
-            uint32_t *tmp32 = (uint32_t *)data;
-            tmp32[elements - 1] = util_endian_convert32(tmp32[elements - 1]);
-        }
-        break;
-#else
-        uint32_t *tmp32 = (uint32_t *)data;
-
-        for (i = 0; i < elements; i++)
-            tmp32[i] = util_endian_convert32(tmp32[i]);
-
+        size_t flipped = util_endian_flip_simd(
+            char_data, num_elements * element_size, element_size);
+        util_endian_flip32(&char_data[flipped],
+                           num_elements - flipped / element_size);
         break;
-#endif
     }
     case (8): {
-        uint64_t *tmp64 = (uint64_t *)data;
-
-        for (i = 0; i < elements; i++)
-            tmp64[i] = util_endian_convert64(tmp64[i]);
+        size_t flipped = util_endian_flip_simd(
+            char_data, num_elements * element_size, element_size);
+        util_endian_flip64(&char_data[flipped],
+                           num_elements - flipped / element_size);
         break;
     }
     default:
@@ -120,3 +310,36 @@ void util_endian_flip_vector(void *data, int element_size, int elements) {
             __func__);
     }
 }
+
+/*
+  Converts 'elements' float values stored with the opposite byte order
+  in 'src' to double values in 'target'; the byte swap and the
+  conversion to double are done in one pass. The 'src' buffer is not
+  modified, and need not be aligned.
+*/
+void util_endian_flip_float_to_double(double *target, const void *src,
+                                      int elements) {
+    const char *char_src = (const char *)src;
+    size_t num_elements = elements > 0 ? elements : 0;
+    size_t converted = 0;
+
+#ifdef UTIL_ENDIAN_AVX2
+    if (util_endian_have_avx2())
+        converted =
+            util_endian_float_to_double_avx2(target, char_src, num_elements);
+#endif
+
+#ifdef UTIL_ENDIAN_SSE2
+    converted += util_endian_float_to_double_sse2(
+        &target[converted], &char_src[4 * converted], num_elements - converted);
+#elif defined(UTIL_ENDIAN_NEON) && defined(__aarch64__)
+    converted =
+        util_endian_float_to_double_neon(target, char_src, num_elements);
+#endif
+
+    for (size_t i = converted; i < num_elements; i++) {
+        uint32_t u;
+        memcpy(&u, &char_src[4 * i], sizeof u);
+        target[i] = util_endian_float_to_double(u);
+    }
+}
@@ -85,11 +85,19 @@ class EclFileFlagEnum(BaseCEnum):
     ECL_FILE_DEFAULT = None
     ECL_FILE_CLOSE_STREAM = None
     ECL_FILE_WRITABLE = None
+    ECL_FILE_READ_AHEAD = None
+    ECL_FILE_AUTO_INDEX = None
+    ECL_FILE_PARALLEL_SCAN = None
+    ECL_FILE_MMAP = None
 
 
 EclFileFlagEnum.addEnum("ECL_FILE_DEFAULT", 0)
 EclFileFlagEnum.addEnum("ECL_FILE_CLOSE_STREAM", 1)
 EclFileFlagEnum.addEnum("ECL_FILE_WRITABLE", 2)
+EclFileFlagEnum.addEnum("ECL_FILE_READ_AHEAD", 4)
+EclFileFlagEnum.addEnum("ECL_FILE_AUTO_INDEX", 8)
+EclFileFlagEnum.addEnum("ECL_FILE_PARALLEL_SCAN", 16)
+EclFileFlagEnum.addEnum("ECL_FILE_MMAP", 32)
 
 
 # -----------------------------------------------------------------
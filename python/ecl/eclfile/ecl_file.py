@@ -205,6 +205,26 @@ class EclFile(BaseCClass):
               in cases where a high number of EclFile instances are
               open concurrently.
 
+           ecl.ECL_FILE_READ_AHEAD : The file is prefetched in large
+              chunks while it is read; this speeds up opening and
+              loading large files, in particular on network file
+              systems.
+
+           ecl.ECL_FILE_AUTO_INDEX : The keyword index is loaded
+              from an index file instead of scanning the file, and
+              the index file is written on the first open. The index
+              file is stored next to the file, or in the directory
+              given by the environment variable ECL_INDEX_CACHE_DIR
+              if the directory of the file is not writable.
+
+           ecl.ECL_FILE_PARALLEL_SCAN : The keyword index of an
+              unformatted file is built by scanning ranges of the
+              file concurrently; for very large files.
+
+           ecl.ECL_FILE_MMAP : An unformatted file opened read only
+              is mapped into memory, and the keywords are loaded from
+              the mapping.
+
         When the file has been loaded the EclFile instance can be used
         to query for and get reference to the EclKW instances
         constituting the file, like e.g. SWAT from a restart file or